@@ -1,7 +1,7 @@
 #
 TEMPLATE = subdirs
 CONFIG   += ordered
-SUBDIRS  += qdlt src plugin commander
+SUBDIRS  += qdlt src plugin commander logger
 CONFIG += c++1z
 
 ICON = Project.icns
@@ -0,0 +1,157 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file benchstatistics.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "benchstatistics.h"
+#include "../src/version.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSysInfo>
+
+#include <cstdio>
+#include <utility>
+
+BenchStatistics::BenchStatistics()
+{
+    m_totalTimer.start();
+    m_info.insert("version", QString(PACKAGE_VERSION));
+    m_info.insert("cpu", QSysInfo::currentCpuArchitecture());
+    m_info.insert("os", QSysInfo::prettyProductName());
+}
+
+void BenchStatistics::startStage()
+{
+    m_stageHeapBytes = getHeapBytes();
+    m_stageTimer.start();
+}
+
+void BenchStatistics::endStage(const QString& name, qint64 messages, qint64 bytes)
+{
+    QJsonObject stage = createStage(name, m_stageTimer.nsecsElapsed(), messages, bytes);
+    // growth of the heap in use, memory allocated and freed again within the stage is not counted
+    const qint64 heapBytes = getHeapBytes();
+    if (heapBytes >= 0 && m_stageHeapBytes >= 0)
+        stage.insert("heapGrowthBytes", heapBytes - m_stageHeapBytes);
+    const qint64 peakRss = getPeakRss();
+    if (peakRss >= 0)
+        stage.insert("peakRssBytes", peakRss);
+    m_stages.append(stage);
+}
+
+void BenchStatistics::addExporterStages(const QDltExporter::Statistics& statistics, int threads)
+{
+    const std::pair<const char*, const QDltExporter::StageStatistics*> stages[] = {
+        { "read", &statistics.read },
+        { "decode", &statistics.decode },
+        { "filter", &statistics.filter },
+        { "format", &statistics.format },
+        { "write", &statistics.write },
+    };
+    for (const auto& [name, stage] : stages) {
+        QJsonObject object = createStage(name, stage->nsecs, stage->messages, stage->bytes);
+        // the worker stages run in parallel, their time is the sum over all threads
+        const bool worker = stage != &statistics.read && stage != &statistics.write;
+        object.insert("threads", worker ? threads : 1);
+        m_stages.append(object);
+    }
+}
+
+void BenchStatistics::setInfo(const QString& key, const QJsonValue& value)
+{
+    m_info.insert(key, value);
+}
+
+QJsonObject BenchStatistics::createStage(const QString& name, qint64 nsecs, qint64 messages, qint64 bytes) const
+{
+    const double seconds = nsecs / 1e9;
+    QJsonObject stage;
+    stage.insert("name", name);
+    stage.insert("timeMs", nsecs / 1e6);
+    stage.insert("messages", messages);
+    stage.insert("bytes", bytes);
+    stage.insert("messagesPerSecond", seconds > 0 ? messages / seconds : 0.0);
+    stage.insert("megabytesPerSecond", seconds > 0 ? bytes / seconds / (1024 * 1024) : 0.0);
+    return stage;
+}
+
+bool BenchStatistics::write(const QString& filename) const
+{
+    QJsonObject root = m_info;
+    root.insert("stages", m_stages);
+    root.insert("totalTimeMs", m_totalTimer.nsecsElapsed() / 1e6);
+    const qint64 peakRss = getPeakRss();
+    if (peakRss >= 0)
+        root.insert("peakRssBytes", peakRss);
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    // qDebug() writes to stderr, so the JSON on stdout can be piped into other tools
+    if (filename == "-") {
+        fwrite(json.constData(), 1, json.size(), stdout);
+        fflush(stdout);
+        return true;
+    }
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        qDebug() << "ERROR: Couldn't write statistics file:" << filename;
+        return false;
+    }
+    return true;
+}
+
+qint64 BenchStatistics::getPeakRss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.PeakWorkingSetSize);
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(__APPLE__)
+    return qint64(usage.ru_maxrss); // bytes
+#else
+    return qint64(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+qint64 BenchStatistics::getHeapBytes()
+{
+    // only glibc reports the heap usage with 64 bit counters
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks + info.hblkhd);
+#endif
+#endif
+    return -1;
+}
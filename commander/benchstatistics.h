@@ -0,0 +1,66 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file benchstatistics.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef BENCHSTATISTICS_H
+#define BENCHSTATISTICS_H
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <qdltexporter.h>
+
+// Collects the time, the counters and the memory usage of the stages of a dlt-commander run
+// and writes them as JSON, so the throughput of releases can be compared.
+class BenchStatistics
+{
+public:
+    BenchStatistics();
+
+    // start the measurement of a stage run by the commander itself
+    void startStage();
+    // end the stage started last, adds its wall time, the heap growth and the peak RSS so far
+    void endStage(const QString& name, qint64 messages, qint64 bytes);
+
+    // add the stages measured inside the exporter, the time of the worker stages is summed over the threads
+    void addExporterStages(const QDltExporter::Statistics& statistics, int threads);
+
+    // add general information about the run, e.g. the input files or the output format
+    void setInfo(const QString& key, const QJsonValue& value);
+
+    // write the JSON document into the file, "-" for standard output
+    bool write(const QString& filename) const;
+
+    // peak resident set size of the process in bytes, -1 if not available
+    static qint64 getPeakRss();
+    // heap memory currently in use by the process in bytes, -1 if not available
+    static qint64 getHeapBytes();
+
+private:
+    QJsonObject createStage(const QString& name, qint64 nsecs, qint64 messages, qint64 bytes) const;
+
+    QElapsedTimer m_totalTimer;
+    QElapsedTimer m_stageTimer;
+    qint64 m_stageHeapBytes{-1};
+    QJsonObject m_info;
+    QJsonArray m_stages;
+};
+
+#endif // BENCHSTATISTICS_H
@@ -31,8 +31,15 @@ CONFIG(debug, debug|release) {
 SOURCES += \
         main.cpp \
         optmanager.cpp \
-        dltfileexporter.cpp
+        benchstatistics.cpp \
+        dltfileexporter.cpp \
+        tracegenerator.cpp
 
 HEADERS += \
-    optmanager.h
-    dltfileexporter.h
+    optmanager.h \
+    benchstatistics.h \
+    dltfileexporter.h \
+    tracegenerator.h
+
+# peak memory usage of the statistics
+win32:LIBS += -lpsapi
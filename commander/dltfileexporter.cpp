@@ -3,19 +3,23 @@
 
 #include <ctime>
 #include <cstddef>
+#include <qdltcompressedwriter.h>
 #include <qdltfilterlist.h>
 #include <qdltfile.h>
+#include <qdltfilereader.h>
+#include <qdltfilterrouter.h>
 
 #include <QFile>
 #include <QDebug>
 #include <QFileInfo>
 #include <QDir>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 namespace {
 
-std::optional<std::pair<QDltMsg, QByteArray>> getMessage(const QDltFile& file, int index) {
-    QByteArray buf = file.getMsg(index);
+std::optional<std::pair<QDltMsg, QByteArray>> parseMessage(const QDltFile& file, QByteArray buf, int index) {
     if(buf.isEmpty())
     {
         qDebug() << "Message buffer empty in for msg with index" << index;
@@ -30,55 +34,141 @@ std::optional<std::pair<QDltMsg, QByteArray>> getMessage(const QDltFile& file, i
     return std::make_pair(std::move(msg), buf);
 }
 
-class SimpleWriter {
+// Calls handler for each message either from the index of the input file
+// or read sequentially from the stream input files without an index.
+template <typename Handler>
+void forEachMessage(const QDltFile& input, const QStringList& streamInputFiles,
+                    const std::optional<QVector<QPair<int, int>>>& ranges,
+                    const std::optional<QVector<qint64>>& indexes, Handler&& handler) {
+    if (streamInputFiles.isEmpty() && indexes) {
+        for (qint64 i : *indexes) {
+            if (auto res = parseMessage(input, input.getMsg(i), i)) {
+                handler(*res);
+            }
+        }
+        return;
+    }
+    if (streamInputFiles.isEmpty()) {
+        const QVector<QPair<int, int>> all{qMakePair(0, input.size())};
+        for (const auto& range : ranges ? *ranges : all) {
+            const int first = qMax(0, range.first);
+            const int last = qMin(input.size(), range.second);
+            for (int i = first; i < last; ++i) {
+                if (auto res = parseMessage(input, input.getMsg(i), i)) {
+                    handler(*res);
+                }
+            }
+        }
+        return;
+    }
+
+    QDltFileReader reader;
+    QByteArray buf;
+    int index = 0;
+    for (const auto& filename : streamInputFiles) {
+        if (!reader.open(filename)) {
+            qDebug() << "Couldn't open input file: " << filename;
+            continue;
+        }
+        while (reader.readMsg(buf)) {
+            if (auto res = parseMessage(input, buf, index++)) {
+                handler(*res);
+            }
+        }
+        if (reader.getErrors() > 0) {
+            qDebug() << "Skipped" << reader.getErrors() << "corrupted sections in" << filename;
+        }
+        reader.close();
+    }
+}
+
+// output data is collected and written in large chunks, many outputs can be open at the same time
+constexpr int kWriteBufferSize = 256 * 1024;
+
+// .dlt.zst outputs are written as seekable zstd frames, compressed by a background thread
+std::unique_ptr<QIODevice> openOutput(const QString& outputPath) {
+    std::unique_ptr<QIODevice> output;
+    if (QDltCompressedWriter::isCompressedFileName(outputPath)) {
+        auto writer = std::make_unique<QDltCompressedWriter>();
+        writer->setFileName(outputPath);
+        output = std::move(writer);
+    } else {
+        output = std::make_unique<QFile>(outputPath);
+    }
+    if (!output->open(QIODevice::WriteOnly)) {
+        qDebug() << "Couldn't open output file: " << outputPath;
+        throw std::runtime_error("File couldn't be opened for writing");
+    }
+    return output;
+}
+
+class Writer {
+public:
+    virtual ~Writer() = default;
+    virtual void write(const QByteArray& buf, const time_t& ts) = 0;
+};
+
+class SimpleWriter : public Writer {
 public:
-    SimpleWriter(const QString& outputPath) {
-        m_output.setFileName(outputPath);
+    SimpleWriter(const QString& outputPath) : m_output(openOutput(outputPath)) {}
+
+    ~SimpleWriter() override {
+        flush();
     }
 
-    void write(const QByteArray& buf, const time_t&) {
-        m_output.write(buf);
+    void write(const QByteArray& buf, const time_t&) override {
+        m_buffer.append(buf);
+        if (m_buffer.size() >= kWriteBufferSize) {
+            flush();
+        }
     }
 
 private:
-    QFile m_output;
+    std::unique_ptr<QIODevice> m_output;
+    QByteArray m_buffer;
+
+    void flush() {
+        m_output->write(m_buffer);
+        m_buffer.clear();
+    }
 };
 
-class SplitWriter {
+// the size limit applies to the uncompressed data for compressed outputs
+class SplitWriter : public Writer {
 public:
-    SplitWriter(const QString& basePath, std::size_t maxOutputSize)
-      : m_basePath(basePath), m_bytesWritten{maxOutputSize}, m_maxOutputSize{maxOutputSize} {}
+    SplitWriter(const QString& basePath, std::size_t maxOutputSize, const QString& extension)
+      : m_basePath(basePath), m_extension(extension), m_bytesWritten{maxOutputSize}, m_maxOutputSize{maxOutputSize} {}
 
-    ~SplitWriter() {
-        if (m_output.isOpen()) {
+    ~SplitWriter() override {
+        if (m_output) {
             // rename very last file
-            m_output.rename(nextFileName());
+            closeOutput();
         }
     }
 
-    void write(const QByteArray& buf, const time_t& ts) {
+    void write(const QByteArray& buf, const time_t& ts) override {
         if (m_bytesWritten >= m_maxOutputSize) {
-            if (m_output.isOpen()) {
-                m_output.rename(nextFileName());
-                m_output.close();
+            if (m_output) {
+                closeOutput();
             }
 
-            m_output.setFileName(m_basePath + "_tmp.dlt");
-            if (!m_output.open(QIODevice::WriteOnly)) {
-                qDebug() << "Couldn't open output file: " << m_output.fileName();
-                throw std::runtime_error("File couldn't be opened for writing");
-            }
+            m_output = openOutput(tmpFileName());
             m_bytesWritten = 0;
             ++m_fileCounter;
             m_timestampBegin = formatTimestamp(ts);
         }
-        m_output.write(buf);
+        m_buffer.append(buf);
+        if (m_buffer.size() >= kWriteBufferSize) {
+            flush();
+        }
         m_bytesWritten += buf.size();
         m_timestampEnd = formatTimestamp(ts);
     }
 private:
-    QFile m_output;
+    std::unique_ptr<QIODevice> m_output;
+    QByteArray m_buffer;
     QString m_basePath;
+    QString m_extension;
     std::size_t m_bytesWritten;
     std::size_t m_fileCounter{0};
     std::size_t m_maxOutputSize;
@@ -86,9 +176,26 @@ private:
     QString m_timestampBegin;
     QString m_timestampEnd;
 
+    void flush() {
+        m_output->write(m_buffer);
+        m_buffer.clear();
+    }
+
+    // compressed files are complete when closed, so all outputs are closed before renaming
+    void closeOutput() {
+        flush();
+        m_output->close();
+        m_output.reset();
+        QFile::rename(tmpFileName(), nextFileName());
+    }
+
+    QString tmpFileName() {
+        return m_basePath + "_tmp" + m_extension;
+    }
+
     QString nextFileName() {
         return m_basePath + "_" + m_timestampBegin + "-" + m_timestampEnd + "_" +
-               QString::number(m_fileCounter) + ".dlt";
+               QString::number(m_fileCounter) + m_extension;
     }
 
     QString formatTimestamp(const time_t& timestamp) {
@@ -100,20 +207,6 @@ private:
         return QString(strtime);
     }
 };
-
-template <typename Writer>
-void processMessages(const QDltFile& m_input, QDltFilterList& filterList, Writer& writer) {
-    for (int i = 0; i < m_input.size(); ++i) {
-        auto res = getMessage(m_input, i);
-        if (!res) {
-            continue;
-        }
-        auto [msg, buf] = *res;
-        if (filterList.isEmpty() || filterList.checkFilter(msg)) {
-            writer.write(buf, msg.getTime());
-        }
-    }
-}
 }
 
 DltFileExporter::DltFileExporter(const QDltFile& input) : m_input(input) {}
@@ -129,8 +222,33 @@ void DltFileExporter::setMaxOutputSize(std::size_t sz)
     m_maxOutputSize = sz;
 }
 
+void DltFileExporter::setStreamInputFiles(const QStringList& files)
+{
+    m_streamInputFiles = files;
+}
+
+void DltFileExporter::setMessageRanges(const QVector<QPair<int, int>>& ranges)
+{
+    m_messageRanges = ranges;
+}
+
+void DltFileExporter::setTimeRange(qint64 startTime, qint64 stopTime)
+{
+    m_timeRange = std::make_pair(startTime, stopTime);
+}
+
+void DltFileExporter::setMessageIndexes(const QVector<qint64>& indexes)
+{
+    m_messageIndexes = indexes;
+}
+
 void DltFileExporter::exportMessages(const QString& outputName)
 {
+    // each output has its own filter list and writer, all outputs are served by a single pass over the input
+    QDltFilterRouter router;
+    std::vector<std::unique_ptr<Writer>> writers;
+    const QString extension = QDltCompressedWriter::isCompressedFileName(outputName) ? ".dlt.zst" : ".dlt";
+
     if (m_splitByFilter) {
         const QFileInfo outputInfo(outputName);
         const auto outputDir = outputInfo.absolutePath() + "/" + outputInfo.baseName();
@@ -146,14 +264,14 @@ void DltFileExporter::exportMessages(const QString& outputName)
             }
 
             const QFileInfo filterInfo(filterFilepath);
+            router.addOutput(filterList);
             if (m_maxOutputSize) {
-                SplitWriter writer(outputDir + "/" + filterInfo.baseName(), *m_maxOutputSize);
-                processMessages(m_input, filterList, writer);
+                writers.push_back(std::make_unique<SplitWriter>(outputDir + "/" + filterInfo.baseName(), *m_maxOutputSize, extension));
             } else {
-                SimpleWriter writer(outputDir + "/" + filterInfo.baseName() + ".dlt");
-                processMessages(m_input, filterList, writer);
+                writers.push_back(std::make_unique<SimpleWriter>(outputDir + "/" + filterInfo.baseName() + extension));
             }
         }
+        qDebug() << "Export to" << router.size() << "outputs with" << router.sizeFilters() << "distinct filters";
     } else {
         QDltFilterList filterList;
         for (const auto& filterFilepath : m_filters) {
@@ -163,12 +281,36 @@ void DltFileExporter::exportMessages(const QString& outputName)
         }
 
         const QFileInfo info(outputName);
+        router.addOutput(filterList);
         if (m_maxOutputSize) {
-            SplitWriter writer(info.absolutePath() + "/" + info.baseName(), *m_maxOutputSize);
-            processMessages(m_input, filterList, writer);
+            writers.push_back(std::make_unique<SplitWriter>(info.absolutePath() + "/" + info.baseName(), *m_maxOutputSize, extension));
         } else {
-            SimpleWriter writer(outputName);
-            processMessages(m_input, filterList, writer);
+            writers.push_back(std::make_unique<SimpleWriter>(outputName));
         }
     }
+
+    if (writers.empty()) {
+        return;
+    }
+
+    m_readMessages = m_readBytes = m_writtenMessages = m_writtenBytes = 0;
+    QVector<int> matches;
+    forEachMessage(m_input, m_streamInputFiles, m_messageRanges, m_messageIndexes, [&](std::pair<QDltMsg, QByteArray>& res) {
+        auto& [msg, buf] = res;
+        ++m_readMessages;
+        m_readBytes += buf.size();
+        // the storage header times are not ascending in every file
+        if (m_timeRange) {
+            const qint64 time = qint64(msg.getTime()) * 1000000 + msg.getMicroseconds();
+            if (time < m_timeRange->first || time > m_timeRange->second) {
+                return;
+            }
+        }
+        router.route(msg, matches);
+        for (int output : matches) {
+            writers[output]->write(buf, msg.getTime());
+            ++m_writtenMessages;
+            m_writtenBytes += buf.size();
+        }
+    });
 }
@@ -2,9 +2,12 @@
 #define DLTFILEEXPORTER_H
 
 #include <QString>
+#include <QPair>
 #include <QStringList>
+#include <QVector>
 
 #include <optional>
+#include <utility>
 
 class QDltFile;
 
@@ -15,14 +18,36 @@ public:
 
     void setFilterList(const QStringList& filters, bool splitByFilter);
     void setMaxOutputSize(std::size_t sz);
+    // read messages sequentially from these files instead of the indexed input file
+    void setStreamInputFiles(const QStringList& files);
+    // export only the messages with index in these ranges from first up to but not including last, not used for stream input
+    void setMessageRanges(const QVector<QPair<int, int>>& ranges);
+    // export only the messages with a storage header time in this range in microseconds, last time included
+    void setTimeRange(qint64 startTime, qint64 stopTime);
+    // export only these messages in this order, e.g. merged by time, not used for stream input
+    void setMessageIndexes(const QVector<qint64>& indexes);
 
     void exportMessages(const QString& output);
 
+    // counters of the last export, for the statistics
+    qint64 getReadMessages() const { return m_readMessages; }
+    qint64 getReadBytes() const { return m_readBytes; }
+    qint64 getWrittenMessages() const { return m_writtenMessages; }
+    qint64 getWrittenBytes() const { return m_writtenBytes; }
+
 private:
     const QDltFile& m_input;
     QStringList m_filters;
     bool m_splitByFilter{false};
     std::optional<std::size_t> m_maxOutputSize;
+    QStringList m_streamInputFiles;
+    std::optional<QVector<QPair<int, int>>> m_messageRanges;
+    std::optional<std::pair<qint64, qint64>> m_timeRange;
+    std::optional<QVector<qint64>> m_messageIndexes;
+    qint64 m_readMessages{0};
+    qint64 m_readBytes{0};
+    qint64 m_writtenMessages{0};
+    qint64 m_writtenBytes{0};
 };
 
 #endif // DLTFILEEXPORTER_H
@@ -1,6 +1,9 @@
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
+#include <QJsonArray>
+#include <QThread>
 #include <QTime>
 
 #include <qdltfile.h>
@@ -9,7 +12,13 @@
 #include <qdltexporter.h>
 #include <optmanager.h>
 
+#include "benchstatistics.h"
 #include "dltfileexporter.h"
+#include "tracegenerator.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
 
 /*
  * Examples:
@@ -22,11 +31,56 @@
  * -c c:/_test/output.txt c:/_test/input.txt
  * -csv -c c:/_test/output.csv c:/_test/input.dlt
  * -csv -c c:/_test/output.csv c:/_test/filter.dlf c:/_test/input.dlt
+ * -parquet -c c:/_test/output.parquet c:/_test/filter.dlf c:/_test/input.dlt
  * -d -c c:/_test/output.dlt c:/_test/filter.dlf c:/_test/input.dlt
  * -csv -c c:/_test/output.csv c:/_test/input1.mf4 c:/_test/input2.mf4 c:/_test/filter.dlf c:/_test/output.dlt
+ * -stream -d -c c:/_test/output.dlt c:/_test/filter.dlf c:/_test/input1.dlt c:/_test/input2.dlt
+ * -merge -d -c c:/_test/output.dlt c:/_test/input1.dlt c:/_test/input2.dlt
+ * -d -from "2024-03-01 14:02:10" -to "2024-03-01 14:05:00" -c c:/_test/output.dlt c:/_test/input.dlt
+ * -stats c:/_test/stats.json -csv -c c:/_test/output.csv c:/_test/input.dlt
+ * -bench 1000000:50:8 -csv -c c:/_test/output.csv c:/_test/bench.dlt
  *
  */
 
+// Convert the time of the -from and -to options to microseconds since 1970,
+// a time without date is on the day of the first message
+static bool parseTimeOption(const QString &text, QDltFile &dltFile, qint64 &time)
+{
+    QDateTime dateTime = QDateTime::fromString(text, "yyyy-MM-dd hh:mm:ss.zzz");
+    if(!dateTime.isValid())
+        dateTime = QDateTime::fromString(text, "yyyy-MM-dd hh:mm:ss");
+    if(!dateTime.isValid())
+    {
+        QTime timeOfDay = QTime::fromString(text, "hh:mm:ss.zzz");
+        if(!timeOfDay.isValid())
+            timeOfDay = QTime::fromString(text, "hh:mm:ss");
+        QDltMsg msg;
+        if(!timeOfDay.isValid() || dltFile.size() == 0 || !dltFile.getMsg(0, msg))
+            return false;
+        dateTime = QDateTime(QDateTime::fromSecsSinceEpoch(msg.getTime()).date(), timeOfDay);
+    }
+    time = dateTime.toMSecsSinceEpoch() * 1000;
+    return true;
+}
+
+// Run the export, the stages are measured if statistics are enabled
+static void runExport(QDltExporter &exporter, BenchStatistics *stats)
+{
+    if(stats)
+    {
+        exporter.setStatisticsEnabled(true);
+        stats->startStage();
+    }
+    exporter.exportMessages();
+    if(stats)
+    {
+        const QDltExporter::Statistics &statistics = exporter.getStatistics();
+        stats->endStage("export", statistics.read.messages, statistics.read.bytes);
+        stats->setInfo("threads", exporter.getWorkerThreadCount());
+        stats->addExporterStages(statistics, exporter.getWorkerThreadCount());
+    }
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
@@ -34,10 +88,13 @@ int main(int argc, char *argv[])
     QDltFilterList filterList;
     OptManager opt;
     QFile outputfile;
+    std::unique_ptr<BenchStatistics> stats;
 
     // Parse commandline parameters
     QStringList arguments = a.arguments();
     opt.parse(&arguments);
+    if(!opt.getStatsFile().isEmpty() || opt.isBench())
+        stats = std::make_unique<BenchStatistics>();
 
     // Perform some checks
     if(opt.getLogFiles().size()<1)
@@ -45,6 +102,21 @@ int main(int argc, char *argv[])
         qDebug() << "ERROR: No DLT file used. At least one DLT file must be provided.";
         return -1;
     }
+    if(opt.isStream() && (!opt.getFromTime().isEmpty() || !opt.getToTime().isEmpty()))
+    {
+        qDebug() << "ERROR: A time range cannot be used with -stream, the messages are found in the index.";
+        return -1;
+    }
+    if(opt.isStream() && opt.isMerge())
+    {
+        qDebug() << "ERROR: -merge cannot be used with -stream, the messages are sorted in the index.";
+        return -1;
+    }
+    if(opt.isBench() && (opt.getMf4Files().size()>0 || opt.getPcapFiles().size()>0))
+    {
+        qDebug() << "ERROR: -bench generates the DLT file, it cannot be used with MF4 or PCAP import.";
+        return -1;
+    }
     if(opt.getMf4Files().size()>0 || opt.getPcapFiles().size()>0)
     {
         if(opt.getLogFiles().size()>1)
@@ -61,9 +133,32 @@ int main(int argc, char *argv[])
         }
     }
 
-    // Import
+    // Generate the synthetic trace of the benchmark into the first DLT file
+    if(opt.isBench())
+    {
+        TraceGenerator generator;
+        if(!generator.parse(opt.getBenchOption()))
+        {
+            qDebug() << "ERROR: Invalid benchmark trace:" << opt.getBenchOption();
+            return -1;
+        }
+        qDebug() << "### Generate benchmark trace";
+        qDebug() << "Messages:" << generator.getMessageCount() << "verbose:" << generator.getVerbosePercent() << "% arguments:" << generator.getArgumentCount();
+        stats->setInfo("trace", QJsonObject{ { "messages", generator.getMessageCount() },
+                                             { "verbosePercent", generator.getVerbosePercent() },
+                                             { "arguments", generator.getArgumentCount() } });
+        stats->startStage();
+        if(!generator.generate(opt.getLogFiles().first()))
+            return -1;
+        stats->endStage("generate", generator.getMessageCount(), generator.getBytes());
+    }
+
+    // Import, all files are written by one importer, so it knows the positions of all messages
+    QVector<qint64> importIndex;
+    bool importIndexValid = false;
     if(!outputfile.fileName().isEmpty())
     {
+        QDltImporter importer(&outputfile);
         // load MF4 files
         QStringList mf4Files = opt.getMf4Files();
         if(mf4Files.size()>0)
@@ -71,7 +166,6 @@ int main(int argc, char *argv[])
         for ( const auto& i : mf4Files )
         {
             qDebug() << "Import MF4 File:" << i << "ms";
-            QDltImporter importer(&outputfile);
             //QTime timeStart = QTime::currentTime();
             importer.dltIpcFromMF4(i);
             //qDebug() << "Duration:" << timeStart.msecsTo(QTime::currentTime());
@@ -83,9 +177,9 @@ int main(int argc, char *argv[])
         for ( const auto& i : pcapFiles )
         {
             qDebug() << "Import PCAP File:" << i;
-            QDltImporter importer(&outputfile);
             importer.dltIpcFromPCAP(i);
         }
+        importIndexValid = importer.getDltIndex(importIndex);
     }
 
     // Export
@@ -94,12 +188,21 @@ int main(int argc, char *argv[])
         // Load dlt files
         qDebug() << "### Load DLT files";
         QStringList logFiles = opt.getLogFiles();
-        for ( const auto& i : logFiles )
+        if(opt.isStream())
         {
-            qDebug() << "Load DLT File:" << i;
-            if(!dltFile.open(i))
-                qDebug() << "ERROR: Failed loading file:" << i;
-            outputfile.setFileName(i);
+            // files are read sequentially by the exporter, no index is created
+            for ( const auto& i : logFiles )
+                qDebug() << "Stream DLT File:" << i;
+        }
+        else
+        {
+            for ( const auto& i : logFiles )
+            {
+                qDebug() << "Load DLT File:" << i;
+                if(!dltFile.open(i,i!=logFiles.first()))
+                    qDebug() << "ERROR: Failed loading file:" << i;
+                outputfile.setFileName(i);
+            }
         }
 
         // Load filter
@@ -115,9 +218,62 @@ int main(int argc, char *argv[])
         }
 
         // Create index
-        qDebug() << "### Create index";
-        dltFile.createIndex();
-        qDebug() << "Number of messages:" << dltFile.size();
+        if(!opt.isStream())
+        {
+            qDebug() << "### Create index";
+            if(stats)
+                stats->startStage();
+            if(importIndexValid)
+            {
+                // the imported file is not scanned again, only messages behind the index are searched
+                dltFile.setDltIndex(importIndex);
+                dltFile.updateIndex();
+            }
+            else
+                dltFile.createIndex();
+            if(stats)
+                stats->endStage("index", dltFile.size(), dltFile.fileSize());
+            qDebug() << "Number of messages:" << dltFile.size();
+        }
+        if(stats)
+        {
+            stats->setInfo("inputFiles", QJsonArray::fromStringList(logFiles));
+            stats->setInfo("filterFiles", QJsonArray::fromStringList(opt.getFilterFiles()));
+            stats->setInfo("cores", QThread::idealThreadCount());
+        }
+
+        // Time range, the first and the last message are found by a binary search in the time index
+        bool timeRange = !opt.getFromTime().isEmpty() || !opt.getToTime().isEmpty();
+        qint64 fromTime = std::numeric_limits<qint64>::min();
+        qint64 toTime = std::numeric_limits<qint64>::max() - 1;
+        if(!opt.getFromTime().isEmpty() && !parseTimeOption(opt.getFromTime(), dltFile, fromTime))
+        {
+            qDebug() << "ERROR: Invalid from time:" << opt.getFromTime();
+            return -1;
+        }
+        if(!opt.getToTime().isEmpty() && !parseTimeOption(opt.getToTime(), dltFile, toTime))
+        {
+            qDebug() << "ERROR: Invalid to time:" << opt.getToTime();
+            return -1;
+        }
+
+        // Merge by time, the exporters read the messages in the order of the merged index
+        QDltExporter::DltExportSelection exportSelection = QDltExporter::SelectionAll;
+        QVector<qint64> mergedIndex;
+        if(opt.isMerge())
+        {
+            qDebug() << "### Merge files by time";
+            if(stats)
+                stats->startStage();
+            mergedIndex = dltFile.createIndexSortedByTime(fromTime, toTime);
+            if(stats)
+                stats->endStage("merge", mergedIndex.size(), 0);
+            qDebug() << "Number of merged messages:" << mergedIndex.size();
+            dltFile.setIndexFilter(mergedIndex);
+            dltFile.enableFilter(true);
+            exportSelection = QDltExporter::SelectionFiltered;
+            timeRange = false; // already applied
+        }
 
         // Create filter index
         //qDebug() << "### Create filter index";
@@ -130,50 +286,116 @@ int main(int argc, char *argv[])
             qDebug() << "### Convert to DLT";
             DltFileExporter exporter(dltFile);
             exporter.setFilterList(opt.getFilterFiles(), opt.isMultifilter());
+            if(opt.isStream())
+                exporter.setStreamInputFiles(logFiles);
+            if(opt.isMerge())
+                exporter.setMessageIndexes(mergedIndex);
+            else if(timeRange)
+            {
+                // each file has its own range, the files can overlap in time
+                const QVector<QPair<int, int>> ranges = dltFile.findMsgRangesByTime(fromTime, toTime);
+                qDebug() << "Time range messages" << ranges;
+                exporter.setMessageRanges(ranges);
+                exporter.setTimeRange(fromTime, toTime);
+            }
 
             if (const auto& split = opt.getSplit(); split)
                 exporter.setMaxOutputSize(split->toBytesCount());
 
             qDebug() << "Commandline DLT convert to " << opt.getConvertDestFile();
+            if(stats)
+                stats->startStage();
             exporter.exportMessages(opt.getConvertDestFile());
+            if(stats)
+            {
+                // the DLT export reads, filters and writes in one pass, so it is one stage
+                stats->setInfo("format", "dlt");
+                stats->endStage("export", exporter.getReadMessages(), exporter.getReadBytes());
+                stats->setInfo("outputMessages", exporter.getWrittenMessages());
+                stats->setInfo("outputBytes", exporter.getWrittenBytes());
+            }
             qDebug() << "DLT export to DLT file format done";
         }
         if(opt.getConvertionMode()==e_ASCI)
         {
             qDebug() << "### Convert to ASCII";
-            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatAscii,QDltExporter::SelectionAll,0,1,0,0,opt.getDelimiter(),opt.getSignature());
+            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatAscii,exportSelection,0,1,0,0,opt.getDelimiter(),opt.getSignature());
             if(opt.isMultifilter())
                 exporter.setMultifilterFilenames(opt.getFilterFiles());
             else
                 exporter.setFilterList(filterList);
+            if(opt.isStream())
+                exporter.setStreamInputFiles(logFiles);
+            if(timeRange)
+                exporter.exportTimeRange(fromTime, toTime);
             qDebug() << "Commandline ASCII convert to " << opt.getConvertDestFile();
-            exporter.exportMessages();
+            if(stats)
+                stats->setInfo("format", "ascii");
+            runExport(exporter, stats.get());
             qDebug() << "DLT export ASCII done";
         }
         if(opt.getConvertionMode()==e_CSV)
         {
             qDebug() << "### Convert to CSV";
-            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatCsv,QDltExporter::SelectionAll,0,1,0,0,opt.getDelimiter(),opt.getSignature());
+            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatCsv,exportSelection,0,1,0,0,opt.getDelimiter(),opt.getSignature());
             if(opt.isMultifilter())
                 exporter.setMultifilterFilenames(opt.getFilterFiles());
             else
                 exporter.setFilterList(filterList);
+            if(opt.isStream())
+                exporter.setStreamInputFiles(logFiles);
+            if(timeRange)
+                exporter.exportTimeRange(fromTime, toTime);
             qDebug() << "Commandline CSV convert to " << opt.getConvertDestFile();
-            exporter.exportMessages();
+            if(stats)
+                stats->setInfo("format", "csv");
+            runExport(exporter, stats.get());
             qDebug() << "DLT export CSV done";
         }
         if(opt.getConvertionMode()==e_UTF8)
         {
             qDebug() << "### Convert to UTF8";
-            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatUTF8,QDltExporter::SelectionAll,0,1,0,0,opt.getDelimiter(),opt.getSignature());
+            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatUTF8,exportSelection,0,1,0,0,opt.getDelimiter(),opt.getSignature());
             if(opt.isMultifilter())
                 exporter.setMultifilterFilenames(opt.getFilterFiles());
             else
                 exporter.setFilterList(filterList);
+            if(opt.isStream())
+                exporter.setStreamInputFiles(logFiles);
+            if(timeRange)
+                exporter.exportTimeRange(fromTime, toTime);
             qDebug() << "Commandline UTF8 convert to " << opt.getConvertDestFile();
-            exporter.exportMessages();
+            if(stats)
+                stats->setInfo("format", "utf8");
+            runExport(exporter, stats.get());
             qDebug() << "DLT export UTF8 done";
         }
+        if(opt.getConvertionMode()==e_PARQUET)
+        {
+            qDebug() << "### Convert to Parquet";
+            QDltExporter exporter(&dltFile,opt.getConvertDestFile(),0,QDltExporter::FormatParquet,exportSelection,0,1,0,0,opt.getDelimiter(),opt.getSignature());
+            if(opt.isMultifilter())
+                exporter.setMultifilterFilenames(opt.getFilterFiles());
+            else
+                exporter.setFilterList(filterList);
+            if(opt.isStream())
+                exporter.setStreamInputFiles(logFiles);
+            if(timeRange)
+                exporter.exportTimeRange(fromTime, toTime);
+            qDebug() << "Commandline Parquet convert to " << opt.getConvertDestFile();
+            if(stats)
+                stats->setInfo("format", "parquet");
+            runExport(exporter, stats.get());
+            qDebug() << "DLT export Parquet done";
+        }
+    }
+
+    // Statistics
+    if(stats)
+    {
+        qDebug() << "### Write statistics";
+        if(!stats->write(opt.getStatsFile().isEmpty() ? QString("-") : opt.getStatsFile()))
+            return -1;
     }
 
     // Terminate
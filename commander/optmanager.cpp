@@ -24,6 +24,7 @@
 #include "optmanager.h"
 #include "../src/version.h"
 #include "qdltexporter.h"
+#include "qdltcompressedfile.h"
 
 #include <QDebug>
 #include <QFileInfo>
@@ -73,6 +74,8 @@ OptManager::OptManager()
     delimiter = QDLT_DEFAULT_EXPORT_DELIMITER;
     signature = QDLT_DEFAULT_EXPORT_SIGNATURE;
     multifilter = false;
+    stream = false;
+    merge = false;
 }
 
 OptManager::OptManager(OptManager const&)
@@ -108,7 +111,7 @@ void OptManager::printUsage()
 #endif
 
     qDebug()<<"\nOptions:\n";
-    qDebug()<<" [logfile]\tLoading one or more logfiles on startup (must end with .dlt)";
+    qDebug()<<" [logfile]\tLoading one or more logfiles on startup (must end with .dlt, .dlt.zst or .dlt.gz)";
     qDebug()<<" [filterfile]\tLoading filterfile on startup (must end with .dlf)";
     qDebug()<<" [pcapfile]\tImporting DLT/IPC from pcap file on startup (must end with .pcap)";
     qDebug()<<" [mf4file]\tImporting DLT/IPC from mf4 file on startup (must end with .mf4)";
@@ -117,24 +120,46 @@ void OptManager::printUsage()
     qDebug()<<" -c textfile\tConvert logfile file to textfile (logfile must end with .dlt)";
     qDebug()<<" -u\tConversion will be done in UTF8 instead of ASCII";
     qDebug()<<" -csv\tConversion will be done in CSV format";
+    qDebug()<<" -parquet\tConversion will be done in Apache Parquet format, one typed column for each header field and the payload";
     qDebug()<<" -d\tConversion will NOT be done, save in dlt file format again instead";
+    qDebug()<<"   \tIf the textfile ends with .dlt.zst, the output is compressed in seekable zstd frames";
     qDebug()<<" -delimiter <character>\tThe used delimiter for CSV export (Default: "+QString(QDLT_DEFAULT_EXPORT_DELIMITER)+").";
     qDebug()<<" -signature <string>\tThe used signature for CSV export, which columns are exported (Default: "+QString(QDLT_DEFAULT_EXPORT_SIGNATURE)+").  I=Index,T=Time,S=Timestamp,O=Count,E=Ecuid,A=Apid,C=Ctid,N=SessionId,Y=Type,U=Subtype,M=Mode,R=#Args,P=Payload";
     qDebug()<<" -split <size>\t Output file size limit given in Kb, Mb or Gb (Default: infinity).";
     qDebug()<<" -multifilter\tMultifilter will generate a separate export file with the name of the filter.";
     qDebug()<<"             \t-c will define the folder name, not the filename.";
+    qDebug()<<" -stream\tRead the logfiles sequentially without creating an index first.";
+    qDebug()<<"        \tMemory usage stays constant, recommended for very large logfiles.";
+    qDebug()<<" -merge\tMerge the messages of all logfiles ordered by storage header time.";
+    qDebug()<<"       \tThe files are sorted in parallel and merged, not supported with -stream.";
+    qDebug()<<" -from <time>\tExport only messages with a storage header time from this time (local time).";
+    qDebug()<<" -to <time>\tExport only messages with a storage header time up to this time (local time).";
+    qDebug()<<"           \tFormat \"yyyy-MM-dd hh:mm:ss[.zzz]\" or \"hh:mm:ss[.zzz]\" on the day of the first message.";
+    qDebug()<<"           \tThe messages are found with a binary search, not supported with -stream.";
+    qDebug()<<" -stats <file>\tWrite the time, messages/s, MB/s and memory usage of each stage as JSON (- for stdout).";
+    qDebug()<<"              \tThe decode, filter and format time is summed over all worker threads.";
+    qDebug()<<" -bench <messages>[:<verbose percent>[:<arguments>]]\tGenerate a synthetic trace into the logfile first,";
+    qDebug()<<"              \tthe same parameters always create the same trace (Default: 80% verbose, up to 4 arguments).";
+    qDebug()<<"              \tThe statistics are written to stdout if -stats is not used.";
     qDebug()<<"\nExamples:\n";
     qDebug().noquote() << executable << "-c .\\trace.txt c:\\trace\\trace.dlt";
     qDebug().noquote() << executable << "-c -u .\\trace.txt c:\\trace\\trace.dlt";
     qDebug().noquote() << executable << "-d -c .\\trace.dlt c:\\trace\\trace.dlt";
     qDebug().noquote() << executable << "-csv -c .\\trace.csv c:\\trace\\trace.dlt";
     qDebug().noquote() << executable << "-csv -delimiter ; -signature TSEACP -c c:\\trace\\trace.csv c:\\trace\\trace.dlt";
+    qDebug().noquote() << executable << "-parquet -c .\\trace.parquet c:\\trace\\trace.dlt";
     qDebug().noquote() << executable << "-d -c .\\filteredtrace.dlt c:\\filter\\filter.dlf c:\\trace\\trace.dlt";
+    qDebug().noquote() << executable << "-d -c .\\trace.dlt.zst c:\\trace\\trace.dlt";
     qDebug().noquote() << executable << "trace_1.dlt trace_2.dlt";
     qDebug().noquote() << executable << "input.pcap output.dlt";
     qDebug().noquote() << executable << "-c output.txt input.pcap";
     qDebug().noquote() << executable << "-c output.txt input1.mf4 input2.mf4";
     qDebug().noquote() << executable << "-d -split 100K c:\\trace\\trace.dlt\n -c output.dlt";
+    qDebug().noquote() << executable << "-stream -csv -c .\\trace.csv c:\\trace\\trace_1.dlt c:\\trace\\trace_2.dlt";
+    qDebug().noquote() << executable << "-merge -d -c .\\merged.dlt c:\\trace\\ecu_1.dlt c:\\trace\\ecu_2.dlt";
+    qDebug().noquote() << executable << "-d -from 14:02:10 -to 14:05:00 -c .\\incident.dlt c:\\trace\\trace.dlt";
+    qDebug().noquote() << executable << "-stats .\\stats.json -csv -c .\\trace.csv c:\\trace\\trace.dlt";
+    qDebug().noquote() << executable << "-bench 10000000:80:4 -csv -c .\\bench.csv .\\bench.dlt";
 }
 
 void OptManager::parse(QStringList *opt)
@@ -191,6 +216,26 @@ void OptManager::parse(QStringList *opt)
 
             qDebug() << "Signature:" << signature;
 
+            i += 1;
+        } else if (str.compare("-from") == 0) {
+            fromTime = opt->value(i + 1);
+            qDebug() << "From time:" << fromTime;
+
+            i += 1;
+        } else if (str.compare("-to") == 0) {
+            toTime = opt->value(i + 1);
+            qDebug() << "To time:" << toTime;
+
+            i += 1;
+        } else if (str.compare("-stats") == 0 || str.compare("--stats") == 0) {
+            statsFile = opt->value(i + 1);
+            qDebug() << "Statistics file:" << statsFile;
+
+            i += 1;
+        } else if (str.compare("-bench") == 0 || str.compare("--bench") == 0) {
+            benchOption = opt->value(i + 1);
+            qDebug() << "Benchmark trace:" << benchOption;
+
             i += 1;
         } else if (str.compare("-split") == 0) {
             const QString c1 = opt->value(i + 1);
@@ -217,15 +262,27 @@ void OptManager::parse(QStringList *opt)
             qDebug() << "Convert to CSV";
 
             convertionmode = e_CSV;
+        } else if (str.compare("-parquet") == 0) {
+            qDebug() << "Convert to Parquet";
+
+            convertionmode = e_PARQUET;
         } else if (str.compare("-multifilter") == 0) {
             qDebug() << "Multifilter export selected.";
 
             multifilter = true;
+        } else if (str.compare("-stream") == 0) {
+            qDebug() << "Stream export selected.";
+
+            stream = true;
+        } else if (str.compare("-merge") == 0) {
+            qDebug() << "Merge by time selected.";
+
+            merge = true;
         } else if (str.compare("-d") == 0) {
             qDebug() << "Convert to DLT";
 
             convertionmode = e_DLT;
-        } else if (opt->at(i).endsWith(".dlt") || opt->at(i).endsWith(".DLT")) {
+        } else if (opt->at(i).endsWith(".dlt") || opt->at(i).endsWith(".DLT") || QDltCompressedFile::isCompressedFileName(opt->at(i))) {
             const QString logFile = QString("%1").arg(opt->at(i));
             logFiles += logFile;
             qDebug()<< "DLT filename:" << logFile;
@@ -249,6 +306,9 @@ bool OptManager::isLogFile() const {return log;}
 bool OptManager::isFilterFile() const {return filter;}
 bool OptManager::isConvert()const {return convert;}
 bool OptManager::isMultifilter() const {return multifilter;}
+bool OptManager::isStream() const {return stream;}
+bool OptManager::isMerge() const {return merge;}
+bool OptManager::isBench() const {return !benchOption.isEmpty();}
 e_convertionmode OptManager::getConvertionMode() const {return convertionmode;}
 QStringList OptManager::getLogFiles()const {return logFiles;}
 QStringList OptManager::getFilterFiles() const {return filterFiles;}
@@ -256,6 +316,10 @@ QString OptManager::getConvertSourceFile() const {return convertSourceFile;}
 QString OptManager::getConvertDestFile()const {return convertDestFile;}
 char OptManager::getDelimiter() const {return delimiter;}
 QString OptManager::getSignature() const {return signature;}
+QString OptManager::getFromTime() const {return fromTime;}
+QString OptManager::getToTime() const {return toTime;}
+QString OptManager::getStatsFile() const {return statsFile;}
+QString OptManager::getBenchOption() const {return benchOption;}
 
 const std::optional<Split> &OptManager::getSplit() const
 {
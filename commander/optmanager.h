@@ -30,6 +30,7 @@ enum e_convertionmode
     e_UTF8 = 1,
     e_DLT  = 2,
     e_CSV  = 3,
+    e_PARQUET = 4,
 };
 
 enum class Units {
@@ -61,6 +62,9 @@ public:
     bool isConvert() const;
     bool isConvertUTF8() const;
     bool isMultifilter() const;
+    bool isStream() const;
+    bool isMerge() const;
+    bool isBench() const;
 
     e_convertionmode getConvertionMode() const;
     QStringList getLogFiles()const ;
@@ -70,6 +74,10 @@ public:
     char getDelimiter() const;
     const std::optional<Split>& getSplit() const;
     QString getSignature() const;
+    QString getFromTime() const;
+    QString getToTime() const;
+    QString getStatsFile() const;
+    QString getBenchOption() const;
 
     const QStringList &getPcapFiles() const;
     const QStringList &getMf4Files() const;
@@ -80,6 +88,8 @@ private:
     bool filter;
     bool convert;
     bool multifilter;
+    bool stream;
+    bool merge;
     //split size
     std::optional<Split> split;
 
@@ -93,6 +103,10 @@ private:
     QString convertDestFile;
     char delimiter;
     QString signature;
+    QString fromTime;
+    QString toTime;
+    QString statsFile;
+    QString benchOption;
 };
 
 #endif // OPTMANAGER_H
@@ -0,0 +1,185 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file tracegenerator.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include "tracegenerator.h"
+
+#include <dlt_protocol.h>
+#include <qdltcompressedwriter.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QStringList>
+
+#include <memory>
+
+namespace {
+
+// generated data is written in large chunks
+constexpr int kWriteBufferSize = 1024 * 1024;
+// storage header time of the first message, 1000 messages per second
+constexpr quint32 kStartTime = 1700000000;
+
+const char* const kApplications[] = { "APP1", "APP2", "NAV", "SYS" };
+const char* const kContexts[] = { "MAIN", "CTX1", "CTX2", "NET" };
+
+// xorshift, independent of the random generator of the platform
+quint32 nextRandom(quint32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void appendUInt16BE(QByteArray& data, quint16 value) {
+    data.append(char(value >> 8));
+    data.append(char(value & 0xff));
+}
+
+void appendUInt32BE(QByteArray& data, quint32 value) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+        data.append(char((value >> shift) & 0xff));
+}
+
+void appendUInt16LE(QByteArray& data, quint16 value) {
+    data.append(char(value & 0xff));
+    data.append(char(value >> 8));
+}
+
+void appendUInt32LE(QByteArray& data, quint32 value) {
+    for (int shift = 0; shift < 32; shift += 8)
+        data.append(char((value >> shift) & 0xff));
+}
+
+void appendId(QByteArray& data, const char* id) {
+    const int length = qstrlen(id);
+    data.append(id, length);
+    data.append(4 - length, '\0');
+}
+
+}
+
+bool TraceGenerator::parse(const QString& option)
+{
+    const QStringList values = option.split(':');
+    bool ok = values.size() <= 3;
+    if (ok)
+        m_messageCount = values[0].toLongLong(&ok);
+    if (ok && values.size() > 1)
+        m_verbosePercent = values[1].toInt(&ok);
+    if (ok && values.size() > 2)
+        m_argumentCount = values[2].toInt(&ok);
+    return ok && m_messageCount > 0 && m_verbosePercent >= 0 && m_verbosePercent <= 100 &&
+           m_argumentCount >= 1 && m_argumentCount <= 255;
+}
+
+void TraceGenerator::appendMessage(QByteArray& data, qint64 num, quint32& random)
+{
+    const bool verbose = int(nextRandom(random) % 100) < m_verbosePercent;
+    const int arguments = verbose ? 1 + int(nextRandom(random) % m_argumentCount) : 0;
+    const int application = nextRandom(random) % 4;
+    const int level = 1 + nextRandom(random) % 6; // fatal up to verbose
+
+    QByteArray payload;
+    if (verbose) {
+        for (int argument = 0; argument < arguments; argument++) {
+            switch ((num + argument) % 4) {
+            case 0:
+                appendUInt32LE(payload, DLT_TYPE_INFO_UINT | DLT_TYLE_32BIT);
+                appendUInt32LE(payload, nextRandom(random));
+                break;
+            case 1:
+                appendUInt32LE(payload, DLT_TYPE_INFO_SINT | DLT_TYLE_32BIT);
+                appendUInt32LE(payload, nextRandom(random));
+                break;
+            case 2: {
+                const QByteArray text = "value " + QByteArray::number(nextRandom(random) % 100000);
+                appendUInt32LE(payload, DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII);
+                appendUInt16LE(payload, text.size() + 1);
+                payload.append(text);
+                payload.append('\0');
+                break;
+            }
+            default:
+                appendUInt32LE(payload, DLT_TYPE_INFO_BOOL | DLT_TYLE_8BIT);
+                payload.append(char(nextRandom(random) & 1));
+                break;
+            }
+        }
+    } else {
+        // message id and raw data, decoded with a FIBEX file in real traces
+        appendUInt32LE(payload, 1000 + nextRandom(random) % 64);
+        const int size = 4 + nextRandom(random) % 29;
+        for (int byte = 0; byte < size; byte++)
+            payload.append(char(nextRandom(random) & 0xff));
+    }
+
+    // storage header
+    data.append("DLT\x01", 4);
+    appendUInt32LE(data, kStartTime + quint32(num / 1000));
+    appendUInt32LE(data, quint32(num % 1000) * 1000);
+    appendId(data, "ECU1");
+
+    // standard header with ECU id, session id and timestamp, extended header
+    const quint16 length = 4 + 4 + 4 + 4 + 10 + payload.size();
+    data.append(char(DLT_HTYP_UEH | DLT_HTYP_WEID | DLT_HTYP_WSID | DLT_HTYP_WTMS | DLT_HTYP_PROTOCOL_VERSION1));
+    data.append(char(num & 0xff));
+    appendUInt16BE(data, length);
+    appendId(data, "ECU1");
+    appendUInt32BE(data, 100 + application);
+    appendUInt32BE(data, quint32(num * 10)); // 0.1 ms units
+    data.append(char((verbose ? DLT_MSIN_VERB : 0) | (level << DLT_MSIN_MTIN_SHIFT)));
+    data.append(char(arguments));
+    appendId(data, kApplications[application]);
+    appendId(data, kContexts[nextRandom(random) % 4]);
+    data.append(payload);
+}
+
+bool TraceGenerator::generate(const QString& filename)
+{
+    std::unique_ptr<QIODevice> output;
+    if (QDltCompressedWriter::isCompressedFileName(filename)) {
+        auto writer = std::make_unique<QDltCompressedWriter>();
+        writer->setFileName(filename);
+        output = std::move(writer);
+    } else {
+        output = std::make_unique<QFile>(filename);
+    }
+    if (!output->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "ERROR: Couldn't open trace file for writing:" << filename;
+        return false;
+    }
+
+    quint32 random = m_seed ? m_seed : 1;
+    QByteArray data;
+    data.reserve(kWriteBufferSize + 64 * 1024);
+    m_bytes = 0;
+    for (qint64 num = 0; num < m_messageCount; num++) {
+        appendMessage(data, num, random);
+        if (data.size() >= kWriteBufferSize || num + 1 == m_messageCount) {
+            if (output->write(data) != data.size()) {
+                qDebug() << "ERROR: Couldn't write trace file:" << filename;
+                return false;
+            }
+            m_bytes += data.size();
+            data.truncate(0); // keeps the reserved buffer
+        }
+    }
+    output->close();
+    return true;
+}
@@ -0,0 +1,61 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file tracegenerator.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef TRACEGENERATOR_H
+#define TRACEGENERATOR_H
+
+#include <QByteArray>
+#include <QString>
+
+// Writes a synthetic DLT trace for benchmarks. The same settings always create the same file,
+// so runs on different machines and releases can be compared.
+class TraceGenerator
+{
+public:
+    // parse the option "<messages>[:<verbose percent>[:<arguments>]]", returns false if invalid
+    bool parse(const QString& option);
+
+    void setMessageCount(qint64 count) { m_messageCount = count; }
+    // share of verbose messages, the other messages are non verbose with a message id
+    void setVerbosePercent(int percent) { m_verbosePercent = percent; }
+    // maximum number of arguments of a verbose message, each message has 1 up to this number
+    void setArgumentCount(int count) { m_argumentCount = count; }
+    void setSeed(quint32 seed) { m_seed = seed; }
+
+    qint64 getMessageCount() const { return m_messageCount; }
+    int getVerbosePercent() const { return m_verbosePercent; }
+    int getArgumentCount() const { return m_argumentCount; }
+
+    // write the trace, a file ending with .dlt.zst is compressed
+    bool generate(const QString& filename);
+
+    // size of the generated trace in bytes, before compression
+    qint64 getBytes() const { return m_bytes; }
+
+private:
+    void appendMessage(QByteArray& data, qint64 num, quint32& random);
+
+    qint64 m_messageCount{1000000};
+    int m_verbosePercent{80};
+    int m_argumentCount{4};
+    quint32 m_seed{1};
+    qint64 m_bytes{0};
+};
+
+#endif // TRACEGENERATOR_H
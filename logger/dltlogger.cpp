@@ -0,0 +1,160 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file dltlogger.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QDebug>
+
+#include "dltlogger.h"
+
+DltLogger::DltLogger(const QVector<LoggerEcu> &ecus, LogWriter *writer, QDltFilterList *filter)
+    : ecus(ecus), connections(ecus.size()), writer(writer), filter(filter), messagesFiltered(0), statisticsInterval(0)
+{
+    connect(&sink, &QDltLiveSink::messagesAvailable, this, &DltLogger::writeMessages, Qt::QueuedConnection);
+    connect(&timer, &QTimer::timeout, this, &DltLogger::timeout);
+}
+
+DltLogger::~DltLogger()
+{
+    stop();
+}
+
+void DltLogger::setMaxQueueSize(qint64 size)
+{
+    QDltLiveSink::Overload overload;
+    overload.policy = QDltLiveSink::OverloadBlock;
+    overload.highWatermark = size;
+    sink.setOverload(overload);
+}
+
+void DltLogger::start()
+{
+    for(int num = 0; num < ecus.size(); num++)
+    {
+        // the index of the ECU is the id of its messages
+        Connection &connection = connections[num];
+        connection.reader = new QDltLiveReader(num, ecus[num].settings, &sink);
+        connect(connection.reader, &QDltLiveReader::stateChanged, this, &DltLogger::stateChanged);
+        qDebug() << "Connect to ECU" << ecus[num].id;
+        connection.reader->start();
+    }
+    statisticsTimer.start();
+    timer.start(1000);
+}
+
+void DltLogger::stop()
+{
+    timer.stop();
+    for(Connection &connection : connections)
+    {
+        delete connection.reader;
+        connection.reader = nullptr;
+    }
+    writeMessages();
+    writer->close();
+}
+
+void DltLogger::writeMessages()
+{
+    sink.take(messages);
+    for(const QDltLiveMessage &message : std::as_const(messages))
+    {
+        const LoggerEcu &ecu = ecus[message.ecu];
+        if(filter)
+        {
+            // only the headers and the verbose payload are decoded, no plugins are used
+            if(!msg.setMsg(message.data, false, ecu.settings.supportDLTv2) || !filter->checkFilter(msg))
+            {
+                messagesFiltered++;
+                continue;
+            }
+        }
+        writer->write(message.data, ecu.id, message.sec, message.usec, ecu.writeDLTv2StorageHeader);
+    }
+
+    // the messages of all connections are flushed at once
+    if(!messages.isEmpty())
+        writer->flush();
+}
+
+void DltLogger::stateChanged(int ecu, int state, const QString &error)
+{
+    Connection &connection = connections[ecu];
+    switch(state)
+    {
+    case QDltConnection::QDltConnectionOnline:
+        qDebug() << "ECU" << ecus[ecu].id << "connected";
+        connection.offline.invalidate();
+        break;
+    case QDltConnection::QDltConnectionOffline:
+    case QDltConnection::QDltConnectionError:
+        qDebug() << "ECU" << ecus[ecu].id << "disconnected" << error;
+        connection.offline.start();
+        break;
+    default:
+        break;
+    }
+}
+
+void DltLogger::timeout()
+{
+    // open lost connections again
+    for(int num = 0; num < connections.size(); num++)
+    {
+        Connection &connection = connections[num];
+        const LoggerEcu &ecu = ecus[num];
+        if(connection.reader && ecu.autoReconnect && connection.offline.isValid() &&
+           connection.offline.elapsed() >= qint64(ecu.autoReconnectTimeout) * 1000)
+        {
+            qDebug() << "Reconnect to ECU" << ecu.id;
+            connection.offline.invalidate();
+            connection.reader->stop();
+            connection.reader->start();
+        }
+    }
+
+    if(statisticsInterval > 0 && statisticsTimer.elapsed() >= qint64(statisticsInterval) * 1000)
+    {
+        statisticsTimer.restart();
+        printStatistics();
+    }
+}
+
+void DltLogger::printStatistics()
+{
+    for(int num = 0; num < connections.size(); num++)
+    {
+        Connection &connection = connections[num];
+        if(!connection.reader)
+            continue;
+        const QDltLiveReader::Statistics statistics = connection.reader->takeStatistics();
+        connection.statistics.bytesReceived += statistics.bytesReceived;
+        connection.statistics.bytesError += statistics.bytesError;
+        connection.statistics.syncFound += statistics.syncFound;
+        connection.statistics.datagramsDropped += statistics.datagramsDropped;
+        qDebug().noquote() << QString("ECU %1: received %2 bytes, errors %3 bytes, dropped %4 datagrams")
+                              .arg(ecus[num].id)
+                              .arg(connection.statistics.bytesReceived)
+                              .arg(connection.statistics.bytesError)
+                              .arg(connection.statistics.datagramsDropped);
+    }
+    qDebug().noquote() << QString("Written %1 messages in %2 files, filtered %3 messages, pending %4 messages")
+                          .arg(writer->getMessagesWritten())
+                          .arg(writer->getFilesWritten())
+                          .arg(messagesFiltered)
+                          .arg(sink.size());
+}
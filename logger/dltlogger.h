@@ -0,0 +1,102 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file dltlogger.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef DLTLOGGER_H
+#define DLTLOGGER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <qdltfilterlist.h>
+#include <qdltlivereader.h>
+#include <qdltlivesink.h>
+#include <qdltmsg.h>
+
+#include "loggerproject.h"
+#include "logwriter.h"
+
+//! Receive the ECU connections of a project and write the messages to files.
+/*!
+  Each connection is read by its own QDltLiveReader thread. The main thread only
+  filters the messages and writes them, nothing is decoded or kept in memory.
+  Lost connections are opened again after the reconnect timeout of the ECU.
+*/
+class DltLogger : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! The constructor.
+    /*!
+      \param ecus The ECU connections.
+      \param writer Writes the messages to files.
+      \param filter Only matching messages are written, nullptr to write all messages.
+    */
+    DltLogger(const QVector<LoggerEcu> &ecus, LogWriter *writer, QDltFilterList *filter);
+    ~DltLogger();
+
+    //! Limit the memory used for received messages waiting to be written.
+    /*!
+      The readers stop reading while the limit is reached.
+      \param size Maximum size of the pending messages in bytes.
+    */
+    void setMaxQueueSize(qint64 size);
+
+    //! Print the statistics in this interval, 0 to disable.
+    void setStatisticsInterval(int secs) { statisticsInterval = secs; }
+
+    //! Open all connections.
+    void start();
+
+    //! Close all connections and write the remaining messages.
+    void stop();
+
+private slots:
+    void writeMessages();
+    void stateChanged(int ecu, int state, const QString &error);
+    void timeout();
+
+private:
+    void printStatistics();
+
+    struct Connection
+    {
+        QDltLiveReader *reader = nullptr;
+        QElapsedTimer offline;
+        QDltLiveReader::Statistics statistics;
+    };
+
+    QVector<LoggerEcu> ecus;
+    QVector<Connection> connections;
+    LogWriter *writer;
+    QDltFilterList *filter;
+
+    QDltLiveSink sink;
+    QVector<QDltLiveMessage> messages;
+    QDltMsg msg;
+    quint64 messagesFiltered;
+
+    QTimer timer;
+    int statisticsInterval;
+    QElapsedTimer statisticsTimer;
+};
+
+#endif // DLTLOGGER_H
@@ -0,0 +1,36 @@
+QT = core network serialport
+
+CONFIG += c++17 cmdline
+
+# Executable name
+TARGET = dlt-logger
+
+# Local includes
+INCLUDEPATH = . ../qdlt
+
+# Unix executable install path
+target.path = $$PREFIX/usr/bin
+INSTALLS += target
+
+# Library definitions for debug and release builds
+CONFIG(debug, debug|release) {
+    DESTDIR = ../debug
+    QMAKE_LIBDIR += ../debug
+    LIBS += -lqdltd
+} else {
+    DESTDIR = ../release
+    QMAKE_LIBDIR += ../release
+    QMAKE_RPATHDIR += ../build/release
+    LIBS += -lqdlt
+}
+
+SOURCES += \
+        main.cpp \
+        loggerproject.cpp \
+        logwriter.cpp \
+        dltlogger.cpp
+
+HEADERS += \
+    loggerproject.h \
+    logwriter.h \
+    dltlogger.h
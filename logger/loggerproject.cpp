@@ -0,0 +1,199 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file loggerproject.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QXmlStreamReader>
+
+#include "loggerproject.h"
+
+namespace {
+
+// interface types of the ECU items of the viewer
+enum { INTERFACETYPE_TCP, INTERFACETYPE_UDP, INTERFACETYPE_SERIAL_DLT, INTERFACETYPE_SERIAL_ASCII };
+
+// the connection settings of an ECU as stored in the project
+struct ProjectEcu
+{
+    QString id;
+    int interfacetype = INTERFACETYPE_TCP;
+    QString hostname = "localhost";
+    int ipport = 3490;
+    int udpport = 3490;
+    QString ethIF;
+    QString mcastIP;
+    bool multicast = false;
+    QString port;
+    int baudrate = 115200;
+    bool syncSerialHeaderIp = false;
+    bool syncSerialHeaderSerial = true;
+    bool writeDLTv2StorageHeader = false;
+    bool autoReconnect = true;
+    int autoReconnectTimeout = 3;
+};
+
+// same conversion as MainWindow::connectECU()
+LoggerEcu toLoggerEcu(const ProjectEcu &item)
+{
+    LoggerEcu ecu;
+    ecu.id = item.id;
+    ecu.writeDLTv2StorageHeader = item.writeDLTv2StorageHeader;
+    ecu.autoReconnect = item.autoReconnect;
+    ecu.autoReconnectTimeout = item.autoReconnectTimeout;
+
+    QDltLiveReader::Settings &settings = ecu.settings;
+    switch(item.interfacetype)
+    {
+    case INTERFACETYPE_TCP:
+        settings.type = QDltLiveReader::TypeTcp;
+        settings.hostname = item.hostname;
+        settings.port = item.ipport;
+        settings.syncSerialHeader = item.syncSerialHeaderIp;
+        break;
+    case INTERFACETYPE_UDP:
+        settings.type = QDltLiveReader::TypeUdp;
+        settings.bindAddress = item.ethIF == "AnyIP" ? QString("0.0.0.0") : item.ethIF;
+        settings.port = item.udpport;
+        if(item.multicast)
+        {
+            settings.multicastGroups = item.mcastIP.split(QRegularExpression("\\s+"));
+            settings.multicastGroups.removeAll(QString());
+            settings.multicastGroups.removeAll(QString("<none>"));
+            settings.multicastInterface = item.ethIF;
+        }
+        break;
+    default:
+        settings.type = item.interfacetype == INTERFACETYPE_SERIAL_ASCII ? QDltLiveReader::TypeSerialAscii : QDltLiveReader::TypeSerialDlt;
+        settings.serialPort = item.port;
+        settings.baudrate = item.baudrate;
+        settings.syncSerialHeader = item.syncSerialHeaderSerial;
+        break;
+    }
+    return ecu;
+}
+
+}
+
+LoggerProject::LoggerProject()
+    : supportDLTv2(false), splitLogFile(false), maxFileSizeMB(100)
+{
+}
+
+bool LoggerProject::load(const QString &filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        error = QString("Cannot open project %1: %2").arg(filename, file.errorString());
+        return false;
+    }
+
+    ecus.clear();
+
+    QXmlStreamReader xml(&file);
+    ProjectEcu item;
+    bool inEcu = false;
+    // applications and contexts of an ECU have elements with the same names
+    int nested = 0;
+
+    while(!xml.atEnd())
+    {
+        xml.readNext();
+
+        if(xml.isStartElement())
+        {
+            const QString name = xml.name().toString();
+            if(name == "ecu")
+            {
+                item = ProjectEcu();
+                inEcu = true;
+                nested = 0;
+            }
+            else if(name == "application" || name == "context")
+            {
+                nested++;
+            }
+            else if(!inEcu)
+            {
+                if(name == "supportDLTv2Decoding")
+                    supportDLTv2 = xml.readElementText().toInt();
+                else if(name == "splitlogfile")
+                    splitLogFile = xml.readElementText().toInt();
+                else if(name == "fmaxFileSizeMB")
+                    maxFileSizeMB = xml.readElementText().toFloat();
+            }
+            else if(nested == 0)
+            {
+                if(name == "id")
+                    item.id = xml.readElementText();
+                else if(name == "interface")
+                    item.interfacetype = xml.readElementText().toInt();
+                else if(name == "hostname")
+                    item.hostname = xml.readElementText();
+                else if(name == "ipport")
+                    item.ipport = xml.readElementText().toInt();
+                else if(name == "udpport")
+                    item.udpport = xml.readElementText().toInt();
+                else if(name == "mcinterface")
+                    item.ethIF = xml.readElementText();
+                else if(name == "mcIP")
+                    item.mcastIP = xml.readElementText();
+                else if(name == "multicast")
+                    item.multicast = xml.readElementText().toInt();
+                else if(name == "port")
+                    item.port = xml.readElementText();
+                else if(name == "baudrate")
+                    item.baudrate = xml.readElementText().toInt();
+                else if(name == "synctoserialheadertcp")
+                    item.syncSerialHeaderIp = xml.readElementText().toInt();
+                else if(name == "synctoserialheaderserial")
+                    item.syncSerialHeaderSerial = xml.readElementText().toInt();
+                else if(name == "writeDLTv2StorageHeader")
+                    item.writeDLTv2StorageHeader = xml.readElementText().toInt();
+                else if(name == "autoReconnect")
+                    item.autoReconnect = xml.readElementText().toInt();
+                else if(name == "autoReconnectTimeout")
+                    item.autoReconnectTimeout = xml.readElementText().toInt();
+            }
+        }
+        else if(xml.isEndElement())
+        {
+            const QString name = xml.name().toString();
+            if(name == "ecu" && inEcu)
+            {
+                ecus.append(toLoggerEcu(item));
+                inEcu = false;
+            }
+            else if(name == "application" || name == "context")
+            {
+                nested--;
+            }
+        }
+    }
+
+    if(xml.hasError())
+    {
+        error = QString("Cannot read project %1: %2").arg(filename, xml.errorString());
+        return false;
+    }
+
+    for(LoggerEcu &ecu : ecus)
+        ecu.settings.supportDLTv2 = supportDLTv2;
+    return true;
+}
@@ -0,0 +1,69 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file loggerproject.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef LOGGERPROJECT_H
+#define LOGGERPROJECT_H
+
+#include <QString>
+#include <QVector>
+
+#include <qdltlivereader.h>
+
+//! An ECU connection of the project.
+struct LoggerEcu
+{
+    QString id;
+    QDltLiveReader::Settings settings;
+    bool writeDLTv2StorageHeader = false;
+    bool autoReconnect = true;
+    int autoReconnectTimeout = 3;   // seconds
+};
+
+//! Read the ECU connections and logging settings of a DLT Viewer project file (.dlp).
+/*!
+  Only the parts needed for logging are read, applications, contexts, filters and
+  plugins of the project are ignored.
+*/
+class LoggerProject
+{
+public:
+    LoggerProject();
+
+    //! Load the project file.
+    /*!
+      \param filename The project file.
+      \return false if the file cannot be read, see getError().
+    */
+    bool load(const QString &filename);
+
+    const QVector<LoggerEcu> &getEcus() const { return ecus; }
+    bool getSupportDLTv2() const { return supportDLTv2; }
+    bool getSplitLogFile() const { return splitLogFile; }
+    float getMaxFileSizeMB() const { return maxFileSizeMB; }
+    QString getError() const { return error; }
+
+private:
+    QVector<LoggerEcu> ecus;
+    bool supportDLTv2;
+    bool splitLogFile;
+    float maxFileSizeMB;
+    QString error;
+};
+
+#endif // LOGGERPROJECT_H
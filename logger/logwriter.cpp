@@ -0,0 +1,159 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file logwriter.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QDateTime>
+#include <QDebug>
+
+#include <qdltimporter.h>
+
+#include "logwriter.h"
+
+extern "C"
+{
+#include "dlt_common.h"
+}
+
+LogWriter::LogWriter()
+    : prefix("dlt-logger"), maxFileSize(0), maxFileAge(0), maxFiles(0), compressed(false),
+      device(nullptr), size(0), messagesWritten(0), filesWritten(0)
+{
+}
+
+LogWriter::~LogWriter()
+{
+    close();
+}
+
+QString LogWriter::fileName() const
+{
+    return compressed ? compressedFile.fileName() : file.fileName();
+}
+
+bool LogWriter::open()
+{
+    close();
+
+    // the names sort by creation time, a name is never reused
+    const QString base = prefix + "_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+    const QString extension = compressed ? ".dlt.zst" : ".dlt";
+    QString name = directory.filePath(base + extension);
+    for(int num = 1; QFile::exists(name); num++)
+        name = directory.filePath(QString("%1_%2%3").arg(base).arg(num).arg(extension));
+
+    if(compressed)
+    {
+        compressedFile.setFileName(name);
+        // the file can be read while it is written
+        compressedFile.setMaxFrameDelay(1000);
+        if(!compressedFile.open(QIODevice::WriteOnly))
+        {
+            qDebug() << "ERROR: Cannot create compressed file" << name;
+            return false;
+        }
+        device = &compressedFile;
+    }
+    else
+    {
+        file.setFileName(name);
+        if(!file.open(QIODevice::WriteOnly))
+        {
+            qDebug() << "ERROR: Cannot create file" << name << file.errorString();
+            return false;
+        }
+        device = &file;
+    }
+
+    qDebug() << "Logging to" << name;
+    size = 0;
+    age.start();
+    filesWritten++;
+    removeOldFiles();
+    return true;
+}
+
+void LogWriter::close()
+{
+    if(!device)
+        return;
+    device->close();
+    device = nullptr;
+}
+
+void LogWriter::flush()
+{
+    if(device == &file)
+        file.flush();
+}
+
+bool LogWriter::write(const QByteArray &data, const QString &ecuId, quint32 sec, quint32 usec, bool v2)
+{
+    // storage header
+    header.clear();
+    if(!v2)
+    {
+        DltStorageHeader str = QDltImporter::makeDltStorageHeader(QDltImporter::DltStorageHeaderTimestamp{sec, usec});
+        dlt_set_id(str.ecu, ecuId.toLatin1());
+        header.append((const char*)&str, sizeof(DltStorageHeader));
+    }
+    else
+    {
+        // same layout as written by the viewer
+        const QByteArray id = ecuId.toLatin1();
+        header.append("DLT", 3);
+        header.append(char(2));
+        const quint32 nanoseconds = usec * 1000ul;
+        header.append((const char*)&nanoseconds, 4);
+        const quint64 seconds = sec;
+        header.append((const char*)&seconds, 5);
+        header.append(char(id.size()));
+        header.append(id);
+    }
+
+    const qint64 length = header.size() + data.size();
+    if(device && ((maxFileSize > 0 && size > 0 && size + length > maxFileSize) ||
+                  (maxFileAge > 0 && age.elapsed() >= qint64(maxFileAge) * 1000)))
+    {
+        close();
+    }
+    if(!device && !open())
+        return false;
+
+    if(device->write(header) != header.size() || device->write(data) != data.size())
+    {
+        qDebug() << "ERROR: Cannot write to" << fileName();
+        return false;
+    }
+    size += length;
+    messagesWritten++;
+    return true;
+}
+
+void LogWriter::removeOldFiles()
+{
+    if(maxFiles <= 0)
+        return;
+
+    const QStringList files = directory.entryList(QStringList() << prefix + "_*.dlt" << prefix + "_*.dlt.zst",
+                                                  QDir::Files, QDir::Name);
+    for(int num = 0; num < files.size() - maxFiles; num++)
+    {
+        qDebug() << "Remove old file" << files[num];
+        directory.remove(files[num]);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file logwriter.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <QByteArray>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+#include <qdltcompressedwriter.h>
+
+//! Write received DLT messages with storage header into rotated files.
+/*!
+  The files are named <prefix>_<date>_<time>.dlt, or .dlt.zst when compressed,
+  and are created in the output directory. A new file is started when the current
+  file reaches the maximum size or age. Only the newest files are kept when the
+  number of files is limited.
+*/
+class LogWriter
+{
+public:
+    LogWriter();
+    ~LogWriter();
+
+    void setDirectory(const QString &path) { directory.setPath(path); }
+    void setPrefix(const QString &name) { prefix = name; }
+    //! Maximum uncompressed size of a file in bytes, 0 for unlimited.
+    void setMaxFileSize(qint64 size) { maxFileSize = size; }
+    //! Maximum time in seconds a file is written, 0 for unlimited.
+    void setMaxFileAge(int secs) { maxFileAge = secs; }
+    //! Maximum number of files kept, the oldest files are removed, 0 for unlimited.
+    void setMaxFiles(int count) { maxFiles = count; }
+    void setCompressed(bool compressed) { this->compressed = compressed; }
+
+    //! Write a message, a new file is started when needed.
+    /*!
+      \param data DLT message without storage header.
+      \param ecuId ECU id of the storage header.
+      \param sec Receive time.
+      \param usec Receive time.
+      \param v2 Write a version 2 storage header.
+      \return false if the file cannot be written.
+    */
+    bool write(const QByteArray &data, const QString &ecuId, quint32 sec, quint32 usec, bool v2);
+
+    //! Write the buffered data to the file.
+    void flush();
+
+    //! Close the current file, the next write() starts a new one.
+    void close();
+
+    QString fileName() const;
+    quint64 getMessagesWritten() const { return messagesWritten; }
+    quint64 getFilesWritten() const { return filesWritten; }
+
+private:
+    bool open();
+    void removeOldFiles();
+
+    QDir directory;
+    QString prefix;
+    qint64 maxFileSize;
+    int maxFileAge;
+    int maxFiles;
+    bool compressed;
+
+    QFile file;
+    QDltCompressedWriter compressedFile;
+    QIODevice *device;
+    qint64 size;
+    QElapsedTimer age;
+    QByteArray header;
+
+    quint64 messagesWritten;
+    quint64 filesWritten;
+};
+
+#endif // LOGWRITER_H
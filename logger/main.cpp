@@ -0,0 +1,158 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file main.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QTimer>
+
+#include <qdltcompressedwriter.h>
+#include <qdltfilterlist.h>
+
+#include "dltlogger.h"
+#include "loggerproject.h"
+#include "logwriter.h"
+
+#include <atomic>
+#include <csignal>
+#include <memory>
+
+/*
+ * Examples:
+ *
+ * project.dlp
+ * -o /data/logs -s 500 -k 100 -z project.dlp
+ * -o /data/logs -t 60 -f errors.dlf -e ECU1 -e ECU2 project.dlp
+ *
+ */
+
+static std::atomic<bool> terminateRequested(false);
+
+static void requestTerminate(int)
+{
+    terminateRequested = true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("dlt-logger");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Receive the ECU connections of a DLT Viewer project without GUI and write them to rotated DLT files.");
+    parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+    parser.addHelpOption();
+    parser.addPositionalArgument("project", "The project file (.dlp) with the ECU connections.");
+    const QCommandLineOption outputOption(QStringList() << "o" << "output", "Directory of the log files.", "directory", ".");
+    const QCommandLineOption prefixOption(QStringList() << "p" << "prefix", "Prefix of the log file names.", "name", "dlt-logger");
+    const QCommandLineOption sizeOption(QStringList() << "s" << "split-size", "Start a new file at this size, default is the maximum file size of the project if splitting is enabled there.", "MB");
+    const QCommandLineOption timeOption(QStringList() << "t" << "split-time", "Start a new file after this time.", "minutes", "0");
+    const QCommandLineOption keepOption(QStringList() << "k" << "keep", "Keep only the newest files.", "count", "0");
+    const QCommandLineOption compressOption(QStringList() << "z" << "compress", "Write compressed .dlt.zst files.");
+    const QCommandLineOption filterOption(QStringList() << "f" << "filter", "Write only messages matching the filters.", "file.dlf");
+    const QCommandLineOption ecuOption(QStringList() << "e" << "ecu", "Connect only this ECU of the project, can be used several times.", "id");
+    const QCommandLineOption queueOption("max-queue", "Memory for received messages waiting to be written, reading is paused when it is used.", "MB", "64");
+    const QCommandLineOption statsOption("stats", "Print statistics in this interval, 0 to disable.", "seconds", "60");
+    parser.addOptions({outputOption, prefixOption, sizeOption, timeOption, keepOption, compressOption,
+                       filterOption, ecuOption, queueOption, statsOption});
+    parser.process(a);
+
+    if(parser.positionalArguments().size() != 1)
+    {
+        qDebug() << "ERROR: One project file must be provided.";
+        parser.showHelp(-1);
+    }
+
+    // Load the ECU connections
+    LoggerProject project;
+    if(!project.load(parser.positionalArguments().first()))
+    {
+        qDebug() << "ERROR:" << project.getError();
+        return -1;
+    }
+    QVector<LoggerEcu> ecus;
+    const QStringList ecuIds = parser.values(ecuOption);
+    for(const LoggerEcu &ecu : project.getEcus())
+    {
+        if(ecuIds.isEmpty() || ecuIds.contains(ecu.id))
+            ecus.append(ecu);
+    }
+    if(ecus.isEmpty())
+    {
+        qDebug() << "ERROR: No ECU to connect in project" << parser.positionalArguments().first();
+        return -1;
+    }
+
+    // Load filters
+    std::unique_ptr<QDltFilterList> filterList;
+    if(parser.isSet(filterOption))
+    {
+        filterList = std::make_unique<QDltFilterList>();
+        if(!filterList->LoadFilter(parser.value(filterOption), true))
+        {
+            qDebug() << "ERROR: Cannot load filter" << parser.value(filterOption);
+            return -1;
+        }
+    }
+
+    // Output files
+    if(parser.isSet(compressOption) && !QDltCompressedWriter::isSupported())
+    {
+        qDebug() << "ERROR: Compressed files are not supported, qdlt was built without zstd.";
+        return -1;
+    }
+    if(!QDir().mkpath(parser.value(outputOption)))
+    {
+        qDebug() << "ERROR: Cannot create directory" << parser.value(outputOption);
+        return -1;
+    }
+    double splitSize = project.getSplitLogFile() ? project.getMaxFileSizeMB() : 0;
+    if(parser.isSet(sizeOption))
+        splitSize = parser.value(sizeOption).toDouble();
+
+    LogWriter writer;
+    writer.setDirectory(parser.value(outputOption));
+    writer.setPrefix(parser.value(prefixOption));
+    writer.setMaxFileSize(qint64(splitSize * 1000 * 1000));
+    writer.setMaxFileAge(parser.value(timeOption).toInt() * 60);
+    writer.setMaxFiles(parser.value(keepOption).toInt());
+    writer.setCompressed(parser.isSet(compressOption));
+
+    DltLogger logger(ecus, &writer, filterList.get());
+    logger.setMaxQueueSize(qint64(parser.value(queueOption).toInt()) * 1024 * 1024);
+    logger.setStatisticsInterval(parser.value(statsOption).toInt());
+
+    // Stop on SIGINT and SIGTERM, the last file is completed
+    std::signal(SIGINT, requestTerminate);
+    std::signal(SIGTERM, requestTerminate);
+    QTimer terminateTimer;
+    QObject::connect(&terminateTimer, &QTimer::timeout, [&]() {
+        if(terminateRequested)
+        {
+            qDebug() << "Stop logging";
+            logger.stop();
+            a.quit();
+        }
+    });
+    terminateTimer.start(200);
+
+    logger.start();
+    return a.exec();
+}
@@ -342,6 +342,7 @@ void DltDBusPlugin::selectedIdxMsg(int /*index*/, QDltMsg &msg)
     form->setTextBrowserPayload(text);
 
     /* DBus message overview */
+    QReadLocker locker(&stateLock);
     text = decodeMessageToString(dbusMsg);
     form->setTextBrowserDBus(text);
 }
@@ -353,6 +354,7 @@ void DltDBusPlugin::initFileStart(QDltFile *file)
    {
     plugin_is_active = true;
     dltFile = file;
+    QWriteLocker locker(&stateLock);
     methods.clear();
     //qDebug() << "Activate plugin" << plugin_name_displayed <<  DLT_DBUS_PLUGIN_VERSION;
     // clear old map
@@ -387,6 +389,7 @@ void DltDBusPlugin::methodsAddMsg(QDltMsg &msg)
     {
         if(dbusMsg.getMessageType()==DBUS_MESSAGE_TYPE_METHOD_CALL)
         {
+           QWriteLocker locker(&stateLock);
            methods[DltDbusMethodKey(dbusMsg.getSender(),dbusMsg.getSerial())] = dbusMsg.getInterface() + "." + dbusMsg.getMember();
         }
     }
@@ -417,6 +420,8 @@ void DltDBusPlugin::segmentedMsg(QDltMsg &msg)
         return;
     }
 
+    QWriteLocker locker(&stateLock);
+
     if(argument1.getValue().toString()=="NWST")
     {
       if(segmentedMessages.contains(handle))
@@ -540,6 +545,12 @@ void DltDBusPlugin::updateFileFinish()
 
 }
 
+bool DltDBusPlugin::isDecoderReentrant()
+{
+    /* state collected by the viewer interface is protected by stateLock */
+    return true;
+}
+
 bool DltDBusPlugin::isMsg(QDltMsg & msg, int triggeredByUser)
 {
     Q_UNUSED(triggeredByUser);
@@ -556,6 +567,8 @@ bool DltDBusPlugin::decodeMsg(QDltMsg &msg, int triggeredByUser)
     if(!checkIfDBusMsg(msg))
         return false;
 
+    QReadLocker locker(&stateLock);
+
     msg.getArgument(0,argument1);
     msg.getArgument(1,argument2);
 
@@ -606,12 +619,13 @@ bool DltDBusPlugin::decodeMsg(QDltMsg &msg, int triggeredByUser)
         if(argument2.getTypeInfo()==QDltArgument::DltTypeInfoUInt)
         {
             uint32_t handle = argument2.getValue().toUInt();
-            if(segmentedMessages.contains(handle))
+            QDltSegmentedMsg *segmentedMessage = segmentedMessages.value(handle);
+            if(segmentedMessage)
             {
-                if(segmentedMessages[handle]->complete())
+                if(segmentedMessage->complete())
                 {
                     // show decoded message
-                    QByteArray data = segmentedMessages[handle]->getHeader() + segmentedMessages[handle]->getPayload() ;
+                    QByteArray data = segmentedMessage->getHeader() + segmentedMessage->getPayload() ;
                     DltDBusDecoder dbusMsg;
                     if(dbusMsg.decode(data))
                     {
@@ -725,7 +739,7 @@ QString DltDBusPlugin::decodeMessageToString(DltDBusDecoder &dbusMsg,bool header
             text = QString("C [%1,%2] ").arg(dbusMsg.getSender()).arg(dbusMsg.getSerial()) + " " + dbusMsg.getPath() + " " + dbusMsg.getInterface()+"."+dbusMsg.getMember()+" ";
             break;
         case DBUS_MESSAGE_TYPE_METHOD_RETURN:
-            method = methods[DltDbusMethodKey(dbusMsg.getDestination(),dbusMsg.getReplySerial())];
+            method = methods.value(DltDbusMethodKey(dbusMsg.getDestination(),dbusMsg.getReplySerial()));
             text = QString("R [%1,%2] ").arg(dbusMsg.getDestination()).arg(dbusMsg.getReplySerial()) + method + " ";
             break;
         case DBUS_MESSAGE_TYPE_SIGNAL:
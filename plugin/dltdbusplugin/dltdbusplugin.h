@@ -23,6 +23,7 @@
 #include <QObject>
 #include <QHash>
 #include <QMap>
+#include <QReadWriteLock>
 
 #include "dbus.h"
 
@@ -30,7 +31,7 @@
 #include "qdltsegmentedmsg.h"
 #include "form.h"
 
-#define DLT_DBUS_PLUGIN_VERSION "2.0.0"
+#define DLT_DBUS_PLUGIN_VERSION "2.1.0"
 
 // we restrict the maximum number of APID/CTID pairs because of performance issues
 #define MAX_LOGIDS 10
@@ -71,13 +72,14 @@ inline size_t qHash(const DltDbusMethodKey &key)
     return qHash(key.getSender()) ^ key.getSerial();
 }
 
-class DltDBusPlugin : public QObject, QDLTPluginInterface, QDltPluginViewerInterface, QDLTPluginDecoderInterface,  QDltPluginControlInterface
+class DltDBusPlugin : public QObject, QDLTPluginInterface, QDltPluginViewerInterface, QDLTPluginDecoderInterface, QDltPluginDecoderReentrantInterface, QDltPluginControlInterface
 {
     Q_OBJECT
     Q_INTERFACES(QDLTPluginInterface)
     Q_INTERFACES(QDltPluginViewerInterface)
     Q_INTERFACES(QDltPluginControlInterface)
     Q_INTERFACES(QDLTPluginDecoderInterface)
+    Q_INTERFACES(QDltPluginDecoderReentrantInterface)
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     Q_PLUGIN_METADATA(IID "org.genivi.DLT.DltDbusPlugin")
 #endif
@@ -123,6 +125,9 @@ public:
     bool isMsg(QDltMsg &msg, int triggeredByUser);
     bool decodeMsg(QDltMsg &msg, int triggeredByUser);
 
+    /* QDltPluginDecoderReentrantInterface */
+    bool isDecoderReentrant();
+
     /* internal variables */
     DltDbus::Form *form;
 
@@ -152,6 +157,8 @@ private:
     bool config_is_loaded=false;
 
     QString plugin_name_displayed = QString("DLT DBus Plugin");
+    // methods and segmentedMessages are filled by the viewer interface while other threads decode
+    QReadWriteLock stateLock;
     QHash<DltDbusMethodKey,QString> methods;
     QMap<uint32_t,QDltSegmentedMsg*> segmentedMessages;
 
@@ -88,6 +88,8 @@ void DltSegmentationPlugin::initFileStart(QDltFile *file){
 if(nullptr == file)
         return;
 
+    QWriteLocker locker(&stateLock);
+
     dltFile = file;
 
     segmentedMessages.clear();
@@ -100,6 +102,7 @@ void DltSegmentationPlugin::initMsg(int index, QDltMsg &msg){
     if(msg.getWithSegementation())
     {
         // add msg to
+        QWriteLocker locker(&stateLock);
         segmentedMessages.append(index);
     }
 
@@ -127,6 +130,7 @@ void DltSegmentationPlugin::updateMsg(int index, QDltMsg &msg){
     if(msg.getWithSegementation())
     {
         // add msg to
+        QWriteLocker locker(&stateLock);
         segmentedMessages.append(index);
     }
 }
@@ -143,6 +147,12 @@ void DltSegmentationPlugin::updateFileFinish(){
         return;
 }
 
+bool DltSegmentationPlugin::isDecoderReentrant()
+{
+    /* segment list is protected by stateLock, chunks are read through QDltFile which locks itself */
+    return true;
+}
+
 bool DltSegmentationPlugin::isMsg(QDltMsg & msg, int triggeredByUser)
 {
     Q_UNUSED(msg);
@@ -164,6 +174,8 @@ bool DltSegmentationPlugin::decodeMsg(QDltMsg &msg, int triggeredByUser)
 {
     Q_UNUSED(triggeredByUser);
 
+    QReadLocker locker(&stateLock);
+
     if(nullptr == dltFile)
          return false;
 
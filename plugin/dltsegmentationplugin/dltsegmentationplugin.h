@@ -22,16 +22,18 @@
 
 #include <QObject>
 #include <QVector>
+#include <QReadWriteLock>
 #include "plugininterface.h"
 #include "form.h"
 
-#define DLT_SEGMENTATION_PLUGIN_VERSION "1.0.0"
+#define DLT_SEGMENTATION_PLUGIN_VERSION "1.1.0"
 
-class DltSegmentationPlugin : public QObject, QDLTPluginInterface, QDLTPluginDecoderInterface, QDltPluginViewerInterface
+class DltSegmentationPlugin : public QObject, QDLTPluginInterface, QDLTPluginDecoderInterface, QDltPluginDecoderReentrantInterface, QDltPluginViewerInterface
 {
     Q_OBJECT
     Q_INTERFACES(QDLTPluginInterface)
     Q_INTERFACES(QDLTPluginDecoderInterface)
+    Q_INTERFACES(QDltPluginDecoderReentrantInterface)
     Q_INTERFACES(QDltPluginViewerInterface)
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     Q_PLUGIN_METADATA(IID "org.genivi.DLT.DltSegmentationPlugin")
@@ -68,6 +70,9 @@ public:
     bool isMsg(QDltMsg &msg, int triggeredByUser);
     bool decodeMsg(QDltMsg &msg, int triggeredByUser);
 
+    /* QDltPluginDecoderReentrantInterface */
+    bool isDecoderReentrant();
+
     /* internal variables */
     DltSegmantationPlugin::Form *form;
 
@@ -75,6 +80,8 @@ private:
     QDltFile *dltFile;
     QString errorText;
 
+    // segmentedMessages is filled by the viewer interface while other threads decode
+    QReadWriteLock stateLock;
     QVector<int> segmentedMessages;
 };
 
@@ -659,6 +659,12 @@ bool NonverbosePlugin::decodeMsg(QDltMsg &msg, int triggeredByUser)
     return true;
 }
 
+bool NonverbosePlugin::isDecoderReentrant()
+{
+    /* decoding only reads the frame maps, which are changed by loadConfig() only */
+    return true;
+}
+
 bool NonverbosePlugin::initControl(QDltControl *control)
 {
     dltControl = control;
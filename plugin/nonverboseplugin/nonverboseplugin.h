@@ -30,7 +30,7 @@
 #include <stdint.h>
 #endif
 
-#define NON_VERBOSE_PLUGIN_VERSION "1.0.0"
+#define NON_VERBOSE_PLUGIN_VERSION "1.1.0"
 #define NON_VERBOSE_PLUGIN_NAME "Non Verbose Mode Plugin"
 
 class DltFibexKey
@@ -105,11 +105,12 @@ public:
         uint32_t pduRefCounter;
 };
 
-class NonverbosePlugin : public QObject, QDLTPluginInterface, QDLTPluginDecoderInterface, QDltPluginControlInterface
+class NonverbosePlugin : public QObject, QDLTPluginInterface, QDLTPluginDecoderInterface, QDltPluginDecoderReentrantInterface, QDltPluginControlInterface
 {
     Q_OBJECT
     Q_INTERFACES(QDLTPluginInterface)
     Q_INTERFACES(QDLTPluginDecoderInterface)
+    Q_INTERFACES(QDltPluginDecoderReentrantInterface)
     Q_INTERFACES(QDltPluginControlInterface)
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     Q_PLUGIN_METADATA(IID "org.genivi.DLT.NonVerbosePlugin")
@@ -132,6 +133,9 @@ public:
     bool isMsg(QDltMsg &msg, int triggeredByUser);
     bool decodeMsg(QDltMsg &msg, int triggeredByUser);
 
+    /* QDltPluginDecoderReentrantInterface */
+    bool isDecoderReentrant();
+
     /* QDltPluginControlInterface */
     bool initControl(QDltControl *control);
     bool initConnections(QStringList list);
@@ -157,6 +157,29 @@ public:
 Q_DECLARE_INTERFACE(QDLTPluginDecoderInterface,
                     "org.genivi.DLT.Plugin.DLTViewerPluginDecoderInterface/1.0")
 
+//! Optional extension of the DLT Viewer Plugin Interface used by decoder plugins.
+/*!
+  A decoder plugin implements this interface in addition to QDLTPluginDecoderInterface
+  to declare that isMsg() and decodeMsg() may be called from several threads at the same time,
+  e.g. by the filter indexer, the exporter and the table view.
+  Decoder plugins without this interface are called by one thread at a time.
+  The viewer never calls loadConfig() of a decoder plugin while it is decoding,
+  state collected by the viewer interface must be protected by the plugin itself.
+*/
+class QDltPluginDecoderReentrantInterface
+{
+public:
+    //! Check if the decoder functions of the plugin are reentrant.
+    /*!
+      \return True if isMsg() and decodeMsg() can be called concurrently.
+    */
+    virtual bool isDecoderReentrant() = 0;
+
+};
+
+Q_DECLARE_INTERFACE(QDltPluginDecoderReentrantInterface,
+                    "org.genivi.DLT.Plugin.DLTViewerPluginDecoderReentrantInterface/1.0")
+
 //! Extended DLT Viewer Plugin Interface used by viewer plugins.
 /*!
   This is an extended DLT Plugin Interface.
@@ -34,6 +34,19 @@ QT                     += serialport
 
 win32:LIBS += User32.lib
 
+# Optional support for compressed DLT files (.dlt.gz, .dlt.zst)
+unix {
+    CONFIG += link_pkgconfig
+    packagesExist(zlib) {
+        PKGCONFIG += zlib
+        DEFINES += QDLT_USE_ZLIB
+    }
+    packagesExist(libzstd) {
+        PKGCONFIG += libzstd
+        DEFINES += QDLT_USE_ZSTD
+    }
+}
+
 # Put intermediate files in the build directory
 MOC_DIR     = build/moc
 OBJECTS_DIR = build/obj
@@ -50,13 +63,19 @@ SOURCES +=  \
     qdltudpconnection.cpp \
     qdltserialconnection.cpp \
     qdltmsg.cpp \
+    qdltmsgcache.cpp \
     qdltfilter.cpp \
     qdltfile.cpp \
+    qdltfilereader.cpp \
+    qdltcompressedfile.cpp \
+    qdltcompressedwriter.cpp \
     qdltcontrol.cpp \
     qdltconnection.cpp \
     qdltbase.cpp \
     qdltargument.cpp \
     qdltfilterlist.cpp \
+    qdltfilterrouter.cpp \
+    qdlttimemerger.cpp \
     qdltfilterindex.cpp \
     qdltdefaultfilter.cpp \
     qdltpluginmanager.cpp \
@@ -65,8 +84,16 @@ SOURCES +=  \
     qdltsegmentedmsg.cpp \
     qdltsettingsmanager.cpp \
     qdltexporter.cpp \
+    qdltparquetwriter.cpp \
     fieldnames.cpp \
     qdltimporter.cpp \
+    qdltpcapreader.cpp \
+    qdltpacketreassembler.cpp \
+    qdltmf4reader.cpp \
+    qdltlivesink.cpp \
+    qdltlivereader.cpp \
+    qdltudpreceiver.cpp \
+    qdltrelayserver.cpp \
     dltmessagematcher.cpp \
     qdltctrlmsg.cpp \
 
@@ -81,13 +108,19 @@ HEADERS += qdlt.h \
     qdltudpconnection.h \
     qdltserialconnection.h \
     qdltmsg.h \
+    qdltmsgcache.h \
     qdltfilter.h \
     qdltfile.h \
+    qdltfilereader.h \
+    qdltcompressedfile.h \
+    qdltcompressedwriter.h \
     qdltcontrol.h \
     qdltconnection.h \
     qdltbase.h \
     qdltargument.h \
     qdltfilterlist.h \
+    qdltfilterrouter.h \
+    qdlttimemerger.h \
     qdltfilterindex.h \
     qdltdefaultfilter.h \
     plugininterface.h \
@@ -99,8 +132,16 @@ HEADERS += qdlt.h \
     qdltsegmentedmsg.h \
     qdltsettingsmanager.h \
     qdltexporter.h \
+    qdltparquetwriter.h \
     fieldnames.h \
     qdltimporter.h \
+    qdltpcapreader.h \
+    qdltpacketreassembler.h \
+    qdltmf4reader.h \
+    qdltlivesink.h \
+    qdltlivereader.h \
+    qdltudpreceiver.h \
+    qdltrelayserver.h \
     dltmessagematcher.h \
     qdltctrlmsg.h \
 
@@ -0,0 +1,670 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltcompressedfile.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QFileInfo>
+#include <QtDebug>
+
+#include <cstring>
+
+#ifdef QDLT_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef QDLT_USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "qdltcompressedfile.h"
+#include "qdltlrucache.hpp"
+
+/* magic number of a zstd frame, of the skippable frame with the seek table and of the seek table footer */
+#define ZSTD_FRAME_MAGIC 0xFD2FB528U
+#define ZSTD_SKIPPABLE_MAGIC_MASK 0xFFFFFFF0U
+#define ZSTD_SKIPPABLE_MAGIC 0x184D2A50U
+#define ZSTD_SEEKTABLE_SKIPPABLE_MAGIC 0x184D2A5EU
+#define ZSTD_SEEKTABLE_FOOTER_MAGIC 0x8F92EAB1U
+#define ZSTD_SEEKTABLE_FOOTER_SIZE 9
+#define ZSTD_FRAME_HEADER_MAX_SIZE 18
+
+/* gzip access points: distance in uncompressed data and size of the deflate history */
+#define GZIP_BLOCK_SPAN (4 * 1024 * 1024)
+#define GZIP_WINDOW_SIZE 32768
+#define GZIP_TRAILER_SIZE 8
+
+#define COMPRESSED_READ_SIZE (256 * 1024)
+
+namespace {
+
+quint32 readUInt32(const char *data)
+{
+    return quint32(quint8(data[0])) | (quint32(quint8(data[1])) << 8) |
+           (quint32(quint8(data[2])) << 16) | (quint32(quint8(data[3])) << 24);
+}
+
+}
+
+QDltCompressedFile::QDltCompressedFile(QObject *parent)
+    : QIODevice(parent), compression(CompressionNone), uncompressedSize(0), compressedEnd(0), position(0),
+      cacheBlocks(8), cache(nullptr), zstdContext(nullptr)
+{
+
+}
+
+QDltCompressedFile::~QDltCompressedFile()
+{
+    close();
+}
+
+void QDltCompressedFile::setFileName(const QString &name)
+{
+    file.setFileName(name);
+}
+
+QString QDltCompressedFile::fileName() const
+{
+    return file.fileName();
+}
+
+void QDltCompressedFile::setCacheBlocks(int count)
+{
+    cacheBlocks = count > 0 ? count : 1;
+}
+
+QDltCompressedFile::Compression QDltCompressedFile::detectCompression(const QString &filename)
+{
+    QFile f(filename);
+    if(!f.open(QIODevice::ReadOnly))
+        return CompressionNone;
+
+    QByteArray magic = f.read(4);
+    if(magic.size() >= 2 && quint8(magic[0]) == 0x1f && quint8(magic[1]) == 0x8b)
+        return CompressionGzip;
+    if(magic.size() == 4)
+    {
+        quint32 value = readUInt32(magic.constData());
+        if(value == ZSTD_FRAME_MAGIC || (value & ZSTD_SKIPPABLE_MAGIC_MASK) == ZSTD_SKIPPABLE_MAGIC)
+            return CompressionZstd;
+    }
+    return CompressionNone;
+}
+
+bool QDltCompressedFile::isSupported(Compression compression)
+{
+    switch(compression)
+    {
+    case CompressionNone:
+        return true;
+    case CompressionGzip:
+#ifdef QDLT_USE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case CompressionZstd:
+#ifdef QDLT_USE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool QDltCompressedFile::isCompressedFileName(const QString &filename)
+{
+    return filename.endsWith(".dlt.gz", Qt::CaseInsensitive) ||
+           filename.endsWith(".dlt.zst", Qt::CaseInsensitive);
+}
+
+bool QDltCompressedFile::open(OpenMode mode)
+{
+    if(isOpen())
+        close();
+
+    if((mode & QIODevice::ReadWrite) != QIODevice::ReadOnly)
+    {
+        setErrorString("Only read access is supported");
+        return false;
+    }
+
+    compression = detectCompression(file.fileName());
+    /* new file of QDltCompressedWriter, frames are added with updateBlocks() when written */
+    if(compression == CompressionNone && file.fileName().endsWith(".zst", Qt::CaseInsensitive) &&
+       QFileInfo(file.fileName()).size() == 0)
+        compression = CompressionZstd;
+    if(!isSupported(compression))
+    {
+        qWarning() << "Compression of file" << file.fileName() << "is not supported by this build";
+        setErrorString("Compression not supported");
+        compression = CompressionNone;
+        return false;
+    }
+
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        setErrorString(file.errorString());
+        return false;
+    }
+
+    if(compression != CompressionNone)
+    {
+        bool result = false;
+        if(compression == CompressionZstd)
+            result = createZstdIndex();
+        else if(compression == CompressionGzip)
+            result = createGzipIndex();
+
+        if(!result)
+        {
+            qWarning() << "Invalid compressed data in file" << file.fileName();
+            setErrorString("Invalid compressed data");
+            file.close();
+            blocks.clear();
+            compression = CompressionNone;
+            return false;
+        }
+
+        uncompressedSize = blocks.isEmpty() ? 0 : blocks.last().uncompressedOffset + blocks.last().uncompressedSize;
+        cache = new QDltLruCache<int,QByteArray,std::hash<int>>(cacheBlocks);
+        qDebug() << "Opened compressed file" << file.fileName() << "with" << blocks.size() << "blocks and" << uncompressedSize << "bytes";
+    }
+
+    position = 0;
+    /* data is already buffered in the decompressed blocks or in the file */
+    return QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void QDltCompressedFile::close()
+{
+    if(isOpen())
+        QIODevice::close();
+
+    if(file.isOpen())
+        file.close();
+    blocks.clear();
+    uncompressedSize = 0;
+    compressedEnd = 0;
+    position = 0;
+    delete cache;
+    cache = nullptr;
+#ifdef QDLT_USE_ZSTD
+    ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(zstdContext));
+#endif
+    zstdContext = nullptr;
+}
+
+qint64 QDltCompressedFile::size() const
+{
+    if(compression == CompressionNone)
+        return file.size();
+    return uncompressedSize;
+}
+
+bool QDltCompressedFile::seek(qint64 pos)
+{
+    if(pos < 0 || !QIODevice::seek(pos))
+        return false;
+
+    position = pos;
+    if(compression == CompressionNone)
+        return file.seek(pos);
+    return true;
+}
+
+qint64 QDltCompressedFile::readData(char *data, qint64 maxSize)
+{
+    if(compression == CompressionNone)
+    {
+        qint64 result = file.read(data, maxSize);
+        if(result > 0)
+            position += result;
+        return result;
+    }
+
+    /* copy from all blocks overlapping the requested range */
+    qint64 done = 0;
+    while(done < maxSize && position < uncompressedSize)
+    {
+        int num = findBlock(position);
+        const QByteArray *block = getBlock(num);
+        if(!block)
+            return done > 0 ? done : -1;
+
+        qint64 offset = position - blocks[num].uncompressedOffset;
+        qint64 length = qMin(maxSize - done, qint64(block->size()) - offset);
+        if(length <= 0)
+            break;
+        memcpy(data + done, block->constData() + offset, length);
+        done += length;
+        position += length;
+    }
+    return done;
+}
+
+qint64 QDltCompressedFile::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+int QDltCompressedFile::findBlock(qint64 pos) const
+{
+    /* binary search for the last block starting at or before pos */
+    int first = 0;
+    int last = blocks.size() - 1;
+    while(first < last)
+    {
+        int middle = (first + last + 1) / 2;
+        if(blocks[middle].uncompressedOffset <= pos)
+            first = middle;
+        else
+            last = middle - 1;
+    }
+    return first;
+}
+
+const QByteArray *QDltCompressedFile::getBlock(int num)
+{
+    if(const QByteArray *data = cache->find(num))
+        return data;
+
+    QByteArray data;
+    bool result = false;
+    if(compression == CompressionZstd)
+        result = decompressZstd(blocks[num], data);
+    else if(compression == CompressionGzip)
+        result = decompressGzip(blocks[num], data);
+
+    if(!result || data.size() != blocks[num].uncompressedSize)
+    {
+        qWarning() << "Decompression of block" << num << "failed in" << file.fileName();
+        return nullptr;
+    }
+
+    cache->put(num, std::move(data));
+    return cache->find(num);
+}
+
+bool QDltCompressedFile::readZstdSeekTable()
+{
+    /* seekable format: skippable frame at the end of the file, containing one entry per frame
+       and a footer with the number of frames, a descriptor and the magic number */
+    qint64 fileSize = file.size();
+    if(fileSize < 8 + ZSTD_SEEKTABLE_FOOTER_SIZE || !file.seek(fileSize - ZSTD_SEEKTABLE_FOOTER_SIZE))
+        return false;
+
+    QByteArray footer = file.read(ZSTD_SEEKTABLE_FOOTER_SIZE);
+    if(footer.size() != ZSTD_SEEKTABLE_FOOTER_SIZE || readUInt32(footer.constData() + 5) != ZSTD_SEEKTABLE_FOOTER_MAGIC)
+        return false;
+
+    qint64 numberOfFrames = readUInt32(footer.constData());
+    bool checksums = quint8(footer[4]) & 0x80;
+    qint64 entrySize = checksums ? 12 : 8;
+    qint64 tableSize = numberOfFrames * entrySize;
+    qint64 tableStart = fileSize - ZSTD_SEEKTABLE_FOOTER_SIZE - tableSize;
+    if(tableStart < 8 || !file.seek(tableStart - 8))
+        return false;
+
+    QByteArray table = file.read(8 + tableSize);
+    if(table.size() != 8 + tableSize ||
+       readUInt32(table.constData()) != ZSTD_SEEKTABLE_SKIPPABLE_MAGIC ||
+       readUInt32(table.constData() + 4) != tableSize + ZSTD_SEEKTABLE_FOOTER_SIZE)
+        return false;
+
+    Block block;
+    for(qint64 num = 0; num < numberOfFrames; num++)
+    {
+        const char *entry = table.constData() + 8 + num * entrySize;
+        block.compressedSize = readUInt32(entry);
+        block.uncompressedSize = readUInt32(entry + 4);
+        if(block.compressedOffset + block.compressedSize > tableStart - 8)
+        {
+            blocks.clear();
+            return false;
+        }
+        if(block.uncompressedSize > 0)
+            blocks.append(block);
+        block.compressedOffset += block.compressedSize;
+        block.uncompressedOffset += block.uncompressedSize;
+    }
+    compressedEnd = fileSize;
+    return true;
+}
+
+bool QDltCompressedFile::createZstdIndex()
+{
+    if(readZstdSeekTable())
+        return true;
+
+    /* no seek table, walk through the frames and block headers */
+    return appendZstdFrames();
+}
+
+bool QDltCompressedFile::updateBlocks()
+{
+    if(!isOpen() || compression != CompressionZstd || file.size() <= compressedEnd)
+        return false;
+
+    qint64 oldSize = uncompressedSize;
+    if(!appendZstdFrames())
+        qWarning() << "Invalid compressed data appended to file" << file.fileName();
+    return uncompressedSize != oldSize;
+}
+
+bool QDltCompressedFile::appendZstdFrames()
+{
+#ifdef QDLT_USE_ZSTD
+    /* continue behind the frames already in the block index, an incomplete frame
+       at the end of the file is ignored, it is added when the file was written completely */
+    qint64 fileSize = file.size();
+    Block block;
+    block.compressedOffset = compressedEnd;
+    block.uncompressedOffset = uncompressedSize;
+    while(block.compressedOffset < fileSize)
+    {
+        if(!file.seek(block.compressedOffset))
+            return false;
+        QByteArray header = file.read(ZSTD_FRAME_HEADER_MAX_SIZE);
+        if(header.size() < 8)
+            break;
+
+        quint32 magic = readUInt32(header.constData());
+        if((magic & ZSTD_SKIPPABLE_MAGIC_MASK) == ZSTD_SKIPPABLE_MAGIC)
+        {
+            qint64 end = block.compressedOffset + 8 + readUInt32(header.constData() + 4);
+            if(end > fileSize)
+                break;
+            block.compressedOffset = compressedEnd = end;
+            continue;
+        }
+        if(magic != ZSTD_FRAME_MAGIC)
+            return false;
+
+        /* frame header size from the frame header descriptor */
+        static const int dictionaryIdSizes[] = { 0, 1, 2, 4 };
+        static const int contentSizeSizes[] = { 0, 2, 4, 8 };
+        quint8 descriptor = header[4];
+        bool singleSegment = descriptor & 0x20;
+        bool checksum = descriptor & 0x04;
+        int contentSizeSize = contentSizeSizes[descriptor >> 6];
+        if(contentSizeSize == 0 && singleSegment)
+            contentSizeSize = 1;
+        qint64 headerSize = 5 + (singleSegment ? 0 : 1) + dictionaryIdSizes[descriptor & 3] + contentSizeSize;
+
+        /* skip the blocks of the frame, 3 bytes block header with last block flag, type and size */
+        qint64 pos = block.compressedOffset + headerSize;
+        bool lastBlock = false;
+        while(!lastBlock && pos + 3 <= fileSize)
+        {
+            if(!file.seek(pos))
+                return false;
+            QByteArray blockHeader = file.read(3);
+            if(blockHeader.size() != 3)
+                return false;
+            quint32 value = quint8(blockHeader[0]) | (quint8(blockHeader[1]) << 8) | (quint8(blockHeader[2]) << 16);
+            lastBlock = value & 1;
+            int type = (value >> 1) & 3;
+            qint64 size = value >> 3;
+            if(type == 1)
+                size = 1; // RLE block has a single byte
+            else if(type == 3)
+                return false;
+            pos += 3 + size;
+        }
+        if(checksum)
+            pos += 4;
+        if(!lastBlock || pos > fileSize)
+            break;
+        block.compressedSize = pos - block.compressedOffset;
+
+        unsigned long long contentSize = ZSTD_getFrameContentSize(header.constData(), header.size());
+        if(contentSize == ZSTD_CONTENTSIZE_ERROR)
+            return false;
+        if(contentSize == ZSTD_CONTENTSIZE_UNKNOWN)
+        {
+            /* size not stored in the frame header, decompress once to get it */
+            if(!file.seek(block.compressedOffset))
+                return false;
+            QByteArray frame = file.read(block.compressedSize);
+            ZSTD_DStream *stream = ZSTD_createDStream();
+            ZSTD_inBuffer in = { frame.constData(), size_t(frame.size()), 0 };
+            QByteArray out(ZSTD_DStreamOutSize(), Qt::Uninitialized);
+            contentSize = 0;
+            size_t result = 1;
+            while(result != 0)
+            {
+                ZSTD_outBuffer output = { out.data(), size_t(out.size()), 0 };
+                result = ZSTD_decompressStream(stream, &output, &in);
+                if(ZSTD_isError(result) || (output.pos == 0 && in.pos == in.size && result != 0))
+                {
+                    ZSTD_freeDStream(stream);
+                    return false;
+                }
+                contentSize += output.pos;
+            }
+            ZSTD_freeDStream(stream);
+        }
+        block.uncompressedSize = contentSize;
+
+        if(block.uncompressedSize > 0)
+            blocks.append(block);
+        block.uncompressedOffset += block.uncompressedSize;
+        block.compressedOffset = compressedEnd = pos;
+        uncompressedSize = block.uncompressedOffset;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool QDltCompressedFile::decompressZstd(const Block &block, QByteArray &data)
+{
+#ifdef QDLT_USE_ZSTD
+    if(!file.seek(block.compressedOffset))
+        return false;
+    QByteArray frame = file.read(block.compressedSize);
+    if(frame.size() != block.compressedSize)
+        return false;
+
+    if(!zstdContext)
+        zstdContext = ZSTD_createDCtx();
+    data.resize(block.uncompressedSize);
+    size_t result = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(zstdContext), data.data(), data.size(),
+                                        frame.constData(), frame.size());
+    return !ZSTD_isError(result) && qint64(result) == block.uncompressedSize;
+#else
+    Q_UNUSED(block);
+    Q_UNUSED(data);
+    return false;
+#endif
+}
+
+bool QDltCompressedFile::createGzipIndex()
+{
+#ifdef QDLT_USE_ZLIB
+    /* Decompress the whole file once and store an access point at a deflate block boundary
+       about every GZIP_BLOCK_SPAN bytes. An access point stores the position in the compressed data,
+       the bits of the last byte already used and the last 32 kB of uncompressed data,
+       which is all that is needed to continue decompression from there. */
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    if(inflateInit2(&strm, 15 + 16) != Z_OK) // gzip format
+        return false;
+
+    QByteArray input(COMPRESSED_READ_SIZE, Qt::Uninitialized);
+    QByteArray window(GZIP_WINDOW_SIZE, '\0');
+    qint64 totalIn = 0;
+    qint64 totalOut = 0;
+    qint64 last = 0;
+    bool result = true;
+    bool streamEnd = false;
+    strm.avail_out = 0;
+
+    while(true)
+    {
+        if(strm.avail_in == 0)
+        {
+            qint64 length = file.read(input.data(), input.size());
+            if(length <= 0)
+            {
+                if(!streamEnd)
+                    qWarning() << "Compressed file" << file.fileName() << "is truncated";
+                break;
+            }
+            strm.avail_in = length;
+            strm.next_in = reinterpret_cast<Bytef*>(input.data());
+        }
+        if(strm.avail_out == 0)
+        {
+            strm.avail_out = GZIP_WINDOW_SIZE;
+            strm.next_out = reinterpret_cast<Bytef*>(window.data());
+        }
+
+        totalIn += strm.avail_in;
+        totalOut += strm.avail_out;
+        int ret = inflate(&strm, Z_BLOCK);
+        totalIn -= strm.avail_in;
+        totalOut -= strm.avail_out;
+
+        if(ret == Z_STREAM_END)
+        {
+            /* end of a gzip member, another member may follow */
+            streamEnd = true;
+            inflateReset(&strm);
+            continue;
+        }
+        if(ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            if(streamEnd)
+                qWarning() << "Ignoring data behind the end of compressed file" << file.fileName();
+            else
+                result = false;
+            break;
+        }
+        streamEnd = false;
+
+        /* at the end of a deflate block, which is not the last block of the member */
+        if((strm.data_type & 128) && !(strm.data_type & 64) && (totalOut == 0 || totalOut - last >= GZIP_BLOCK_SPAN))
+        {
+            Block block;
+            block.compressedOffset = totalIn;
+            block.uncompressedOffset = totalOut;
+            block.bits = strm.data_type & 7;
+            if(totalOut > 0)
+            {
+                /* window is used as ring buffer, the oldest data starts behind the current output position */
+                int left = strm.avail_out;
+                block.window.reserve(GZIP_WINDOW_SIZE);
+                block.window.append(window.constData() + GZIP_WINDOW_SIZE - left, left);
+                block.window.append(window.constData(), GZIP_WINDOW_SIZE - left);
+                if(totalOut < GZIP_WINDOW_SIZE)
+                    block.window = block.window.right(totalOut);
+            }
+            if(!blocks.isEmpty())
+                blocks.last().uncompressedSize = totalOut - blocks.last().uncompressedOffset;
+            blocks.append(block);
+            last = totalOut;
+        }
+    }
+    inflateEnd(&strm);
+
+    if(!blocks.isEmpty())
+        blocks.last().uncompressedSize = totalOut - blocks.last().uncompressedOffset;
+    if(!blocks.isEmpty() && blocks.last().uncompressedSize == 0)
+        blocks.removeLast();
+    return result;
+#else
+    return false;
+#endif
+}
+
+bool QDltCompressedFile::decompressGzip(const Block &block, QByteArray &data)
+{
+#ifdef QDLT_USE_ZLIB
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    if(inflateInit2(&strm, -15) != Z_OK) // raw deflate, the access point is inside the deflate data
+        return false;
+
+    QByteArray input(COMPRESSED_READ_SIZE, Qt::Uninitialized);
+    bool result = file.seek(block.compressedOffset - (block.bits ? 1 : 0));
+    if(result && block.bits)
+    {
+        char byte;
+        result = file.getChar(&byte);
+        if(result)
+            inflatePrime(&strm, block.bits, quint8(byte) >> (8 - block.bits));
+    }
+    if(result && !block.window.isEmpty())
+        inflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(block.window.constData()), block.window.size());
+
+    data.resize(block.uncompressedSize);
+    strm.next_out = reinterpret_cast<Bytef*>(data.data());
+    strm.avail_out = data.size();
+    bool raw = true;
+    qint64 skip = 0;
+
+    while(result && strm.avail_out > 0)
+    {
+        if(strm.avail_in == 0)
+        {
+            qint64 length = file.read(input.data(), input.size());
+            if(length <= 0)
+            {
+                result = false;
+                break;
+            }
+            strm.avail_in = length;
+            strm.next_in = reinterpret_cast<Bytef*>(input.data());
+        }
+        if(skip > 0)
+        {
+            /* trailer of the previous gzip member */
+            qint64 length = qMin<qint64>(skip, strm.avail_in);
+            strm.next_in += length;
+            strm.avail_in -= length;
+            skip -= length;
+            continue;
+        }
+
+        int ret = inflate(&strm, Z_NO_FLUSH);
+        if(ret == Z_STREAM_END)
+        {
+            /* block continues in the next gzip member */
+            if(raw)
+            {
+                skip = GZIP_TRAILER_SIZE;
+                inflateReset2(&strm, 15 + 16);
+                raw = false;
+            }
+            else
+                inflateReset(&strm);
+        }
+        else if(ret != Z_OK && ret != Z_BUF_ERROR)
+            result = false;
+    }
+    inflateEnd(&strm);
+    return result;
+#else
+    Q_UNUSED(block);
+    Q_UNUSED(data);
+    return false;
+#endif
+}
@@ -0,0 +1,175 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltcompressedfile.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_COMPRESSED_FILE_H
+#define QDLT_COMPRESSED_FILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+#include "export_rules.h"
+
+template<typename Key, typename Value, typename Hash> class QDltLruCache;
+
+//! Random access to DLT files compressed with zstd or gzip.
+/*!
+  The device presents the uncompressed content of a .dlt.zst or .dlt.gz file as a seekable,
+  read only device. Positions used for seek() and in the message index are positions in the
+  uncompressed data, so the index does not depend on the compression.
+
+  When the file is opened a block index is created, which maps each block of uncompressed data
+  to its position in the compressed file. Reading decompresses only the blocks needed,
+  the most recently used blocks are kept in a cache.
+
+  zstd files are split into blocks at frame boundaries, the seek table of the zstd seekable
+  format is used if the file has one. A file compressed as a single frame is one block.
+  gzip files are scanned once when opened and an access point with the last 32 kB of history
+  is stored about every 4 MB of uncompressed data.
+
+  Files which are not compressed are read directly from the file. An empty .dlt.zst file
+  is opened as zstd file, so it can be followed with updateBlocks() while it is written.
+*/
+class QDLT_EXPORT QDltCompressedFile : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    typedef enum { CompressionNone, CompressionGzip, CompressionZstd } Compression;
+
+    //! The constructor.
+    /*!
+      \param parent The parent object.
+    */
+    explicit QDltCompressedFile(QObject *parent = nullptr);
+
+    //! The destructor.
+    ~QDltCompressedFile() override;
+
+    //! Set the name of the file to be opened.
+    /*!
+      \param name The file name.
+    */
+    void setFileName(const QString &name);
+
+    //! Get the name of the file.
+    QString fileName() const;
+
+    //! Open the file and create the block index if the file is compressed.
+    /*!
+      Only QIODevice::ReadOnly is supported.
+      \param mode The open mode.
+      \return false if the file could not be opened or the compressed data is invalid.
+    */
+    bool open(OpenMode mode) override;
+
+    //! Close the file and clear the block index and the cache.
+    void close() override;
+
+    //! The device is random access.
+    bool isSequential() const override { return false; }
+
+    //! Get the size of the uncompressed data.
+    qint64 size() const override;
+
+    //! Set the position in the uncompressed data.
+    bool seek(qint64 pos) override;
+
+    //! Add the frames appended to a zstd file since the block index was created.
+    /*!
+      Used to follow a file which is still written by QDltCompressedWriter,
+      a frame is added when it is complete. Does nothing for other files.
+      \return true if the size of the uncompressed data has changed.
+    */
+    bool updateBlocks();
+
+    //! Get the compression of the opened file.
+    Compression getCompression() const { return compression; }
+
+    //! Get the number of blocks of the block index, 0 for uncompressed files.
+    int getNumberOfBlocks() const { return blocks.size(); }
+
+    //! Set the maximum number of decompressed blocks kept in memory.
+    /*!
+      Must be called before open(), default is 8 blocks.
+      \param count Number of blocks.
+    */
+    void setCacheBlocks(int count);
+
+    //! Detect the compression of a file by the magic bytes at the beginning of the file.
+    /*!
+      \param filename The file to be checked.
+      \return The compression, CompressionNone also if the file cannot be read.
+    */
+    static Compression detectCompression(const QString &filename);
+
+    //! Check if the library was built with support for a compression.
+    /*!
+      \param compression The compression to be checked.
+      \return true if files with this compression can be read.
+    */
+    static bool isSupported(Compression compression);
+
+    //! Check if a file name has the extension of a compressed DLT file (.dlt.gz or .dlt.zst).
+    /*!
+      \param filename The file name to be checked.
+      \return true if the file name ends with a supported extension.
+    */
+    static bool isCompressedFileName(const QString &filename);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    struct Block
+    {
+        qint64 compressedOffset = 0;
+        qint64 compressedSize = 0; // zstd only, gzip is decompressed until the block is complete
+        qint64 uncompressedOffset = 0;
+        qint64 uncompressedSize = 0;
+        int bits = 0; // gzip only, number of bits of the byte in front of compressedOffset
+        QByteArray window; // gzip only, history needed to start decompression
+    };
+
+    bool createZstdIndex();
+    bool readZstdSeekTable();
+    bool appendZstdFrames();
+    bool createGzipIndex();
+    int findBlock(qint64 pos) const;
+    const QByteArray *getBlock(int num);
+    bool decompressZstd(const Block &block, QByteArray &data);
+    bool decompressGzip(const Block &block, QByteArray &data);
+
+    QFile file;
+    Compression compression;
+    QVector<Block> blocks;
+    qint64 uncompressedSize;
+    qint64 compressedEnd; // zstd only, end of the frames in the block index
+    qint64 position;
+    int cacheBlocks;
+    QDltLruCache<int,QByteArray,std::hash<int>> *cache;
+    void *zstdContext;
+};
+
+#endif // QDLT_COMPRESSED_FILE_H
@@ -0,0 +1,282 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltcompressedwriter.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QMutexLocker>
+#include <QThread>
+#include <QtDebug>
+
+#include <utility>
+
+#ifdef QDLT_USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "qdltcompressedwriter.h"
+
+/* seek table of the zstd seekable format, see QDltCompressedFile */
+#define ZSTD_SEEKTABLE_SKIPPABLE_MAGIC 0x184D2A5EU
+#define ZSTD_SEEKTABLE_FOOTER_MAGIC 0x8F92EAB1U
+#define ZSTD_SEEKTABLE_FOOTER_SIZE 9
+
+#define DEFAULT_FRAME_SIZE (4 * 1024 * 1024)
+#define MIN_FRAME_SIZE (64 * 1024)
+#define MAX_FRAME_SIZE (1024 * 1024 * 1024)
+
+/* frames waiting for compression, limits the memory used when the compression is slower than the input */
+#define MAX_QUEUED_FRAMES 4
+
+namespace {
+
+void appendUInt32(QByteArray &data, quint32 value)
+{
+    for(int i = 0; i < 4; i++)
+        data.append(char((value >> (8 * i)) & 0xff));
+}
+
+}
+
+QDltCompressedWriter::QDltCompressedWriter(QObject *parent)
+    : QIODevice(parent), frameSize(DEFAULT_FRAME_SIZE), maxFrameDelay(-1), compressionLevel(3),
+      uncompressedSize(0), thread(nullptr), compressedSize(0), finishing(false), failed(false)
+{
+
+}
+
+QDltCompressedWriter::~QDltCompressedWriter()
+{
+    close();
+}
+
+void QDltCompressedWriter::setFileName(const QString &name)
+{
+    file.setFileName(name);
+}
+
+QString QDltCompressedWriter::fileName() const
+{
+    return file.fileName();
+}
+
+void QDltCompressedWriter::setFrameSize(qint64 size)
+{
+    frameSize = qBound(qint64(MIN_FRAME_SIZE), size, qint64(MAX_FRAME_SIZE));
+}
+
+void QDltCompressedWriter::setMaxFrameDelay(int msecs)
+{
+    maxFrameDelay = msecs;
+}
+
+void QDltCompressedWriter::setCompressionLevel(int level)
+{
+    compressionLevel = level;
+}
+
+bool QDltCompressedWriter::isSupported()
+{
+#ifdef QDLT_USE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool QDltCompressedWriter::isCompressedFileName(const QString &filename)
+{
+    return filename.endsWith(".dlt.zst", Qt::CaseInsensitive);
+}
+
+qint64 QDltCompressedWriter::getCompressedSize() const
+{
+    QMutexLocker locker(&mutex);
+    return compressedSize;
+}
+
+bool QDltCompressedWriter::open(OpenMode mode)
+{
+    if(isOpen())
+        close();
+
+    if(!isSupported())
+    {
+        qWarning() << "Cannot write" << file.fileName() << ", zstd compression is not supported by this build";
+        setErrorString("Compression not supported");
+        return false;
+    }
+
+    if((mode & QIODevice::ReadWrite) != QIODevice::WriteOnly || (mode & QIODevice::Append))
+    {
+        setErrorString("Only writing a new file is supported");
+        return false;
+    }
+
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        setErrorString(file.errorString());
+        return false;
+    }
+
+    frame.clear();
+    frame.reserve(frameSize);
+    uncompressedSize = 0;
+    frames.clear();
+    seekTable.clear();
+    compressedSize = 0;
+    finishing = false;
+    failed = false;
+
+    thread = QThread::create([this]() { compressFrames(); });
+    thread->start();
+
+    /* data is collected in the frame buffer */
+    return QIODevice::open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+}
+
+void QDltCompressedWriter::close()
+{
+    if(!isOpen())
+        return;
+
+    if(!frame.isEmpty())
+        completeFrame();
+
+    {
+        QMutexLocker locker(&mutex);
+        finishing = true;
+        condition.wakeAll();
+    }
+    thread->wait();
+    delete thread;
+    thread = nullptr;
+
+    if(failed)
+        qWarning() << "Writing compressed file" << file.fileName() << "failed";
+    else if(!writeSeekTable())
+        qWarning() << "Writing seek table of" << file.fileName() << "failed";
+
+    file.close();
+    QIODevice::close();
+}
+
+qint64 QDltCompressedWriter::readData(char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+qint64 QDltCompressedWriter::writeData(const char *data, qint64 maxSize)
+{
+    qint64 done = 0;
+    while(done < maxSize)
+    {
+        if(frame.isEmpty())
+            frameTimer.start();
+        qint64 length = qMin(maxSize - done, frameSize - frame.size());
+        frame.append(data + done, length);
+        done += length;
+        if(frame.size() >= frameSize && !completeFrame())
+            return -1;
+    }
+
+    if(!frame.isEmpty() && maxFrameDelay >= 0 && frameTimer.hasExpired(maxFrameDelay) && !completeFrame())
+        return -1;
+
+    uncompressedSize += maxSize;
+    return maxSize;
+}
+
+bool QDltCompressedWriter::completeFrame()
+{
+    QMutexLocker locker(&mutex);
+    while(frames.size() >= MAX_QUEUED_FRAMES && !failed)
+        condition.wait(&mutex);
+    if(failed)
+    {
+        setErrorString("Compression failed");
+        return false;
+    }
+
+    frames.enqueue(frame);
+    frame.clear();
+    frame.reserve(frameSize);
+    condition.wakeAll();
+    return true;
+}
+
+void QDltCompressedWriter::compressFrames()
+{
+#ifdef QDLT_USE_ZSTD
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    QByteArray compressed;
+
+    QMutexLocker locker(&mutex);
+    forever
+    {
+        while(frames.isEmpty() && !finishing)
+            condition.wait(&mutex);
+        if(frames.isEmpty())
+            break;
+        QByteArray data = frames.dequeue();
+        condition.wakeAll();
+        locker.unlock();
+
+        /* each frame is a complete zstd frame with the content size in the header,
+           so it can be decompressed on its own */
+        compressed.resize(ZSTD_compressBound(data.size()));
+        size_t result = ZSTD_compressCCtx(context, compressed.data(), compressed.size(),
+                                          data.constData(), data.size(), compressionLevel);
+        bool ok = !ZSTD_isError(result) && file.write(compressed.constData(), result) == qint64(result) && file.flush();
+
+        locker.relock();
+        if(!ok)
+        {
+            failed = true;
+            frames.clear();
+            condition.wakeAll();
+            break;
+        }
+        seekTable.append(quint32(result));
+        seekTable.append(quint32(data.size()));
+        compressedSize += result;
+    }
+
+    ZSTD_freeCCtx(context);
+#else
+    QMutexLocker locker(&mutex);
+    failed = true;
+    condition.wakeAll();
+#endif
+}
+
+bool QDltCompressedWriter::writeSeekTable()
+{
+    /* skippable frame with one entry per frame and the footer, no checksums */
+    quint32 numberOfFrames = seekTable.size() / 2;
+    QByteArray table;
+    appendUInt32(table, ZSTD_SEEKTABLE_SKIPPABLE_MAGIC);
+    appendUInt32(table, numberOfFrames * 8 + ZSTD_SEEKTABLE_FOOTER_SIZE);
+    for(quint32 value : std::as_const(seekTable))
+        appendUInt32(table, value);
+    appendUInt32(table, numberOfFrames);
+    table.append(char(0));
+    appendUInt32(table, ZSTD_SEEKTABLE_FOOTER_MAGIC);
+
+    return file.write(table) == table.size() && file.flush();
+}
@@ -0,0 +1,153 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltcompressedwriter.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_COMPRESSED_WRITER_H
+#define QDLT_COMPRESSED_WRITER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QIODevice>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "export_rules.h"
+
+class QThread;
+
+//! Write DLT files compressed as seekable zstd frames.
+/*!
+  The data written to the device is split into frames of a fixed uncompressed size.
+  Each complete frame is compressed and written to the file by a background thread,
+  so the thread writing the messages is not blocked by the compression.
+
+  When the device is closed a seek table in the zstd seekable format is appended,
+  QDltCompressedFile uses it to open the file without decompressing it.
+  Files without seek table, e.g. when logging was interrupted, can still be read
+  frame by frame.
+
+  Only new files can be written, appending to an existing file is not supported.
+*/
+class QDLT_EXPORT QDltCompressedWriter : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    //! The constructor.
+    /*!
+      \param parent The parent object.
+    */
+    explicit QDltCompressedWriter(QObject *parent = nullptr);
+
+    //! The destructor, closes the file.
+    ~QDltCompressedWriter() override;
+
+    //! Set the name of the file to be written.
+    /*!
+      \param name The file name.
+    */
+    void setFileName(const QString &name);
+
+    //! Get the name of the file.
+    QString fileName() const;
+
+    //! Set the uncompressed size of a frame.
+    /*!
+      Must be called before open(), default is 4 MB.
+      \param size Size of a frame in bytes.
+    */
+    void setFrameSize(qint64 size);
+
+    //! Complete a frame also when its first data was written this time ago.
+    /*!
+      Used while logging, so a reader of the file gets the messages with a limited delay.
+      Frames are completed only when data is written. Default is -1, frames are completed by size only.
+      \param msecs Time in milliseconds, -1 to disable.
+    */
+    void setMaxFrameDelay(int msecs);
+
+    //! Set the zstd compression level.
+    /*!
+      Must be called before open(), default is 3.
+      \param level The compression level.
+    */
+    void setCompressionLevel(int level);
+
+    //! Create the file and start the compression thread.
+    /*!
+      Only QIODevice::WriteOnly is supported, an existing file is truncated.
+      \param mode The open mode.
+      \return false if the file could not be created or zstd support is not built.
+    */
+    bool open(OpenMode mode) override;
+
+    //! Compress the remaining data, write the seek table and close the file.
+    void close() override;
+
+    //! The device is written sequentially.
+    bool isSequential() const override { return true; }
+
+    //! Get the number of uncompressed bytes written to the device.
+    qint64 getUncompressedSize() const { return uncompressedSize; }
+
+    //! Get the number of compressed bytes already written to the file.
+    qint64 getCompressedSize() const;
+
+    //! Check if the library was built with zstd support.
+    static bool isSupported();
+
+    //! Check if a file name has the extension of files written by this class (.dlt.zst).
+    /*!
+      \param filename The file name to be checked.
+      \return true if the file name ends with .dlt.zst.
+    */
+    static bool isCompressedFileName(const QString &filename);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    bool completeFrame();
+    void compressFrames();
+    bool writeSeekTable();
+
+    QFile file;
+    qint64 frameSize;
+    int maxFrameDelay;
+    int compressionLevel;
+    QByteArray frame;
+    QElapsedTimer frameTimer;
+    qint64 uncompressedSize;
+
+    QThread *thread;
+    mutable QMutex mutex;
+    QWaitCondition condition;
+    /* shared with the compression thread, protected by mutex */
+    QQueue<QByteArray> frames;
+    QVector<quint32> seekTable; // compressed and uncompressed size of each written frame
+    qint64 compressedSize;
+    bool finishing;
+    bool failed;
+};
+
+#endif // QDLT_COMPRESSED_WRITER_H
@@ -21,6 +21,8 @@
 
 #include <QtDebug>
 
+#include <string.h>
+
 #include "qdltconnection.h"
 
 extern "C"
@@ -63,8 +65,8 @@ bool QDltConnection::getSyncSerialHeader() const
 
 void QDltConnection::clear()
 {
-    data.clear();
-    dataView.align(data);
+    buffer.clear();
+    position = 0;
     bytesReceived = 0;
     bytesError = 0;
     syncFound = 0;
@@ -75,187 +77,195 @@ void QDltConnection::add(const QByteArray &bytes)
 {
     bytesReceived += bytes.size();
 
-    QByteArray dataViewArray = dataView;
-    data = dataViewArray + bytes;
+    /* remove the parsed data only when it is at least half of the buffer */
+    if(position > 0 && position >= buffer.size()/2)
+    {
+        buffer.remove(0,position);
+        position = 0;
+    }
+    buffer.append(bytes);
+}
+
+int QDltConnection::messageLength(const char *data, int size, bool supportDLTv2)
+{
+    if(size < 4)
+        return 0;
+
+    const quint8 htyp = quint8(data[0]);
+    if(supportDLTv2 && ((htyp & 0xe0) >> 5) == 2)
+    {
+        /* content information 0x3 is reserved */
+        if((htyp & 0x03) == 0x03)
+            return -1;
+        if(size < 7)
+            return 0;
+        const int len = (quint16(quint8(data[5])) << 8) | quint8(data[6]);
+        return len < 7 ? -1 : len;
+    }
+
+    /* the length is read byte by byte, the data may be unaligned */
+    const int len = (quint16(quint8(data[2])) << 8) | quint8(data[3]);
+    const int headersize = int(sizeof(DltStandardHeader)) + DLT_STANDARD_HEADER_EXTRA_SIZE(htyp) +
+                           (DLT_IS_HTYP_UEH(htyp) ? int(sizeof(DltExtendedHeader)) : 0);
 
-    dataView.align(data);
+    /* a message shorter than its headers has no payload */
+    return qMax(len,headersize);
 }
 
-bool QDltConnection::parseDlt(QDltMsg &msg , bool supportDLTv2)
+bool QDltConnection::followedBySerialHeader(int end) const
 {
-    /* if sync to serial header search for header */
-    int found = 0;
-    int firstPos = 0;
-    int secondPos = 0;
+    /* the data received so far must match the serial header */
+    const int available = qMin(buffer.size()-end,int(sizeof(dltSerialHeader)));
+    return memcmp(buffer.constData()+end,dltSerialHeader,available) == 0;
+}
 
-    char lastFound = 0;
+bool QDltConnection::containsSerialMessage(int start, int end, bool supportDLTv2) const
+{
+    const int found = buffer.indexOf(QByteArray::fromRawData(dltSerialHeader,sizeof(dltSerialHeader)),start);
+    if(found < 0 || found >= end)
+        return false;
 
-    /* Use primitive buffer for faster access */
-    int cbuf_sz = dataView.size();
-    const char *cbuf = dataView.constData();
+    /* the message at the serial header must be complete and followed by the next serial header */
+    const int next = found+sizeof(dltSerialHeader);
+    const int length = messageLength(buffer.constData()+next,buffer.size()-next,supportDLTv2);
+    return length > 0 && buffer.size()-next >= length && followedBySerialHeader(next+length);
+}
 
-    /* find marker in buffer */
-    for(int num=0;num<cbuf_sz;num++) {
-        if(cbuf[num] == 'D')
-        {
-            lastFound = 'D';
-        }
-        else if(lastFound == 'D' && cbuf[num] == 'L')
-        {
-            lastFound = 'L';
-        }
-        else if(lastFound == 'L' && cbuf[num] == 'S')
-        {
-            lastFound = 'S';
-        }
-        else if(lastFound == 'S' && cbuf[num] == 0x01)
+bool QDltConnection::parseDlt(QDltMsg &msg , bool supportDLTv2)
+{
+    const char *cbuf = buffer.constData();
+    const int cbuf_sz = buffer.size();
+
+    while(position < cbuf_sz)
+    {
+        int start = position;
+
+        if(syncSerialHeader)
         {
-            /* header found */
-            found++;
-            if(found==1)
-            {
-                firstPos = num+1;
-                syncFound++;
-            }
-            if(found==2)
+            /* skip data until serial header */
+            const int found = buffer.indexOf(QByteArray::fromRawData(dltSerialHeader,sizeof(dltSerialHeader)),position);
+            if(found < 0)
             {
-                secondPos = num+1;
-                break;
+                /* keep the end of the data, it may be the start of a serial header */
+                const int keep = qMin(cbuf_sz-position,int(sizeof(dltSerialHeader))-1);
+                bytesError += cbuf_sz-keep-position;
+                position = cbuf_sz-keep;
+                return false;
             }
-            lastFound = 0;
+            bytesError += found-position;
+            position = found;
+            start = found+sizeof(dltSerialHeader);
         }
-        else
+        else if(cbuf_sz-position >= int(sizeof(dltSerialHeader)) &&
+                memcmp(cbuf+position,dltSerialHeader,sizeof(dltSerialHeader)) == 0)
         {
-            lastFound = 0;
+            start = position+sizeof(dltSerialHeader);
         }
-        if((!syncSerialHeader) && num==3)
-            break;
-    }
 
-    if(syncSerialHeader && !found)
-    {
-        /* complete sync header not found */
-        if(!lastFound)
+        const int length = messageLength(cbuf+start,cbuf_sz-start,supportDLTv2);
+        if(length < 0)
         {
-            /* clear buffer if even not start of sync header found */
-            bytesError += dataView.size();
-            dataView.clear();
+            /* invalid header, search the next message from the next byte */
+            bytesError++;
+            position++;
+            continue;
         }
-        return false;
-    }
-
-    //qDebug() << "found " << found << " firstPos " << firstPos << " secondPos " << secondPos;
-
-    if(found==2)
-    {
-        /* two sync headers found */
-        /* try to read msg */
-        if(!msg.setMsg(dataView.mid(firstPos,secondPos-firstPos-4),false,supportDLTv2))
+        if(length == 0 || cbuf_sz-start < length)
         {
-            /* no valid msg found, perhaps to short */
-            dataView.advance(secondPos-4);
-            /* errors found */
-            bytesError += secondPos-4;
+            /* a corrupted length would wait for the data of the next messages,
+               resync when a complete message with serial header follows */
+            if(syncSerialHeader && length > 0 && containsSerialMessage(start,cbuf_sz,supportDLTv2))
+            {
+                bytesError++;
+                position++;
+                continue;
+            }
+            /* message not completely received */
             return false;
         }
-        else
+
+        if(start > position)
+            syncFound++;
+
+        /* copy the message, msg keeps parts of the data which is moved by add() */
+        const bool valid = msg.setMsg(QByteArray(cbuf+start,length),false,supportDLTv2);
+        if(valid && !(syncSerialHeader && containsSerialMessage(start,start+length,supportDLTv2)))
         {
-            /* msg read successful */
-            dataView.advance(secondPos-4);
-            if(firstPos>4)
-                /* errors found */
-                bytesError += firstPos-4;
+            position = start+length;
             return true;
         }
 
-    }
-
-    if(firstPos>4)
-        /* errors found */
-        bytesError += firstPos-4;
-
-    /* try to read msg */
-    if(!msg.setMsg(dataView.mid(firstPos),false,supportDLTv2))
-    {
-        /* no complete msg found */
-        /* perhaps not completely received */
-        /* check valid size */
-        if(dataView.size()>DLT_MAX_MESSAGE_LEN)
+        if(syncSerialHeader)
         {
-            /* size exceeds max DLT message size */
-            /* clear buffer */
-            /* errors found */
-            bytesError += dataView.size();
-            dataView.clear();
+            /* the length is corrupted, resync at the next serial header */
+            bytesError++;
+            position++;
+            continue;
         }
-        return false;
+
+        /* errors found */
+        bytesError += start+length-position;
+        position = start+length;
     }
 
-    /* msg read successful */
-    dataView.advance(firstPos+msg.getHeaderSize()+msg.getPayloadSize());
-    return true;
+    return false;
 }
 
 bool QDltConnection::parseAscii(QDltMsg &msg)
 {
-    bool success = false;
+    const char *cbuf = buffer.constData();
+    const int cbuf_sz = buffer.size();
 
-    /* Use primitive buffer for faster access */
-    int cbuf_sz = dataView.size();
-    const char *cbuf = dataView.constData();
-
-    /* find end of line in buffer */
-    for(int num=0;num<cbuf_sz;num++) {
-        if(cbuf[num] == '\r' || cbuf[num] == '\n')
+    while(position < cbuf_sz)
+    {
+        /* find end of line in buffer */
+        int num = position;
+        while(num < cbuf_sz && cbuf[num] != '\r' && cbuf[num] != '\n')
+            num++;
+        if(num == cbuf_sz)
         {
-            // end of line found
-
-            // check if line is empty, do not store empty lines
-            if(num!=0)
-            {
-                // set parameters of DLT message to be generated
-                msg.clear();
-                msg.setEcuid("");
-                msg.setApid("SER");
-                msg.setCtid("ASC");
-                msg.setMode(QDltMsg::DltModeVerbose);
-                msg.setType(QDltMsg::DltTypeLog);
-                msg.setSubtype(QDltMsg::DltLogInfo);
-                msg.setMessageCounter(messageCounter++);
-                msg.setNumberOfArguments(1);
-
-                // add one argument as String
-                QDltArgument arg;
-                arg.setTypeInfo(QDltArgument::DltTypeInfoStrg);
-                arg.setEndianness(QDlt::DltEndiannessLittleEndian);
-                arg.setOffsetPayload(0);
-                arg.setData(QByteArray(cbuf,num)+QByteArray("",1));
-                msg.addArgument(arg);
-
-                // generate binary payload and header of DLT message
-                msg.genMsg();
-
-                // succesful found a new line to be written as DLT message
-                success = true;
-            }
+            // no message found
+            return false;
+        }
 
-            // remove parsed line from buffer
-            if( (num < (cbuf_sz-1)) && (cbuf[num+1] == '\n' || cbuf[num+1] == '\r'))
-            {
-                // \n and \r found, remove two additional characters
-                dataView.advance(num+2);
-            }
-            else
-            {
-                // only \n or \r found, remove only one character
-                dataView.advance(num+1);
-            }
+        const int start = position;
 
-            // msg read successful
-            return success;
-        }
+        // remove parsed line from buffer, \n and \r found remove two characters
+        if(num < (cbuf_sz-1) && (cbuf[num+1] == '\n' || cbuf[num+1] == '\r'))
+            position = num+2;
+        else
+            position = num+1;
+
+        // check if line is empty, do not store empty lines
+        if(num == start)
+            continue;
+
+        // set parameters of DLT message to be generated
+        msg.clear();
+        msg.setEcuid("");
+        msg.setApid("SER");
+        msg.setCtid("ASC");
+        msg.setMode(QDltMsg::DltModeVerbose);
+        msg.setType(QDltMsg::DltTypeLog);
+        msg.setSubtype(QDltMsg::DltLogInfo);
+        msg.setMessageCounter(messageCounter++);
+        msg.setNumberOfArguments(1);
+
+        // add one argument as String
+        QDltArgument arg;
+        arg.setTypeInfo(QDltArgument::DltTypeInfoStrg);
+        arg.setEndianness(QDlt::DltEndiannessLittleEndian);
+        arg.setOffsetPayload(0);
+        arg.setData(QByteArray(cbuf+start,num-start)+QByteArray("",1));
+        msg.addArgument(arg);
+
+        // generate binary payload and header of DLT message
+        msg.genMsg();
+
+        // succesful found a new line to be written as DLT message
+        return true;
     }
 
     // no message found
-    return success;
+    return false;
 }
@@ -98,14 +98,28 @@ public:
     void setSyncSerialHeader(bool _syncSerialHeader);
     bool getSyncSerialHeader() const;
 
+    //! Get the next complete DLT message of the received data.
+    /*!
+      The length of the message is read from its standard header, the message is
+      only decoded when all its bytes are received.
+      With serial header sync, an invalid message or a message containing a further
+      complete message with serial header has a corrupted length. The parser then
+      resyncs at the next serial header instead of skipping the length.
+      \param msg Set to the message.
+      \param supportDLTv2 also accept DLT protocol version 2 messages
+      \return true if a message was found, false if more data is needed.
+    */
     bool parseDlt(QDltMsg &msg,bool supportDLTv2 = false);
     bool parseAscii(QDltMsg &msg);
 
     void clear();
-    void add(const QByteArray &bytes);
 
-    QByteArray data;
-    QDltDataView dataView = {data};
+    //! Add received data.
+    /*!
+      The parsed data is removed when it is at least half of the buffer,
+      so each received byte is moved at most once on average.
+    */
+    void add(const QByteArray &bytes);
 
     unsigned long bytesReceived;
     unsigned long bytesError;
@@ -118,6 +132,14 @@ protected:
 
 private:
 
+    static int messageLength(const char *data,int size,bool supportDLTv2);
+    bool followedBySerialHeader(int end) const;
+    bool containsSerialMessage(int start,int end,bool supportDLTv2) const;
+
+    /* received data, parsed up to position */
+    QByteArray buffer;
+    int position;
+
     unsigned char messageCounter;
 
 };
@@ -19,6 +19,7 @@
  * @licence end@
  */
 
+#include <QMutexLocker>
 #include <QtDebug>
 
 #include "qdltcontrol.h"
@@ -129,3 +130,15 @@ void QDltControl::reopenFile()
 {
     emit reopenFileSignal();
 }
+
+QMap<QString,quint64> QDltControl::getShedMessages() const
+{
+    QMutexLocker locker(&mutex);
+    return shedMessages;
+}
+
+void QDltControl::setShedMessages(const QMap<QString,quint64> &shed)
+{
+    QMutexLocker locker(&mutex);
+    shedMessages = shed;
+}
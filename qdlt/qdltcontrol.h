@@ -27,6 +27,7 @@
 #include <QString>
 #include <QFile>
 #include <QDateTime>
+#include <QMap>
 #include <QMutex>
 #include <time.h>
 
@@ -53,6 +54,16 @@ public:
     void disconnectEcu(int index);
     void connectAllEcu();
     void disconnectAllEcu();
+
+    //! Get the number of live messages shed by the overload policy.
+    /*!
+      \return The number of shed messages per ECU and application, the keys are "ECU:APID".
+    */
+    QMap<QString,quint64> getShedMessages() const;
+
+    //! Set the number of shed live messages, called by the viewer.
+    void setShedMessages(const QMap<QString,quint64> &shed);
+
     bool silentmode;
     bool commandlinemode;
 
@@ -75,6 +86,9 @@ protected:
 private:
     QObject *server;
 
+    mutable QMutex mutex;
+    QMap<QString,quint64> shedMessages;
+
 };
 
 
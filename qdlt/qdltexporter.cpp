@@ -1,9 +1,15 @@
 #include <algorithm>
+#include <utility>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
+#include <QQueue>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include "qdltexporter.h"
+#include "qdltfilereader.h"
 #include "fieldnames.h"
 #include "qdltoptmanager.h"
 
@@ -15,6 +21,9 @@ QDltExporter::QDltExporter(QDltFile *from, QString outputfileName, QDltPluginMan
     size = 0;
     starting_index=0;
     stoping_index=0;
+    timeRange = false;
+    startTime = 0;
+    stopTime = 0;
     automaticTimeSettings=_automaticTimeSettings;
     utcOffset=_utcOffset;
     dst=_dst;
@@ -29,6 +38,15 @@ QDltExporter::QDltExporter(QDltFile *from, QString outputfileName, QDltPluginMan
     this->selection = selection;
 
     this->signature = signature;
+
+    workerThreads = qMax(1, QThread::idealThreadCount());
+    statisticsEnabled = false;
+    readRange = 0;
+    readNum = 0;
+    readEnd = 0;
+    streamFileIndex = -1;
+    streamTotalSize = 0;
+    streamDoneSize = 0;
 }
 
 void QDltExporter::run()
@@ -129,7 +147,7 @@ bool QDltExporter::writeCSVHeader()
     return true;
 }
 
-void QDltExporter::writeCSVLine(int index, QDltMsg msg,QFile &to)
+void QDltExporter::writeCSVLine(int index, QDltMsg &msg,QByteArray &out)
 {
     QString text("");
 
@@ -187,7 +205,7 @@ void QDltExporter::writeCSVLine(int index, QDltMsg msg,QFile &to)
     }
     text += "\n";
 
-    to.write(text.toLatin1().constData());
+    out.append(text.toLatin1().constData());
 }
 
 bool QDltExporter::startExport()
@@ -240,6 +258,7 @@ bool QDltExporter::startExport()
                     qDebug() << "Multifilter export filename: " << file->fileName();
                     multifilterFilesList.append(file);
                     multifilterFilterList.append(filterList);
+                    multifilterRouter.addOutput(*filterList);
                 }
                 else
                 {
@@ -251,11 +270,23 @@ bool QDltExporter::startExport()
 
         }
     }
-    else if((exportFormat == QDltExporter::FormatDlt)||(exportFormat == QDltExporter::FormatDltDecoded))
+    else if((exportFormat == QDltExporter::FormatDlt)||(exportFormat == QDltExporter::FormatDltDecoded)||
+            (exportFormat == QDltExporter::FormatParquet))
     {
         if(multifilterFilenames.isEmpty())
         {
-            if(!to.open(QIODevice::WriteOnly))
+            /* compressed DLT export, the frames are compressed by a background thread */
+            if(exportFormat != QDltExporter::FormatParquet && QDltCompressedWriter::isCompressedFileName(to.fileName()))
+            {
+                compressedTo.setFileName(to.fileName());
+                if(!compressedTo.open(QIODevice::WriteOnly))
+                {
+                    if (QDltOptManager::getInstance()->issilentMode())
+                        qDebug() << QString("ERROR - cannot open the export file %1").arg(to.fileName());
+                    return false;
+                }
+            }
+            else if(!to.open(QIODevice::WriteOnly))
             {
                 if (QDltOptManager::getInstance()->issilentMode())
                     qDebug() << QString("ERROR - cannot open the export file %1").arg(to.fileName());
@@ -269,7 +300,10 @@ bool QDltExporter::startExport()
                 QFileInfo info(filename);
                 info.baseName();
                 QFile *file;
-                file = new QFile(to.fileName()+"/"+info.baseName()+".dlt");
+                if(exportFormat == QDltExporter::FormatParquet)
+                    file = new QFile(to.fileName()+"/"+info.baseName()+".parquet");
+                else
+                    file = new QFile(to.fileName()+"/"+info.baseName()+".dlt");
                 QDltFilterList *filterList = new QDltFilterList();
                 if(!filterList->LoadFilter(filename,true))
                     qDebug() << "Export: Open filter file " << filename << " failed!";
@@ -278,6 +312,7 @@ bool QDltExporter::startExport()
                 {
                     multifilterFilesList.append(file);
                     multifilterFilterList.append(filterList);
+                    multifilterRouter.addOutput(*filterList);
                 }
                 else
                 {
@@ -290,6 +325,26 @@ bool QDltExporter::startExport()
         }
     }
 
+    /* write Parquet file header, the columns are collected and written in row groups */
+    if(exportFormat == QDltExporter::FormatParquet)
+    {
+        if(multifilterFilenames.isEmpty())
+            parquetWriters.append(new QDltParquetWriter(&to));
+        else
+        {
+            for(auto file : std::as_const(multifilterFilesList))
+                parquetWriters.append(new QDltParquetWriter(file));
+        }
+        for(auto writer : std::as_const(parquetWriters))
+        {
+            if(!writer->start())
+            {
+                qDebug() << QString("ERROR - cannot write the export file %1").arg(to.fileName());
+                return false;
+            }
+        }
+    }
+
     /* write CSV header if CSV export */
     if(exportFormat == QDltExporter::FormatCsv)
     {
@@ -333,15 +388,32 @@ bool QDltExporter::startExport()
 
 bool QDltExporter::finish()
 {
+    bool result = true;
+
+    /* write remaining rows and footer before the files are closed */
+    for(auto writer : std::as_const(parquetWriters))
+    {
+        if(!writer->finish())
+        {
+            qDebug() << "Export: Writing Parquet file failed!";
+            result = false;
+        }
+        delete writer;
+    }
+    parquetWriters.clear();
 
     if(exportFormat == QDltExporter::FormatAscii ||
        exportFormat == QDltExporter::FormatUTF8 ||
        exportFormat == QDltExporter::FormatCsv ||
        exportFormat == QDltExporter::FormatDlt ||
-       exportFormat == QDltExporter::FormatDltDecoded)
+       exportFormat == QDltExporter::FormatDltDecoded ||
+       exportFormat == QDltExporter::FormatParquet)
     {
         if(multifilterFilenames.isEmpty())
+        {
+            compressedTo.close();
             to.close();
+        }
         else
         {
             for(auto file : multifilterFilesList)
@@ -355,6 +427,7 @@ bool QDltExporter::finish()
             }
             multifilterFilterList.clear();
             multifilterFilesList.clear();
+            multifilterRouter.clear();
         }
     }
     else if (exportFormat == QDltExporter::FormatClipboard ||
@@ -372,60 +445,65 @@ bool QDltExporter::finish()
         emit clipboard(clipboardString);
     }
 
-    return true;
+    return result;
 }
 
-bool QDltExporter::getMsg(unsigned long int num,QDltMsg &msg,QByteArray &buf)
+bool QDltExporter::isInTimeRange(const QDltMsg &msg) const
+{
+    const qint64 time = qint64(msg.getTime()) * 1000000 + msg.getMicroseconds();
+    return time >= startTime && time <= stopTime;
+}
+
+int QDltExporter::getMsgIndex(unsigned long int num) const
 {
-    bool result;
-    buf.clear();
     if(exportSelection == QDltExporter::SelectionAll)
-    {
-        buf = from->getMsg(num);
-        if( true == buf.isEmpty())
-        {
-            qDebug() << "Buffer empty in" << __FILE__ << __LINE__;
-            return false;
-        }
-        result =  msg.setMsg(buf);
-        msg.setIndex(num);
-    }
+        return num;
     else if(exportSelection == QDltExporter::SelectionFiltered)
+        return from->getMsgFilterPos(num);
+    else if(exportSelection == QDltExporter::SelectionSelected)
+        return from->getMsgFilterPos(selectedRows.at(num));
+
+    qDebug() << "Unhandled error in" << __FILE__ << __LINE__;
+    return -1;
+}
+
+bool QDltExporter::getMsg(int index,QDltMsg &msg,QByteArray &buf)
+{
+    if(exportFormat != QDltExporter::FormatDlt)
     {
-        buf = from->getMsgFilter(num);
-        if( true == buf.isEmpty())
+        // decoded message is shared with the views, but do not flood the cache with the whole export
+        if(!streamInputFiles.isEmpty() || !from->getMsgCache()->get(index,msg))
         {
-            qDebug() << "Buffer empty in" << __FILE__ << __LINE__;
-            return false;
+            if(buf.isEmpty() || !msg.setMsg(buf,true,from->getDLTv2Support()))
+                return false;
+            msg.setIndex(index);
+            if(pluginManager)
+                pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
         }
-        result =  msg.setMsg(buf);
-        msg.setIndex(from->getMsgFilterPos(num));
-    }
-    else if(exportSelection == QDltExporter::SelectionSelected)
-    {
-        buf = from->getMsgFilter(selectedRows[num]);
-        if( true == buf.isEmpty())
+        if(exportFormat == QDltExporter::FormatDltDecoded)
         {
-            qDebug() << "Buffer empty in" << __FILE__ << __LINE__;
-            return false;
+            msg.setNumberOfArguments(msg.sizeArguments());
+            msg.getMsg(buf,true);
         }
-        result =  msg.setMsg(buf);
-        msg.setIndex(from->getMsgFilterPos(selectedRows[num]));
+        return true;
     }
-    else
+
+    if( true == buf.isEmpty())
     {
-        qDebug() << "Unhandled error in" << __FILE__ << __LINE__;
+        qDebug() << "Buffer empty in" << __FILE__ << __LINE__;
         return false;
     }
+    bool result = msg.setMsg(buf,true,from->getDLTv2Support());
+    msg.setIndex(index);
 
     return result;
 }
 
-bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &buf,QFile &to)
+bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &buf,QByteArray &out)
 {
     if((exportFormat == QDltExporter::FormatDlt)||(exportFormat == QDltExporter::FormatDltDecoded))
     {
-        to.write(buf);
+        out.append(buf);
     }
     else if(exportFormat == QDltExporter::FormatAscii ||
             exportFormat == QDltExporter::FormatUTF8  ||
@@ -442,7 +520,7 @@ bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &bu
             else if(exportSelection == QDltExporter::SelectionFiltered)
                 text += QString("%1 ").arg(from->getMsgFilterPos(num));
             else if(exportSelection == QDltExporter::SelectionSelected)
-                text += QString("%1 ").arg(from->getMsgFilterPos(selectedRows[num]));
+                text += QString("%1 ").arg(from->getMsgFilterPos(selectedRows.at(num)));
             else
                 return false;
             if( automaticTimeSettings == 0 )
@@ -470,12 +548,12 @@ bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &bu
          {
             if(exportFormat == QDltExporter::FormatAscii)
                 /* write to file */
-                to.write(text.toLatin1().constData());
+                out.append(text.toLatin1().constData());
             else if (exportFormat == QDltExporter::FormatUTF8)
-                to.write(text.toUtf8().constData());
+                out.append(text.toUtf8().constData());
             else if(exportFormat == QDltExporter::FormatClipboard ||
                     exportFormat == QDltExporter::FormatClipboardPayloadOnly)
-                clipboardString += text;
+                out.append(text.toUtf8());
          }
         catch (...)
          {
@@ -484,11 +562,11 @@ bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &bu
     else if(exportFormat == QDltExporter::FormatCsv)
     {
         if(exportSelection == QDltExporter::SelectionAll)
-            writeCSVLine(num, msg,to);
+            writeCSVLine(num, msg,out);
         else if(exportSelection == QDltExporter::SelectionFiltered)
-            writeCSVLine(from->getMsgFilterPos(num), msg,to);
+            writeCSVLine(from->getMsgFilterPos(num), msg,out);
         else if(exportSelection == QDltExporter::SelectionSelected)
-            writeCSVLine(from->getMsgFilterPos(selectedRows[num]), msg,to);
+            writeCSVLine(from->getMsgFilterPos(selectedRows.at(num)), msg,out);
         else
             return false;
     }
@@ -502,7 +580,7 @@ bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &bu
         else if(exportSelection == QDltExporter::SelectionFiltered)
             text += QString("%1").arg(from->getMsgFilterPos(num));
         else if(exportSelection == QDltExporter::SelectionSelected)
-            text += QString("%1").arg(from->getMsgFilterPos(selectedRows[num]));
+            text += QString("%1").arg(from->getMsgFilterPos(selectedRows.at(num)));
         else
             return false;
 
@@ -518,11 +596,32 @@ bool QDltExporter::exportMsg(unsigned long int num, QDltMsg &msg, QByteArray &bu
                 "|" + msg.getCtid() +
                 "|" + payload.replace('|', "\\|").replace('#', "\\#").replace('*', "\\*") +
                 "| |\n";
-        clipboardString += text;
+        out.append(text.toUtf8());
     }
     return true;
 }
 
+QDltParquetWriter::Row QDltExporter::createParquetRow(unsigned long int num, QDltMsg &msg)
+{
+    QDltParquetWriter::Row row;
+    row.index = getMsgIndex(num);
+    row.time = qint64(msg.getTime()) * 1000000 + msg.getMicroseconds();
+    row.timestamp = msg.getTimestamp();
+    row.counter = msg.getMessageCounter();
+    row.ecuid = msg.getEcuid().simplified().toUtf8();
+    row.apid = msg.getApid().simplified().toUtf8();
+    row.ctid = msg.getCtid().simplified().toUtf8();
+    row.sessionid = msg.getSessionid();
+    row.type = msg.getType();
+    row.subtype = msg.getSubtype();
+    row.mode = msg.getMode();
+    row.args = msg.getNumberOfArguments();
+    QString payload = msg.toStringPayload().simplified().remove(QChar::Null);
+    if(from) from->applyRegExString(msg,payload);
+    row.payload = payload.toUtf8();
+    return row;
+}
+
 
 void QDltExporter::exportMessageRange(unsigned long start, unsigned long stop)
 {
@@ -530,6 +629,13 @@ void QDltExporter::exportMessageRange(unsigned long start, unsigned long stop)
     this->stoping_index=stop;
 }
 
+void QDltExporter::exportTimeRange(qint64 start, qint64 stop)
+{
+    this->timeRange=true;
+    this->startTime=start;
+    this->stopTime=stop;
+}
+
 void QDltExporter::setFilterList(QDltFilterList &filterList)
 {
     this->filterList = filterList;
@@ -540,10 +646,270 @@ void QDltExporter::setMultifilterFilenames(QStringList multifilterFilenames)
     this->multifilterFilenames=multifilterFilenames;
 }
 
-void QDltExporter::exportMessages()
+void QDltExporter::setStreamInputFiles(const QStringList &filenames)
 {
-    QDltMsg msg;
+    this->streamInputFiles = filenames;
+}
+
+/* number of messages read, decoded and formatted as one unit by a worker thread */
+#define EXPORT_BATCH_SIZE 1024
+
+struct QDltExporter::ExportBatch
+{
+    QVector<unsigned long int> nums;
+    QVector<int> indexes;
+    QVector<QByteArray> buffers;
+    QVector<QByteArray> outputs; // formatted data for each output file
+    QVector<QVector<QDltParquetWriter::Row>> rows; // rows for each output file in Parquet format
+    QVector<int> matches; // outputs of the current message in multifilter mode
+    int progress = 0;
+    int readErrors = 0;
+    int exportErrors = 0;
+    int exportCounter = 0;
+    bool measure = false; // collect the statistics of the worker stages
+    QDltExporter::Statistics statistics;
+    bool done = false;
+};
+
+namespace {
+
+void addStatistics(QDltExporter::StageStatistics &sum, const QDltExporter::StageStatistics &stage)
+{
+    sum.nsecs += stage.nsecs;
+    sum.messages += stage.messages;
+    sum.bytes += stage.bytes;
+}
+
+}
+
+class QDltExporter::BatchRunnable : public QRunnable
+{
+public:
+    BatchRunnable(QDltExporter *exporter, ExportBatch *batch) : exporter(exporter), batch(batch) {}
+
+    void run() override
+    {
+        exporter->processBatch(*batch);
+
+        QMutexLocker locker(&exporter->batchMutex);
+        batch->done = true;
+        exporter->batchCondition.wakeAll();
+    }
+
+private:
+    QDltExporter *exporter;
+    ExportBatch *batch;
+};
+
+void QDltExporter::setWorkerThreadCount(int count)
+{
+    workerThreads = count > 0 ? count : 1;
+}
+
+void QDltExporter::setStatisticsEnabled(bool enabled)
+{
+    statisticsEnabled = enabled;
+}
+
+void QDltExporter::exportMsgToOutput(unsigned long int num, QDltMsg &msg, QByteArray &buf, ExportBatch &batch, int output)
+{
+    if(exportFormat == QDltExporter::FormatParquet)
+    {
+        batch.rows[output].append(createParquetRow(num,msg));
+        batch.exportCounter++;
+    }
+    else if(!exportMsg(num,msg,buf,batch.outputs[output]))
+        batch.exportErrors++;
+    else
+        batch.exportCounter++;
+}
+
+void QDltExporter::filterAndExportMsg(unsigned long int num, QDltMsg &msg, QByteArray &buf, ExportBatch &batch)
+{
+    QElapsedTimer timer;
+    if(batch.measure)
+        timer.start();
+
+    // apply Regex if needed
+    if(exportFormat == QDltExporter::FormatDlt || exportFormat == QDltExporter::FormatDltDecoded)
+    {
+        //FIXME: The following does not work for non verbose messages, must be fixed to enable RegEx for DLT Export again
+        //msg.setNumberOfArguments(msg.sizeArguments());
+        bool isApplied = false;
+        if(from) isApplied = from->applyRegExStringMsg(msg);
+        if(isApplied) msg.getMsg(buf,true);
+    }
+
+    const bool matches = filterList.isEmpty() || filterList.checkFilter(msg);
+
+    // all filter files are evaluated together, shared filters only once
+    if(matches && !multifilterFilenames.isEmpty())
+        multifilterRouter.route(msg,batch.matches);
+
+    if(batch.measure)
+    {
+        batch.statistics.filter.nsecs += timer.nsecsElapsed();
+        batch.statistics.filter.messages++;
+        timer.start();
+    }
+    if(!matches)
+        return;
+
+    // export message
+    if(multifilterFilenames.isEmpty())
+    {
+        exportMsgToOutput(num,msg,buf,batch,0);
+    }
+    else
+    {
+        for(int filterNum : std::as_const(batch.matches))
+            exportMsgToOutput(num,msg,buf,batch,filterNum);
+    }
+
+    if(batch.measure)
+    {
+        batch.statistics.format.nsecs += timer.nsecsElapsed();
+        batch.statistics.format.messages++;
+    }
+}
+
+bool QDltExporter::readBatch(ExportBatch &batch)
+{
+    if(streamInputFiles.isEmpty())
+    {
+        while(batch.nums.size() < EXPORT_BATCH_SIZE && readRange < readRanges.size())
+        {
+            if(readNum >= readRanges[readRange].second)
+            {
+                // continue with the range of the next file
+                if(++readRange < readRanges.size())
+                    readNum = readRanges[readRange].first;
+                continue;
+            }
+            batch.nums.append(readNum);
+            batch.indexes.append(getMsgIndex(readNum));
+            readNum++;
+        }
+        if(batch.nums.isEmpty())
+            return false;
+
+        // one sorted pass over the file instead of a seek for each message
+        batch.buffers = from->getMsgBatch(batch.indexes);
+        batch.progress = ( readNum * 100.0 ) / readEnd;
+        return true;
+    }
+
+    /* stream input files, index is the running number of the message */
     QByteArray buf;
+    while(batch.nums.size() < EXPORT_BATCH_SIZE)
+    {
+        if(streamFileIndex < 0 || !streamReader.readMsg(buf))
+        {
+            if(streamFileIndex >= streamInputFiles.size())
+                break;
+            if(streamFileIndex >= 0)
+            {
+                if(streamReader.getErrors() > 0)
+                    qDebug() << "Export:" << streamReader.getErrors() << "corrupted sections skipped in" << streamInputFiles[streamFileIndex];
+                streamDoneSize += streamReader.getFileSize();
+                streamReader.close();
+            }
+            if(++streamFileIndex >= streamInputFiles.size())
+                break;
+            if(!streamReader.open(streamInputFiles[streamFileIndex]))
+            {
+                qDebug() << "Export: Open stream input file" << streamInputFiles[streamFileIndex] << "failed!";
+                batch.readErrors++;
+            }
+            continue;
+        }
+        batch.nums.append(readNum);
+        batch.indexes.append(readNum);
+        batch.buffers.append(buf);
+        readNum++;
+    }
+    if(streamTotalSize > 0)
+        batch.progress = ( (streamDoneSize + streamReader.getPosition()) * 100 ) / streamTotalSize;
+    return !batch.nums.isEmpty() || batch.readErrors > 0;
+}
+
+void QDltExporter::processBatch(ExportBatch &batch)
+{
+    QDltMsg msg;
+    QElapsedTimer timer;
+    for(int num=0;num<batch.nums.size();num++)
+    {
+        QByteArray &buf = batch.buffers[num];
+        const int rawSize = buf.size();
+        if(batch.measure)
+            timer.start();
+
+        // get message, it is decoded if needed
+        if(false == getMsg(batch.indexes[num],msg,buf))
+        {
+            batch.readErrors++;
+            continue;
+        }
+
+        if(batch.measure)
+        {
+            batch.statistics.decode.nsecs += timer.nsecsElapsed();
+            batch.statistics.decode.messages++;
+            batch.statistics.decode.bytes += rawSize;
+        }
+
+        // the storage header times are not ascending in every file
+        if(timeRange && !isInTimeRange(msg))
+            continue;
+
+        filterAndExportMsg(batch.nums[num],msg,buf,batch);
+    }
+
+    if(batch.measure)
+    {
+        for(const auto &output : std::as_const(batch.outputs))
+            batch.statistics.format.bytes += output.size();
+    }
+
+    // raw data is not needed anymore, only the formatted output is kept until written
+    batch.buffers.clear();
+}
+
+void QDltExporter::writeBatch(ExportBatch &batch)
+{
+    if(exportFormat == QDltExporter::FormatClipboard ||
+       exportFormat == QDltExporter::FormatClipboardPayloadOnly ||
+       exportFormat == QDltExporter::FormatClipboardJiraTable ||
+       exportFormat == QDltExporter::FormatClipboardJiraTableHead)
+    {
+        for(const auto &output : std::as_const(batch.outputs))
+            clipboardString += QString::fromUtf8(output);
+    }
+    else if(exportFormat == QDltExporter::FormatParquet)
+    {
+        for(int num=0;num<parquetWriters.size() && num<batch.rows.size();num++)
+        {
+            for(const auto &row : std::as_const(batch.rows[num]))
+                parquetWriters[num]->addRow(row);
+        }
+    }
+    else if(compressedTo.isOpen())
+    {
+        compressedTo.write(batch.outputs[0]);
+    }
+    else if(multifilterFilenames.isEmpty())
+    {
+        to.write(batch.outputs[0]);
+    }
+    else
+    {
+        for(int num=0;num<multifilterFilesList.size();num++)
+            multifilterFilesList[num]->write(batch.outputs[num]);
+    }
+}
+
+void QDltExporter::exportMessages()
+{
     float percent=0;
     QString qszPercent;
     /* initialise values */
@@ -554,6 +920,10 @@ void QDltExporter::exportMessages()
     clipboardString.clear();
     unsigned long int starting = 0;
     unsigned long int stoping = this->size;
+    statistics = Statistics();
+    QElapsedTimer exportTimer;
+    QElapsedTimer stageTimer;
+    exportTimer.start();
 
     /* start export */
     if(false == startExport())
@@ -578,95 +948,147 @@ void QDltExporter::exportMessages()
         qDebug() << "Start DLT export" << stoping - starting << "messages" << "of" << this->size << "range: " << starting << "-" << stoping << ",silent mode" << !silentMode;
     }
 
+    /* binary search of the time range in the time index of each file, the messages outside are not read,
+       the storage header time of each message is checked as well */
+    readRanges.clear();
+    readRanges.append(qMakePair(starting, stoping));
+    if(timeRange && streamInputFiles.isEmpty() && (exportSelection == QDltExporter::SelectionAll ||
+       (exportSelection == QDltExporter::SelectionFiltered && from->isIndexFilterSorted())))
+    {
+        readRanges.clear();
+        const QVector<QPair<int,int>> fileRanges = from->findMsgRangesByTime(startTime, stopTime);
+        for(const auto &fileRange : fileRanges)
+        {
+            unsigned long int first = fileRange.first;
+            unsigned long int last = fileRange.second;
+            if(exportSelection == QDltExporter::SelectionFiltered)
+            {
+                first = from->findMsgFilterPos(first);
+                last = from->findMsgFilterPos(last);
+            }
+            first = std::max(starting, first);
+            last = std::min(stoping, last);
+            if(first < last)
+                readRanges.append(qMakePair(first, last));
+        }
+        qDebug() << "DLT export of time range" << startTime << "-" << stopTime << "limited to" << readRanges.size() << "ranges";
+    }
+
     /* init fileprogress */
 
     int progressCounter = 1;
     emit progress("Exp",1,0);
 
-    for(;starting<stoping;starting++)
+    /* init reader */
+    readRange = 0;
+    readNum = readRanges.isEmpty() ? stoping : readRanges.first().first;
+    readEnd = stoping;
+    streamFileIndex = -1;
+    streamTotalSize = 0;
+    streamDoneSize = 0;
+    for(const auto &filename : std::as_const(streamInputFiles))
+        streamTotalSize += QFileInfo(filename).size();
+    if(!streamInputFiles.isEmpty())
+        qDebug() << "Start DLT stream export of" << streamInputFiles.size() << "files with" << streamTotalSize << "bytes";
+
+    /* Pipeline: this thread reads batches of messages in file order, the worker threads decode,
+       filter and format each batch into its own output buffer and this thread writes the
+       finished batches in the order they were read. */
+    int outputCount = multifilterFilenames.isEmpty() ? 1 : multifilterFilesList.size();
+    QThreadPool pool;
+    pool.setMaxThreadCount(workerThreads);
+    QQueue<ExportBatch*> batches;
+    bool endOfInput = false;
+
+    while(true)
     {
-        int percent = (( starting * 100.0 ) /stoping );
-        if(percent>=progressCounter)
+        // keep enough batches in flight to keep all workers busy, limits memory usage too
+        while(!endOfInput && batches.size() < 2 * workerThreads)
         {
-            progressCounter += 1;
-            emit progress("Exp:",2,percent); // every 1%
-            if((percent>0) && ((percent%10)==0))
-                qDebug() << "Exported:" << percent << "%"; // every 10%
+            ExportBatch *batch = new ExportBatch();
+            batch->outputs.resize(outputCount);
+            if(exportFormat == QDltExporter::FormatParquet)
+                batch->rows.resize(outputCount);
+            batch->measure = statisticsEnabled;
+            stageTimer.start();
+            if(!readBatch(*batch))
+            {
+                delete batch;
+                endOfInput = true;
+                break;
+            }
+            if(statisticsEnabled)
+            {
+                statistics.read.nsecs += stageTimer.nsecsElapsed();
+                statistics.read.messages += batch->nums.size();
+                for(const auto &buf : std::as_const(batch->buffers))
+                    statistics.read.bytes += buf.size();
+            }
+            batches.enqueue(batch);
+            pool.start(new BatchRunnable(this,batch));
         }
 
-        // TODO: Handle cancel operation
+        if(batches.isEmpty())
+            break;
 
-        // get message
-        if(false == getMsg(starting,msg,buf))
+        // wait for the oldest batch, later batches may already be finished
+        ExportBatch *batch = batches.dequeue();
         {
-        //  finish();
-        //qDebug() << "DLT Export getMsg failed on msg index" << starting;
-        readErrors++;
-        continue;
-        //  return;
-        }
-        // decode message if needed
-        if(exportFormat != QDltExporter::FormatDlt)
-        {
-            //FIXME: The following does not work for non verbose messages, must be fixed
-            if(pluginManager)
-                pluginManager->decodeMsg(msg,silentMode);
-            if (exportFormat == QDltExporter::FormatDltDecoded)
-            {
-                msg.setNumberOfArguments(msg.sizeArguments());
-                msg.getMsg(buf,true);
-            }
+            QMutexLocker locker(&batchMutex);
+            while(!batch->done)
+                batchCondition.wait(&batchMutex);
         }
 
-        // apply Regex if needed
-        if(exportFormat == QDltExporter::FormatDlt || exportFormat == QDltExporter::FormatDltDecoded)
+        stageTimer.start();
+        writeBatch(*batch);
+        if(statisticsEnabled)
         {
-            //FIXME: The following does not work for non verbose messages, must be fixed to enable RegEx for DLT Export again
-            //msg.setNumberOfArguments(msg.sizeArguments());
-            bool isApplied = false;
-            if(from) isApplied = from->applyRegExStringMsg(msg);
-            if(isApplied) msg.getMsg(buf,true);
+            statistics.write.nsecs += stageTimer.nsecsElapsed();
+            statistics.write.messages += batch->statistics.format.messages;
+            statistics.write.bytes += batch->statistics.format.bytes;
+            addStatistics(statistics.decode,batch->statistics.decode);
+            addStatistics(statistics.filter,batch->statistics.filter);
+            addStatistics(statistics.format,batch->statistics.format);
         }
+        readErrors += batch->readErrors;
+        exportErrors += batch->exportErrors;
+        exportCounter += batch->exportCounter;
 
-        if(filterList.isEmpty() || filterList.checkFilter(msg))
+        if(batch->progress>=progressCounter)
         {
-            // export message
-            if(multifilterFilenames.isEmpty())
-            {
-                if(!exportMsg(starting,msg,buf,to))
-                {
-                    // finish();
-                  //qDebug() << "DLT Export exportMsg() failed";
-                  exportErrors++;
-                  continue;
-                }
-                else
-                   exportCounter++;
-            }
-            else
-            {
-                for(int num=0;num<multifilterFilterList.size();num++)
-                {
-                    if(multifilterFilterList[num]->checkFilter(msg))
-                    {
-                        if(!exportMsg(starting,msg,buf,*multifilterFilesList[num]))
-                            exportErrors++;
-                        else
-                            exportCounter++;
-                    }
-                }
-            }
+            if((batch->progress/10) > ((progressCounter-1)/10))
+                qDebug() << "Exported:" << (batch->progress/10)*10 << "%"; // every 10%
+            progressCounter = batch->progress + 1;
+            emit progress("Exp:",2,batch->progress); // every 1%
         }
 
-    } // for loop
+        delete batch;
+    }
+
+    if(!streamInputFiles.isEmpty())
+    {
+        streamReader.close();
+        this->size = readNum;
+        stoping = readNum;
+    }
+    starting = readNum;
 
     emit progress("",3,100);
     qDebug() << "Exported:" << 100 << "%";
 
+    // the Parquet files and compressed frames are completed when the files are closed
+    stageTimer.start();
     if (!finish())
     {
         startFinishError++;
     }
+    if(statisticsEnabled)
+    {
+        statistics.write.nsecs += stageTimer.nsecsElapsed();
+        if(exportFormat == QDltExporter::FormatParquet && multifilterFilenames.isEmpty())
+            statistics.write.bytes = QFileInfo(to.fileName()).size();
+        statistics.nsecs = exportTimer.nsecsElapsed();
+    }
 
 
     if ( startFinishError>0 || readErrors>0 || exportErrors>0 )
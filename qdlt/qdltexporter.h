@@ -5,10 +5,16 @@
 #include <QThread>
 #include <QFile>
 #include <QModelIndexList>
+#include <QMutex>
+#include <QWaitCondition>
 
 #include "export_rules.h"
+#include "qdltcompressedwriter.h"
 #include "qdltfile.h"
+#include "qdltfilereader.h"
+#include "qdltfilterrouter.h"
 #include "qdltmsg.h"
+#include "qdltparquetwriter.h"
 #include "qdltpluginmanager.h"
 
 
@@ -22,10 +28,31 @@ class QDLT_EXPORT QDltExporter : public QThread
 public:
 
     typedef enum { FormatDlt,FormatAscii,FormatCsv,FormatClipboard,FormatClipboardPayloadOnly,FormatDltDecoded,FormatUTF8,
-                   FormatClipboardJiraTable, FormatClipboardJiraTableHead} DltExportFormat;
+                   FormatClipboardJiraTable, FormatClipboardJiraTableHead, FormatParquet} DltExportFormat;
 
     typedef enum { SelectionAll,SelectionFiltered,SelectionSelected } DltExportSelection;
 
+    /* Time and amount of data of one stage of the export.
+     * The time of the decode, filter and format stages is summed over all worker threads.
+     */
+    struct StageStatistics
+    {
+        qint64 nsecs = 0;    // time spent in the stage in nanoseconds
+        qint64 messages = 0; // messages processed by the stage
+        qint64 bytes = 0;    // raw message data or formatted output processed by the stage
+    };
+
+    /* Statistics of the last export, collected if enabled with setStatisticsEnabled() */
+    struct Statistics
+    {
+        StageStatistics read;   // raw messages read from the input files
+        StageStatistics decode; // messages parsed and decoded by the plugins
+        StageStatistics filter; // messages checked by the filters and the regular expressions
+        StageStatistics format; // messages formatted into the outputs
+        StageStatistics write;  // formatted data written to the export files
+        qint64 nsecs = 0;       // wall time of the whole export
+    };
+
 private:
 
     /* Add double quotes to a value.
@@ -41,17 +68,78 @@ private:
      */
     bool writeCSVHeader();
 
-    /* Write the message out to an open file
+    /* Format the message as CSV line
      * \param index True index to QDltFile of the message
-     * \param to File to write to
      * \param msg msg to get the data from
+     * \param out Buffer the line is appended to
      */
-    void writeCSVLine(int index, QDltMsg msg,QFile &to);
+    void writeCSVLine(int index, QDltMsg &msg,QByteArray &out);
+
+    struct ExportBatch;
+    class BatchRunnable;
 
     bool startExport();
     bool finish();
-    bool getMsg(unsigned long int num, QDltMsg &msg, QByteArray &buf);
-    bool exportMsg(unsigned long int num, QDltMsg &msg,QByteArray &buf,QFile &to);
+    int getMsgIndex(unsigned long int num) const;
+    bool isInTimeRange(const QDltMsg &msg) const;
+
+    /* Parse the raw message and decode it if needed by the export format.
+     * Thread safe, called by the worker threads.
+     * \param index Index of the message in the QDltFile or running number in stream mode
+     * \param msg The message which contains the result
+     * \param buf Raw message data, replaced by the decoded data for FormatDltDecoded
+     * \return false if the message could not be parsed
+     */
+    bool getMsg(int index, QDltMsg &msg, QByteArray &buf);
+
+    /* Format the message and append it to the output buffer, thread safe
+     * \param num Running number of the message in the export
+     * \param msg The decoded message
+     * \param buf The message data, used for DLT export formats
+     * \param out Buffer the formatted message is appended to
+     * \return false if formatting failed
+     */
+    bool exportMsg(unsigned long int num, QDltMsg &msg,QByteArray &buf,QByteArray &out);
+
+    /* Convert the message into a row of the Parquet export, thread safe
+     * \param num Running number of the message in the export
+     * \param msg The decoded message
+     * \return The row with the message header fields and the payload text
+     */
+    QDltParquetWriter::Row createParquetRow(unsigned long int num, QDltMsg &msg);
+
+    /* Format the message into one output of the batch
+     * \param num Running number of the message in the export
+     * \param msg The decoded message
+     * \param buf The message data, used for DLT export formats
+     * \param batch The batch containing the outputs
+     * \param output Number of the output file
+     */
+    void exportMsgToOutput(unsigned long int num, QDltMsg &msg, QByteArray &buf, ExportBatch &batch, int output);
+
+    /* Apply regular expressions and filters to a message and format it into the outputs of the batch
+     * \param num Running number of the message in the export
+     * \param msg The already decoded message
+     * \param buf The message data, used for DLT export formats
+     * \param batch The batch containing one output buffer per export file
+     */
+    void filterAndExportMsg(unsigned long int num, QDltMsg &msg, QByteArray &buf, ExportBatch &batch);
+
+    /* Reader stage: read the next batch of raw messages in export order
+     * \param batch Empty batch to be filled
+     * \return false if there are no more messages
+     */
+    bool readBatch(ExportBatch &batch);
+
+    /* Worker stage: decode, filter and format all messages of a batch
+     * \param batch Batch filled by readBatch()
+     */
+    void processBatch(ExportBatch &batch);
+
+    /* Writer stage: write the formatted output of a batch to the export files or clipboard
+     * \param batch Batch processed by processBatch()
+     */
+    void writeBatch(ExportBatch &batch);
 
 public:
 
@@ -65,6 +153,7 @@ public:
     void run() override;
 
     /* Export some messages from QDltFile to a CSV file.
+     * DLT exports into a file ending with .dlt.zst are written as seekable zstd frames.
      * \param from QDltFile to pull messages from
      * \param to Regular file to export to
      * \param pluginManager The treewidget representing plugins. Needed to run decoders.
@@ -76,6 +165,15 @@ public:
 
     void exportMessageRange(unsigned long start, unsigned long stop);
 
+    /* Limit the export to the messages with a storage header time in this range.
+     * The first and the last message of each file are found with the time index of the QDltFile,
+     * so only the messages in the ranges are read. The time of each read message is checked as well,
+     * which is the only check for marked messages, stream input and a filter index sorted by time.
+     * \param start Start time in microseconds since 1970-01-01 UTC
+     * \param stop Stop time in microseconds since 1970-01-01 UTC, messages at this time are included
+     */
+    void exportTimeRange(qint64 start, qint64 stop);
+
     /* If a filter list is set, an additional filter is applied when exporting
      * \param filterList Copy of filter list
      */
@@ -86,6 +184,35 @@ public:
      */
     void setMultifilterFilenames(QStringList multifilterFilenames);
 
+    /* Read the messages directly from these DLT files instead of the indexed QDltFile.
+     * The files are read once from beginning to end in large blocks, no index is created
+     * and memory usage does not depend on the file size. Only SelectionAll is supported,
+     * the QDltFile is still used for the DLTv2 setting and regular expressions.
+     * \param filenames DLT files to be exported in this order
+     */
+    void setStreamInputFiles(const QStringList &filenames);
+
+    /* Set the number of threads decoding, filtering and formatting messages in parallel.
+     * The order of the messages in the export is not affected.
+     * \param count Number of worker threads, default is the number of cores
+     */
+    void setWorkerThreadCount(int count);
+
+    /* Get the number of threads decoding, filtering and formatting messages in parallel.
+     */
+    int getWorkerThreadCount() const { return workerThreads; }
+
+    /* Measure the time and the data of each stage of the export.
+     * Disabled by default, as each message is timed several times.
+     * \param enabled true to collect the statistics of the next export
+     */
+    void setStatisticsEnabled(bool enabled);
+
+    /* Get the statistics of the last export
+     * \return The statistics, all zero if not enabled
+     */
+    const Statistics &getStatistics() const { return statistics; }
+
   signals:
 
     void clipboard(QString text);
@@ -98,8 +225,12 @@ private:
     unsigned long int size;
     unsigned long int starting_index;
     unsigned long int stoping_index;
+    bool timeRange;
+    qint64 startTime;
+    qint64 stopTime;
     QDltFile *from;
     QFile to;
+    QDltCompressedWriter compressedTo; // used instead of to for DLT export into a .dlt.zst file
     QString clipboardString;
     QDltPluginManager *pluginManager;
     QModelIndexList *selection;
@@ -113,8 +244,27 @@ private:
     QDltFilterList filterList;
     QStringList multifilterFilenames;
     QList<QFile*> multifilterFilesList;
+    QList<QDltParquetWriter*> parquetWriters; // one for each output file in Parquet format
     QList<QDltFilterList*> multifilterFilterList;
+    QDltFilterRouter multifilterRouter;
+    QStringList streamInputFiles;
     QString signature;
+
+    int workerThreads;
+    bool statisticsEnabled;
+    Statistics statistics;
+    QMutex batchMutex;
+    QWaitCondition batchCondition;
+
+    /* reader stage state */
+    QVector<QPair<unsigned long int,unsigned long int>> readRanges; // from first up to but not including last
+    int readRange;
+    unsigned long int readNum;
+    unsigned long int readEnd;
+    QDltFileReader streamReader;
+    int streamFileIndex;
+    qint64 streamTotalSize;
+    qint64 streamDoneSize;
 };
 
 #endif // QDLTEXPORTER_H
@@ -19,24 +19,96 @@
  * @licence end@
  */
 
+#include <QAtomicInt>
 #include <QFile>
+#include <QThread>
 #include <QtDebug>
+#include <QtEndian>
+
+#include <algorithm>
+#include <utility>
 
 #include "qdltfile.h"
+#include "qdlttimemerger.h"
 
 extern "C"
 {
 #include "dlt_common.h"
 }
 
+namespace {
+
+/* number of bytes of the storage header needed for the time */
+const int STORAGE_HEADER_TIME_SIZE = 13;
+
+/* version 1: seconds and microseconds, version 2: nanoseconds and 40 bit seconds, little endian */
+bool getStorageHeaderTime(const uchar *data, qint64 size, qint64 &time)
+{
+    if(size >= 12 && data[3] == 1)
+    {
+        time = qint64(qFromLittleEndian<quint32>(data + 4)) * 1000000 + qFromLittleEndian<qint32>(data + 8);
+        return true;
+    }
+    if(size >= STORAGE_HEADER_TIME_SIZE && data[3] == 2)
+    {
+        qint64 seconds = qint64(qFromLittleEndian<quint32>(data + 8)) | (qint64(data[12]) << 32);
+        time = seconds * 1000000 + qFromLittleEndian<quint32>(data + 4) / 1000;
+        return true;
+    }
+    return false;
+}
+
+struct TimeSortInput
+{
+    QString filename;
+    QVector<qint64> indexAll;
+    qint64 offset = 0;
+    QVector<QDltTimeIndexEntry> entries;
+};
+
+/* read the storage header times of all messages of a file in the time range with large sequential reads */
+void readStorageHeaderTimes(TimeSortInput &input, qint64 startTime, qint64 stopTime)
+{
+    static const qint64 READ_SIZE = 1024 * 1024;
+
+    QDltCompressedFile file;
+    file.setFileName(input.filename);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Sort by time: open of file" << input.filename << "failed";
+        return;
+    }
+
+    QByteArray buf;
+    qint64 bufPos = 0;
+    qint64 time = 0;
+    input.entries.reserve(input.indexAll.size());
+    for(int index=0;index<input.indexAll.size();index++)
+    {
+        const qint64 pos = input.indexAll[index];
+        if(pos < bufPos || pos + STORAGE_HEADER_TIME_SIZE > bufPos + buf.size())
+        {
+            if(!file.seek(pos))
+                break;
+            bufPos = pos;
+            buf = file.read(READ_SIZE);
+        }
+        /* a message without valid time keeps the time of the message before */
+        getStorageHeaderTime(reinterpret_cast<const uchar*>(buf.constData()) + (pos - bufPos), bufPos + buf.size() - pos, time);
+        if(time >= startTime && time <= stopTime)
+            input.entries.append({ time, input.offset + index });
+    }
+}
+
+}
+
 QDltFile::QDltFile()
 {
     filterFlag = false;
+    indexFilterSorted = true;
     sortByTimeFlag = false;
     sortByTimestampFlag = false;
-
-    cache.setMaxCost(1000);
-    cacheEnable = true;
+    dltv2Support = false;
 }
 
 QDltFile::~QDltFile()
@@ -44,18 +116,9 @@ QDltFile::~QDltFile()
     clear();
 }
 
-void QDltFile::setCacheSize(qsizetype cost)
+void QDltFile::setCacheSize(qsizetype sizeMB)
 {
-    if(cost==0)
-    {
-        cacheEnable = false;
-        cache.setMaxCost(1);
-    }
-    else
-    {
-        cacheEnable = true;
-        cache.setMaxCost(cost);
-    }
+    msgCache.setMaxSizeMB(sizeMB);
 }
 
 void QDltFile::setDLTv2Support(bool _dltv2Support)
@@ -79,7 +142,7 @@ void QDltFile::clear()
     }
     files.clear();
 
-    cache.clear();
+    msgCache.clear();
 }
 
 int QDltFile::getNumberOfFiles() const
@@ -95,6 +158,7 @@ void QDltFile::setDltIndex(QVector<qint64> &_indexAll, int num)
     }
 
     files[num]->indexAll = _indexAll;
+    files[num]->timeIndex.clear();
 }
 
 int QDltFile::size() const
@@ -161,6 +225,7 @@ void QDltFile::clearIndex()
     for(int num=0;num<files.size();num++)
     {
         files[num]->indexAll.clear();
+        files[num]->timeIndex.clear();
     }
 }
 
@@ -203,6 +268,8 @@ bool QDltFile::updateIndex()
             return false;
         }
 
+        /* compressed file which is still written, add the frames written since the last update */
+        files[numFile]->infile.updateBlocks();
 
         /* start at last found position */
         if(files[numFile]->indexAll.size())
@@ -424,6 +491,7 @@ bool QDltFile::createIndexFilter()
 {
     /* clear old index */
     indexFilter.clear();
+    indexFilterSorted = true;
 
     return updateIndexFilter();
 }
@@ -491,11 +559,14 @@ void QDltFile::clearFilterIndex()
 {
     /* clear old index */
     indexFilter.clear();
+    indexFilterSorted = true;
 
 }
 
 void QDltFile::addFilterIndex (int index)
 {
+    if(!indexFilter.isEmpty() && index < indexFilter.last())
+        indexFilterSorted = false;
     indexFilter.append(index);
 
 }
@@ -628,26 +699,94 @@ QByteArray QDltFile::getMsg(int index) const
     return buf;
 }
 
-bool QDltFile::getMsg(int index,QDltMsg &msg)
+QVector<QByteArray> QDltFile::getMsgBatch(const QVector<int> &indexes) const
 {
-    bool result;
-    QDltMsg *cacheMsg;
+    /* gap between two messages up to which they are read together */
+    static const qint64 MAX_READ_GAP = 64 * 1024;
+    /* maximum size of one merged read */
+    static const qint64 MAX_READ_SIZE = 4 * 1024 * 1024;
 
-    // check if msg is already in cache
-    if(cacheEnable)
+    struct Location
     {
-        mutexQDlt.lock();
-        cacheMsg = cache[index];
-        if(cacheMsg)
+        int file;
+        qint64 pos;
+        qint64 length;
+        int request;
+    };
+
+    QVector<QByteArray> result(indexes.size());
+    QVector<Location> locations;
+    locations.reserve(indexes.size());
+
+    /* index may be extended by updateIndex() while the messages are read */
+    QMutexLocker locker(&mutexQDlt);
+
+    /* resolve file and position of each message */
+    for(int request=0;request<indexes.size();request++)
+    {
+        int index = indexes[request];
+        if(index < 0)
+            continue;
+        int num;
+        for(num=0;num<files.size();num++)
         {
-            // load from cache
-            msg = *cacheMsg;
-            mutexQDlt.unlock();
-            return true;
+            if(index < files[num]->indexAll.size())
+                break;
+            index -= files[num]->indexAll.size();
         }
-        mutexQDlt.unlock();
+        if(num >= files.size() || !files[num]->infile.isOpen())
+            continue;
+
+        const QVector<qint64> &indexAll = files[num]->indexAll;
+        qint64 pos = indexAll[index];
+        qint64 end = (index == indexAll.size()-1) ? files[num]->infile.size() : indexAll[index+1];
+        if(end <= pos)
+            continue;
+        locations.append(Location{num, pos, end - pos, request});
+    }
+
+    std::sort(locations.begin(), locations.end(), [](const Location &a, const Location &b) {
+        return a.file < b.file || (a.file == b.file && a.pos < b.pos);
+    });
+
+    /* merge neighbouring messages into one read */
+    for(int first=0;first<locations.size();)
+    {
+        int last = first;
+        qint64 start = locations[first].pos;
+        qint64 end = start + locations[first].length;
+        while(last+1 < locations.size()
+              && locations[last+1].file == locations[first].file
+              && locations[last+1].pos - end <= MAX_READ_GAP
+              && locations[last+1].pos + locations[last+1].length - start <= MAX_READ_SIZE)
+        {
+            last++;
+            end = qMax(end, locations[last].pos + locations[last].length);
+        }
+
+        QDltCompressedFile &infile = files[locations[first].file]->infile;
+        QByteArray block;
+        if(infile.seek(start))
+            block = infile.read(end - start);
+        else
+            qDebug() << "Seek error on " << start << infile.fileName() << __FILE__ << __LINE__;
+
+        for(int num=first;num<=last;num++)
+        {
+            qint64 offset = locations[num].pos - start;
+            if(offset + locations[num].length <= block.size())
+                result[locations[num].request] = block.mid(offset, locations[num].length);
+        }
+        first = last + 1;
     }
 
+    return result;
+}
+
+bool QDltFile::getMsg(int index,QDltMsg &msg)
+{
+    bool result;
+
     // load message from DLT file
     QByteArray data = getMsg(index);
     if(data.isEmpty())
@@ -655,23 +794,26 @@ bool QDltFile::getMsg(int index,QDltMsg &msg)
     result = msg.setMsg(data,true,dltv2Support);
     msg.setIndex(index);
 
-    // store msg in cache
-    if(cacheEnable && result)
-    {
-        cacheMsg = new QDltMsg();
-        *cacheMsg = msg;
-        mutexQDlt.lock();
-        if(!cache.insert(index,cacheMsg))
-        {
-            // object deleted already by insert function
-            // delete cacheMsg;
-        }
-        mutexQDlt.unlock();
-    }
-
     return result;
 }
 
+bool QDltFile::getMsgDecoded(int index,QDltMsg &msg,QDltMessageDecoder *decoder,int triggeredByUser,bool addToCache)
+{
+    auto decode = [&](QDltMsg &decodedMsg) {
+        if(!getMsg(index,decodedMsg))
+            return false;
+        if(decoder)
+            decoder->decodeMsg(decodedMsg,triggeredByUser);
+        return true;
+    };
+
+    // decoded msg is taken from the cache, or stored in the cache after decoding
+    if(addToCache)
+        return msgCache.getOrCompute(index,msg,decode);
+
+    return msgCache.get(index,msg) || decode(msg);
+}
+
 QByteArray QDltFile::getMsgFilter(int index) const
 {
     if(filterFlag)
@@ -724,6 +866,151 @@ int QDltFile::getMsgFilterPos(int index) const
     }
 }
 
+int QDltFile::findMsgFilterPos(int index) const
+{
+    if(!filterFlag)
+        return qBound(0, index, size());
+
+    if(indexFilterSorted)
+        return std::lower_bound(indexFilter.begin(), indexFilter.end(), index) - indexFilter.begin();
+
+    /* sorted by time or merged, the positions are not ascending */
+    return std::find_if(indexFilter.begin(), indexFilter.end(), [index](qint64 pos) { return pos >= index; }) - indexFilter.begin();
+}
+
+bool QDltFile::isIndexFilterSorted() const
+{
+    return indexFilterSorted;
+}
+
+bool QDltFile::readMsgTime(QDltFileItem *file, int index, qint64 &time)
+{
+    if(!file->infile.seek(file->indexAll[index]))
+        return false;
+
+    QByteArray buf = file->infile.read(STORAGE_HEADER_TIME_SIZE);
+    return getStorageHeaderTime(reinterpret_cast<const uchar*>(buf.constData()), buf.size(), time);
+}
+
+void QDltFile::updateTimeIndex(QDltFileItem *file)
+{
+    /* entries can only be added for messages already in the index */
+    for(qint64 index = qint64(file->timeIndex.size()) * QDLT_TIME_INDEX_STEP; index < file->indexAll.size(); index += QDLT_TIME_INDEX_STEP)
+    {
+        qint64 time = 0;
+        if(!readMsgTime(file, index, time) && !file->timeIndex.isEmpty())
+            time = file->timeIndex.last(); // keep the index ascending for corrupted messages
+        file->timeIndex.append(time);
+    }
+}
+
+int QDltFile::findFileMsgByTime(QDltFileItem *file, qint64 time)
+{
+    updateTimeIndex(file);
+
+    /* the searched message follows the last entry older than time and is not behind the next entry */
+    const QVector<qint64> &timeIndex = file->timeIndex;
+    int entry = std::lower_bound(timeIndex.begin(), timeIndex.end(), time) - timeIndex.begin();
+    int first = entry > 0 ? (entry - 1) * QDLT_TIME_INDEX_STEP + 1 : 0;
+    int last = entry < timeIndex.size() ? entry * QDLT_TIME_INDEX_STEP : file->indexAll.size();
+    for(int index = first; index < last; index++)
+    {
+        qint64 msgTime = 0;
+        if(readMsgTime(file, index, msgTime) && msgTime >= time)
+            return index;
+    }
+    return last;
+}
+
+int QDltFile::findMsgByTime(qint64 time)
+{
+    int offset = 0;
+
+    mutexQDlt.lock();
+
+    for(int numFile=0;numFile<files.size();numFile++)
+    {
+        QDltFileItem *file = files[numFile];
+        int index = findFileMsgByTime(file, time);
+        if(index < file->indexAll.size())
+        {
+            mutexQDlt.unlock();
+            return offset + index;
+        }
+        offset += file->indexAll.size();
+    }
+
+    mutexQDlt.unlock();
+
+    return offset;
+}
+
+QVector<QPair<int,int>> QDltFile::findMsgRangesByTime(qint64 startTime, qint64 stopTime)
+{
+    QVector<QPair<int,int>> ranges;
+    int offset = 0;
+
+    mutexQDlt.lock();
+
+    /* the files can overlap in time, so each file has its own range */
+    for(int numFile=0;numFile<files.size();numFile++)
+    {
+        QDltFileItem *file = files[numFile];
+        int first = findFileMsgByTime(file, startTime);
+        int last = stopTime < std::numeric_limits<qint64>::max() ? findFileMsgByTime(file, stopTime + 1) : file->indexAll.size();
+        if(first < last)
+            ranges.append(qMakePair(offset + first, offset + last));
+        offset += file->indexAll.size();
+    }
+
+    mutexQDlt.unlock();
+
+    return ranges;
+}
+
+QVector<qint64> QDltFile::createIndexSortedByTime(qint64 startTime, qint64 stopTime)
+{
+    QVector<TimeSortInput> inputs;
+
+    mutexQDlt.lock();
+    qint64 offset = 0;
+    for(int numFile=0;numFile<files.size();numFile++)
+    {
+        TimeSortInput input;
+        input.filename = files[numFile]->infile.fileName();
+        input.indexAll = files[numFile]->indexAll;
+        input.offset = offset;
+        inputs.append(input);
+        offset += files[numFile]->indexAll.size();
+    }
+    mutexQDlt.unlock();
+
+    /* the files are read in parallel, each thread with its own file handle takes the next file */
+    QAtomicInt next(0);
+    QVector<QThread*> threads;
+    const int workers = qBound(1, QThread::idealThreadCount(), inputs.size());
+    for(int num=0;num<workers;num++)
+    {
+        threads.append(QThread::create([&inputs,&next,startTime,stopTime]() {
+            int input;
+            while((input = next.fetchAndAddRelaxed(1)) < inputs.size())
+                readStorageHeaderTimes(inputs[input], startTime, stopTime);
+        }));
+        threads.last()->start();
+    }
+    for(QThread *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+
+    QDltTimeMerger merger;
+    for(auto &input : inputs)
+        merger.addInput(std::move(input.entries));
+
+    return merger.merge();
+}
+
 void QDltFile::clearFilter()
 {
     filterList.clearFilter();
@@ -767,9 +1054,10 @@ QVector<qint64> QDltFile::getIndexFilter() const
 void QDltFile::setIndexFilter(QVector<qint64> _indexFilter)
 {
     indexFilter = _indexFilter;
+    indexFilterSorted = std::is_sorted(indexFilter.begin(), indexFilter.end());
 }
 
-bool QDltFile::applyRegExString(QDltMsg &msg,QString &text)
+bool QDltFile::applyRegExString(const QDltMsg &msg,QString &text)
 {
 
     return filterList.applyRegExString(msg,text);
@@ -23,23 +23,31 @@
 #define QDLT_FILE_H
 
 #include "export_rules.h"
+#include "qdltcompressedfile.h"
 #include "qdltfilter.h"
 #include "qdltfilterlist.h"
 #include "qdltmsg.h"
+#include "qdltmsgcache.h"
+#include "qdltmessagedecoder.h"
 
 #include <QObject>
 #include <QString>
 #include <QFile>
 #include <QDateTime>
 #include <QMutex>
+#include <QPair>
 #include <time.h>
-#include <QCache>
+
+#include <limits>
+
+//! Number of messages between two entries of the time index.
+#define QDLT_TIME_INDEX_STEP 1024
 
 class QDLT_EXPORT QDltFileItem
 {
 public:
-    //! DLT log file.
-    QFile infile;
+    //! DLT log file, .dlt.zst and .dlt.gz files are decompressed on access.
+    QDltCompressedFile infile;
 
     //! Index of all DLT messages.
     /*!
@@ -47,6 +55,13 @@ public:
     */
     QVector<qint64> indexAll;
 
+    //! Sparse time index.
+    /*!
+      Storage header time in microseconds of every QDLT_TIME_INDEX_STEP-th message of indexAll.
+      Created when needed by QDltFile::findMsgByTime().
+    */
+    QVector<qint64> timeIndex;
+
 };
 
 //! Access to a DLT log file.
@@ -93,6 +108,8 @@ public:
     //! Open a DLT log file.
     /*!
       The DLT log file is parsed and a index of all DLT log messages is created.
+      Files compressed with zstd or gzip are detected by their content, the index then
+      contains positions in the uncompressed data.
       \param filename The DLT filename.
       \return true if the file is successfully opened with no error, false if an error occured.
     */
@@ -147,6 +164,19 @@ public:
     */
     bool getMsg(int index,QDltMsg &msg);
 
+    //! Get one decoded message of the DLT log file.
+    /*!
+      The message is taken from the shared message cache if available.
+      Otherwise it is loaded from the DLT file, decoded with the decoder and stored in the cache.
+      \param index The number of the DLT message in the DLT file starting from zero.
+      \param msg The message which contains the decoded DLT message after the function returns.
+      \param decoder The decoder used on a cache miss, no decoding is done if nullptr.
+      \param triggeredByUser Whether decode operation was triggered by the user or not
+      \param addToCache Store the message in the cache on a cache miss, false for sequential scans.
+      \return true if the message is valid, false if an error occurred.
+    */
+    bool getMsgDecoded(int index,QDltMsg &msg,QDltMessageDecoder *decoder,int triggeredByUser,bool addToCache = true);
+
     //! Get one DLT message of the DLT log file selected by index
     /*!
       \param index position of the DLT message in the log file up to the number DLT messages in the file
@@ -154,6 +184,15 @@ public:
     */
     QByteArray getMsg(int index) const;
 
+    //! Get several DLT messages of the DLT log file with merged file reads
+    /*!
+      The requested messages are sorted by file position and adjacent messages are read
+      with one large sequential read instead of one seek and read per message.
+      \param indexes positions of the DLT messages in the log file up to the number DLT messages in the file
+      \return Byte arrays containing the complete DLT messages in the order of indexes, empty for invalid indexes.
+    */
+    QVector<QByteArray> getMsgBatch(const QVector<int> &indexes) const;
+
     //! Get one DLT message of the filtered DLT log file selected by index
     /*!
       \param index position of the DLT message in the log file up to the number of DLT messages in the file
@@ -168,6 +207,54 @@ public:
     */
     int getMsgFilterPos(int index) const;
 
+    //! Find the first position in the filtered index with a message at or after the given message
+    /*!
+      The filtered index is binary searched when it is in file order, otherwise it is scanned.
+      \param index position of the DLT message in the log file
+      \return position in the filtered index, sizeFilter() if no filtered message follows.
+    */
+    int findMsgFilterPos(int index) const;
+
+    //! Check if the filtered index is in file order
+    /*!
+      The filtered index is not in file order when it was sorted by time or timestamp,
+      or merged by time.
+      \return true if the positions in the filtered index are ascending.
+    */
+    bool isIndexFilterSorted() const;
+
+    //! Find the first DLT message with a storage header time at or after the given time
+    /*!
+      The sparse time index is searched first, then at most QDLT_TIME_INDEX_STEP messages are read.
+      The time index is created and extended when needed. The storage header times are expected
+      in ascending order, as written by the logger.
+      \param time Time in microseconds since 1970-01-01 UTC.
+      \return position of the DLT message in the log file, size() if all messages are older.
+    */
+    int findMsgByTime(qint64 time);
+
+    //! Find the DLT messages with a storage header time in a time range, separately in each file
+    /*!
+      Each file is searched on its own like in findMsgByTime(), so files overlapping in time are supported.
+      Messages in the ranges can still be outside the time range if the storage header times are not ascending.
+      \param startTime First time in microseconds since 1970-01-01 UTC.
+      \param stopTime Last time in microseconds since 1970-01-01 UTC.
+      \return Ranges of positions in the log file from first up to but not including last, in file order without empty ranges.
+    */
+    QVector<QPair<int,int>> findMsgRangesByTime(qint64 startTime, qint64 stopTime);
+
+    //! Create an index of all DLT messages sorted by storage header time
+    /*!
+      The storage header times of the files are read in parallel, then the messages
+      of all files are merged by time with QDltTimeMerger.
+      Messages with the same time keep their order in the log file.
+      \param startTime Only messages at or after this time in microseconds since 1970-01-01 UTC.
+      \param stopTime Only messages at or before this time in microseconds since 1970-01-01 UTC.
+      \return positions of the DLT messages in the log file ordered by time.
+    */
+    QVector<qint64> createIndexSortedByTime(qint64 startTime = std::numeric_limits<qint64>::min(),
+                                            qint64 stopTime = std::numeric_limits<qint64>::max());
+
     //! Delete all filters and markers.
     /*!
       This includes all positive and negative filters and markers.
@@ -281,11 +368,17 @@ public:
      **/
     void setIndexFilter(QVector<qint64> _indexFilter);
 
-    //! Sets the max cache size for DLT messages
+    //! Sets the max cache size for decoded DLT messages
+    /*!
+     * \param sizeMB Cache size in MB, 0 disables the cache
+     **/
+    void setCacheSize(qsizetype sizeMB);
+
+    //! Get the cache of decoded DLT messages shared by all views of this file
     /*!
-     * \param cost Cache size
+     * \return Pointer to the message cache
      **/
-    void setCacheSize(qsizetype cost);
+    QDltMsgCache* getMsgCache() { return &msgCache; }
 
     //! Sets DLTv2 support
     /*!
@@ -302,7 +395,7 @@ public:
     //! Apply RegEx Replace to the string, if any active in the filters
     /*!
     */
-    bool applyRegExString(QDltMsg &msg,QString &text);
+    bool applyRegExString(const QDltMsg &msg,QString &text);
 
     //! Apply RegEx Replace to the arguments of a message, if any active in the filters
     /*!
@@ -312,6 +405,15 @@ public:
 protected:
 
 private:
+    //! Add the entries of the messages indexed since the last call to the time index, mutexQDlt must be locked.
+    void updateTimeIndex(QDltFileItem *file);
+
+    //! Read the storage header time of a message in microseconds, mutexQDlt must be locked.
+    bool readMsgTime(QDltFileItem *file, int index, qint64 &time);
+
+    //! Find the first message of a file with a storage header time at or after time, mutexQDlt must be locked.
+    int findFileMsgByTime(QDltFileItem *file, qint64 time);
+
     //! Mutex to lock critical path for infile
     mutable QMutex mutexQDlt;
 
@@ -324,6 +426,9 @@ private:
     */
     QVector<qint64> indexFilter;
 
+    //! The positions in indexFilter are ascending.
+    bool indexFilterSorted;
+
     //! This contains the list of filters.
     QDltFilterList filterList;
 
@@ -348,8 +453,8 @@ private:
     */
     bool sortByTimestampFlag;
 
-    QCache<int,QDltMsg> cache;
-    bool cacheEnable;
+    //! Decoded messages shared by table view, search view, plugins and exporter.
+    QDltMsgCache msgCache;
 
     //! DLTv2 Support.
     /*!
@@ -0,0 +1,177 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltfilereader.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtDebug>
+
+#include "qdltfilereader.h"
+
+/* size of the storage header up to the length byte of the ECU id in DLTv2 */
+#define DLT_STORAGE_HEADER_V2_MIN_SIZE 14
+#define DLT_STORAGE_HEADER_V1_SIZE 16
+
+QDltFileReader::QDltFileReader(qint64 blockSize)
+    : blockSize(blockSize > 0 ? blockSize : 4 * 1024 * 1024),
+      blockPosition(0), offset(0), fileSize(0), msgPosition(0), errors(0), endOfFile(true)
+{
+
+}
+
+bool QDltFileReader::open(const QString &filename)
+{
+    close();
+
+    file.setFileName(filename);
+    file.setCacheBlocks(1); // blocks are read only once
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "open of file" << filename << "failed";
+        return false;
+    }
+
+    fileSize = file.size();
+    endOfFile = false;
+    return true;
+}
+
+void QDltFileReader::close()
+{
+    if(file.isOpen())
+        file.close();
+    block.clear();
+    blockPosition = 0;
+    offset = 0;
+    fileSize = 0;
+    msgPosition = 0;
+    errors = 0;
+    endOfFile = true;
+}
+
+bool QDltFileReader::fill(qint64 bytes)
+{
+    /* make sure that at least bytes are available behind offset */
+    while(block.size() - offset < bytes && !endOfFile)
+    {
+        QByteArray data = file.read(qMax(blockSize, bytes));
+        if(data.isEmpty())
+        {
+            endOfFile = true;
+            break;
+        }
+        /* drop already consumed data */
+        if(offset > 0)
+        {
+            block.remove(0, offset);
+            blockPosition += offset;
+            offset = 0;
+        }
+        block.append(data);
+    }
+    return block.size() - offset >= bytes;
+}
+
+bool QDltFileReader::isMarker(const char *data)
+{
+    return data[0] == 'D' && data[1] == 'L' && data[2] == 'T' && (data[3] == 0x01 || data[3] == 0x02);
+}
+
+bool QDltFileReader::skipToMarker()
+{
+    bool skipped = false;
+
+    while(fill(4))
+    {
+        const char *data = block.constData() + offset;
+        qint64 available = block.size() - offset;
+        for(qint64 num = 0; num + 4 <= available; num++)
+        {
+            if(isMarker(data + num))
+            {
+                if(num > 0)
+                    skipped = true;
+                offset += num;
+                if(skipped)
+                    errors++;
+                return true;
+            }
+        }
+        /* keep the last bytes, they could be the beginning of a marker */
+        offset += available - 3;
+        skipped = true;
+    }
+
+    return false;
+}
+
+qint64 QDltFileReader::messageLength()
+{
+    /* storage header length, DLTv2 storage header contains the length of the ECU id */
+    qint64 storageLength = DLT_STORAGE_HEADER_V1_SIZE;
+    if(block.at(offset + 3) == 0x02)
+    {
+        if(!fill(DLT_STORAGE_HEADER_V2_MIN_SIZE))
+            return -1;
+        storageLength = DLT_STORAGE_HEADER_V2_MIN_SIZE + (unsigned char)block.at(offset + 13);
+    }
+
+    /* read DLT protocol version from standard header, the length field moved in DLTv2 */
+    if(!fill(storageLength + 1))
+        return -1;
+    quint8 version = (((unsigned char)block.at(offset + storageLength)) & 0xe0) >> 5;
+    qint64 lengthOffset = (version == 2) ? 5 : 2;
+
+    if(!fill(storageLength + lengthOffset + 2))
+        return -1;
+    quint16 length = (unsigned char)block.at(offset + storageLength + lengthOffset);
+    length = length << 8 | (unsigned char)block.at(offset + storageLength + lengthOffset + 1);
+
+    return length + storageLength;
+}
+
+bool QDltFileReader::readMsg(QByteArray &buf)
+{
+    buf.clear();
+
+    while(skipToMarker())
+    {
+        qint64 length = messageLength();
+        if(length < 0)
+            return false; // truncated at end of file
+
+        /* message is only valid, if the next message starts directly behind it or the file ends */
+        bool valid;
+        if(fill(length + 4))
+            valid = isMarker(block.constData() + offset + length);
+        else
+            valid = (block.size() - offset == length);
+
+        if(!valid)
+        {
+            /* search again behind the current marker */
+            offset += 4;
+            continue;
+        }
+
+        msgPosition = blockPosition + offset;
+        buf = block.mid(offset, length);
+        offset += length;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,93 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltfilereader.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_FILE_READER_H
+#define QDLT_FILE_READER_H
+
+#include "export_rules.h"
+#include "qdltcompressedfile.h"
+
+#include <QByteArray>
+#include <QString>
+
+//! Sequential reader of DLT files.
+/*!
+  Reads a DLT file with storage headers front to back in large blocks and returns
+  one message after the other without creating an index.
+  Messages are detected with the same rules as QDltFile::createIndex(),
+  so memory use does not depend on the file size.
+  Compressed .dlt.zst and .dlt.gz files are decompressed while reading.
+*/
+class QDLT_EXPORT QDltFileReader
+{
+public:
+    //! The constructor.
+    /*!
+      \param blockSize Size of one file read in bytes.
+    */
+    explicit QDltFileReader(qint64 blockSize = 4 * 1024 * 1024);
+
+    //! Open a DLT file and start reading at the beginning.
+    /*!
+      \param filename The DLT file to be read.
+      \return true if the file was opened.
+    */
+    bool open(const QString &filename);
+
+    //! Close the DLT file.
+    void close();
+
+    //! Read the next DLT message.
+    /*!
+      Data which does not belong to a valid message is skipped and counted as error.
+      \param buf Byte array containing the complete DLT message including storage header.
+      \return true if a message was read, false at the end of the file.
+    */
+    bool readMsg(QByteArray &buf);
+
+    //! Get the file position of the message returned by the last readMsg().
+    qint64 getMsgPosition() const { return msgPosition; }
+
+    //! Get the number of bytes already consumed from the file.
+    qint64 getPosition() const { return blockPosition + offset; }
+
+    //! Get the size of the file in bytes.
+    qint64 getFileSize() const { return fileSize; }
+
+    //! Get the number of times data had to be skipped to find the next message.
+    qint64 getErrors() const { return errors; }
+
+private:
+    bool fill(qint64 bytes);
+    bool skipToMarker();
+    qint64 messageLength();
+    static bool isMarker(const char *data);
+
+    QDltCompressedFile file;
+    qint64 blockSize;
+    QByteArray block;
+    qint64 blockPosition;
+    qint64 offset;
+    qint64 fileSize;
+    qint64 msgPosition;
+    qint64 errors;
+    bool endOfFile;
+};
+
+#endif // QDLT_FILE_READER_H
@@ -162,6 +162,14 @@ bool QDltFilter::compileRegexps()
 }
 
 bool QDltFilter::match(const QDltMsg &msg) const
+{
+    std::optional<QString> headerText;
+    std::optional<QString> payloadText;
+
+    return match(msg,headerText,payloadText);
+}
+
+bool QDltFilter::match(const QDltMsg &msg, std::optional<QString> &headerText, std::optional<QString> &payloadText) const
 {
 
     if( (true == enableEcuid) && (msg.getEcuid() != ecuid))
@@ -200,31 +208,37 @@ bool QDltFilter::match(const QDltMsg &msg) const
         }
     }
 
+    if( (true == enableHeader) && !headerText )
+        headerText = msg.toStringHeader();
+
     if(true == enableRegexp_Header)
     {
-        if( (true == enableHeader) && ( false == headerRegularExpression.match(msg.toStringHeader()).hasMatch() ) )
+        if( (true == enableHeader) && ( false == headerRegularExpression.match(*headerText).hasMatch() ) )
         {
             return false;
         }
     }
     else
     {
-        if( ( true == enableHeader ) && ( false == msg.toStringHeader().contains(header,ignoreCase_Header?Qt::CaseInsensitive:Qt::CaseSensitive)) )
+        if( ( true == enableHeader ) && ( false == headerText->contains(header,ignoreCase_Header?Qt::CaseInsensitive:Qt::CaseSensitive)) )
         {
             return false;
         }
     }
 
+    if( (true == enablePayload) && !payloadText )
+        payloadText = msg.toStringPayload();
+
     if( true == enableRegexp_Payload)
     {
-        if( (true == enablePayload) && ( false == payloadRegularExpression.match(msg.toStringPayload()).hasMatch() ) )
+        if( (true == enablePayload) && ( false == payloadRegularExpression.match(*payloadText).hasMatch() ) )
         {
             return false;
         }
     }
     else
     {
-        if( (true == enablePayload) && ( false == msg.toStringPayload().contains(payload,ignoreCase_Payload?Qt::CaseInsensitive:Qt::CaseSensitive)) )
+        if( (true == enablePayload) && ( false == payloadText->contains(payload,ignoreCase_Payload?Qt::CaseInsensitive:Qt::CaseSensitive)) )
         {
             return false;
         }
@@ -35,6 +35,8 @@
 #include "export_rules.h"
 #include "qdltmsg.h"
 
+#include <optional>
+
 
 class QDLT_EXPORT QDltFilter
 {
@@ -132,6 +134,16 @@ public:
     */
     bool match(const QDltMsg &msg) const;
 
+    //! Check if filter matches, reusing header and payload text created by other filters.
+    /*!
+      Header and payload text of the message are only created if needed and not yet available.
+      \param msg The message to be checked
+      \param headerText Header text of the message, created on first use
+      \param payloadText Payload text of the message, created on first use
+      \return true if filter matches the message, else false
+    */
+    bool match(const QDltMsg &msg, std::optional<QString> &headerText, std::optional<QString> &payloadText) const;
+
     //! Save filter parameters in XML file.
     /*!
     */
@@ -129,7 +129,7 @@ QString QDltFilterList::checkMarker(const QDltMsg &msg)
 
 #endif
 
-bool QDltFilterList::applyRegExString(QDltMsg &msg,QString &text)
+bool QDltFilterList::applyRegExString(const QDltMsg &msg,QString &text)
 {
     QDltFilter *filter;
     bool result = false;
@@ -0,0 +1,138 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltfilterrouter.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QStringList>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <optional>
+
+#include "qdltfilterrouter.h"
+
+QDltFilterRouter::QDltFilterRouter()
+{
+
+}
+
+QDltFilterRouter::~QDltFilterRouter()
+{
+    clear();
+}
+
+void QDltFilterRouter::clear()
+{
+    qDeleteAll(filters);
+    filters.clear();
+    filterIndex.clear();
+    outputs.clear();
+}
+
+QString QDltFilterRouter::filterKey(const QDltFilter &filter)
+{
+    /* all settings used by QDltFilter::match(), name and colour do not change the result */
+    QStringList key;
+    key << (filter.enableEcuid ? filter.ecuid : QString())
+        << (filter.enableApid ? QString("%1%2").arg(filter.enableRegexp_Appid).arg(filter.apid) : QString())
+        << (filter.enableCtid ? QString("%1%2").arg(filter.enableRegexp_Context).arg(filter.ctid) : QString())
+        << (filter.enableHeader ? QString("%1%2%3").arg(filter.enableRegexp_Header).arg(filter.ignoreCase_Header).arg(filter.header) : QString())
+        << (filter.enablePayload ? QString("%1%2%3").arg(filter.enableRegexp_Payload).arg(filter.ignoreCase_Payload).arg(filter.payload) : QString())
+        << (filter.enableMessageId ? QString("%1-%2").arg(filter.messageIdMin).arg(filter.messageIdMax) : QString())
+        << QString::number(filter.enableCtrlMsgs)
+        << (filter.enableLogLevelMax ? QString::number(filter.logLevelMax) : QString())
+        << (filter.enableLogLevelMin ? QString::number(filter.logLevelMin) : QString());
+    return key.join(QChar(0));
+}
+
+int QDltFilterRouter::addOutput(const QDltFilterList &filterList)
+{
+    Output output;
+
+    for(const QDltFilter *filter : filterList.filters)
+    {
+        if(!filter->enableFilter || !(filter->isPositive() || filter->isNegative()))
+            continue;
+
+        QString key = filterKey(*filter);
+        int index = filterIndex.value(key,-1);
+        if(index < 0)
+        {
+            QDltFilter *copy = new QDltFilter();
+            *copy = *filter;
+            copy->compileRegexps();
+            index = filters.size();
+            filters.append(copy);
+            filterIndex.insert(key,index);
+        }
+
+        if(filter->isPositive())
+            output.positive.append(index);
+        else
+            output.negative.append(index);
+    }
+
+    outputs.append(output);
+    return outputs.size() - 1;
+}
+
+void QDltFilterRouter::route(const QDltMsg &msg, QVector<int> &matches) const
+{
+    /* result of each distinct filter for this message: -1 not evaluated yet, 0 no match, 1 match */
+    QVarLengthArray<signed char,256> results(filters.size());
+    std::fill(results.begin(), results.end(), -1);
+    std::optional<QString> headerText;
+    std::optional<QString> payloadText;
+
+    auto matchFilter = [&](int index) {
+        if(results[index] < 0)
+            results[index] = filters.at(index)->match(msg,headerText,payloadText) ? 1 : 0;
+        return results[index] == 1;
+    };
+
+    matches.clear();
+    for(int num = 0; num < outputs.size(); num++)
+    {
+        const Output &output = outputs.at(num);
+
+        /* same logic as QDltFilterList::checkFilter() */
+        bool found = output.positive.isEmpty();
+        for(int index : output.positive)
+        {
+            if(matchFilter(index))
+            {
+                found = true;
+                break;
+            }
+        }
+
+        if(found)
+        {
+            for(int index : output.negative)
+            {
+                if(matchFilter(index))
+                {
+                    found = false;
+                    break;
+                }
+            }
+        }
+
+        if(found)
+            matches.append(num);
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltfilterrouter.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_FILTER_ROUTER_H
+#define QDLT_FILTER_ROUTER_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "export_rules.h"
+#include "qdltfilter.h"
+#include "qdltfilterlist.h"
+
+//! Route messages to several outputs, each selected by its own filter list.
+/*!
+  All filter lists are compiled into one matcher: filters with the same matching criteria
+  in several lists are evaluated only once per message, and header and payload text of a
+  message are created at most once for all filters.
+  The result for each output is the same as QDltFilterList::checkFilter() of its filter list.
+  After setup, route() does not modify the router and can be called from several threads.
+*/
+class QDLT_EXPORT QDltFilterRouter
+{
+public:
+    //! The constructor.
+    QDltFilterRouter();
+
+    //! The destructor.
+    ~QDltFilterRouter();
+
+    //! Add the filter list of the next output.
+    /*!
+      Only enabled positive and negative filters are used, markers are ignored.
+      \param filterList The filter list, it is copied.
+      \return The number of the output.
+    */
+    int addOutput(const QDltFilterList &filterList);
+
+    //! Remove all outputs and filters.
+    void clear();
+
+    //! Get the number of outputs.
+    int size() const { return outputs.size(); }
+
+    //! Get the number of distinct filters evaluated per message.
+    int sizeFilters() const { return filters.size(); }
+
+    //! Find all outputs a message is routed to.
+    /*!
+      \param msg The message to be checked.
+      \param matches Contains the numbers of all matching outputs in ascending order after the function returns.
+    */
+    void route(const QDltMsg &msg, QVector<int> &matches) const;
+
+private:
+    struct Output
+    {
+        QVector<int> positive;
+        QVector<int> negative;
+    };
+
+    Q_DISABLE_COPY(QDltFilterRouter)
+
+    static QString filterKey(const QDltFilter &filter);
+
+    QVector<QDltFilter*> filters;
+    QHash<QString,int> filterIndex;
+    QVector<Output> outputs;
+};
+
+#endif // QDLT_FILTER_ROUTER_H
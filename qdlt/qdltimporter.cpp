@@ -8,18 +8,29 @@ extern "C" {
 
 #include "qdltmsg.h"
 #include "qdltimporter.h"
+#include "qdltpcapreader.h"
+#include "qdltmf4reader.h"
 
 #include <time.h>
 
+namespace {
+
+/* the messages are collected and written to the output file in large blocks */
+const int OUTPUT_BUFFER_SIZE = 4 * 1024 * 1024;
+
+}
+
 QDltImporter::QDltImporter(QFile *outputfile, QStringList fileNames, QObject *parent) :
-    QThread(parent)
+    QThread(parent),
+    tcpReassembler([this](const char *data, int size) { writeDLTMessageToFile(QByteArray(),data,size,QString(),streamSec,streamUsec); counterDLTMessages++; })
 {
     this->outputfile = outputfile;
     this->fileNames = fileNames;
 }
 
 QDltImporter::QDltImporter(QFile *outputfile, QString fileName,QObject *parent) :
-                                                                                         QThread(parent)
+                                                                                         QThread(parent),
+    tcpReassembler([this](const char *data, int size) { writeDLTMessageToFile(QByteArray(),data,size,QString(),streamSec,streamUsec); counterDLTMessages++; })
 {
     this->outputfile = outputfile;
     fileNames.append(fileName);
@@ -50,37 +61,31 @@ void QDltImporter::dltIpcFromPCAP(QString fileName)
     counterRecordsIPC = 0;
     counterDLTMessages = 0;
     counterIPCMessages = 0;
+    counterRecordsMalformed = 0;
+    resetStreams();
 
-    QFile inputfile(fileName);
-
-    if(!inputfile.open(QFile::ReadOnly))
-       return;
-
-    /* open output file */
-    if(!outputfile->open(QIODevice::WriteOnly|QIODevice::Append))
+    /* the capture is mapped into memory, the packets are parsed without copying them */
+    QDltPcapReader reader;
+    if(!reader.open(fileName))
     {
-        qDebug() << "Failed opening WriteOnly" << outputfile->fileName();
+        qDebug() << "fromPCAP:" << "Cannot open file" << fileName;
+        return;
     }
 
+    /* open output file */
+    openOutput();
+
     int progressCounter = 1;
     emit progress("PCAP",1,0);
 
-    pcap_hdr_t globalHeader;
-    pcaprec_hdr_t recordHeader;
-
-    qDebug() << "Import DLT/IPC from PCAP file:" << fileName;
+    qDebug() << "Import DLT/IPC from" << (reader.isPcapng() ? "PCAPNG" : "PCAP") << "file:" << fileName;
 
-    if(inputfile.read((char*)&globalHeader,sizeof(pcap_hdr_t))!=sizeof(pcap_hdr_t))
-    {
-        inputfile.close();
-        outputfile->close();
-        qDebug() << "fromPCAP:" << "Cannot open file" << fileName;
-        return;
-    }
-    quint64 fileSize = inputfile.size();
-    while(inputfile.read((char*)&recordHeader,sizeof(pcaprec_hdr_t))==sizeof(pcaprec_hdr_t))
+    const qint64 fileSize = qMax<qint64>(1,reader.getFileSize());
+    quint32 expireTime = 0;
+    QDltPcapPacket packet;
+    while(reader.readPacket(packet))
     {
-        int percent = inputfile.pos()*100/fileSize;
+        int percent = reader.getPosition()*100/fileSize;
         if(percent>=progressCounter)
         {
             progressCounter += 1;
@@ -91,43 +96,62 @@ void QDltImporter::dltIpcFromPCAP(QString fileName)
 
         // TODO: Handle cancel request
 
-        QByteArray record = inputfile.read(recordHeader.incl_len);
-         if(record.length() != recordHeader.incl_len)
-         {
-             inputfile.close();
-             outputfile->close();
-             qDebug() << "fromPCAP: PCAP file not complete!";
-             qDebug() << "fromPCAP:" << "Size Error: Cannot read Record";
-             return;
-         }
-         counterRecords ++;
-         quint64 pos = 12;
-         //Read EtherType
-         if(record.size()<(qsizetype)(pos+2))
-         {
-             inputfile.close();
-             outputfile->close();
-             qDebug() << "dltFromPCAP:" << "Size Error: Cannot read Record";
-             return;
-         }
-         quint16 etherType = (((quint16)record.at(pos))<<8)|((quint16)(record.at(pos+1)&0xff));
-         pos+=2;
-         if(!dltFromEthernetFrame(record,pos,etherType,recordHeader.ts_sec,recordHeader.ts_usec))
-         {
-             inputfile.close();
-             outputfile->close();
-             qDebug() << "fromPCAP:" << "Size Error: Cannot read Ethernet Frame";
-             return;
-         }
-         if(!ipcFromEthernetFrame(record,pos,etherType,recordHeader.ts_sec,recordHeader.ts_usec))
-         {
-             inputfile.close();
-             outputfile->close();
-             qDebug() << "fromPCAP:" << "Size Error: Cannot read Ethernet Frame";
-             return;
-         }
+        counterRecords ++;
+
+        /* drop incomplete datagrams and idle connections every 10 seconds of capture time */
+        if(packet.sec - expireTime >= 10)
+        {
+            ipDefragmenter.expire(packet.sec);
+            tcpReassembler.expire(packet.sec);
+            expireTime = packet.sec;
+        }
+
+        /* find the network layer behind the link layer header */
+        int pos;
+        quint16 etherType;
+        switch(packet.linkType)
+        {
+        case QDltPcapLinkTypeEthernet:
+            pos = 12;
+            break;
+        case QDltPcapLinkTypeLinuxSll:
+            pos = 14;
+            break;
+        case QDltPcapLinkTypeLinuxSll2:
+            pos = 0;
+            break;
+        case QDltPcapLinkTypeRaw:
+        case QDltPcapLinkTypeNull:
+            pos = packet.linkType == QDltPcapLinkTypeNull ? 4 : 0;
+            if(packet.size <= pos)
+            {
+                counterRecordsMalformed++;
+                continue;
+            }
+            if(!dltFromIpPacket(packet.data+pos,packet.size-pos,packet.sec,packet.usec))
+                counterRecordsMalformed++;
+            continue;
+        default:
+            counterRecordsMalformed++;
+            continue;
+        }
+        if(packet.size<pos+2)
+        {
+            counterRecordsMalformed++;
+            continue;
+        }
+        etherType = qFromBigEndian<quint16>(packet.data+pos);
+        pos += packet.linkType == QDltPcapLinkTypeLinuxSll2 ? 20 : 2;
+
+        const QByteArray record = QByteArray::fromRawData(packet.data,packet.size);
+        if(!dltFromEthernetFrame(record,pos,etherType,packet.sec,packet.usec) ||
+           !ipcFromEthernetFrame(record,pos,etherType,packet.sec,packet.usec))
+        {
+            counterRecordsMalformed++;
+        }
     }
-    inputfile.close();
+    tcpReassembler.flush();
+    flushOutput();
     outputfile->close();
 
     emit progress("",3,100);
@@ -137,6 +161,12 @@ void QDltImporter::dltIpcFromPCAP(QString fileName)
     qDebug() << "fromPCAP: Counter DLT Mesages:" << counterDLTMessages;
     qDebug() << "fromPCAP: Counter Records IPC:" << counterRecordsIPC;
     qDebug() << "fromPCAP: Counter IPC Mesages:" << counterIPCMessages;
+    qDebug() << "fromPCAP: Counter Records malformed:" << counterRecordsMalformed;
+    qDebug() << "fromPCAP: Counter IP datagrams incomplete:" << ipDefragmenter.getDropped()+ipDefragmenter.size();
+    qDebug() << "fromPCAP: Counter TCP bytes lost:" << tcpReassembler.getBytesLost();
+    qDebug() << "fromPCAP: Counter TCP bytes skipped:" << tcpReassembler.getBytesSkipped();
+    if(reader.getErrors())
+        qDebug() << "fromPCAP: Capture file truncated or corrupted, errors:" << reader.getErrors();
 
     qDebug() << "fromPCAP: Import finished";
 }
@@ -148,6 +178,8 @@ void QDltImporter::dltIpcFromMF4(QString fileName)
     counterRecordsIPC = 0;
     counterDLTMessages = 0;
     counterIPCMessages = 0;
+    counterRecordsMalformed = 0;
+    resetStreams();
     channelGroupLength.clear();
     channelGroupName.clear();
 
@@ -160,10 +192,7 @@ void QDltImporter::dltIpcFromMF4(QString fileName)
     }
 
     /* open output file */
-    if(!outputfile->open(QIODevice::WriteOnly|QIODevice::Append))
-    {
-        qDebug() << "Failed opening WriteOnly" << outputfile->fileName();
-    }
+    openOutput();
 
     int progressCounter = 1;
     emit progress("MF4",1,0);
@@ -315,463 +344,64 @@ void QDltImporter::dltIpcFromMF4(QString fileName)
                 ptrDg=0;
         }
     }
-    // seek to and read data list header
-    inputfile.seek(mdfDgBlockLinks.dg_data);
-    if(inputfile.read((char*)&mdfHeader,sizeof(mdf_hdr_t))!=sizeof(mdf_hdr_t))
-    {
-        inputfile.close();
-        outputfile->close();
-        qDebug() << "fromMF4: Cannot read datalist header";
-        return;
-    }
-    int numberOfLinks = 0;
-    bool isDataBlock = false;
-    if(mdfHeader.id[0]=='#' && mdfHeader.id[1]=='#' && mdfHeader.id[2]=='D' && mdfHeader.id[3]=='L')
-    {
-        // Datalist detected, get number of datablocks
-        numberOfLinks = mdfHeader.link_count;
-        qDebug() << "fromMF4: Datalist detected";
-    }
-    else if(mdfHeader.id[0]=='#' && mdfHeader.id[1]=='#' && mdfHeader.id[2]=='D' && mdfHeader.id[3]=='T')
-    {
-        // Only one Datalblock detected
-        numberOfLinks = 2;
-        isDataBlock = true;
-        qDebug() << "fromMF4: Datablock detected";
-    }
-    else
+    inputfile.close();
+
+    // the data blocks are read and decompressed ahead by worker threads, the records are parsed in file order
+    QDltMf4Reader reader;
+    if(!reader.open(fileName,mdfDgBlockLinks.dg_data))
     {
-        inputfile.close();
         outputfile->close();
         qDebug() << "fromMF4: Cannot find Datalist or Datablock";
         return;
     }
-    for(int num=1;num<numberOfLinks;num++)
+    qDebug() << "fromMF4: Data blocks:" << reader.getBlockCount();
+
+    QByteArray buffer,block,recordData;
+    int pos = 0;
+    int errors = 0;
+    while(reader.readBlock(block))
     {
-        if(!isDataBlock)
+        int percent = reader.getBlockIndex()*100/reader.getBlockCount();
+        if(percent>=progressCounter)
         {
-            quint64 addressOfDataBlock;
-            inputfile.seek(mdfDgBlockLinks.dg_data+sizeof(mdf_hdr_t)+num*sizeof(quint64));
-            if(inputfile.read((char*)&addressOfDataBlock,sizeof(quint64))!=sizeof(quint64))
-            {
-                inputfile.close();
-                outputfile->close();
-                qDebug() << "fromMF4: Cannot read datablock address";
-                return;
-            }
-            inputfile.seek(addressOfDataBlock);
-            if(inputfile.read((char*)&mdfHeader,sizeof(mdf_hdr_t))!=sizeof(mdf_hdr_t))
+            progressCounter += 1;
+            emit progress("MF4:",2,percent); // every 1%
+            if((percent>0) && ((percent%10)==0))
             {
-                inputfile.close();
-                outputfile->close();
-                qDebug() << "fromMF4: Cannot read datablock header";
-                return;
+                qDebug() << "Import MF4:" << percent << "%"; // every 10%
             }
         }
-        if(mdfHeader.id[0]=='#' && mdfHeader.id[1]=='#' && mdfHeader.id[2]=='D' && mdfHeader.id[3]=='T')
-        {
-            const auto pos = inputfile.pos() - sizeof(mdf_hdr_t);
-            quint64 posDt=0;
-            quint16 recordId;
-            quint32 lengthVLSD;
-            mdf_ethFrame ethFrame;
-            mdf_plpRaw_t plpRaw;
-            mdf_dltFrame_t dltFrameBlock;
-            QByteArray recordData;
-            quint64 fileSize = inputfile.size();
-            while(posDt<(mdfHeader.length-sizeof(mdf_hdr_t)))
-            {
-                int percent = inputfile.pos()*100/fileSize;
-                if(percent>=progressCounter)
-                {
-                    progressCounter += 1;
-                    emit progress("MF4:",2,percent); // every 1%
-                    if((percent>0) && ((percent%10)==0))
-                    {
-                        qDebug() << "Import MF4:" << percent << "%"; // every 10%
-                    }
-                }
-                //qDebug() << "Record:" << counterRecords << pos << posDt;
 
-                // TODO: Handle cancel operation
+        // TODO: Handle cancel operation
 
-                //qDebug() << "posDt =" << posDt;
-                inputfile.seek(pos+sizeof(mdf_hdr_t)+posDt);
-                counterRecords++;
-                if(inputfile.read((char*)&recordId,sizeof(quint16))!=sizeof(quint16))
-                {
-                    inputfile.close();
-                    outputfile->close();
-                    qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                    return;
-                }
-                posDt += sizeof(quint16);
-                if(channelGroupLength.contains(recordId))
-                {
-                    QString name;
-                    if(channelGroupName.contains(recordId))
-                        name = channelGroupName[recordId];
-                    if(channelGroupLength[recordId]==-1)
-                    {
-                        if(inputfile.read((char*)&lengthVLSD,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        posDt += sizeof(quint32);
-                        posDt += lengthVLSD;
-                        recordData = inputfile.read(lengthVLSD);
-                        //qDebug() << "recordId =" << recordId << "length =" << lengthVLSD;
-                    }
-                    else if(channelGroupLength[recordId]==43)
-                    {
-                        // Ethernet Group
-                        if(inputfile.read((char*)&ethFrame.timeStamp,sizeof(quint64))!=sizeof(quint64))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.asynchronous,sizeof(quint8))!=sizeof(quint8))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.source,6)!=6)
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.destination,6)!=6)
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.etherType,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.crc,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.receivedDataByteCount,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.dataLength,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.dataBytes,sizeof(quint64))!=sizeof(quint64))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(!recordData.isEmpty())
-                        {
-                            quint64 time = hdBlockLinks.start_time_ns+ethFrame.timeStamp+(hdBlockLinks.hd_tz_offset_min+hdBlockLinks.hd_dst_offset_min)*60*1000000000;
-                            if(!dltFromEthernetFrame(recordData,0,ethFrame.etherType,time/1000000000,time%1000000000/1000))
-                            {
-                                inputfile.close();
-                                outputfile->close();
-                                qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read Ethernet Frame";
-                                return;
-                            }
-                            if(!ipcFromEthernetFrame(recordData,0,ethFrame.etherType,time/1000000000,time%1000000000/1000))
-                            {
-                                inputfile.close();
-                                outputfile->close();
-                                qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read Ethernet Frame";
-                                return;
-                            }
-                            recordData.clear();
-                        }
-                        posDt += channelGroupLength[recordId];
-                    }
-                    else if(channelGroupLength[recordId]==51)
-                    {
-                        // Ethernet Group
-                        if(inputfile.read((char*)&ethFrame.timeStamp,sizeof(quint64))!=sizeof(quint64))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.asynchronous,sizeof(quint8))!=sizeof(quint8))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.source,6)!=6)
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.destination,6)!=6)
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.etherType,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.crc,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.receivedDataByteCount,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.beaconTimeStamp,sizeof(quint64))!=sizeof(quint64)) // TODO: Beacon Time Stamp
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.dataLength,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&ethFrame.dataBytes,sizeof(quint64))!=sizeof(quint64))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(!recordData.isEmpty())
-                        {
-                            int pos = 0;
-                            quint64 time = hdBlockLinks.start_time_ns+ethFrame.timeStamp+(hdBlockLinks.hd_tz_offset_min+hdBlockLinks.hd_dst_offset_min)*60*1000000000;
-                            if(!dltFromEthernetFrame(recordData,pos,ethFrame.etherType,time/1000000000,time%1000000000/1000))
-                            {
-                                inputfile.close();
-                                outputfile->close();
-                                qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read Ethernet Frame";
-                                return;
-                            }
-                            pos = 0;
-                            if(!ipcFromEthernetFrame(recordData,pos,ethFrame.etherType,time/1000000000,time%1000000000/1000))
-                            {
-                                inputfile.close();
-                                outputfile->close();
-                                qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read Ethernet Frame";
-                                return;
-                            }
-                            recordData.clear();
-                        }
-                        posDt += channelGroupLength[recordId];
-                    }
-                    else if(channelGroupLength[recordId]==29 && name=="DLT_Frame")
-                    {
-                        // DLT Frame
-                        if(inputfile.read((char*)&dltFrameBlock.timeStamp,sizeof(quint64))!=sizeof(quint64))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&dltFrameBlock.asynchronous,sizeof(quint8))!=sizeof(quint8))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&dltFrameBlock.currentFragmentNumber,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&dltFrameBlock.lastFragmentNumber,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&dltFrameBlock.ecuId,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&dltFrameBlock.dataLength,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&dltFrameBlock.dataBytes,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(!recordData.isEmpty())
-                        {
-                            int pos = 0;
-                            quint64 time = hdBlockLinks.start_time_ns+dltFrameBlock.timeStamp+(hdBlockLinks.hd_tz_offset_min+hdBlockLinks.hd_dst_offset_min)*60*1000000000;
-                            if(!dltFrame(recordData,pos,time/1000000000,time%1000000000/1000))
-                            {
-                                inputfile.close();
-                                outputfile->close();
-                                qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read DLTFrame";
-                                return;
-                            }
-                            recordData.clear();
-                        }
-                        posDt += channelGroupLength[recordId];
-                    }
-                    else if(channelGroupLength[recordId]==29)
-                    {
-                        // PLP Raw
-                        if(inputfile.read((char*)&plpRaw.timeStamp,sizeof(quint64))!=sizeof(quint64))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.asynchronous,sizeof(quint8))!=sizeof(quint8))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.probeId,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.msgType,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.probeFlags,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.dataFlags,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.dataCounter,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.dataLength,sizeof(quint16))!=sizeof(quint16))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(inputfile.read((char*)&plpRaw.dataBytes,sizeof(quint32))!=sizeof(quint32))
-                        {
-                            inputfile.close();
-                            outputfile->close();
-                            qDebug() << "fromMF4:" << "Size Error: Cannot read Record";
-                            return;
-                        }
-                        if(!recordData.isEmpty())
-                        {
-                            quint64 time = hdBlockLinks.start_time_ns+plpRaw.timeStamp+(hdBlockLinks.hd_tz_offset_min+hdBlockLinks.hd_dst_offset_min)*60*1000000000;
-                            if(!ipcFromPlpRaw(&plpRaw,recordData,time/1000000000,time%1000000000/1000))
-                            {
-                                inputfile.close();
-                                outputfile->close();
-                                qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read Ethernet Frame";
-                                return;
-                            }
-                            recordData.clear();
-                        }
-                        posDt += channelGroupLength[recordId];
-                    }
-                    else
-                    {
-                        qDebug() << "fromMF4: ERROR: Unknown recordId =" << recordId << "Length =" << channelGroupLength[recordId];
-                        qDebug() << "fromMF4: But try to continue read file.";
-                        posDt += channelGroupLength[recordId];
-                    }
-                }
-                else
-                {
-                    qDebug() << "fromMF4: ERROR: Unknown recordId =" << recordId;
-                    break;
-                }
-            }
+        if(reader.getErrors()!=errors)
+        {
+            // data is missing, the record in front of the gap is lost
+            qDebug() << "fromMF4: ERROR: Cannot read data block";
+            errors = reader.getErrors();
+            buffer.clear();
+            pos = 0;
+            recordData.clear();
+        }
+
+        // a record may continue in the next block
+        if(pos<buffer.size())
+            buffer = buffer.mid(pos) + block;
+        else
+            buffer = block;
+        pos = 0;
+        if(!recordsFromMF4(buffer,pos,recordData))
+        {
+            // unknown record, continue with the next block
+            buffer.clear();
+            pos = 0;
         }
     }
+    if(pos<buffer.size())
+        qDebug() << "fromMF4: ERROR: Last record not complete";
 
-    inputfile.close();
+    tcpReassembler.flush();
+    flushOutput();
     outputfile->close();
 
     emit progress("",3,100);
@@ -781,10 +411,99 @@ void QDltImporter::dltIpcFromMF4(QString fileName)
     qDebug() << "fromMF4: counterDLTMessages:" << counterDLTMessages;
     qDebug() << "fromMF4: counterRecordsIPC:" << counterRecordsIPC;
     qDebug() << "fromMF4: counterIPCMessages:" << counterIPCMessages;
+    qDebug() << "fromMF4: counterRecordsMalformed:" << counterRecordsMalformed;
 
     qDebug() << "fromMF4: Import finished";
 }
 
+bool QDltImporter::recordsFromMF4(const QByteArray &data,int &pos,QByteArray &recordData)
+{
+    const char *ptr = data.constData();
+    const qint64 timeOffset = hdBlockLinks.start_time_ns+(hdBlockLinks.hd_tz_offset_min+hdBlockLinks.hd_dst_offset_min)*60*1000000000LL;
+    while(data.size()-pos>=2)
+    {
+        quint16 recordId = qFromLittleEndian<quint16>(ptr+pos);
+        const auto length = channelGroupLength.constFind(recordId);
+        if(length==channelGroupLength.constEnd())
+        {
+            qDebug() << "fromMF4: ERROR: Unknown recordId =" << recordId;
+            return false;
+        }
+        if(*length==-1)
+        {
+            // variable length data, used by the next record
+            if(data.size()-pos<6)
+                break;
+            quint32 lengthVLSD = qFromLittleEndian<quint32>(ptr+pos+2);
+            if(quint64(data.size()-pos-6)<lengthVLSD)
+                break;
+            recordData = QByteArray(ptr+pos+6,lengthVLSD);
+            pos += 6+lengthVLSD;
+            counterRecords++;
+            continue;
+        }
+        if(data.size()-pos<2+*length)
+            break;
+        const char *record = ptr+pos+2;
+        pos += 2+*length;
+        counterRecords++;
+
+        if(*length==43 || *length==51)
+        {
+            // Ethernet Group, with beacon time stamp if 51 bytes
+            mdf_ethFrame_t ethFrame;
+            memcpy(&ethFrame.etherType,record+21,sizeof(quint16));
+            memcpy(&ethFrame.timeStamp,record,sizeof(quint64));
+            if(!recordData.isEmpty())
+            {
+                quint64 time = timeOffset+qFromLittleEndian(ethFrame.timeStamp);
+                quint16 etherType = qFromLittleEndian(ethFrame.etherType);
+                if(!dltFromEthernetFrame(recordData,0,etherType,time/1000000000,time%1000000000/1000) ||
+                   !ipcFromEthernetFrame(recordData,0,etherType,time/1000000000,time%1000000000/1000))
+                {
+                    qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read Ethernet Frame";
+                    counterRecordsMalformed++;
+                }
+                recordData.clear();
+            }
+        }
+        else if(*length==29 && channelGroupName.value(recordId)=="DLT_Frame")
+        {
+            // DLT Frame
+            mdf_dltFrame_t dltFrameBlock;
+            memcpy(&dltFrameBlock,record,sizeof(mdf_dltFrame_t));
+            if(!recordData.isEmpty())
+            {
+                quint64 time = timeOffset+qFromLittleEndian(dltFrameBlock.timeStamp);
+                dltFrame(recordData.constData(),recordData.size(),time/1000000000,time%1000000000/1000);
+                recordData.clear();
+            }
+        }
+        else if(*length==29)
+        {
+            // PLP Raw
+            mdf_plpRaw_t plpRaw;
+            memcpy(&plpRaw,record,sizeof(mdf_plpRaw_t));
+            if(!recordData.isEmpty())
+            {
+                quint64 time = timeOffset+qFromLittleEndian(plpRaw.timeStamp);
+                if(!ipcFromPlpRaw(&plpRaw,recordData,time/1000000000,time%1000000000/1000))
+                {
+                    qDebug() << "fromMF4: ERROR:" << "Size Error: Cannot read PLP Raw";
+                    counterRecordsMalformed++;
+                }
+                recordData.clear();
+            }
+        }
+        else
+        {
+            qDebug() << "fromMF4: ERROR: Unknown recordId =" << recordId << "Length =" << *length;
+            qDebug() << "fromMF4: But try to continue read file.";
+        }
+    }
+    return true;
+}
+
 DltStorageHeader QDltImporter::makeDltStorageHeader(std::optional<DltStorageHeaderTimestamp> ts)
 {
     DltStorageHeader result;
@@ -815,7 +534,7 @@ DltStorageHeader QDltImporter::makeDltStorageHeader(std::optional<DltStorageHead
     return result;
 }
 
-bool QDltImporter::ipcFromEthernetFrame(QByteArray &record,int pos,quint16 etherType,quint32 sec,quint32 usec)
+bool QDltImporter::ipcFromEthernetFrame(const QByteArray &record,int pos,quint16 etherType,quint32 sec,quint32 usec)
 {
     if(etherType==0x9100 || etherType==0x88a8)
     {
@@ -848,7 +567,7 @@ bool QDltImporter::ipcFromEthernetFrame(QByteArray &record,int pos,quint16 ether
            qDebug() << "ipcFromEthernetFrame: Size issue!";
            return false;
        }
-       plp_header_t *plpHeader = (plp_header_t *) (record.data()+pos);
+       const plp_header_t *plpHeader = (const plp_header_t *) (record.constData()+pos);
 
        pos += sizeof(plp_header_t);
 
@@ -869,7 +588,7 @@ bool QDltImporter::ipcFromEthernetFrame(QByteArray &record,int pos,quint16 ether
            counterRecordsIPC++;
            while(record.size()>=(qsizetype)(pos+sizeof(plp_header_data_t)))
            {
-               plp_header_data_t *plpHeaderData = (plp_header_data_t *) (record.data()+pos);
+               const plp_header_data_t *plpHeaderData = (const plp_header_data_t *) (record.constData()+pos);
 
                pos += sizeof(plp_header_data_t);
 
@@ -1048,23 +767,20 @@ bool QDltImporter::ipcFromPlpRaw(mdf_plpRaw_t *plpRaw,QByteArray &record,quint32
     return true;
 }
 
-bool QDltImporter::dltFrame(QByteArray &record,int pos,quint32 sec,quint32 usec)
+bool QDltImporter::dltFrame(const char *data,int size,quint32 sec,quint32 usec)
 {
     counterRecordsDLT++;
     // Now read the DLT Messages
-    quint64 dataSize;
-    dataSize = record.size()-pos;
-    char* dataPtr = record.data()+pos;
+    quint64 dataSize = size>0 ? size : 0;
+    const char* dataPtr = data;
     // Find one ore more DLT messages in the UDP message
     while(dataSize>0)
     {
-        QDltMsg qmsg;
-        quint64 sizeMsg = qmsg.checkMsgSize(dataPtr,dataSize);
+        quint64 sizeMsg = QDltMsg::getMsgSize(dataPtr,dataSize);
         if(sizeMsg>0)
         {
             // DLT message found, write it with storage header
-            QByteArray empty;
-            writeDLTMessageToFile(empty,dataPtr,sizeMsg,0,sec,usec);
+            writeDLTMessageToFile(QByteArray(),dataPtr,sizeMsg,QString(),sec,usec);
             counterDLTMessages++;
 
             //totalBytesRcvd+=sizeMsg;
@@ -1087,8 +803,7 @@ bool QDltImporter::dltFrame(QByteArray &record,int pos,quint32 sec,quint32 usec)
     return true;
 }
 
-
-bool QDltImporter::dltFromEthernetFrame(QByteArray &record,int pos,quint16 etherType,quint32 sec,quint32 usec)
+bool QDltImporter::dltFromEthernetFrame(const QByteArray &record,int pos,quint16 etherType,quint32 sec,quint32 usec)
 {
     if(etherType==0x9100 || etherType==0x88a8)
     {
@@ -1121,13 +836,13 @@ bool QDltImporter::dltFromEthernetFrame(QByteArray &record,int pos,quint16 ether
             qDebug() << "dltFromEthernetFrame: Size issue!";
             return false;
         }
-        plp_header_t *plpHeader = (plp_header_t *) (record.data()+pos);
+        const plp_header_t *plpHeader = (const plp_header_t *) (record.constData()+pos);
 
         pos += sizeof(plp_header_t);
 
         if(/*qFromBigEndian(plpHeader->probeId) == 0x62 &&*/ qFromBigEndian(plpHeader->msgType) == 0x80)
         {
-            plp_header_data_t *plpHeaderData = (plp_header_data_t *) (record.data()+pos);
+            const plp_header_data_t *plpHeaderData = (const plp_header_data_t *) (record.constData()+pos);
 
             pos += sizeof(plp_header_data_t);
 
@@ -1151,92 +866,222 @@ bool QDltImporter::dltFromEthernetFrame(QByteArray &record,int pos,quint16 ether
             }
         }
     }
-    if(etherType==0x0800) // IP packet found
+    if(etherType==0x0800 || etherType==0x86dd) // IP packet found
     {
-       pos+=4;
-       if(record.size()<(pos+2))
-       {
-           qDebug() << "Size issue!";
-           return false;
-       }
-       //quint16 identification = (((quint16)record.at(pos))<<8)|((quint16)(record.at(pos+1)&0xff));
-       pos+=2;
-       if(record.size()<(pos+2))
-       {
-           qDebug() << "Size issue!";
-           return false;
-       }
-       quint16 flagsOffset = (((quint16)record.at(pos))<<8)|((quint16)(record.at(pos+1)&0xff));
-       quint16 flags =  flagsOffset >> 13; // TODO: Flags are in the wrong bit order
-       quint16 offset =  flagsOffset & 0x1fff;
-       pos+=3;
-       if(record.size()<(pos+2))
-       {
-           qDebug() << "Size issue!";
-           return false;
-       }
-       quint8 protocol = record.at(pos);
-       if(protocol==0x11) // UDP packet found
-       {
-           pos+=11;
-           if((flags==0 || flags==2) && offset==0)
-           {
-               // no fragmentation
-               pos+=2;
-               if(record.size()<(pos+2))
-               {
-                   qDebug() << "Size issue!";
-                   return false;
-               }
-               quint16 destPort = (((quint16)record.at(pos))<<8)|((quint16)(record.at(pos+1)&0xff));
-               if(destPort==3490||destPort==3489)
-               {
-                   pos+=6;
-                   dltFrame(record,pos,sec,usec);
-               }
-           }
-           else
-           {
-               //fragmentation
-               if(flags==0)
-               {
-                   // last fragment
-                   segmentBufferUDP += QByteArray(record.data()+pos,record.size()-pos);
+        if(record.size()<=pos)
+        {
+            qDebug() << "dltFromEthernetFrame: Size issue!";
+            return false;
+        }
+        return dltFromIpPacket(record.constData()+pos,record.size()-pos,sec,usec);
+    }
+    return true;
+}
 
-                   pos=2;
-                   if(segmentBufferUDP.size()<(pos+2))
-                   {
-                       qDebug() << "Size issue!";
-                       return false;
-                   }
-                   quint16 destPort = (((quint16)segmentBufferUDP.at(pos))<<8)|((quint16)(segmentBufferUDP.at(pos+1)&0xff));
-                   if(destPort==3490||destPort==3489)
-                   {
-                       pos+=6;
-                       dltFrame(segmentBufferUDP,pos,sec,usec);
-                   }
-                   segmentBufferUDP.clear();
-               }
-               else
-               {
-                   // first or further fragment
-                   segmentBufferUDP += QByteArray(record.data()+pos,record.size()-pos);
-               }
-           }
-       }
+bool QDltImporter::dltFromIpPacket(const char *data,int size,quint32 sec,quint32 usec)
+{
+    const uchar *ip = reinterpret_cast<const uchar*>(data);
+    QDltFlowKey key;
+    int headerLength;
+    int fragmentOffset = 0;
+    bool moreFragments = false;
+    bool fragmented = false;
+
+    if(size<1)
+        return false;
+    const int version = ip[0] >> 4;
+    if(version==4)
+    {
+        headerLength = (ip[0] & 0x0f) * 4;
+        if(headerLength<20 || size<headerLength)
+        {
+            qDebug() << "dltFromIpPacket: Size issue!";
+            return false;
+        }
+        // ignore the Ethernet padding behind the packet
+        size = qMin<int>(size,qFromBigEndian<quint16>(ip+2));
+        if(size<headerLength)
+        {
+            qDebug() << "dltFromIpPacket: Size issue!";
+            return false;
+        }
+        const quint16 flagsOffset = qFromBigEndian<quint16>(ip+6);
+        moreFragments = flagsOffset & 0x2000;
+        fragmentOffset = (flagsOffset & 0x1fff) * 8;
+        fragmented = moreFragments || fragmentOffset;
+        key.protocol = ip[9];
+        key.id = qFromBigEndian<quint16>(ip+4);
+        memcpy(key.source,ip+12,4);
+        memcpy(key.destination,ip+16,4);
+    }
+    else if(version==6)
+    {
+        if(size<40)
+        {
+            qDebug() << "dltFromIpPacket: Size issue!";
+            return false;
+        }
+        size = qMin<int>(size,40+qFromBigEndian<quint16>(ip+4));
+        memcpy(key.source,ip+8,16);
+        memcpy(key.destination,ip+24,16);
+        headerLength = 40;
+        quint8 nextHeader = ip[6];
+        // skip the extension headers up to the transport layer
+        while(nextHeader==0 || nextHeader==43 || nextHeader==44 || nextHeader==60)
+        {
+            if(size<headerLength+8)
+            {
+                qDebug() << "dltFromIpPacket: Size issue!";
+                return false;
+            }
+            const uchar *extension = ip+headerLength;
+            if(nextHeader==44)
+            {
+                const quint16 flagsOffset = qFromBigEndian<quint16>(extension+2);
+                moreFragments = flagsOffset & 0x1;
+                fragmentOffset = flagsOffset & 0xfff8;
+                fragmented = true;
+                key.id = qFromBigEndian<quint32>(extension+4);
+                nextHeader = extension[0];
+                headerLength += 8;
+            }
+            else
+            {
+                nextHeader = extension[0];
+                headerLength += (extension[1]+1)*8;
+            }
+        }
+        if(size<headerLength)
+        {
+            qDebug() << "dltFromIpPacket: Size issue!";
+            return false;
+        }
+        key.protocol = nextHeader;
+    }
+    else
+    {
+        return true; // no IP packet
+    }
+
+    if(key.protocol!=0x11 && key.protocol!=0x06)
+        return true; // neither UDP nor TCP
+
+    if(!fragmented)
+        return dltFromTransport(key,data+headerLength,size-headerLength,sec,usec);
+
+    // fragments of different datagrams may be interleaved, they are collected per datagram
+    QByteArray datagram;
+    if(!ipDefragmenter.addFragment(key,fragmentOffset,moreFragments,data+headerLength,size-headerLength,sec,datagram))
+        return true;
+    return dltFromTransport(key,datagram.constData(),datagram.size(),sec,usec);
+}
+
+bool QDltImporter::dltFromTransport(const QDltFlowKey &key,const char *data,int size,quint32 sec,quint32 usec)
+{
+    const uchar *header = reinterpret_cast<const uchar*>(data);
+    if(key.protocol==0x11) // UDP packet found
+    {
+        if(size<8)
+        {
+            qDebug() << "dltFromTransport: Size issue!";
+            return false;
+        }
+        const quint16 destPort = qFromBigEndian<quint16>(header+2);
+        if(destPort==3490||destPort==3489)
+        {
+            dltFrame(data+8,size-8,sec,usec);
+        }
+    }
+    else if(key.protocol==0x06) // TCP segment found
+    {
+        if(size<20)
+        {
+            qDebug() << "dltFromTransport: Size issue!";
+            return false;
+        }
+        const quint16 sourcePort = qFromBigEndian<quint16>(header);
+        const quint16 destPort = qFromBigEndian<quint16>(header+2);
+        const int headerLength = (header[12] >> 4) * 4;
+        if(headerLength<20 || size<headerLength)
+        {
+            qDebug() << "dltFromTransport: Size issue!";
+            return false;
+        }
+        // DLT is sent by the ECU from the DLT port
+        if(sourcePort==3490||sourcePort==3489||destPort==3490||destPort==3489)
+        {
+            QDltFlowKey stream = key;
+            stream.id = (quint32(sourcePort) << 16) | destPort;
+            const quint8 flags = header[13] & (QDltTcpReassembler::FlagFin|QDltTcpReassembler::FlagSyn|QDltTcpReassembler::FlagRst);
+            if(size>headerLength)
+                counterRecordsDLT++;
+            streamSec = sec;
+            streamUsec = usec;
+            tcpReassembler.addSegment(stream,qFromBigEndian<quint32>(header+4),flags,data+headerLength,size-headerLength,sec);
+        }
     }
     return true;
 }
 
-void QDltImporter::writeDLTMessageToFile(QByteArray &bufferHeader,char* bufferPayload,quint32 bufferPayloadSize,QString ecuId,quint32 sec,quint32 usec)
+void QDltImporter::resetStreams()
+{
+    ipDefragmenter.clear();
+    tcpReassembler.clear();
+}
+
+void QDltImporter::writeDLTMessageToFile(const QByteArray &bufferHeader,const char* bufferPayload,quint32 bufferPayloadSize,const QString &ecuId,quint32 sec,quint32 usec)
 {
     const auto timestamp =
         (sec || usec) ? std::optional<DltStorageHeaderTimestamp>({sec, usec}) : std::nullopt;
     DltStorageHeader str = makeDltStorageHeader(timestamp);
 
-    dlt_set_id(str.ecu, ecuId.toLatin1());
+    if(!ecuId.isEmpty())
+        dlt_set_id(str.ecu, ecuId.toLatin1());
+
+    // the message size is known, so the index is built while writing
+    indexAll.append(outputPosition);
+    outputPosition += sizeof(DltStorageHeader) + bufferHeader.size() + bufferPayloadSize;
+
+    if(outputBuffer.capacity() < OUTPUT_BUFFER_SIZE)
+        outputBuffer.reserve(OUTPUT_BUFFER_SIZE);
+    outputBuffer.append((const char*)&str,sizeof(DltStorageHeader));
+    outputBuffer.append(bufferHeader);
+    outputBuffer.append(bufferPayload,bufferPayloadSize);
+    if(outputBuffer.size() >= OUTPUT_BUFFER_SIZE)
+        flushOutput();
+}
 
-    outputfile->write((char*)&str,sizeof(DltStorageHeader));
-    outputfile->write(bufferHeader);
-    outputfile->write(bufferPayload,bufferPayloadSize);
+void QDltImporter::openOutput()
+{
+    if(!outputfile->open(QIODevice::WriteOnly|QIODevice::Append))
+    {
+        qDebug() << "Failed opening WriteOnly" << outputfile->fileName();
+        indexValid = false;
+    }
+    // the index only covers the file if nothing else was written since the last import
+    else if(outputfile->size() != outputPosition)
+    {
+        indexValid = false;
+    }
+}
+
+bool QDltImporter::getDltIndex(QVector<qint64> &index) const
+{
+    if(!indexValid)
+        return false;
+    index = indexAll;
+    return true;
+}
+
+void QDltImporter::flushOutput()
+{
+    if(outputBuffer.isEmpty())
+        return;
+    if(outputfile->write(outputBuffer) != outputBuffer.size())
+    {
+        qDebug() << "Failed writing" << outputfile->fileName();
+        indexValid = false;
+    }
+    // truncate keeps the reserved memory for the next messages
+    outputBuffer.truncate(0);
 }
@@ -2,32 +2,17 @@
 #define QDLTIMPORTER_H
 
 #include <QMap>
+#include <QVector>
 #include <QThread>
 #include <QObject>
 #include <QFile>
 
 #include "export_rules.h"
 #include "dlt_common.h"
+#include "qdltpacketreassembler.h"
 
 #include <optional>
 
-typedef struct pcap_hdr_s {
-        quint32 magic_number;   /* magic number */
-        quint16 version_major;  /* major version number */
-        quint16 version_minor;  /* minor version number */
-        qint32  thiszone;       /* GMT to local correction */
-        quint32 sigfigs;        /* accuracy of timestamps */
-        quint32 snaplen;        /* max length of captured packets, in octets */
-        quint32 network;        /* data link type */
-} PACKED pcap_hdr_t;
-
-typedef struct pcaprec_hdr_s {
-        quint32 ts_sec;         /* timestamp seconds */
-        quint32 ts_usec;        /* timestamp microseconds */
-        quint32 incl_len;       /* number of octets of packet saved in file */
-        quint32 orig_len;       /* actual length of packet */
-} PACKED pcaprec_hdr_t;
-
 typedef struct plp_header {
         quint16 probeId;
         quint16 counter;
@@ -173,6 +158,15 @@ public:
 
     void setOutputfile(QFile *newOutputfile);
 
+    //! Get the index of all messages written to the output file.
+    /*!
+      The position of each message is recorded while it is written, so the output
+      file does not need to be scanned again, see QDltFile::setDltIndex().
+      \param index Set to the positions of the messages in the output file.
+      \return false if the output file was not empty or a write failed, the file must be indexed then.
+    */
+    bool getDltIndex(QVector<qint64> &index) const;
+
     struct DltStorageHeaderTimestamp {
         quint32 sec;
         quint32 usec;
@@ -181,12 +175,18 @@ public:
 
   private:
 
-    bool dltFrame(QByteArray &record,int pos,quint32 sec = 0,quint32 usec = 0);
-    bool dltFromEthernetFrame(QByteArray &record,int pos,quint16 etherType,quint32 sec = 0,quint32 usec = 0);
-    bool ipcFromEthernetFrame(QByteArray &record,int pos,quint16 etherType,quint32 sec = 0,quint32 usec = 0);
+    bool dltFrame(const char *data,int size,quint32 sec = 0,quint32 usec = 0);
+    bool dltFromEthernetFrame(const QByteArray &record,int pos,quint16 etherType,quint32 sec = 0,quint32 usec = 0);
+    bool dltFromIpPacket(const char *data,int size,quint32 sec = 0,quint32 usec = 0);
+    bool dltFromTransport(const QDltFlowKey &key,const char *data,int size,quint32 sec,quint32 usec);
+    void resetStreams();
+    bool ipcFromEthernetFrame(const QByteArray &record,int pos,quint16 etherType,quint32 sec = 0,quint32 usec = 0);
+    bool recordsFromMF4(const QByteArray &data,int &pos,QByteArray &recordData);
     bool ipcFromPlpRaw(mdf_plpRaw_t *plpRaw, QByteArray &record,quint32 sec = 0,quint32 usec = 0);
 
-    void writeDLTMessageToFile(QByteArray &bufferHeader,char* bufferPayload,quint32 bufferPayloadSize,QString ecuId,quint32 sec = 0,quint32 usec = 0);
+    void writeDLTMessageToFile(const QByteArray &bufferHeader,const char* bufferPayload,quint32 bufferPayloadSize,const QString &ecuId,quint32 sec = 0,quint32 usec = 0);
+    void openOutput();
+    void flushOutput();
 
     mdf_idblock_t mdfIdblock;
     mdf_hdblocklinks_t hdBlockLinks;
@@ -197,9 +197,16 @@ public:
     quint64 counterRecordsDLT = 0;
     quint64 counterRecordsIPC = 0;
 
+    quint64 counterRecordsMalformed = 0;
+
     bool inSegment = false;
     QByteArray segmentBuffer;
-    QByteArray segmentBufferUDP;
+
+    // IP fragments and TCP streams of all flows, the handler writes the messages with the time of the current packet
+    QDltIpDefragmenter ipDefragmenter;
+    QDltTcpReassembler tcpReassembler;
+    quint32 streamSec = 0;
+    quint32 streamUsec = 0;
 
     QMap<quint16,int> channelGroupLength;
     QMap<quint16,QString> channelGroupName;
@@ -207,6 +214,14 @@ public:
     QFile *outputfile;
     QStringList fileNames;
 
+    // messages not yet written to the output file, see flushOutput()
+    QByteArray outputBuffer;
+
+    // positions of the written messages, valid if the output file was empty at the first import
+    QVector<qint64> indexAll;
+    qint64 outputPosition = 0;
+    bool indexValid = true;
+
 signals:
 
     void progress(QString name,int status, int progress);
@@ -0,0 +1,442 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltlivereader.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QDebug>
+#include <QHostAddress>
+#include <QNetworkInterface>
+#include <QSerialPort>
+#include <QSocketNotifier>
+#include <QTcpSocket>
+#include <QUdpSocket>
+
+#include <algorithm>
+#include <time.h>
+
+#include "qdltlivereader.h"
+#include "qdltudpreceiver.h"
+
+namespace {
+
+// datagrams read with one system call, and batches read before returning to the event loop
+const int UDP_BATCH_SIZE = 64;
+const int UDP_MAX_BATCHES = 16;
+
+// time in ms between the checks for stop() while the sink is overloaded
+const int OVERLOAD_WAIT = 100;
+
+void currentTime(quint32 &sec, quint32 &usec)
+{
+    struct timespec ts;
+    if(timespec_get(&ts, TIME_UTC))
+    {
+        sec = quint32(ts.tv_sec);
+        usec = quint32(ts.tv_nsec / 1000);
+    }
+    else
+    {
+        sec = 0;
+        usec = 0;
+    }
+}
+
+}
+
+QDltLiveReader::QDltLiveReader(int ecu, const Settings &settings, QDltLiveSink *sink)
+    : ecu(ecu), settings(settings), sink(sink),
+      tcpSocket(nullptr), udpSocket(nullptr), udpReceiver(nullptr), udpNotifier(nullptr), serialPort(nullptr),
+      state(QDltConnection::QDltConnectionOffline), stopping(false), bytesReceived(0), bytesError(0), syncFound(0), datagramsDropped(0)
+{
+    moveToThread(&thread);
+}
+
+QDltLiveReader::~QDltLiveReader()
+{
+    stop();
+}
+
+void QDltLiveReader::start()
+{
+    if(thread.isRunning())
+        return;
+    stopping = false;
+    thread.start();
+    QMetaObject::invokeMethod(this, "open", Qt::QueuedConnection);
+}
+
+void QDltLiveReader::stop()
+{
+    if(!thread.isRunning())
+        return;
+    // the thread may wait for the consumer of the sink
+    stopping = true;
+    // the sockets are deleted in the thread which created them
+    QMetaObject::invokeMethod(this, "close", Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+}
+
+void QDltLiveReader::write(const QByteArray &data)
+{
+    QMetaObject::invokeMethod(this, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, data));
+}
+
+QDltLiveReader::Statistics QDltLiveReader::takeStatistics()
+{
+    Statistics statistics;
+    statistics.bytesReceived = bytesReceived.exchange(0);
+    statistics.bytesError = bytesError.exchange(0);
+    statistics.syncFound = syncFound.exchange(0);
+    statistics.datagramsDropped = datagramsDropped.exchange(0);
+    return statistics;
+}
+
+void QDltLiveReader::setState(int newState, const QString &error)
+{
+    if(state == newState && error.isEmpty())
+        return;
+    state = newState;
+    emit stateChanged(ecu, newState, error);
+}
+
+void QDltLiveReader::open()
+{
+    connection.clear();
+    connection.setSyncSerialHeader(settings.syncSerialHeader);
+
+    switch(settings.type)
+    {
+    case TypeTcp:
+        tcpSocket = new QTcpSocket(this);
+        connect(tcpSocket, &QTcpSocket::readyRead, this, &QDltLiveReader::read);
+        connect(tcpSocket, &QTcpSocket::stateChanged, this, &QDltLiveReader::socketStateChanged);
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        connect(tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketError()));
+#else
+        connect(tcpSocket, &QAbstractSocket::errorOccurred, this, &QDltLiveReader::socketError);
+#endif
+        setState(QDltConnection::QDltConnectionConnecting);
+        tcpSocket->connectToHost(settings.hostname, settings.port);
+        break;
+    case TypeUdp:
+    {
+        if(!openReceiver() && !openUdpSocket())
+            return;
+
+        // the socket stays bound if joining a group fails, unicast messages are still received
+        QString error;
+        if(!settings.multicastGroups.isEmpty())
+        {
+            const QList<QNetworkInterface> interfaces = QNetworkInterface::allInterfaces();
+            auto iface = std::find_if(interfaces.begin(), interfaces.end(), [this](const QNetworkInterface &i) {
+                return i.humanReadableName() == settings.multicastInterface;
+            });
+            if(iface == interfaces.end())
+            {
+                qDebug() << "QDltLiveReader: Interface not found" << settings.multicastInterface;
+                error = "Interface not found";
+            }
+            else
+            {
+                for(const QString &group : settings.multicastGroups)
+                {
+                    if(!joinMulticastGroup(group, *iface))
+                        error = "Error joining multicast group";
+                }
+            }
+        }
+        if(error.isEmpty())
+            setState(QDltConnection::QDltConnectionOnline);
+        else
+            setState(QDltConnection::QDltConnectionError, error);
+        break;
+    }
+    case TypeSerialDlt:
+    case TypeSerialAscii:
+        serialPort = new QSerialPort(this);
+        serialPort->setPortName(settings.serialPort);
+        serialPort->setBaudRate(settings.baudrate, QSerialPort::AllDirections);
+        serialPort->setDataBits(QSerialPort::Data8);
+        serialPort->setParity(QSerialPort::NoParity);
+        serialPort->setStopBits(QSerialPort::OneStop);
+        serialPort->setFlowControl(QSerialPort::NoFlowControl);
+        connect(serialPort, &QSerialPort::readyRead, this, &QDltLiveReader::read);
+        if(!serialPort->open(QIODevice::ReadWrite))
+        {
+            qDebug() << "QDltLiveReader: Cannot open serial port" << settings.serialPort << serialPort->errorString();
+            setState(QDltConnection::QDltConnectionError, serialPort->errorString());
+            return;
+        }
+        setState(QDltConnection::QDltConnectionOnline);
+        break;
+    }
+}
+
+bool QDltLiveReader::openReceiver()
+{
+    if(!QDltUdpReceiver::isSupported())
+        return false;
+
+    udpReceiver = new QDltUdpReceiver(UDP_BATCH_SIZE);
+    if(!udpReceiver->open(settings.bindAddress, settings.port, settings.receiveBufferSize))
+    {
+        // e.g. an IPv6 address, QUdpSocket reports the error if binding fails again
+        qDebug() << "QDltLiveReader: Batched receive not possible," << udpReceiver->errorString();
+        delete udpReceiver;
+        udpReceiver = nullptr;
+        return false;
+    }
+    if(udpReceiver->getReceiveBufferSize() < settings.receiveBufferSize)
+        qDebug() << "QDltLiveReader: Receive buffer limited to" << udpReceiver->getReceiveBufferSize() << "bytes, see net.core.rmem_max";
+
+    udpNotifier = new QSocketNotifier(udpReceiver->socketDescriptor(), QSocketNotifier::Read, this);
+    connect(udpNotifier, &QSocketNotifier::activated, this, &QDltLiveReader::readDatagrams);
+    return true;
+}
+
+bool QDltLiveReader::openUdpSocket()
+{
+    udpSocket = new QUdpSocket(this);
+    const QHostAddress address = settings.bindAddress.isEmpty() ? QHostAddress(QHostAddress::AnyIPv4) : QHostAddress(settings.bindAddress);
+    if(!udpSocket->bind(address, settings.port, QUdpSocket::ShareAddress))
+    {
+        qDebug() << "QDltLiveReader: Binding failed with" << udpSocket->errorString();
+        setState(QDltConnection::QDltConnectionError, "Binding failed");
+        return false;
+    }
+    udpSocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, settings.receiveBufferSize);
+    connect(udpSocket, &QUdpSocket::readyRead, this, &QDltLiveReader::read);
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    connect(udpSocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketError()));
+#else
+    connect(udpSocket, &QAbstractSocket::errorOccurred, this, &QDltLiveReader::socketError);
+#endif
+    return true;
+}
+
+bool QDltLiveReader::joinMulticastGroup(const QString &group, const QNetworkInterface &iface)
+{
+    if(udpReceiver)
+    {
+        if(udpReceiver->joinMulticastGroup(group, iface.index()))
+            return true;
+        qDebug() << "QDltLiveReader: Error joining multicast group" << group << "on interface" << settings.multicastInterface << udpReceiver->errorString();
+        return false;
+    }
+    if(udpSocket->joinMulticastGroup(QHostAddress(group), iface))
+        return true;
+    qDebug() << "QDltLiveReader: Error joining multicast group" << group << "on interface" << settings.multicastInterface << udpSocket->errorString();
+    return false;
+}
+
+void QDltLiveReader::close()
+{
+    // the signals are disconnected first, deleting a socket changes its state
+    if(tcpSocket)
+    {
+        tcpSocket->disconnect(this);
+        tcpSocket->abort();
+        delete tcpSocket;
+        tcpSocket = nullptr;
+    }
+    if(udpSocket)
+    {
+        udpSocket->disconnect(this);
+        delete udpSocket;
+        udpSocket = nullptr;
+    }
+    if(udpReceiver)
+    {
+        // the notifier must not watch a closed socket
+        delete udpNotifier;
+        udpNotifier = nullptr;
+        delete udpReceiver;
+        udpReceiver = nullptr;
+    }
+    if(serialPort)
+    {
+        serialPort->disconnect(this);
+        serialPort->close();
+        delete serialPort;
+        serialPort = nullptr;
+    }
+    setState(QDltConnection::QDltConnectionOffline);
+}
+
+void QDltLiveReader::socketStateChanged()
+{
+    switch(tcpSocket->state())
+    {
+    case QAbstractSocket::HostLookupState:
+    case QAbstractSocket::ConnectingState:
+        setState(QDltConnection::QDltConnectionConnecting);
+        break;
+    case QAbstractSocket::ConnectedState:
+        // a new connection starts with an empty parse buffer
+        connection.clear();
+        setState(QDltConnection::QDltConnectionOnline);
+        break;
+    case QAbstractSocket::UnconnectedState:
+        // keep the error of a failed connection
+        if(state != QDltConnection::QDltConnectionError)
+            setState(QDltConnection::QDltConnectionOffline);
+        break;
+    default:
+        break;
+    }
+}
+
+void QDltLiveReader::socketError()
+{
+    QAbstractSocket *socket = tcpSocket ? static_cast<QAbstractSocket*>(tcpSocket) : udpSocket;
+    if(!socket || socket->error() == QAbstractSocket::RemoteHostClosedError)
+        return; // reported as offline state
+    qDebug() << "QDltLiveReader: Socket error" << socket->errorString() << "for" << settings.hostname << "on" << settings.port;
+    setState(QDltConnection::QDltConnectionError, socket->errorString());
+    if(tcpSocket)
+        tcpSocket->abort();
+}
+
+void QDltLiveReader::read()
+{
+    quint32 sec, usec;
+    currentTime(sec, usec);
+
+    if(udpSocket)
+    {
+        while(udpSocket->hasPendingDatagrams())
+        {
+            datagram.resize(qMax<qint64>(0, udpSocket->pendingDatagramSize()));
+            const qint64 size = udpSocket->readDatagram(datagram.data(), datagram.size());
+            if(size <= 0)
+                continue;
+            bytesReceived += size;
+            addDatagram(datagram.constData(), int(size), sec, usec);
+        }
+        addMessages();
+    }
+    else if(tcpSocket)
+    {
+        addData(tcpSocket->readAll(), sec, usec);
+    }
+    else if(serialPort)
+    {
+        addData(serialPort->readAll(), sec, usec);
+    }
+}
+
+void QDltLiveReader::readDatagrams()
+{
+    // a full batch means more datagrams may be pending, the notifier fires again for the rest
+    int count = UDP_BATCH_SIZE;
+    for(int batch = 0; batch < UDP_MAX_BATCHES && count == UDP_BATCH_SIZE; batch++)
+    {
+        count = udpReceiver->receive();
+        for(int num = 0; num < count; num++)
+        {
+            const QDltUdpDatagram &datagram = udpReceiver->datagram(num);
+            bytesReceived += datagram.size;
+            addDatagram(datagram.data, datagram.size, datagram.sec, datagram.usec);
+        }
+    }
+    if(count < 0)
+        qDebug() << "QDltLiveReader: Receive error" << udpReceiver->errorString();
+    datagramsDropped += udpReceiver->takeDropped();
+
+    addMessages();
+}
+
+void QDltLiveReader::addDatagram(const char *data, int size, quint32 sec, quint32 usec)
+{
+    // a datagram contains one or more complete messages
+    while(size > 0)
+    {
+        const quint32 sizeMsg = QDltMsg::getMsgSize(data, size, settings.supportDLTv2);
+        if(sizeMsg == 0)
+        {
+            bytesError += size;
+            break;
+        }
+        QDltLiveMessage message;
+        message.ecu = ecu;
+        message.sec = sec;
+        message.usec = usec;
+        message.data = QByteArray(data, sizeMsg);
+        messages.append(message);
+        data += sizeMsg;
+        size -= sizeMsg;
+    }
+}
+
+void QDltLiveReader::addData(const QByteArray &data, quint32 sec, quint32 usec)
+{
+    if(settings.type == TypeUdp)
+    {
+        bytesReceived += data.size();
+        addDatagram(data.constData(), data.size(), sec, usec);
+    }
+    else
+    {
+        connection.add(data);
+        while(settings.type == TypeSerialAscii ? connection.parseAscii(msg) : connection.parseDlt(msg, settings.supportDLTv2))
+        {
+            QDltLiveMessage message;
+            message.ecu = ecu;
+            message.sec = sec;
+            message.usec = usec;
+            message.controlResponse = msg.getType() == QDltMsg::DltTypeControl && msg.getSubtype() == QDltMsg::DltControlResponse;
+            message.data = msg.getHeader() + msg.getPayload();
+            messages.append(message);
+        }
+        bytesReceived += connection.bytesReceived;
+        bytesError += connection.bytesError;
+        syncFound += connection.syncFound;
+        connection.bytesReceived = 0;
+        connection.bytesError = 0;
+        connection.syncFound = 0;
+    }
+    addMessages();
+}
+
+void QDltLiveReader::addMessages()
+{
+    sink->add(messages);
+    messages.clear();
+
+    // nothing is read while the sink is overloaded, TCP connections are throttled by the ECU
+    while(!stopping && !sink->waitForSpace(OVERLOAD_WAIT))
+    {
+    }
+}
+
+void QDltLiveReader::writeData(const QByteArray &data)
+{
+    QIODevice *device = nullptr;
+    if(tcpSocket)
+        device = tcpSocket;
+    else if(udpSocket)
+        device = udpSocket;
+    else if(serialPort)
+        device = serialPort;
+    if(!device || !device->isOpen())
+    {
+        qDebug() << "QDltLiveReader: ECU is not connected";
+        return;
+    }
+    device->write(data);
+}
@@ -0,0 +1,186 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltlivereader.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_LIVE_READER_H
+#define QDLT_LIVE_READER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+#include "export_rules.h"
+#include "qdltconnection.h"
+#include "qdltlivesink.h"
+
+class QAbstractSocket;
+class QDltUdpReceiver;
+class QNetworkInterface;
+class QSerialPort;
+class QSocketNotifier;
+class QTcpSocket;
+class QUdpSocket;
+
+//! Receive and parse the DLT messages of one ECU connection in its own thread.
+/*!
+  The reader owns the socket or serial port of the connection. It lives in its own
+  thread, so connections are read and parsed concurrently and independent of the
+  thread consuming the messages. Each reader has its own parse buffer, the complete
+  messages are added to a QDltLiveSink shared by all readers.
+
+  The connection state is reported with stateChanged(), data is sent to the ECU with
+  write(). Both can be used from any thread.
+
+  UDP datagrams are read in batches by QDltUdpReceiver where supported, the messages
+  get the receive time of the kernel. Otherwise QUdpSocket is used.
+
+  With the overload policy QDltLiveSink::OverloadBlock the reader stops reading while
+  the sink is overloaded. TCP connections are then throttled by the ECU, UDP datagrams
+  are dropped by the kernel and counted in the statistics.
+*/
+class QDLT_EXPORT QDltLiveReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! The type of the connection.
+    enum Type { TypeTcp, TypeUdp, TypeSerialDlt, TypeSerialAscii };
+
+    //! The configuration of the connection.
+    struct Settings
+    {
+        Type type = TypeTcp;
+        QString hostname;               //!< TCP: host to connect to.
+        QString bindAddress;            //!< UDP: local address, empty for any address.
+        quint16 port = 3490;            //!< TCP or UDP port.
+        QStringList multicastGroups;    //!< UDP: multicast groups to join.
+        QString multicastInterface;     //!< UDP: name of the interface for multicast.
+        int receiveBufferSize = 26214400; //!< UDP: size of the socket receive buffer.
+        QString serialPort;             //!< Serial: name of the port.
+        int baudrate = 115200;          //!< Serial: baudrate.
+        bool syncSerialHeader = false;  //!< TCP or serial: messages start with a serial header.
+        bool supportDLTv2 = false;
+    };
+
+    //! The constructor.
+    /*!
+      \param ecu Id of the connection, set in the messages added to the sink.
+      \param settings The configuration of the connection.
+      \param sink The sink receiving the messages.
+    */
+    QDltLiveReader(int ecu, const Settings &settings, QDltLiveSink *sink);
+
+    //! The destructor, closes the connection and stops the thread.
+    ~QDltLiveReader();
+
+    //! Start the thread and open the connection.
+    void start();
+
+    //! Close the connection and stop the thread.
+    /*!
+      Must not be called from the thread of the reader.
+    */
+    void stop();
+
+    //! Send data to the ECU, the data is written by the thread of the reader.
+    void write(const QByteArray &data);
+
+    //! Get the id of the connection.
+    int getEcu() const { return ecu; }
+
+    //! Get the last reported state, see QDltConnection::QDltConnectionState.
+    int getState() const { return state; }
+
+    //! Counters of the connection.
+    struct Statistics
+    {
+        quint64 bytesReceived = 0;      //!< Received bytes.
+        quint64 bytesError = 0;         //!< Bytes which are not part of a message.
+        quint64 syncFound = 0;          //!< Found serial headers.
+        quint64 datagramsDropped = 0;   //!< UDP: datagrams dropped by the kernel because the receive buffer was full.
+    };
+
+    //! Get the statistics since the last call and reset them.
+    Statistics takeStatistics();
+
+    //! Parse received data and add the complete messages to the sink.
+    /*!
+      Called by the thread of the reader when data is received.
+      \param data The received data, a datagram for UDP connections.
+      \param sec Receive time.
+      \param usec Receive time.
+    */
+    void addData(const QByteArray &data, quint32 sec, quint32 usec);
+
+signals:
+    //! The state of the connection changed.
+    /*!
+      \param ecu Id of the connection.
+      \param state See QDltConnection::QDltConnectionState.
+      \param error The error if the state is QDltConnection::QDltConnectionError.
+    */
+    void stateChanged(int ecu, int state, const QString &error);
+
+private slots:
+    void open();
+    void close();
+    void read();
+    void readDatagrams();
+    void writeData(const QByteArray &data);
+    void socketStateChanged();
+    void socketError();
+
+private:
+    void setState(int newState, const QString &error = QString());
+    bool openReceiver();
+    bool openUdpSocket();
+    bool joinMulticastGroup(const QString &group, const QNetworkInterface &iface);
+    void addDatagram(const char *data, int size, quint32 sec, quint32 usec);
+    void addMessages();
+
+    int ecu;
+    Settings settings;
+    QDltLiveSink *sink;
+    QThread thread;
+
+    QTcpSocket *tcpSocket;
+    QUdpSocket *udpSocket;
+    QDltUdpReceiver *udpReceiver;
+    QSocketNotifier *udpNotifier;
+    QSerialPort *serialPort;
+
+    // parse buffer of the stream connections
+    QDltConnection connection;
+    QDltMsg msg;
+    QByteArray datagram;
+    QVector<QDltLiveMessage> messages;
+
+    std::atomic<int> state;
+    std::atomic<bool> stopping;
+    std::atomic<quint64> bytesReceived;
+    std::atomic<quint64> bytesError;
+    std::atomic<quint64> syncFound;
+    std::atomic<quint64> datagramsDropped;
+};
+
+#endif // QDLT_LIVE_READER_H
@@ -0,0 +1,311 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltlivesink.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QMutexLocker>
+
+#include "qdltlivesink.h"
+#include "qdltmsg.h"
+#include "qdltrelayserver.h"
+
+#include <utility>
+
+extern "C"
+{
+#include "dlt_common.h"
+}
+
+namespace {
+
+// log level of the trace messages, they are dropped like verbose messages
+const int LEVEL_TRACE = QDltMsg::DltLogVerbose;
+// messages without message info, e.g. non verbose messages, are never dropped by level
+const int LEVEL_UNKNOWN = -1;
+
+// read the level and application id from the extended header of a DLT v1 message
+bool messageInfoV1(const QByteArray &data, quint8 htyp, int &level, QByteArray &apid)
+{
+    if(!DLT_IS_HTYP_UEH(htyp))
+        return true;
+
+    const int offset = int(sizeof(DltStandardHeader)) + DLT_STANDARD_HEADER_EXTRA_SIZE(htyp);
+    if(data.size() < offset + int(sizeof(DltExtendedHeader)))
+        return true;
+
+    const DltExtendedHeader *extendedheader = reinterpret_cast<const DltExtendedHeader*>(data.constData() + offset);
+    apid = QByteArray(extendedheader->apid, int(qstrnlen(extendedheader->apid, DLT_ID_SIZE)));
+    if(DLT_GET_MSIN_MSTP(extendedheader->msin) == DLT_TYPE_CONTROL)
+        return false;
+    level = DLT_GET_MSIN_MSTP(extendedheader->msin) == DLT_TYPE_LOG ? DLT_GET_MSIN_MTIN(extendedheader->msin) : LEVEL_TRACE;
+    return true;
+}
+
+// read the level and application id from the base header of a DLT v2 message, see QDltMsg::setMsg()
+bool messageInfoV2(const QByteArray &data, quint8 htyp, int &level, QByteArray &apid)
+{
+    const int contentInformation = htyp & 0x03;
+    int offset = 7;
+    if(contentInformation == 0x02)
+    {
+        return false; // control
+    }
+    else if(contentInformation == 0x00)
+    {
+        // verbose: message info, number of arguments and timestamp
+        const quint8 msin = quint8(data[offset]);
+        const int type = (msin & 0x0e) >> 1;
+        if(type == DLT_TYPE_CONTROL)
+            return false;
+        level = type == DLT_TYPE_LOG ? (msin >> 4) : LEVEL_TRACE;
+        offset += 2 + 9;
+    }
+    else if(contentInformation == 0x01)
+    {
+        // non verbose: timestamp and message id
+        offset += 9 + 4;
+    }
+    else
+    {
+        return true;
+    }
+
+    // optional ECU id, followed by the application id
+    if(htyp & 0x04)
+    {
+        if(data.size() < offset + 1)
+            return true;
+        offset += 1 + quint8(data[offset]);
+    }
+    if(htyp & 0x08)
+    {
+        if(data.size() < offset + 1 || data.size() < offset + 1 + quint8(data[offset]))
+            return true;
+        apid = data.mid(offset + 1, quint8(data[offset]));
+    }
+    return true;
+}
+
+// read the level and application id of a message, false for control messages
+bool messageInfo(const QByteArray &data, int &level, QByteArray &apid)
+{
+    level = LEVEL_UNKNOWN;
+    apid.clear();
+    if(data.size() < int(sizeof(DltStandardHeader)))
+        return false;
+
+    const quint8 htyp = quint8(data[0]);
+    if((htyp & DLT_HTYP_VERS) == DLT_HTYP_PROTOCOL_VERSION1)
+        return messageInfoV1(data, htyp, level, apid);
+    if(((htyp & DLT_HTYP_VERS) >> 5) == 2 && data.size() >= 8)
+        return messageInfoV2(data, htyp, level, apid);
+    return true;
+}
+
+QDltLiveSink::QDltLiveSink(QObject *parent)
+    : QObject(parent), pendingSize(0), notified(false), overloaded(false), shedTotal(0), relay(nullptr)
+{
+}
+
+bool QDltLiveSink::shed(const QDltLiveMessage &message, QByteArray &apid)
+{
+    int level;
+    if(message.controlResponse || !messageInfo(message.data, level, apid))
+        return false;
+
+    switch(overload.policy)
+    {
+    case OverloadDropByLevel:
+        return level != LEVEL_UNKNOWN && level > overload.logLevel;
+    case OverloadSample:
+        return samples[message.ecu]++ % qMax(1, overload.sampleRate) != 0;
+    default:
+        return false;
+    }
+}
+
+bool QDltLiveSink::append(QDltLiveMessage &message)
+{
+    message.sequence = sequences[message.ecu]++;
+
+    if(overload.highWatermark > 0 && pendingSize >= overload.highWatermark)
+        overloaded = true;
+
+    QByteArray apid;
+    if(overloaded && shed(message, apid))
+    {
+        shedCounters[qMakePair(message.ecu, apid)]++;
+        shedTotal++;
+        return false;
+    }
+
+    pendingSize += message.data.size();
+    pending.append(message);
+    if(overload.hardLimit > 0 && pendingSize > overload.hardLimit)
+        dropOldest();
+    return true;
+}
+
+void QDltLiveSink::dropOldest()
+{
+    /* drop down to half of the limit, so the pending messages are moved only once for many dropped messages */
+    const qint64 target = overload.hardLimit / 2;
+    int kept = 0;
+    int num = 0;
+    for(; num < pending.size() && pendingSize > target; num++)
+    {
+        QDltLiveMessage &message = pending[num];
+        if(message.controlResponse)
+        {
+            if(kept != num)
+                pending[kept] = std::move(message);
+            kept++;
+            continue;
+        }
+        int level;
+        QByteArray apid;
+        messageInfo(message.data, level, apid);
+        shedCounters[qMakePair(message.ecu, apid)]++;
+        shedTotal++;
+        pendingSize -= message.data.size();
+    }
+    pending.erase(pending.begin() + kept, pending.begin() + num);
+}
+
+void QDltLiveSink::add(QDltLiveMessage &message)
+{
+    bool notify;
+    {
+        QMutexLocker locker(&mutex);
+        notify = append(message) && !notified;
+        if(notify)
+            notified = true;
+    }
+    if(QDltRelayServer *server = relay)
+        server->publish(QVector<QDltLiveMessage>{message});
+    // emitted without the lock, a direct connection may take the messages
+    if(notify)
+        emit messagesAvailable();
+}
+
+void QDltLiveSink::add(QVector<QDltLiveMessage> &messages)
+{
+    if(messages.isEmpty())
+        return;
+
+    bool notify;
+    {
+        QMutexLocker locker(&mutex);
+        bool added = false;
+        for(QDltLiveMessage &message : messages)
+            added = append(message) || added;
+        notify = added && !notified;
+        if(notify)
+            notified = true;
+    }
+    // each reader adds its messages in order, so they are published in order too
+    if(QDltRelayServer *server = relay)
+        server->publish(messages);
+    if(notify)
+        emit messagesAvailable();
+}
+
+void QDltLiveSink::take(QVector<QDltLiveMessage> &messages)
+{
+    messages.clear();
+    QMutexLocker locker(&mutex);
+    messages.swap(pending);
+    pendingSize = 0;
+    notified = false;
+    // all pending messages are taken, the readers may continue
+    if(overloaded)
+    {
+        overloaded = false;
+        samples.clear();
+        spaceAvailable.wakeAll();
+    }
+}
+
+void QDltLiveSink::reset(int ecu)
+{
+    QMutexLocker locker(&mutex);
+    sequences.remove(ecu);
+}
+
+int QDltLiveSink::size() const
+{
+    QMutexLocker locker(&mutex);
+    return pending.size();
+}
+
+void QDltLiveSink::setRelay(QDltRelayServer *relay)
+{
+    this->relay = relay;
+}
+
+void QDltLiveSink::setOverload(const Overload &overload)
+{
+    QMutexLocker locker(&mutex);
+    this->overload = overload;
+    overloaded = overload.highWatermark > 0 && pendingSize >= overload.highWatermark;
+    if(!overloaded)
+        spaceAvailable.wakeAll();
+}
+
+bool QDltLiveSink::waitForSpace(int msecs)
+{
+    QMutexLocker locker(&mutex);
+    if(overload.policy != OverloadBlock || !overloaded)
+        return true;
+    spaceAvailable.wait(&mutex, msecs);
+    return !overloaded;
+}
+
+bool QDltLiveSink::isOverloaded() const
+{
+    QMutexLocker locker(&mutex);
+    return overloaded;
+}
+
+QVector<QDltLiveShedCounter> QDltLiveSink::getShed() const
+{
+    QMutexLocker locker(&mutex);
+    QVector<QDltLiveShedCounter> counters;
+    counters.reserve(shedCounters.size());
+    for(auto it = shedCounters.constBegin(); it != shedCounters.constEnd(); ++it)
+    {
+        QDltLiveShedCounter counter;
+        counter.ecu = it.key().first;
+        counter.apid = QString::fromLatin1(it.key().second);
+        counter.count = it.value();
+        counters.append(counter);
+    }
+    return counters;
+}
+
+quint64 QDltLiveSink::getShedTotal() const
+{
+    QMutexLocker locker(&mutex);
+    return shedTotal;
+}
+
+void QDltLiveSink::clearShed()
+{
+    QMutexLocker locker(&mutex);
+    shedCounters.clear();
+    shedTotal = 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltlivesink.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_LIVE_SINK_H
+#define QDLT_LIVE_SINK_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#include "export_rules.h"
+
+class QDltRelayServer;
+
+//! A DLT message received on a live connection.
+struct QDltLiveMessage
+{
+    int ecu = 0;                //!< Id of the connection given to the reader.
+    quint64 sequence = 0;       //!< Number of the message on its connection, starting with 0.
+    quint32 sec = 0;            //!< Receive time, used for the storage header.
+    quint32 usec = 0;
+    bool controlResponse = false; //!< The message is a response to a control request.
+    QByteArray data;            //!< DLT message without storage header.
+};
+
+//! Number of messages of one application shed by the overload policy of QDltLiveSink.
+struct QDltLiveShedCounter
+{
+    int ecu = 0;                //!< Id of the connection given to the reader.
+    QString apid;               //!< Application id, empty if the messages have no extended header.
+    quint64 count = 0;          //!< Number of shed messages.
+};
+
+//! Collects the messages received on all live connections in receive order.
+/*!
+  Each connection is read and parsed by its own thread, see QDltLiveReader. The threads
+  add the messages to one sink, the consumer takes all pending messages at once.
+  The messages of a connection keep their order and get consecutive sequence numbers.
+
+  messagesAvailable() is emitted once when the sink becomes non-empty and again only
+  after the consumer has taken the messages, so a queued connection to the consumer
+  does not flood its event loop.
+
+  When the consumer cannot keep up, the pending messages are limited by the overload
+  policy, see setOverload(). The policy applies from the moment the pending messages
+  reach the high watermark until the consumer takes them. There is deliberately no
+  low watermark: take() always takes all pending messages, so the sink is empty when
+  the policy ends. Messages the policy keeps, e.g. control responses or messages
+  without log level, are limited by the hard limit, which applies with every policy:
+  when it is exceeded, the oldest messages are dropped down to half of the limit.
+  Shed and dropped messages still use their sequence number, so the consumer sees the gaps.
+*/
+class QDLT_EXPORT QDltLiveSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! What happens when the pending messages reach the high watermark.
+    enum OverloadPolicy
+    {
+        OverloadBlock,          //!< The readers stop reading until the consumer took the messages.
+        OverloadDropByLevel,    //!< Messages less severe than the log level are dropped, messages without log level are kept.
+        OverloadSample          //!< Only one of sampleRate messages of a connection is kept.
+    };
+
+    //! The configuration of the overload policy.
+    struct Overload
+    {
+        OverloadPolicy policy = OverloadBlock;
+        qint64 highWatermark = 0;   //!< Size of the pending messages in bytes which starts the policy, 0 for unlimited.
+        int logLevel = 3;           //!< DropByLevel: least severe level kept, see QDltMsg::DltLogDef.
+        int sampleRate = 10;        //!< Sample: one of sampleRate messages is kept.
+        qint64 hardLimit = 0;       //!< Size of the pending messages in bytes at which the oldest are dropped, 0 for unlimited.
+    };
+
+    //! The constructor.
+    explicit QDltLiveSink(QObject *parent = nullptr);
+
+    //! Add a message received on a connection, called by the reader threads.
+    /*!
+      \param message The message, the sequence number is set by the sink.
+    */
+    void add(QDltLiveMessage &message);
+
+    //! Add several messages received on the same connection at once.
+    /*!
+      \param messages The messages, the sequence numbers are set by the sink.
+    */
+    void add(QVector<QDltLiveMessage> &messages);
+
+    //! Take all pending messages in receive order.
+    /*!
+      \param messages Replaced by the pending messages.
+    */
+    void take(QVector<QDltLiveMessage> &messages);
+
+    //! Restart the sequence numbers of a connection.
+    void reset(int ecu);
+
+    //! Get the number of pending messages.
+    int size() const;
+
+    //! Set the overload policy.
+    void setOverload(const Overload &overload);
+
+    //! Wait until the readers may add messages again.
+    /*!
+      Called by the reader threads after adding messages. With OverloadBlock the readers
+      wait here while the sink is overloaded, so TCP connections are throttled by the ECU.
+      \param msecs Maximum time to wait.
+      \return false if the sink is still overloaded.
+    */
+    bool waitForSpace(int msecs);
+
+    //! Check if the overload policy is active.
+    bool isOverloaded() const;
+
+    //! Get the number of messages shed since the last clearShed(), per connection and application.
+    QVector<QDltLiveShedCounter> getShed() const;
+
+    //! Get the total number of messages shed since the last clearShed().
+    quint64 getShedTotal() const;
+
+    //! Reset the shed counters.
+    void clearShed();
+
+    //! Publish the added messages also to the clients of a relay server.
+    /*!
+      The messages are published by the reader threads when they are added, independent
+      of the consumer of the sink.
+      \param relay The relay server, nullptr to stop publishing.
+    */
+    void setRelay(QDltRelayServer *relay);
+
+signals:
+    //! Emitted when messages are added to an empty sink.
+    void messagesAvailable();
+
+private:
+    bool append(QDltLiveMessage &message);
+    bool shed(const QDltLiveMessage &message, QByteArray &apid);
+    void dropOldest();
+
+    mutable QMutex mutex;
+    QWaitCondition spaceAvailable;
+    QVector<QDltLiveMessage> pending;
+    qint64 pendingSize;
+    QHash<int,quint64> sequences;
+    bool notified;
+
+    Overload overload;
+    bool overloaded;
+    QHash<int,int> samples;
+    QHash<QPair<int,QByteArray>,quint64> shedCounters;
+    quint64 shedTotal;
+    std::atomic<QDltRelayServer*> relay;
+};
+
+#endif // QDLT_LIVE_SINK_H
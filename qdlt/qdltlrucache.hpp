@@ -1,59 +1,209 @@
 #ifndef QDLTLRUCACHE_HPP
 #define QDLTLRUCACHE_HPP
 
-#include <unordered_map>
-#include <list>
+#include <cstdint>
+#include <functional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
-template<typename Key, typename Value>
+// Fixed capacity LRU cache without allocations after construction.
+// All entries live in a pre-allocated slot array, the recency list is linked by slot indices
+// and keys are found through an open-addressing table (linear probing, backward shift deletion).
+// Value must be default constructible; references returned by get() stay valid until the next put().
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
 class QDltLruCache {
 
+    using SlotIndex = std::uint32_t;
+    static constexpr SlotIndex npos = static_cast<SlotIndex>(-1);
+
     struct CacheEntry {
-        Key key;
-        Value value;
+        Key key{};
+        Value value{};
+        SlotIndex prev = npos;
+        SlotIndex next = npos;
     };
 
-    using CacheListIterator = typename std::list<CacheEntry>::iterator;
 public:
 
     QDltLruCache(size_t capacity) :
-        m_capacity(capacity) {
+        m_capacity(capacity > 0 ? capacity : 1),
+        m_slots(m_capacity) {
+        size_t buckets = 1;
+        while (buckets < m_capacity * 2) {
+            buckets <<= 1;
+        }
+        m_buckets.assign(buckets, npos);
+        m_mask = buckets - 1;
     }
 
     void put(const Key& key, const Value& value) {
-        auto it = m_keyIteratorsMap.find(key);
-        m_cacheItems.push_front(CacheEntry{key, value});
-        if (it != m_keyIteratorsMap.end()) {
-            m_cacheItems.erase(it->second);
-            m_keyIteratorsMap.erase(it);
-        }
-        m_keyIteratorsMap[key] = m_cacheItems.begin();
+        insert(key, value);
+    }
 
-        if (m_keyIteratorsMap.size() > m_capacity) {
-            auto last = std::prev(m_cacheItems.end());
-            m_keyIteratorsMap.erase(last->key);
-            m_cacheItems.pop_back();
-        }
+    void put(const Key& key, Value&& value) {
+        insert(key, std::move(value));
     }
 
     const Value& get(const Key& key) {
-        auto it = m_keyIteratorsMap.find(key);
-        if (it == m_keyIteratorsMap.end()) {
+        const Value* value = find(key);
+        if (value == nullptr) {
             throw std::range_error("no such key in cache found");
         }
+        return *value;
+    }
 
-        m_cacheItems.splice(m_cacheItems.begin(), m_cacheItems, it->second);
-        return it->second->value;
+    // Single lookup alternative to exists() followed by get(); returns nullptr if key is not cached.
+    const Value* find(const Key& key) {
+        const SlotIndex slot = m_buckets[findBucket(key)];
+        if (slot == npos) {
+            return nullptr;
+        }
+        moveToFront(slot);
+        return &m_slots[slot].value;
+    }
+
+    // Returns the cached value or stores and returns the result of compute() if key is not cached.
+    template<typename Compute>
+    const Value& getOrCompute(const Key& key, Compute&& compute) {
+        if (const Value* value = find(key)) {
+            return *value;
+        }
+        return m_slots[insert(key, compute())].value;
     }
 
     bool exists(const Key& key) const {
-        return m_keyIteratorsMap.find(key) != m_keyIteratorsMap.end();
+        return m_buckets[findBucket(key)] != npos;
+    }
+
+    void clear() {
+        m_buckets.assign(m_buckets.size(), npos);
+        for (size_t i = 0; i < m_size; ++i) {
+            m_slots[i].value = Value{};
+        }
+        m_size = 0;
+        m_head = npos;
+        m_tail = npos;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    size_t capacity() const {
+        return m_capacity;
     }
 
 private:
-    std::list<CacheEntry> m_cacheItems;
-    std::unordered_map<Key, CacheListIterator> m_keyIteratorsMap;
+    size_t homeBucket(const Key& key) const {
+        size_t h = m_hash(key);
+        // spread sequential keys like message indices over the table
+        h ^= h >> 16;
+        h *= 0x45d9f3bU;
+        h ^= h >> 16;
+        return h & m_mask;
+    }
+
+    // Returns the bucket holding key, or the empty bucket where key would be inserted.
+    size_t findBucket(const Key& key) const {
+        size_t bucket = homeBucket(key);
+        while (m_buckets[bucket] != npos && !(m_slots[m_buckets[bucket]].key == key)) {
+            bucket = (bucket + 1) & m_mask;
+        }
+        return bucket;
+    }
+
+    template<typename V>
+    SlotIndex insert(const Key& key, V&& value) {
+        size_t bucket = findBucket(key);
+        SlotIndex slot = m_buckets[bucket];
+        if (slot != npos) {
+            m_slots[slot].value = std::forward<V>(value);
+            moveToFront(slot);
+            return slot;
+        }
+
+        if (m_size < m_capacity) {
+            slot = static_cast<SlotIndex>(m_size++);
+        } else {
+            // reuse least recently used slot
+            slot = m_tail;
+            eraseBucket(findBucket(m_slots[slot].key));
+            unlink(slot);
+            bucket = findBucket(key);
+        }
+
+        m_slots[slot].key = key;
+        m_slots[slot].value = std::forward<V>(value);
+        m_buckets[bucket] = slot;
+        linkFront(slot);
+        return slot;
+    }
+
+    void eraseBucket(size_t bucket) {
+        m_buckets[bucket] = npos;
+        size_t next = bucket;
+        while (true) {
+            next = (next + 1) & m_mask;
+            if (m_buckets[next] == npos) {
+                return;
+            }
+            const size_t home = homeBucket(m_slots[m_buckets[next]].key);
+            // entry stays if its home bucket lies cyclically in (bucket, next]
+            const bool stays = bucket <= next ? (bucket < home && home <= next)
+                                              : (bucket < home || home <= next);
+            if (!stays) {
+                m_buckets[bucket] = m_buckets[next];
+                m_buckets[next] = npos;
+                bucket = next;
+            }
+        }
+    }
+
+    void unlink(SlotIndex slot) {
+        CacheEntry& entry = m_slots[slot];
+        if (entry.prev != npos) {
+            m_slots[entry.prev].next = entry.next;
+        } else {
+            m_head = entry.next;
+        }
+        if (entry.next != npos) {
+            m_slots[entry.next].prev = entry.prev;
+        } else {
+            m_tail = entry.prev;
+        }
+        entry.prev = npos;
+        entry.next = npos;
+    }
+
+    void linkFront(SlotIndex slot) {
+        CacheEntry& entry = m_slots[slot];
+        entry.prev = npos;
+        entry.next = m_head;
+        if (m_head != npos) {
+            m_slots[m_head].prev = slot;
+        }
+        m_head = slot;
+        if (m_tail == npos) {
+            m_tail = slot;
+        }
+    }
+
+    void moveToFront(SlotIndex slot) {
+        if (slot != m_head) {
+            unlink(slot);
+            linkFront(slot);
+        }
+    }
+
     const size_t m_capacity;
+    std::vector<CacheEntry> m_slots;
+    std::vector<SlotIndex> m_buckets;
+    size_t m_mask = 0;
+    size_t m_size = 0;
+    SlotIndex m_head = npos;
+    SlotIndex m_tail = npos;
+    Hash m_hash;
 };
 
 #endif // QDLTLRUCACHE_HPP
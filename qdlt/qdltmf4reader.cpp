@@ -0,0 +1,331 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmf4reader.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QtEndian>
+
+#ifdef QDLT_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "qdltmf4reader.h"
+
+namespace {
+
+/* header of each block: id, reserved, length and number of links */
+const int MDF_HEADER_SIZE = 24;
+/* data section of a ##DZ block in front of the compressed data */
+const int MDF_DZ_HEADER_SIZE = 24;
+/* large ##DT blocks are read in parts of this size */
+const quint64 MDF_DT_PART_SIZE = 16 * 1024 * 1024;
+/* larger compressed blocks are treated as corrupted file */
+const quint64 MDF_MAX_BLOCK_SIZE = 1024 * 1024 * 1024;
+/* limit for nested and chained lists, protects against loops in corrupted files */
+const int MDF_MAX_LIST_DEPTH = 8;
+const int MDF_MAX_BLOCKS = 16 * 1024 * 1024;
+
+bool isBlock(const uchar *header, const char *id)
+{
+    return header[0] == '#' && header[1] == '#' && header[2] == id[0] && header[3] == id[1];
+}
+
+}
+
+class QDltMf4Reader::JobRunnable : public QRunnable
+{
+public:
+    JobRunnable(QDltMf4Reader *reader, Job *job) : reader(reader), job(job) {}
+
+    void run() override
+    {
+        reader->runJob(job);
+
+        QMutexLocker locker(&reader->mutex);
+        job->done = true;
+        reader->condition.wakeAll();
+    }
+
+private:
+    QDltMf4Reader *reader;
+    Job *job;
+};
+
+QDltMf4Reader::QDltMf4Reader()
+    : nextBlock(0), nextJob(0), errors(0)
+{
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+QDltMf4Reader::~QDltMf4Reader()
+{
+    close();
+}
+
+void QDltMf4Reader::setThreads(int threads)
+{
+    pool.setMaxThreadCount(qMax(1, threads));
+}
+
+bool QDltMf4Reader::isCompressionSupported()
+{
+#ifdef QDLT_USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool QDltMf4Reader::open(const QString &fileName, quint64 dataLink)
+{
+    close();
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qDebug() << "QDltMf4Reader: Cannot open file" << fileName;
+        return false;
+    }
+    this->fileName = fileName;
+    if(!addBlocks(file, dataLink, 0) || blocks.isEmpty())
+    {
+        qDebug() << "QDltMf4Reader: Cannot find data blocks in" << fileName;
+        blocks.clear();
+        return false;
+    }
+    startJobs();
+    return true;
+}
+
+void QDltMf4Reader::close()
+{
+    pool.waitForDone();
+    qDeleteAll(jobs);
+    jobs.clear();
+    blocks.clear();
+    nextBlock = 0;
+    nextJob = 0;
+    errors = 0;
+}
+
+bool QDltMf4Reader::addBlocks(QFile &file, quint64 link, int depth)
+{
+    // follow the chain of lists, the data blocks of each list are added in order
+    while(link)
+    {
+        uchar header[MDF_HEADER_SIZE];
+        if(!file.seek(link) || file.read(reinterpret_cast<char*>(header), MDF_HEADER_SIZE) != MDF_HEADER_SIZE)
+        {
+            qDebug() << "QDltMf4Reader: Cannot read block header at position" << link;
+            return false;
+        }
+        const quint64 length = qFromLittleEndian<quint64>(header + 8);
+        const quint64 linkCount = qFromLittleEndian<quint64>(header + 16);
+        if(length < MDF_HEADER_SIZE || linkCount > (length - MDF_HEADER_SIZE) / 8 || link + length > quint64(file.size()))
+        {
+            qDebug() << "QDltMf4Reader: Invalid block length" << length << "at position" << link;
+            return false;
+        }
+        if(blocks.size() >= MDF_MAX_BLOCKS)
+        {
+            qDebug() << "QDltMf4Reader: Too many data blocks";
+            return false;
+        }
+
+        if(isBlock(header, "DT"))
+        {
+            for(quint64 part = 0; part < length - MDF_HEADER_SIZE; part += MDF_DT_PART_SIZE)
+            {
+                Block block;
+                block.position = link + MDF_HEADER_SIZE + part;
+                block.size = qMin(MDF_DT_PART_SIZE, length - MDF_HEADER_SIZE - part);
+                blocks.append(block);
+            }
+            return true;
+        }
+        if(isBlock(header, "DZ"))
+        {
+            if(length > MDF_MAX_BLOCK_SIZE)
+            {
+                qDebug() << "QDltMf4Reader: Compressed block too large at position" << link;
+                return false;
+            }
+            Block block;
+            block.position = link;
+            block.size = length;
+            block.compressed = true;
+            blocks.append(block);
+            return true;
+        }
+        if(!isBlock(header, "DL") && !isBlock(header, "HL"))
+        {
+            qDebug() << "QDltMf4Reader: Unknown data block" << QByteArray(reinterpret_cast<char*>(header), 4) << "at position" << link;
+            return false;
+        }
+        if(depth >= MDF_MAX_LIST_DEPTH || linkCount < 1)
+        {
+            qDebug() << "QDltMf4Reader: Invalid data list at position" << link;
+            return false;
+        }
+
+        const QByteArray links = file.read(linkCount * 8);
+        if(quint64(links.size()) != linkCount * 8)
+            return false;
+        const uchar *linkData = reinterpret_cast<const uchar*>(links.constData());
+        if(isBlock(header, "HL"))
+        {
+            // the header list only links to the first data list
+            return addBlocks(file, qFromLittleEndian<quint64>(linkData), depth + 1);
+        }
+        // first link is the next data list, then the data blocks
+        for(quint64 num = 1; num < linkCount; num++)
+        {
+            if(!addBlocks(file, qFromLittleEndian<quint64>(linkData + num * 8), depth + 1))
+                return false;
+        }
+        link = qFromLittleEndian<quint64>(linkData);
+    }
+    return true;
+}
+
+bool QDltMf4Reader::decodeBlock(const QByteArray &block, QByteArray &data)
+{
+    const uchar *header = reinterpret_cast<const uchar*>(block.constData());
+    if(block.size() < MDF_HEADER_SIZE)
+        return false;
+    if(isBlock(header, "DT"))
+    {
+        data = block.mid(MDF_HEADER_SIZE);
+        return true;
+    }
+    if(!isBlock(header, "DZ") || block.size() < MDF_HEADER_SIZE + MDF_DZ_HEADER_SIZE)
+        return false;
+
+    const uchar *dz = header + MDF_HEADER_SIZE;
+    const quint8 zipType = dz[2];
+    const quint32 columns = qFromLittleEndian<quint32>(dz + 4);
+    const quint64 originalLength = qFromLittleEndian<quint64>(dz + 8);
+    const quint64 compressedLength = qFromLittleEndian<quint64>(dz + 16);
+    if((dz[0] != 'D' || dz[1] != 'T') || zipType > 1 || originalLength > MDF_MAX_BLOCK_SIZE ||
+       compressedLength > quint64(block.size() - MDF_HEADER_SIZE - MDF_DZ_HEADER_SIZE))
+    {
+        qDebug() << "QDltMf4Reader: Unsupported compressed block";
+        return false;
+    }
+
+#ifdef QDLT_USE_ZLIB
+    QByteArray inflated(int(originalLength), Qt::Uninitialized);
+    uLongf inflatedLength = uLongf(originalLength);
+    if(uncompress(reinterpret_cast<Bytef*>(inflated.data()), &inflatedLength,
+                  reinterpret_cast<const Bytef*>(dz + MDF_DZ_HEADER_SIZE), uLong(compressedLength)) != Z_OK ||
+       inflatedLength != originalLength)
+    {
+        qDebug() << "QDltMf4Reader: Cannot decompress block";
+        return false;
+    }
+
+    if(zipType == 0 || columns == 0 || originalLength < columns)
+    {
+        data = inflated;
+        return true;
+    }
+
+    // the records were stored column by column, the bytes behind the last full row are not transposed
+    const quint64 rows = originalLength / columns;
+    data = QByteArray(int(originalLength), Qt::Uninitialized);
+    const char *source = inflated.constData();
+    char *destination = data.data();
+    for(quint64 column = 0; column < columns; column++)
+    {
+        const char *in = source + column * rows;
+        char *out = destination + column;
+        for(quint64 row = 0; row < rows; row++)
+            out[row * columns] = in[row];
+    }
+    memcpy(destination + rows * columns, source + rows * columns, originalLength - rows * columns);
+    return true;
+#else
+    Q_UNUSED(columns)
+    qDebug() << "QDltMf4Reader: Compressed blocks are not supported, build without zlib";
+    return false;
+#endif
+}
+
+void QDltMf4Reader::runJob(Job *job)
+{
+    // each job uses its own file handle, so the blocks are read concurrently
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly) || !file.seek(job->block.position))
+    {
+        qDebug() << "QDltMf4Reader: Cannot read block at position" << job->block.position;
+        return;
+    }
+    QByteArray block = file.read(job->block.size);
+    if(quint64(block.size()) != job->block.size)
+    {
+        qDebug() << "QDltMf4Reader: Block truncated at position" << job->block.position;
+        return;
+    }
+    if(!job->block.compressed)
+    {
+        job->data = block;
+        job->ok = true;
+        return;
+    }
+    job->ok = decodeBlock(block, job->data);
+}
+
+void QDltMf4Reader::startJobs()
+{
+    // read ahead enough blocks to keep all workers busy, limits memory usage too
+    while(nextJob < blocks.size() && jobs.size() < 2 * pool.maxThreadCount())
+    {
+        Job *job = new Job();
+        job->block = blocks.at(nextJob++);
+        jobs.enqueue(job);
+        pool.start(new JobRunnable(this, job));
+    }
+}
+
+bool QDltMf4Reader::readBlock(QByteArray &data)
+{
+    while(!jobs.isEmpty())
+    {
+        // wait for the oldest block, later blocks may already be finished
+        Job *job = jobs.dequeue();
+        {
+            QMutexLocker locker(&mutex);
+            while(!job->done)
+                condition.wait(&mutex);
+        }
+        const bool ok = job->ok;
+        data = job->data;
+        delete job;
+        nextBlock++;
+        startJobs();
+
+        // blocks which cannot be read are skipped
+        if(ok)
+            return true;
+        errors++;
+    }
+    return false;
+}
@@ -0,0 +1,131 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmf4reader.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_MF4_READER_H
+#define QDLT_MF4_READER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "export_rules.h"
+
+//! Read the data blocks of a data group of an MF4 file in parallel.
+/*!
+  The data of a data group is stored in one data block or in a list of data blocks,
+  optionally compressed with deflate and transposed. The blocks are listed when the
+  reader is opened, then worker threads read and decompress the blocks ahead of the
+  caller. The caller receives the data of the blocks in file order, so the records
+  are parsed sequentially like from one contiguous block.
+
+  Supported blocks are ##DT, ##DZ, ##DL and ##HL. Large ##DT blocks are split into
+  parts, so memory usage is limited by the number of blocks read ahead.
+*/
+class QDLT_EXPORT QDltMf4Reader
+{
+public:
+    //! The constructor.
+    QDltMf4Reader();
+
+    //! The destructor, waits for the worker threads.
+    ~QDltMf4Reader();
+
+    //! Open the file and list the data blocks of a data group.
+    /*!
+      \param fileName The MF4 file.
+      \param dataLink File position of the data block or data list of the data group.
+      \return false if the file cannot be opened or no data block is found.
+    */
+    bool open(const QString &fileName, quint64 dataLink);
+
+    //! Wait for the worker threads and forget the blocks.
+    void close();
+
+    //! Get the data of the next block in file order.
+    /*!
+      Blocks which cannot be read or decompressed are skipped and counted as errors,
+      so the data of the returned block does not continue the previous one if the
+      number of errors changed.
+      \param data Set to the uncompressed data of the block.
+      \return false at the end of the data.
+    */
+    bool readBlock(QByteArray &data);
+
+    //! Set the number of worker threads, default is the number of cores.
+    void setThreads(int threads);
+
+    //! Get the number of blocks.
+    int getBlockCount() const { return blocks.size(); }
+
+    //! Get the number of blocks already returned by readBlock().
+    int getBlockIndex() const { return nextBlock; }
+
+    //! Get the number of blocks skipped because they cannot be read.
+    int getErrors() const { return errors; }
+
+    //! Check if ##DZ blocks can be decompressed, requires zlib.
+    static bool isCompressionSupported();
+
+    //! Get the uncompressed data of a ##DT or ##DZ block.
+    /*!
+      \param block The block including its header.
+      \param data Set to the uncompressed data.
+      \return false if the block is invalid or the compression is not supported.
+    */
+    static bool decodeBlock(const QByteArray &block, QByteArray &data);
+
+private:
+    struct Block
+    {
+        quint64 position = 0; // data of a ##DT block or header of a ##DZ block
+        quint64 size = 0;
+        bool compressed = false;
+    };
+
+    struct Job
+    {
+        Block block;
+        QByteArray data;
+        bool done = false;
+        bool ok = false;
+    };
+
+    class JobRunnable;
+
+    bool addBlocks(QFile &file, quint64 link, int depth);
+    void runJob(Job *job);
+    void startJobs();
+
+    QString fileName;
+    QVector<Block> blocks;
+    int nextBlock;
+    int nextJob;
+    int errors;
+    QThreadPool pool;
+    QQueue<Job*> jobs;
+    QMutex mutex;
+    QWaitCondition condition;
+};
+
+#endif // QDLT_MF4_READER_H
@@ -136,7 +136,7 @@ QString QDltMsg::getTimeString() const
     return QString(strtime);
 }
 
-QString QDltMsg::getGmTimeWithOffsetString(qlonglong offset, bool dst)
+QString QDltMsg::getGmTimeWithOffsetString(qlonglong offset, bool dst) const
 {
     struct tm *time_tm;
     time_tm = gmtime(&time);
@@ -163,12 +163,16 @@ QString QDltMsg::getGmTimeWithOffsetString(qlonglong offset, bool dst)
 
 quint32 QDltMsg::checkMsgSize(const char *data,quint32 size,bool supportDLTv2)
 {
-    quint32 sizeStorageHeader = 0;
-    QString storageHeaderEcuId;
-
     /* empty message */
     clear();
 
+    return getMsgSize(data,size,supportDLTv2);
+}
+
+quint32 QDltMsg::getMsgSize(const char *data,quint32 size,bool supportDLTv2)
+{
+    quint32 sizeStorageHeader = 0;
+
     /* find storage header and read storage header */
     if(size < 4)
     {
@@ -198,7 +202,6 @@ quint32 QDltMsg::checkMsgSize(const char *data,quint32 size,bool supportDLTv2)
             if(size < (quint32)(14+ecuIdLength)) {
                 return 0; // length error
             }
-            storageHeaderEcuId = QString(QByteArray(data+14,ecuIdLength));
             sizeStorageHeader = 14 + ecuIdLength;
 
         }
@@ -212,25 +215,24 @@ quint32 QDltMsg::checkMsgSize(const char *data,quint32 size,bool supportDLTv2)
     if(size < sizeStorageHeader+4) {
         return 0;
     }
-    quint32 htyp2 = *((quint32*) (data + sizeStorageHeader));
-    versionNumber = (htyp2 & 0xe0) >> 5;  // Byte 0, Bit 5-7
-
+    const quint8 htyp = *((quint8*) (data + sizeStorageHeader));
+    const quint8 versionNumber = (htyp & 0xe0) >> 5;  // Byte 0, Bit 5-7
 
     if(!supportDLTv2 || versionNumber==1)
     {
-        const DltStandardHeader *standardheader = 0;
         unsigned int extra_size,headersize;
 
         if(size < (sizeStorageHeader+sizeof(DltStandardHeader))) {
             return 0;
         }
 
-        standardheader = (DltStandardHeader*) (data + sizeStorageHeader);
+        /* the length is read byte by byte, the message may be unaligned */
+        const quint16 len = (quint16(quint8(data[sizeStorageHeader+2])) << 8) | quint8(data[sizeStorageHeader+3]);
 
         /* calculate complete size of headers */
-        extra_size = DLT_STANDARD_HEADER_EXTRA_SIZE(standardheader->htyp)+(DLT_IS_HTYP_UEH(standardheader->htyp) ? sizeof(DltExtendedHeader) : 0);
+        extra_size = DLT_STANDARD_HEADER_EXTRA_SIZE(htyp)+(DLT_IS_HTYP_UEH(htyp) ? sizeof(DltExtendedHeader) : 0);
         headersize = sizeStorageHeader + sizeof(DltStandardHeader) + extra_size;
-        if(DLT_SWAP_16(standardheader->len)<(static_cast<int>(headersize) - sizeStorageHeader))
+        if(len<(headersize - sizeStorageHeader))
         {
             // there is something wrong with the header, at least size of header
             // at the momment no error, distinguish different errors needed
@@ -238,12 +240,12 @@ quint32 QDltMsg::checkMsgSize(const char *data,quint32 size,bool supportDLTv2)
         }
         else
         {
-            if(size < (sizeStorageHeader + DLT_SWAP_16(standardheader->len)))
+            if(size < (sizeStorageHeader + len))
             {
                 // whole message does not fit
                 return 0;
             }
-            return DLT_SWAP_16(standardheader->len) + sizeStorageHeader;
+            return len + sizeStorageHeader;
         }
 
     }
@@ -256,44 +258,14 @@ quint32 QDltMsg::checkMsgSize(const char *data,quint32 size,bool supportDLTv2)
             return 0;
         }
 
-        /* decode Header Type 2 */
-        withSessionId = htyp2 & 0x10;
-        withAppContextId = htyp2 & 0x08;
-        withEcuId = htyp2 & 0x04;
-        contentInformation = htyp2 & 0x03; // 0x0 = verbose, 0x1 = non verbose, 0x2 = control
-        withHFMessageInfo = (contentInformation == 0x00) || (contentInformation == 0x02); // verbose or control
-        withHFNumberOfArguments = (contentInformation == 0x00) || (contentInformation == 0x02); // verbose or control
-        withHFTimestamp = (contentInformation == 0x00) || (contentInformation == 0x01); // verbose or none verbose
-        withHFMessageId = (contentInformation == 0x01); // none verbose
-        if(contentInformation==0x00)
-        {
-            mode = DltModeVerbose;
-        }
-        else if(contentInformation==0x01)
+        /* content information 0x3 is reserved */
+        if((htyp & 0x03) == 0x03)
         {
-            mode = DltModeNonVerbose;
-        }
-        else if(contentInformation==0x02)
-        {
-            mode = DltModeNonVerbose;
-        }
-        else
-        {
-            /* error used reserved value */
             return 0;
         }
-        withSegementation = htyp2 & 0x0800;
-        withPrivacyLevel = htyp2 & 0x0400;
-        withTags = htyp2 & 0x0200;
-        withSourceFileNameLineNumber = htyp2 & 0x0100;
-        /* TODO: Endianess of payload not defined in DLTv2, undefined, set to LittleEndian by default */
-        endianness = QDlt::DltEndiannessLittleEndian;
-
-        /* get Message Counter */
-        messageCounter = *((quint8*) (data + 4 + sizeStorageHeader));
 
         /* get Message Length */
-        quint16 messageLength = qFromBigEndian(*((quint16*) (data + 5 + sizeStorageHeader)));
+        const quint16 messageLength = (quint16(quint8(data[sizeStorageHeader+5])) << 8) | quint8(data[sizeStorageHeader+6]);
 
         if(size < (sizeStorageHeader + messageLength))
         {
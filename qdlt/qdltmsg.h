@@ -91,7 +91,7 @@ public:
       \param dst Daylight saving time - if true, adding automatically 3600 seconds on top.
       \return QString representing the the time of the message for specific time zone.
     */
-    QString getGmTimeWithOffsetString(qlonglong utcOffsetInSeconds, bool dst);
+    QString getGmTimeWithOffsetString(qlonglong utcOffsetInSeconds, bool dst) const;
 
     //! Get the time, microseconds part, of the DLT message, when the DLT message is logged.
     /*!
@@ -436,6 +436,16 @@ public:
     */
     quint32 checkMsgSize(const char *data,quint32 size,bool supportDLTv2 = false);
 
+    //! Get the size of a DLT message in a buffer without allocating memory or changing a message object.
+    /*!
+      Used to split buffers with many messages, e.g. received UDP datagrams, into messages.
+      \param data the buffer containing the DLT messages.
+      \param size the size of the buffer
+      \param supportDLTv2 also accept DLT protocol version 2 messages
+      \return the size of the DLT message including storage header if found, 0 if the message is invalid or not complete
+    */
+    static quint32 getMsgSize(const char *data,quint32 size,bool supportDLTv2 = false);
+
     //! Parse the arguments from the Payload.
     bool parseArguments();
 
@@ -0,0 +1,154 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmsgcache.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QMutexLocker>
+
+#include <limits>
+
+#include "qdltmsgcache.h"
+
+QDltMsgCache::QDltMsgCache()
+    : maxSizeMB(0), hits(0), misses(0)
+{
+    setMaxSizeMB(256);
+}
+
+void QDltMsgCache::setMaxSizeMB(qint64 sizeMB)
+{
+    if(sizeMB < 0)
+        sizeMB = 0;
+
+    maxSizeMB = sizeMB;
+
+    /* each shard gets an equal part of the budget, QCache counts cost in int on Qt5 */
+    qint64 shardBytes = (sizeMB * 1024 * 1024) / numberOfShards;
+    if(shardBytes > std::numeric_limits<int>::max())
+        shardBytes = std::numeric_limits<int>::max();
+
+    for(int num = 0; num < numberOfShards; num++)
+    {
+        QMutexLocker locker(&shards[num].mutex);
+        if(shardBytes == 0)
+            shards[num].cache.clear();
+        shards[num].cache.setMaxCost(shardBytes > 0 ? shardBytes : 1);
+    }
+}
+
+bool QDltMsgCache::get(int index, QDltMsg &msg)
+{
+    if(!isEnabled())
+        return false;
+
+    Shard &s = shard(index);
+    QMutexLocker locker(&s.mutex);
+    QDltMsg *cacheMsg = s.cache.object(index);
+    if(cacheMsg)
+    {
+        msg = *cacheMsg;
+        hits++;
+        return true;
+    }
+    misses++;
+    return false;
+}
+
+bool QDltMsgCache::contains(int index) const
+{
+    if(!isEnabled())
+        return false;
+
+    const Shard &s = shard(index);
+    QMutexLocker locker(&s.mutex);
+    return s.cache.contains(index);
+}
+
+void QDltMsgCache::put(int index, const QDltMsg &msg)
+{
+    if(!isEnabled())
+        return;
+
+    QDltMsg *cacheMsg = new QDltMsg(msg);
+    qint64 msgCost = cost(msg);
+
+    Shard &s = shard(index);
+    QMutexLocker locker(&s.mutex);
+    /* object is deleted by insert if it does not fit into the cache */
+    s.cache.insert(index, cacheMsg, msgCost);
+}
+
+void QDltMsgCache::clear()
+{
+    for(int num = 0; num < numberOfShards; num++)
+    {
+        QMutexLocker locker(&shards[num].mutex);
+        shards[num].cache.clear();
+    }
+}
+
+bool QDltMsgCache::setDecoderHash(const QByteArray &hash)
+{
+    QMutexLocker locker(&decoderHashMutex);
+    if(hash == decoderHash)
+        return false;
+
+    decoderHash = hash;
+    clear();
+    return true;
+}
+
+QByteArray QDltMsgCache::getDecoderHash() const
+{
+    QMutexLocker locker(&decoderHashMutex);
+    return decoderHash;
+}
+
+void QDltMsgCache::resetStatistics()
+{
+    hits = 0;
+    misses = 0;
+}
+
+int QDltMsgCache::count() const
+{
+    int result = 0;
+    for(int num = 0; num < numberOfShards; num++)
+    {
+        QMutexLocker locker(&shards[num].mutex);
+        result += shards[num].cache.count();
+    }
+    return result;
+}
+
+qint64 QDltMsgCache::sizeBytes() const
+{
+    qint64 result = 0;
+    for(int num = 0; num < numberOfShards; num++)
+    {
+        QMutexLocker locker(&shards[num].mutex);
+        result += shards[num].cache.totalCost();
+    }
+    return result;
+}
+
+qint64 QDltMsgCache::cost(const QDltMsg &msg)
+{
+    /* payload is counted twice, because the argument list holds a copy of the argument data */
+    return sizeof(QDltMsg) + msg.getHeaderSize() + 2 * qint64(msg.getPayloadSize())
+            + msg.sizeArguments() * qint64(sizeof(QDltArgument));
+}
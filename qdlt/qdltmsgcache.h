@@ -0,0 +1,164 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmsgcache.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_MSG_CACHE_H
+#define QDLT_MSG_CACHE_H
+
+#include "export_rules.h"
+#include "qdltmsg.h"
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+
+#include <atomic>
+
+//! Cache of decoded DLT messages shared by all views of a QDltFile.
+/*!
+  Messages are stored after plugin decoding, keyed by their absolute index in the QDltFile.
+  The cache is limited by an approximate memory budget in MB instead of a number of messages.
+  Entries are distributed over several shards, each protected by its own mutex,
+  so the table view, the search view, viewer plugins and the exporter thread can use it concurrently.
+*/
+class QDLT_EXPORT QDltMsgCache
+{
+public:
+    //! The constructor.
+    QDltMsgCache();
+
+    //! Set the memory budget of the cache.
+    /*!
+      Changing the budget evicts entries until the new budget is met.
+      \param sizeMB Memory budget in MB, 0 disables the cache.
+    */
+    void setMaxSizeMB(qint64 sizeMB);
+
+    //! Get the memory budget of the cache.
+    /*!
+      \return Memory budget in MB, 0 if the cache is disabled.
+    */
+    qint64 getMaxSizeMB() const { return maxSizeMB; }
+
+    //! Check if the cache is enabled.
+    /*!
+      \return true if the budget is greater than zero.
+    */
+    bool isEnabled() const { return maxSizeMB > 0; }
+
+    //! Get a decoded message from the cache.
+    /*!
+      \param index Absolute index of the message in the QDltFile.
+      \param msg The message which contains the cached message after the function returns.
+      \return true if the message was found in the cache, false otherwise.
+    */
+    bool get(int index, QDltMsg &msg);
+
+    //! Check if a message is in the cache without changing statistics or eviction order.
+    /*!
+      \param index Absolute index of the message in the QDltFile.
+      \return true if the message is in the cache.
+    */
+    bool contains(int index) const;
+
+    //! Store a decoded message in the cache.
+    /*!
+      \param index Absolute index of the message in the QDltFile.
+      \param msg The decoded message.
+    */
+    void put(int index, const QDltMsg &msg);
+
+    //! Get a decoded message from the cache, or decode and store it if it is not cached.
+    /*!
+      \param index Absolute index of the message in the QDltFile.
+      \param msg The message which contains the decoded message after the function returns.
+      \param compute Called with msg to read and decode the message, returns false on error.
+      \return true if the message was found or decoded, false otherwise.
+    */
+    template<typename Compute>
+    bool getOrCompute(int index, QDltMsg &msg, Compute &&compute)
+    {
+        if(get(index, msg))
+            return true;
+        if(!compute(msg))
+            return false;
+        put(index, msg);
+        return true;
+    }
+
+    //! Remove all messages from the cache.
+    /*!
+      Must be called whenever the decoded representation changes, e.g. after the decoder plugins were reconfigured.
+    */
+    void clear();
+
+    //! Set the hash of the active decoder plugin configuration.
+    /*!
+      Cached messages are only valid for the decoder set they were decoded with.
+      If the hash differs from the current one, all messages are removed from the cache.
+      \param hash Hash over all active decoder plugins, empty if plugins are disabled.
+      \return true if the cache was invalidated.
+    */
+    bool setDecoderHash(const QByteArray &hash);
+
+    //! Get the hash of the decoder plugin configuration the cached messages were decoded with.
+    QByteArray getDecoderHash() const;
+
+    //! Get the number of cache hits since the last reset.
+    quint64 getHits() const { return hits; }
+
+    //! Get the number of cache misses since the last reset.
+    quint64 getMisses() const { return misses; }
+
+    //! Reset hit and miss counters.
+    void resetStatistics();
+
+    //! Get the number of messages currently stored.
+    int count() const;
+
+    //! Get the approximated memory used by all stored messages in bytes.
+    qint64 sizeBytes() const;
+
+    //! Approximate the memory footprint of a decoded message.
+    /*!
+      \param msg The message to be measured.
+      \return Estimated size in bytes.
+    */
+    static qint64 cost(const QDltMsg &msg);
+
+private:
+    static const int numberOfShards = 16;
+
+    struct Shard
+    {
+        mutable QMutex mutex;
+        QCache<int,QDltMsg> cache;
+    };
+
+    Shard &shard(int index) { return shards[static_cast<unsigned int>(index) % numberOfShards]; }
+    const Shard &shard(int index) const { return shards[static_cast<unsigned int>(index) % numberOfShards]; }
+
+    Shard shards[numberOfShards];
+    mutable QMutex decoderHashMutex;
+    QByteArray decoderHash;
+    std::atomic<qint64> maxSizeMB;
+    std::atomic<quint64> hits;
+    std::atomic<quint64> misses;
+};
+
+#endif // QDLT_MSG_CACHE_H
@@ -24,6 +24,7 @@
 #include "qdltoptmanager.h"
 #include "version.h"
 #include "qdltexporter.h"
+#include "qdltcompressedfile.h"
 
 #include <QDebug>
 #include <QFileInfo>
@@ -146,7 +147,7 @@ void QDltOptManager::parse(const QStringList& args)
             qDebug()<< "Project filename:" << projectFile;
             closeConsole = true;
         }
-        if (arg.endsWith(".dlt") || arg.endsWith(".DLT"))
+        if (arg.endsWith(".dlt") || arg.endsWith(".DLT") || QDltCompressedFile::isCompressedFileName(arg))
         {
             const QString logFile = arg;
             logFiles += logFile;
@@ -235,7 +236,7 @@ void QDltOptManager::parse(const QStringList& args)
     QStringList positionalArguments = m_parser.positionalArguments();
     for (const QString &arg : positionalArguments)
     {
-        if(arg.endsWith(".dlt") || arg.endsWith(".DLT"))
+        if(arg.endsWith(".dlt") || arg.endsWith(".DLT") || QDltCompressedFile::isCompressedFileName(arg))
         {
             const QString logFile = arg;
             logFiles += logFile;
@@ -0,0 +1,337 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltpacketreassembler.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <utility>
+
+#include "qdltpacketreassembler.h"
+#include "dlt_protocol.h"
+
+namespace {
+
+/* maximum size of an IP datagram */
+const int IP_MAX_DATAGRAM_SIZE = 65535;
+/* more incomplete datagrams are not kept, e.g. if only fragments of large datagrams were captured */
+const size_t IP_MAX_DATAGRAMS = 4096;
+/* compact the stream buffer when this much data was parsed */
+const int TCP_COMPACT_SIZE = 64 * 1024;
+
+}
+
+size_t QDltFlowKeyHash::operator()(const QDltFlowKey &key) const
+{
+    // FNV-1a over the fields
+    size_t hash = size_t(14695981039346656037ULL);
+    auto add = [&hash](const quint8 *data, size_t size) {
+        for(size_t num=0;num<size;num++)
+            hash = (hash ^ data[num]) * size_t(1099511628211ULL);
+    };
+    add(key.source,sizeof(key.source));
+    add(key.destination,sizeof(key.destination));
+    add(reinterpret_cast<const quint8*>(&key.id),sizeof(key.id));
+    add(&key.protocol,sizeof(key.protocol));
+    return hash;
+}
+
+QDltIpDefragmenter::QDltIpDefragmenter(quint32 timeout)
+    : timeout(timeout), dropped(0)
+{
+
+}
+
+bool QDltIpDefragmenter::addFragment(const QDltFlowKey &key, int offset, bool moreFragments, const char *data, int size, quint32 time, QByteArray &datagram)
+{
+    if(offset < 0 || size < 0 || offset + size > IP_MAX_DATAGRAM_SIZE || (moreFragments && (size & 7)))
+        return false; // invalid fragment
+
+    if(datagrams.size() >= IP_MAX_DATAGRAMS && datagrams.find(key) == datagrams.end())
+    {
+        dropped += datagrams.size();
+        datagrams.clear();
+    }
+
+    Datagram &entry = datagrams[key];
+    entry.time = time;
+    if(entry.data.size() < offset + size)
+    {
+        entry.data.resize(offset + size);
+        entry.received.resize((offset + size + 7) / 8);
+    }
+    memcpy(entry.data.data() + offset, data, size);
+    for(int block=offset/8;block<(offset+size+7)/8;block++)
+    {
+        if(!entry.received[block])
+        {
+            entry.received[block] = 1;
+            entry.receivedBlocks++;
+        }
+    }
+    if(!moreFragments)
+        entry.totalSize = offset + size;
+
+    if(entry.totalSize < 0 || entry.receivedBlocks < (entry.totalSize + 7) / 8)
+        return false;
+
+    datagram = std::move(entry.data);
+    datagram.resize(entry.totalSize);
+    datagrams.erase(key);
+    return true;
+}
+
+void QDltIpDefragmenter::expire(quint32 time)
+{
+    for(auto it = datagrams.begin(); it != datagrams.end();)
+    {
+        if(time - it->second.time > timeout)
+        {
+            dropped++;
+            it = datagrams.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void QDltIpDefragmenter::clear()
+{
+    datagrams.clear();
+    dropped = 0;
+}
+
+QDltTcpReassembler::QDltTcpReassembler(MessageHandler handler, quint32 timeout)
+    : handler(std::move(handler)), timeout(timeout), maxPendingBytes(4 * 1024 * 1024),
+      bytesLost(0), bytesSkipped(0), messages(0)
+{
+
+}
+
+int QDltTcpReassembler::messageSize(const char *data, int size)
+{
+    if(size < 4)
+        return 0;
+    const quint8 htyp = quint8(data[0]);
+    if((htyp & DLT_HTYP_VERS) != DLT_HTYP_PROTOCOL_VERSION1)
+        return -1;
+    const int length = (quint8(data[2]) << 8) | quint8(data[3]);
+    const int headerSize = 4 + (DLT_IS_HTYP_WEID(htyp) ? 4 : 0) + (DLT_IS_HTYP_WSID(htyp) ? 4 : 0) +
+                           (DLT_IS_HTYP_WTMS(htyp) ? 4 : 0) + (DLT_IS_HTYP_UEH(htyp) ? 10 : 0);
+    if(length < headerSize)
+        return -1;
+    if(size < length)
+        return 0;
+    return length;
+}
+
+int QDltTcpReassembler::parse(const char *data, int size)
+{
+    int pos = 0;
+    while(size - pos >= 4)
+    {
+        // serial header in front of the message
+        if(data[pos] == 'D' && data[pos+1] == 'L' && data[pos+2] == 'S' && data[pos+3] == 0x01)
+        {
+            pos += 4;
+            continue;
+        }
+        const int length = messageSize(data + pos, size - pos);
+        if(length == 0)
+            break; // message not complete
+        if(length < 0)
+        {
+            // search the next message header
+            bytesSkipped++;
+            pos++;
+            continue;
+        }
+        handler(data + pos, length);
+        messages++;
+        pos += length;
+    }
+    return pos;
+}
+
+void QDltTcpReassembler::deliver(Stream &stream, const char *data, int size)
+{
+    stream.nextSequence += quint32(size);
+    stream.nextOffset += size;
+
+    if(stream.bufferPosition >= stream.buffer.size())
+    {
+        // nothing buffered, the messages are parsed in the segment, only an incomplete message is kept
+        const int used = parse(data, size);
+        stream.buffer = QByteArray(data + used, size - used);
+        stream.bufferPosition = 0;
+        return;
+    }
+
+    stream.buffer.append(data, size);
+    stream.bufferPosition += parse(stream.buffer.constData() + stream.bufferPosition, stream.buffer.size() - stream.bufferPosition);
+    if(stream.bufferPosition >= stream.buffer.size())
+    {
+        stream.buffer.clear();
+        stream.bufferPosition = 0;
+    }
+    else if(stream.bufferPosition >= TCP_COMPACT_SIZE)
+    {
+        stream.buffer.remove(0, stream.bufferPosition);
+        stream.bufferPosition = 0;
+    }
+}
+
+void QDltTcpReassembler::deliverPending(Stream &stream)
+{
+    while(!stream.pending.empty() && stream.pending.begin()->first <= stream.nextOffset)
+    {
+        auto first = stream.pending.begin();
+        const quint64 offset = first->first;
+        const QByteArray segment = std::move(first->second);
+        stream.pending.erase(first);
+        stream.pendingBytes -= segment.size();
+
+        // parts already received are skipped
+        const quint64 end = offset + segment.size();
+        if(end > stream.nextOffset)
+        {
+            const int skip = int(stream.nextOffset - offset);
+            deliver(stream, segment.constData() + skip, segment.size() - skip);
+        }
+    }
+}
+
+void QDltTcpReassembler::skipGap(Stream &stream)
+{
+    if(stream.pending.empty())
+        return;
+
+    // the incomplete message in front of the gap is lost, parsing continues behind the gap
+    const quint64 gap = stream.pending.begin()->first - stream.nextOffset;
+    bytesLost += gap + (stream.buffer.size() - stream.bufferPosition);
+    stream.buffer.clear();
+    stream.bufferPosition = 0;
+    stream.nextSequence += quint32(gap);
+    stream.nextOffset += gap;
+    deliverPending(stream);
+}
+
+void QDltTcpReassembler::addSegment(const QDltFlowKey &key, quint32 sequence, quint8 flags, const char *data, int size, quint32 time)
+{
+    auto it = streams.find(key);
+    if(flags & FlagSyn)
+    {
+        // new connection, the SYN uses one sequence number
+        if(it != streams.end())
+            streams.erase(it);
+        Stream stream;
+        stream.nextSequence = sequence + 1;
+        it = streams.emplace(key, std::move(stream)).first;
+        sequence++;
+    }
+    else if(it == streams.end())
+    {
+        if(flags & (FlagFin | FlagRst))
+            return;
+        // capture started within the connection
+        Stream stream;
+        stream.nextSequence = sequence;
+        it = streams.emplace(key, std::move(stream)).first;
+    }
+
+    Stream &stream = it->second;
+    stream.time = time;
+
+    // stream position behind the segment, where a FIN or RST ends the connection
+    const quint64 segmentEnd = quint64(qint64(stream.nextOffset) + qint32(sequence - stream.nextSequence) + size);
+
+    if(size > 0)
+    {
+        qint32 diff = qint32(sequence - stream.nextSequence);
+        if(diff < 0)
+        {
+            // retransmission, only new data is used
+            if(-qint64(diff) >= size)
+                size = 0;
+            else
+            {
+                data -= diff;
+                size += diff;
+                diff = 0;
+            }
+        }
+        if(size > 0 && diff == 0)
+        {
+            deliver(stream, data, size);
+            deliverPending(stream);
+        }
+        else if(size > 0)
+        {
+            // data is missing in front of the segment
+            QByteArray &segment = stream.pending[stream.nextOffset + quint64(diff)];
+            if(segment.size() < size)
+            {
+                stream.pendingBytes += size - segment.size();
+                segment = QByteArray(data, size);
+            }
+            if(stream.pendingBytes > maxPendingBytes)
+                skipGap(stream);
+        }
+    }
+
+    if(flags & (FlagFin | FlagRst))
+    {
+        // segments in front of the end may still arrive out of order
+        stream.finished = true;
+        stream.endOffset = segmentEnd;
+    }
+    if(stream.finished && stream.nextOffset >= stream.endOffset)
+    {
+        bytesLost += stream.pendingBytes;
+        streams.erase(it);
+    }
+}
+
+void QDltTcpReassembler::expire(quint32 time)
+{
+    for(auto it = streams.begin(); it != streams.end();)
+    {
+        if(time - it->second.time > timeout)
+        {
+            bytesLost += it->second.pendingBytes;
+            it = streams.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void QDltTcpReassembler::flush()
+{
+    for(auto &entry : streams)
+    {
+        while(!entry.second.pending.empty())
+            skipGap(entry.second);
+    }
+    streams.clear();
+}
+
+void QDltTcpReassembler::clear()
+{
+    streams.clear();
+    bytesLost = 0;
+    bytesSkipped = 0;
+    messages = 0;
+}
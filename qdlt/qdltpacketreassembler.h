@@ -0,0 +1,218 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltpacketreassembler.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_PACKET_REASSEMBLER_H
+#define QDLT_PACKET_REASSEMBLER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#include "export_rules.h"
+
+//! Identifies a fragmented IP datagram or one direction of a TCP connection.
+struct QDltFlowKey
+{
+    quint8 source[16] = {};      //!< Source address, IPv4 addresses use the first 4 bytes.
+    quint8 destination[16] = {}; //!< Destination address.
+    quint32 id = 0;              //!< IP identification of a datagram, source and destination port of a connection.
+    quint8 protocol = 0;         //!< IP protocol number.
+
+    bool operator==(const QDltFlowKey &other) const
+    {
+        return id == other.id && protocol == other.protocol &&
+               memcmp(source,other.source,sizeof(source)) == 0 &&
+               memcmp(destination,other.destination,sizeof(destination)) == 0;
+    }
+};
+
+//! Hash of a flow key for unordered containers.
+struct QDLT_EXPORT QDltFlowKeyHash
+{
+    size_t operator()(const QDltFlowKey &key) const;
+};
+
+//! Reassemble fragmented IPv4 and IPv6 datagrams.
+/*!
+  Fragments are collected per datagram, identified by addresses, protocol and identification,
+  so fragments of different flows may be interleaved in any order. Incomplete datagrams
+  are dropped after a timeout.
+*/
+class QDLT_EXPORT QDltIpDefragmenter
+{
+public:
+    //! The constructor.
+    /*!
+      \param timeout Seconds after which incomplete datagrams are dropped.
+    */
+    explicit QDltIpDefragmenter(quint32 timeout = 30);
+
+    //! Add a fragment of a datagram.
+    /*!
+      \param key Identifies the datagram.
+      \param offset Position of the fragment in the payload of the datagram in bytes.
+      \param moreFragments false for the last fragment.
+      \param data Payload of the fragment.
+      \param size Size of the payload.
+      \param time Capture time in seconds.
+      \param datagram Set to the payload of the whole datagram if it is complete.
+      \return true if the datagram is complete.
+    */
+    bool addFragment(const QDltFlowKey &key, int offset, bool moreFragments, const char *data, int size, quint32 time, QByteArray &datagram);
+
+    //! Drop the incomplete datagrams older than the timeout.
+    /*!
+      \param time Current capture time in seconds.
+    */
+    void expire(quint32 time);
+
+    //! Drop all incomplete datagrams and reset the counter.
+    void clear();
+
+    //! Get the number of incomplete datagrams.
+    int size() const { return int(datagrams.size()); }
+
+    //! Get the number of datagrams dropped because they were not complete.
+    quint64 getDropped() const { return dropped; }
+
+private:
+    struct Datagram
+    {
+        QByteArray data;
+        QVector<quint8> received; // one flag for each block of 8 bytes
+        int receivedBlocks = 0;
+        int totalSize = -1; // known when the last fragment is received
+        quint32 time = 0;
+    };
+
+    std::unordered_map<QDltFlowKey,Datagram,QDltFlowKeyHash> datagrams;
+    quint32 timeout;
+    quint64 dropped;
+};
+
+//! Reassemble the TCP streams of DLT connections and split them into DLT messages.
+/*!
+  The data of each direction of each connection is put in order by the sequence numbers.
+  Retransmitted data is ignored, segments received out of order are kept until the missing
+  data arrives. If data is missing in the capture, the stream continues behind the gap.
+  A connection closed by FIN or RST is removed when all data up to the end is received.
+
+  The stream is parsed like a QDltConnection: DLT messages without storage header,
+  optionally with serial header. After a gap or a capture started within a connection
+  the parser searches the next valid message header. Complete messages are passed to
+  the handler, in the common case of segments in order without copying them.
+*/
+class QDLT_EXPORT QDltTcpReassembler
+{
+public:
+    //! Called for each DLT message found, the data is only valid during the call.
+    typedef std::function<void(const char *data, int size)> MessageHandler;
+
+    //! TCP header flags used by the reassembler.
+    enum { FlagFin = 0x01, FlagSyn = 0x02, FlagRst = 0x04 };
+
+    //! The constructor.
+    /*!
+      \param handler Called for each DLT message.
+      \param timeout Seconds after which idle connections are removed.
+    */
+    explicit QDltTcpReassembler(MessageHandler handler, quint32 timeout = 300);
+
+    //! Add a TCP segment.
+    /*!
+      \param key Identifies the direction of the connection.
+      \param sequence Sequence number of the segment.
+      \param flags TCP flags of the segment.
+      \param data Payload of the segment.
+      \param size Size of the payload.
+      \param time Capture time in seconds.
+    */
+    void addSegment(const QDltFlowKey &key, quint32 sequence, quint8 flags, const char *data, int size, quint32 time);
+
+    //! Remove the connections idle for longer than the timeout.
+    /*!
+      \param time Current capture time in seconds.
+    */
+    void expire(quint32 time);
+
+    //! Pass the data kept out of order of all connections to the parser and remove all connections.
+    /*!
+      Called at the end of the capture, the missing data is counted as lost.
+    */
+    void flush();
+
+    //! Remove all connections without parsing their data and reset the counters.
+    void clear();
+
+    //! Get the number of open connections.
+    int size() const { return int(streams.size()); }
+
+    //! Set the maximum amount of data kept out of order per connection, default 4 MB.
+    void setMaxPendingBytes(int bytes) { maxPendingBytes = bytes; }
+
+    //! Get the number of bytes missing in the capture.
+    quint64 getBytesLost() const { return bytesLost; }
+
+    //! Get the number of bytes skipped because they were not part of a valid DLT message.
+    quint64 getBytesSkipped() const { return bytesSkipped; }
+
+    //! Get the number of DLT messages found.
+    quint64 getMessages() const { return messages; }
+
+    //! Get the size of a DLT message without storage header in a stream.
+    /*!
+      \param data Begin of the message.
+      \param size Available data.
+      \return Size of the message, 0 if more data is needed, -1 if this is no valid message header.
+    */
+    static int messageSize(const char *data, int size);
+
+private:
+    struct Stream
+    {
+        quint32 nextSequence = 0;
+        quint64 nextOffset = 0; // position of the next expected byte in the stream, does not wrap
+        quint32 time = 0;
+        QByteArray buffer; // incomplete message, parsed from bufferPosition
+        int bufferPosition = 0;
+        std::map<quint64,QByteArray> pending; // segments received out of order by stream position
+        int pendingBytes = 0;
+        bool finished = false; // FIN or RST received, the stream is removed when endOffset is reached
+        quint64 endOffset = 0;
+    };
+
+    void deliver(Stream &stream, const char *data, int size);
+    void deliverPending(Stream &stream);
+    void skipGap(Stream &stream);
+    int parse(const char *data, int size);
+
+    MessageHandler handler;
+    std::unordered_map<QDltFlowKey,Stream,QDltFlowKeyHash> streams;
+    quint32 timeout;
+    int maxPendingBytes;
+    quint64 bytesLost;
+    quint64 bytesSkipped;
+    quint64 messages;
+};
+
+#endif // QDLT_PACKET_REASSEMBLER_H
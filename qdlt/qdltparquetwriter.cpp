@@ -0,0 +1,464 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltparquetwriter.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include "qdltparquetwriter.h"
+
+/* Parquet format constants, see parquet.thrift of the Apache Parquet project */
+#define PARQUET_MAGIC "PAR1"
+
+#define PARQUET_TYPE_INT32 1
+#define PARQUET_TYPE_INT64 2
+#define PARQUET_TYPE_BYTE_ARRAY 6
+
+#define PARQUET_CONVERTED_UTF8 0
+#define PARQUET_CONVERTED_TIMESTAMP_MICROS 10
+#define PARQUET_CONVERTED_UINT_8 11
+#define PARQUET_CONVERTED_UINT_32 13
+#define PARQUET_CONVERTED_INT_8 15
+
+#define PARQUET_REPETITION_REQUIRED 0
+
+#define PARQUET_ENCODING_PLAIN 0
+#define PARQUET_ENCODING_RLE 3
+#define PARQUET_ENCODING_RLE_DICTIONARY 8
+
+#define PARQUET_PAGE_DATA 0
+#define PARQUET_PAGE_DICTIONARY 2
+
+namespace {
+
+struct ColumnDescription
+{
+    const char *name;
+    int type;
+    int convertedType; // -1 if none
+    bool dictionary;
+};
+
+/* order of the columns in the file, must match QDltParquetWriter::writeRowGroup() */
+const ColumnDescription columns[] = {
+    { "index", PARQUET_TYPE_INT64, -1, false },
+    { "time", PARQUET_TYPE_INT64, PARQUET_CONVERTED_TIMESTAMP_MICROS, false },
+    { "timestamp", PARQUET_TYPE_INT32, PARQUET_CONVERTED_UINT_32, false },
+    { "counter", PARQUET_TYPE_INT32, PARQUET_CONVERTED_UINT_8, false },
+    { "ecuid", PARQUET_TYPE_BYTE_ARRAY, PARQUET_CONVERTED_UTF8, true },
+    { "apid", PARQUET_TYPE_BYTE_ARRAY, PARQUET_CONVERTED_UTF8, true },
+    { "ctid", PARQUET_TYPE_BYTE_ARRAY, PARQUET_CONVERTED_UTF8, true },
+    { "sessionid", PARQUET_TYPE_INT32, PARQUET_CONVERTED_UINT_32, false },
+    { "type", PARQUET_TYPE_INT32, PARQUET_CONVERTED_INT_8, false },
+    { "subtype", PARQUET_TYPE_INT32, PARQUET_CONVERTED_INT_8, false },
+    { "mode", PARQUET_TYPE_INT32, PARQUET_CONVERTED_INT_8, false },
+    { "args", PARQUET_TYPE_INT32, -1, false },
+    { "payload", PARQUET_TYPE_BYTE_ARRAY, PARQUET_CONVERTED_UTF8, false },
+};
+
+const int numberOfColumns = sizeof(columns) / sizeof(columns[0]);
+
+void appendInt32(QByteArray &data, quint32 value)
+{
+    char bytes[4];
+    for(int num = 0; num < 4; num++)
+        bytes[num] = char((value >> (8 * num)) & 0xff);
+    data.append(bytes, 4);
+}
+
+void appendInt64(QByteArray &data, quint64 value)
+{
+    char bytes[8];
+    for(int num = 0; num < 8; num++)
+        bytes[num] = char((value >> (8 * num)) & 0xff);
+    data.append(bytes, 8);
+}
+
+void appendByteArray(QByteArray &data, const QByteArray &value)
+{
+    appendInt32(data, value.size());
+    data.append(value);
+}
+
+void appendVarint(QByteArray &data, quint64 value)
+{
+    while(value >= 0x80)
+    {
+        data.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    data.append(char(value));
+}
+
+/* Serializer for the Thrift compact protocol used by the Parquet metadata */
+class ThriftCompactWriter
+{
+public:
+    enum { TypeI32 = 5, TypeI64 = 6, TypeBinary = 8, TypeList = 9, TypeStruct = 12 };
+
+    QByteArray data;
+
+    ThriftCompactWriter() : lastFieldId(0) {}
+
+    void fieldI32(int id, qint32 value)
+    {
+        fieldHeader(id, TypeI32);
+        appendVarint(data, zigzag(value));
+    }
+
+    void fieldI64(int id, qint64 value)
+    {
+        fieldHeader(id, TypeI64);
+        appendVarint(data, zigzag(value));
+    }
+
+    void fieldBinary(int id, const QByteArray &value)
+    {
+        fieldHeader(id, TypeBinary);
+        binary(value);
+    }
+
+    void fieldStructBegin(int id)
+    {
+        fieldHeader(id, TypeStruct);
+        structBegin();
+    }
+
+    void fieldList(int id, int elementType, int size)
+    {
+        fieldHeader(id, TypeList);
+        if(size < 15)
+        {
+            data.append(char((size << 4) | elementType));
+        }
+        else
+        {
+            data.append(char(0xf0 | elementType));
+            appendVarint(data, size);
+        }
+    }
+
+    /* struct as list element or nested field */
+    void structBegin()
+    {
+        fieldIds.append(lastFieldId);
+        lastFieldId = 0;
+    }
+
+    void structEnd()
+    {
+        data.append(char(0)); // stop field
+        lastFieldId = fieldIds.takeLast();
+    }
+
+    void i32(qint32 value) { appendVarint(data, zigzag(value)); }
+
+    void binary(const QByteArray &value)
+    {
+        appendVarint(data, value.size());
+        data.append(value);
+    }
+
+private:
+    static quint64 zigzag(qint64 value) { return (quint64(value) << 1) ^ quint64(value >> 63); }
+
+    void fieldHeader(int id, int type)
+    {
+        int delta = id - lastFieldId;
+        if(delta > 0 && delta <= 15)
+        {
+            data.append(char((delta << 4) | type));
+        }
+        else
+        {
+            data.append(char(type));
+            appendVarint(data, zigzag(id));
+        }
+        lastFieldId = id;
+    }
+
+    int lastFieldId;
+    QVector<int> fieldIds;
+};
+
+}
+
+void QDltParquetWriter::DictionaryColumn::append(const QByteArray &value)
+{
+    auto it = ids.constFind(value);
+    if(it == ids.constEnd())
+    {
+        it = ids.insert(value, values.size());
+        values.append(value);
+    }
+    indexes.append(it.value());
+}
+
+void QDltParquetWriter::DictionaryColumn::clear()
+{
+    ids.clear();
+    values.clear();
+    indexes.clear();
+}
+
+QDltParquetWriter::QDltParquetWriter(QIODevice *device, int rowGroupSize)
+    : device(device), rowGroupSize(rowGroupSize > 0 ? rowGroupSize : 65536),
+      position(0), numRows(0), error(false), rows(0)
+{
+
+}
+
+bool QDltParquetWriter::start()
+{
+    write(QByteArray(PARQUET_MAGIC));
+    return !error;
+}
+
+void QDltParquetWriter::addRow(const Row &row)
+{
+    appendInt64(indexColumn, row.index);
+    appendInt64(timeColumn, row.time);
+    appendInt32(timestampColumn, row.timestamp);
+    appendInt32(counterColumn, row.counter);
+    ecuidColumn.append(row.ecuid);
+    apidColumn.append(row.apid);
+    ctidColumn.append(row.ctid);
+    appendInt32(sessionidColumn, row.sessionid);
+    appendInt32(typeColumn, quint32(qint32(row.type)));
+    appendInt32(subtypeColumn, quint32(qint32(row.subtype)));
+    appendInt32(modeColumn, quint32(qint32(row.mode)));
+    appendInt32(argsColumn, quint32(row.args));
+    appendByteArray(payloadColumn, row.payload);
+
+    rows++;
+    numRows++;
+    if(rows >= rowGroupSize)
+        writeRowGroup();
+}
+
+bool QDltParquetWriter::finish()
+{
+    if(rows > 0)
+        writeRowGroup();
+
+    QByteArray metaData = createFileMetaData();
+    write(metaData);
+    QByteArray length;
+    appendInt32(length, metaData.size());
+    write(length);
+    write(QByteArray(PARQUET_MAGIC));
+
+    return !error;
+}
+
+void QDltParquetWriter::writeRowGroup()
+{
+    RowGroupInfo rowGroup;
+    rowGroup.numRows = rows;
+
+    qint64 start = position;
+    rowGroup.chunks.append(writePlainChunk(indexColumn));
+    rowGroup.chunks.append(writePlainChunk(timeColumn));
+    rowGroup.chunks.append(writePlainChunk(timestampColumn));
+    rowGroup.chunks.append(writePlainChunk(counterColumn));
+    rowGroup.chunks.append(writeDictionaryChunk(ecuidColumn));
+    rowGroup.chunks.append(writeDictionaryChunk(apidColumn));
+    rowGroup.chunks.append(writeDictionaryChunk(ctidColumn));
+    rowGroup.chunks.append(writePlainChunk(sessionidColumn));
+    rowGroup.chunks.append(writePlainChunk(typeColumn));
+    rowGroup.chunks.append(writePlainChunk(subtypeColumn));
+    rowGroup.chunks.append(writePlainChunk(modeColumn));
+    rowGroup.chunks.append(writePlainChunk(argsColumn));
+    rowGroup.chunks.append(writePlainChunk(payloadColumn));
+    rowGroup.size = position - start;
+    rowGroups.append(rowGroup);
+
+    rows = 0;
+    indexColumn.clear();
+    timeColumn.clear();
+    timestampColumn.clear();
+    counterColumn.clear();
+    ecuidColumn.clear();
+    apidColumn.clear();
+    ctidColumn.clear();
+    sessionidColumn.clear();
+    typeColumn.clear();
+    subtypeColumn.clear();
+    modeColumn.clear();
+    argsColumn.clear();
+    payloadColumn.clear();
+}
+
+QDltParquetWriter::ChunkInfo QDltParquetWriter::writePlainChunk(const QByteArray &values)
+{
+    ChunkInfo chunk;
+    chunk.dataPageOffset = position;
+    writePage(PARQUET_PAGE_DATA, values, rows, PARQUET_ENCODING_PLAIN);
+    chunk.size = position - chunk.dataPageOffset;
+    return chunk;
+}
+
+QDltParquetWriter::ChunkInfo QDltParquetWriter::writeDictionaryChunk(const DictionaryColumn &column)
+{
+    ChunkInfo chunk;
+
+    /* dictionary page with all distinct values in plain encoding */
+    chunk.dictionaryPageOffset = position;
+    QByteArray dictionary;
+    for(const QByteArray &value : column.values)
+        appendByteArray(dictionary, value);
+    writePage(PARQUET_PAGE_DICTIONARY, dictionary, column.values.size(), PARQUET_ENCODING_PLAIN);
+
+    /* data page with the dictionary indexes, bit width followed by RLE runs of equal indexes */
+    chunk.dataPageOffset = position;
+    int bitWidth = 1;
+    while((1 << bitWidth) < column.values.size())
+        bitWidth++;
+    int valueBytes = (bitWidth + 7) / 8;
+
+    QByteArray data;
+    data.append(char(bitWidth));
+    for(int num = 0; num < column.indexes.size();)
+    {
+        int value = column.indexes.at(num);
+        int runLength = 1;
+        while(num + runLength < column.indexes.size() && column.indexes.at(num + runLength) == value)
+            runLength++;
+        appendVarint(data, quint64(runLength) << 1);
+        for(int byte = 0; byte < valueBytes; byte++)
+            data.append(char((value >> (8 * byte)) & 0xff));
+        num += runLength;
+    }
+    writePage(PARQUET_PAGE_DATA, data, column.indexes.size(), PARQUET_ENCODING_RLE_DICTIONARY);
+
+    chunk.size = position - chunk.dictionaryPageOffset;
+    return chunk;
+}
+
+void QDltParquetWriter::writePage(int pageType, const QByteArray &data, int numValues, int encoding)
+{
+    ThriftCompactWriter header;
+    header.structBegin();
+    header.fieldI32(1, pageType);
+    header.fieldI32(2, data.size()); // uncompressed size
+    header.fieldI32(3, data.size()); // compressed size
+    if(pageType == PARQUET_PAGE_DATA)
+    {
+        header.fieldStructBegin(5);
+        header.fieldI32(1, numValues);
+        header.fieldI32(2, encoding);
+        header.fieldI32(3, PARQUET_ENCODING_RLE); // definition levels, not used by required columns
+        header.fieldI32(4, PARQUET_ENCODING_RLE); // repetition levels, not used by flat schema
+        header.structEnd();
+    }
+    else
+    {
+        header.fieldStructBegin(7);
+        header.fieldI32(1, numValues);
+        header.fieldI32(2, encoding);
+        header.structEnd();
+    }
+    header.structEnd();
+
+    write(header.data);
+    write(data);
+}
+
+QByteArray QDltParquetWriter::createFileMetaData() const
+{
+    ThriftCompactWriter meta;
+    meta.structBegin();
+    meta.fieldI32(1, 1); // version
+
+    /* schema, root element followed by one element for each column */
+    meta.fieldList(2, ThriftCompactWriter::TypeStruct, numberOfColumns + 1);
+    meta.structBegin();
+    meta.fieldBinary(4, "schema");
+    meta.fieldI32(5, numberOfColumns);
+    meta.structEnd();
+    for(const ColumnDescription &column : columns)
+    {
+        meta.structBegin();
+        meta.fieldI32(1, column.type);
+        meta.fieldI32(3, PARQUET_REPETITION_REQUIRED);
+        meta.fieldBinary(4, column.name);
+        if(column.convertedType >= 0)
+            meta.fieldI32(6, column.convertedType);
+        meta.structEnd();
+    }
+
+    meta.fieldI64(3, numRows);
+
+    meta.fieldList(4, ThriftCompactWriter::TypeStruct, rowGroups.size());
+    for(const RowGroupInfo &rowGroup : rowGroups)
+    {
+        meta.structBegin();
+        meta.fieldList(1, ThriftCompactWriter::TypeStruct, numberOfColumns);
+        for(int num = 0; num < numberOfColumns; num++)
+        {
+            const ColumnDescription &column = columns[num];
+            const ChunkInfo &chunk = rowGroup.chunks.at(num);
+            qint64 chunkOffset = column.dictionary ? chunk.dictionaryPageOffset : chunk.dataPageOffset;
+
+            /* column chunk */
+            meta.structBegin();
+            meta.fieldI64(2, chunkOffset);
+
+            /* column meta data */
+            meta.fieldStructBegin(3);
+            meta.fieldI32(1, column.type);
+            if(column.dictionary)
+            {
+                meta.fieldList(2, ThriftCompactWriter::TypeI32, 3);
+                meta.i32(PARQUET_ENCODING_PLAIN);
+                meta.i32(PARQUET_ENCODING_RLE);
+                meta.i32(PARQUET_ENCODING_RLE_DICTIONARY);
+            }
+            else
+            {
+                meta.fieldList(2, ThriftCompactWriter::TypeI32, 2);
+                meta.i32(PARQUET_ENCODING_PLAIN);
+                meta.i32(PARQUET_ENCODING_RLE);
+            }
+            meta.fieldList(3, ThriftCompactWriter::TypeBinary, 1);
+            meta.binary(column.name);
+            meta.fieldI32(4, 0); // uncompressed
+            meta.fieldI64(5, rowGroup.numRows);
+            meta.fieldI64(6, chunk.size);
+            meta.fieldI64(7, chunk.size);
+            meta.fieldI64(9, chunk.dataPageOffset);
+            if(column.dictionary)
+                meta.fieldI64(11, chunk.dictionaryPageOffset);
+            meta.structEnd();
+
+            meta.structEnd();
+        }
+        meta.fieldI64(2, rowGroup.size);
+        meta.fieldI64(3, rowGroup.numRows);
+        meta.structEnd();
+    }
+
+    meta.fieldBinary(6, "COVESA DLT Viewer");
+    meta.structEnd();
+
+    return meta.data;
+}
+
+void QDltParquetWriter::write(const QByteArray &data)
+{
+    if(device->write(data) != data.size())
+        error = true;
+    position += data.size();
+}
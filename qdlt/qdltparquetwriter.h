@@ -0,0 +1,144 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltparquetwriter.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_PARQUET_WRITER_H
+#define QDLT_PARQUET_WRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QVector>
+
+#include "export_rules.h"
+
+//! Write DLT messages in the Apache Parquet columnar file format.
+/*!
+  The writer has no external dependencies, it writes uncompressed files with a fixed schema:
+  index, time (UTC in microseconds), timestamp (0.1 ms), counter, ecuid, apid, ctid, sessionid,
+  type, subtype, mode, args and payload.
+  Ecuid, apid and ctid are dictionary encoded, all other columns use plain encoding.
+  Rows are collected in memory and written as one row group each time the row group size is reached.
+*/
+class QDLT_EXPORT QDltParquetWriter
+{
+public:
+    //! One message in the export.
+    struct Row
+    {
+        qint64 index = 0;
+        qint64 time = 0;
+        quint32 timestamp = 0;
+        quint8 counter = 0;
+        QByteArray ecuid;
+        QByteArray apid;
+        QByteArray ctid;
+        quint32 sessionid = 0;
+        qint8 type = 0;
+        qint8 subtype = 0;
+        qint8 mode = 0;
+        qint32 args = 0;
+        QByteArray payload;
+    };
+
+    //! The constructor.
+    /*!
+      \param device Opened device the file is written to, must stay valid until finish() is called.
+      \param rowGroupSize Number of rows in each row group.
+    */
+    explicit QDltParquetWriter(QIODevice *device, int rowGroupSize = 65536);
+
+    //! Write the file header.
+    /*!
+      \return false if writing failed.
+    */
+    bool start();
+
+    //! Add a row, a row group is written if enough rows are collected.
+    /*!
+      \param row The message to be added.
+    */
+    void addRow(const Row &row);
+
+    //! Write the remaining rows and the file footer.
+    /*!
+      \return false if writing failed.
+    */
+    bool finish();
+
+    //! Get the number of rows added.
+    qint64 getNumberOfRows() const { return numRows; }
+
+private:
+    struct DictionaryColumn
+    {
+        QHash<QByteArray,int> ids;
+        QVector<QByteArray> values;
+        QVector<int> indexes;
+
+        void append(const QByteArray &value);
+        void clear();
+    };
+
+    struct ChunkInfo
+    {
+        qint64 dictionaryPageOffset = -1;
+        qint64 dataPageOffset = 0;
+        qint64 size = 0;
+    };
+
+    struct RowGroupInfo
+    {
+        QVector<ChunkInfo> chunks;
+        qint64 numRows = 0;
+        qint64 size = 0;
+    };
+
+    void writeRowGroup();
+    ChunkInfo writePlainChunk(const QByteArray &values);
+    ChunkInfo writeDictionaryChunk(const DictionaryColumn &column);
+    void writePage(int pageType, const QByteArray &data, int numValues, int encoding);
+    QByteArray createFileMetaData() const;
+    void write(const QByteArray &data);
+
+    QIODevice *device;
+    int rowGroupSize;
+    qint64 position;
+    qint64 numRows;
+    bool error;
+
+    /* columns of the current row group */
+    int rows;
+    QByteArray indexColumn;
+    QByteArray timeColumn;
+    QByteArray timestampColumn;
+    QByteArray counterColumn;
+    DictionaryColumn ecuidColumn;
+    DictionaryColumn apidColumn;
+    DictionaryColumn ctidColumn;
+    QByteArray sessionidColumn;
+    QByteArray typeColumn;
+    QByteArray subtypeColumn;
+    QByteArray modeColumn;
+    QByteArray argsColumn;
+    QByteArray payloadColumn;
+
+    QVector<RowGroupInfo> rowGroups;
+};
+
+#endif // QDLT_PARQUET_WRITER_H
@@ -0,0 +1,351 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltpcapreader.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QDebug>
+#include <QtEndian>
+
+#include "qdltpcapreader.h"
+
+namespace {
+
+const quint32 PCAP_MAGIC_MICROSECONDS = 0xa1b2c3d4;
+const quint32 PCAP_MAGIC_NANOSECONDS = 0xa1b23c4d;
+const int PCAP_FILE_HEADER_SIZE = 24;
+const int PCAP_RECORD_HEADER_SIZE = 16;
+
+const quint32 PCAPNG_SECTION_HEADER_BLOCK = 0x0A0D0D0A;
+const quint32 PCAPNG_INTERFACE_DESCRIPTION_BLOCK = 1;
+const quint32 PCAPNG_OBSOLETE_PACKET_BLOCK = 2;
+const quint32 PCAPNG_SIMPLE_PACKET_BLOCK = 3;
+const quint32 PCAPNG_ENHANCED_PACKET_BLOCK = 6;
+const quint32 PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+const quint16 PCAPNG_OPTION_END = 0;
+const quint16 PCAPNG_OPTION_IF_TSRESOL = 9;
+const quint16 PCAPNG_OPTION_IF_TSOFFSET = 14;
+
+/* larger packets or blocks are treated as corrupted file */
+const qint64 PCAP_MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+
+}
+
+QDltPcapReader::QDltPcapReader()
+    : fileSize(0), position(0), windowSize(256 * 1024 * 1024), window(nullptr), windowStart(0), windowLength(0),
+      pcapng(false), bigEndian(false), errors(0)
+{
+
+}
+
+QDltPcapReader::~QDltPcapReader()
+{
+    close();
+}
+
+bool QDltPcapReader::open(const QString &fileName)
+{
+    close();
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qDebug() << "QDltPcapReader: Cannot open file" << fileName;
+        return false;
+    }
+    fileSize = file.size();
+
+    const uchar *header = map(0,PCAP_FILE_HEADER_SIZE);
+    if(!header)
+    {
+        qDebug() << "QDltPcapReader: File too small" << fileName;
+        close();
+        return false;
+    }
+
+    const quint32 magic = qFromLittleEndian<quint32>(header);
+    if(magic == PCAPNG_SECTION_HEADER_BLOCK)
+    {
+        // the sections are read like packets, each one sets its byte order
+        pcapng = true;
+        return true;
+    }
+    if(magic == PCAP_MAGIC_MICROSECONDS || magic == PCAP_MAGIC_NANOSECONDS)
+        bigEndian = false;
+    else if(qFromBigEndian<quint32>(header) == PCAP_MAGIC_MICROSECONDS || qFromBigEndian<quint32>(header) == PCAP_MAGIC_NANOSECONDS)
+        bigEndian = true;
+    else
+    {
+        qDebug() << "QDltPcapReader: Unknown file format" << fileName;
+        close();
+        return false;
+    }
+    pcapInterface.ticksPerSecond = read32(header) == PCAP_MAGIC_NANOSECONDS ? 1000000000 : 1000000;
+    pcapInterface.linkType = read32(header+20) & 0xffff; // upper bits contain the FCS length
+    position = PCAP_FILE_HEADER_SIZE;
+    return true;
+}
+
+void QDltPcapReader::close()
+{
+    if(window)
+        file.unmap(window);
+    window = nullptr;
+    windowStart = 0;
+    windowLength = 0;
+    file.close();
+    fileSize = 0;
+    position = 0;
+    pcapng = false;
+    bigEndian = false;
+    pcapInterface = Interface();
+    interfaces.clear();
+    errors = 0;
+}
+
+const uchar *QDltPcapReader::map(qint64 pos, qint64 size)
+{
+    if(pos < 0 || size < 0 || pos + size > fileSize)
+        return nullptr;
+    if(window && pos >= windowStart && pos + size <= windowStart + windowLength)
+        return window + (pos - windowStart);
+
+    /* map the next window, at least the requested range */
+    if(window)
+        file.unmap(window);
+    windowStart = pos;
+    windowLength = qMin(fileSize - pos, qMax(windowSize, size));
+    window = file.map(windowStart,windowLength);
+    if(!window)
+    {
+        qDebug() << "QDltPcapReader: Cannot map file" << file.fileName() << "at position" << pos;
+        windowLength = 0;
+        return nullptr;
+    }
+    return window;
+}
+
+quint16 QDltPcapReader::read16(const uchar *data) const
+{
+    return bigEndian ? qFromBigEndian<quint16>(data) : qFromLittleEndian<quint16>(data);
+}
+
+quint32 QDltPcapReader::read32(const uchar *data) const
+{
+    return bigEndian ? qFromBigEndian<quint32>(data) : qFromLittleEndian<quint32>(data);
+}
+
+quint64 QDltPcapReader::read64(const uchar *data) const
+{
+    return bigEndian ? qFromBigEndian<quint64>(data) : qFromLittleEndian<quint64>(data);
+}
+
+void QDltPcapReader::setTime(QDltPcapPacket &packet, const Interface &iface, quint64 ticks) const
+{
+    const quint64 fraction = ticks % iface.ticksPerSecond;
+    packet.sec = quint32(qint64(ticks / iface.ticksPerSecond) + iface.offsetSeconds);
+    if(iface.ticksPerSecond <= (quint64(1) << 40))
+        packet.usec = quint32(fraction * 1000000 / iface.ticksPerSecond);
+    else
+        packet.usec = quint32(double(fraction) * 1000000 / double(iface.ticksPerSecond));
+}
+
+bool QDltPcapReader::readPacket(QDltPcapPacket &packet)
+{
+    if(!pcapng)
+        return readPcapRecord(packet);
+
+    bool isPacket = false;
+    while(readPcapngBlock(packet,isPacket))
+    {
+        if(isPacket)
+            return true;
+    }
+    return false;
+}
+
+bool QDltPcapReader::readPcapRecord(QDltPcapPacket &packet)
+{
+    if(position >= fileSize)
+        return false;
+
+    const uchar *header = map(position,PCAP_RECORD_HEADER_SIZE);
+    if(!header)
+    {
+        qDebug() << "QDltPcapReader: Record header truncated at position" << position;
+        errors++;
+        return false;
+    }
+    const quint32 sec = read32(header);
+    const quint32 fraction = read32(header+4);
+    const quint32 capturedSize = read32(header+8);
+    const quint32 originalSize = read32(header+12);
+    if(capturedSize > PCAP_MAX_BLOCK_SIZE)
+    {
+        qDebug() << "QDltPcapReader: Invalid record size" << capturedSize << "at position" << position;
+        errors++;
+        return false;
+    }
+
+    const uchar *record = map(position,PCAP_RECORD_HEADER_SIZE+capturedSize);
+    if(!record)
+    {
+        qDebug() << "QDltPcapReader: Record truncated at position" << position;
+        errors++;
+        return false;
+    }
+    packet.data = reinterpret_cast<const char*>(record + PCAP_RECORD_HEADER_SIZE);
+    packet.size = capturedSize;
+    packet.originalSize = originalSize;
+    packet.linkType = pcapInterface.linkType;
+    packet.sec = sec;
+    packet.usec = pcapInterface.ticksPerSecond == 1000000 ? fraction : fraction / 1000;
+    position += PCAP_RECORD_HEADER_SIZE + capturedSize;
+    return true;
+}
+
+void QDltPcapReader::readInterfaceOptions(Interface &iface, const uchar *options, qint64 size)
+{
+    qint64 pos = 0;
+    while(pos + 4 <= size)
+    {
+        const quint16 code = read16(options+pos);
+        const quint16 length = read16(options+pos+2);
+        pos += 4;
+        if(code == PCAPNG_OPTION_END || pos + length > size)
+            break;
+        if(code == PCAPNG_OPTION_IF_TSRESOL && length == 1)
+        {
+            // negative power of 10, or of 2 if the highest bit is set
+            const quint8 resolution = options[pos];
+            quint64 ticks = 1;
+            if(resolution & 0x80)
+                ticks = quint64(1) << qMin(63, resolution & 0x7f);
+            else
+            {
+                for(int num=0;num<qMin(19, int(resolution));num++)
+                    ticks *= 10;
+            }
+            iface.ticksPerSecond = ticks;
+        }
+        else if(code == PCAPNG_OPTION_IF_TSOFFSET && length == 8)
+        {
+            iface.offsetSeconds = qint64(read64(options+pos));
+        }
+        pos += (length + 3) & ~3;
+    }
+}
+
+bool QDltPcapReader::readPcapngBlock(QDltPcapPacket &packet, bool &isPacket)
+{
+    isPacket = false;
+    if(position >= fileSize)
+        return false;
+
+    const uchar *header = map(position,12);
+    if(!header)
+    {
+        qDebug() << "QDltPcapReader: Block header truncated at position" << position;
+        errors++;
+        return false;
+    }
+
+    /* the byte order of a section is defined by its header block */
+    const quint32 type = qFromLittleEndian<quint32>(header);
+    if(type == PCAPNG_SECTION_HEADER_BLOCK)
+    {
+        if(qFromLittleEndian<quint32>(header+8) == PCAPNG_BYTE_ORDER_MAGIC)
+            bigEndian = false;
+        else if(qFromBigEndian<quint32>(header+8) == PCAPNG_BYTE_ORDER_MAGIC)
+            bigEndian = true;
+        else
+        {
+            qDebug() << "QDltPcapReader: Invalid section header at position" << position;
+            errors++;
+            return false;
+        }
+        interfaces.clear();
+    }
+
+    const quint32 blockType = read32(header);
+    const quint32 blockLength = read32(header+4);
+    if(blockLength < 12 || (blockLength & 3) || blockLength > PCAP_MAX_BLOCK_SIZE)
+    {
+        qDebug() << "QDltPcapReader: Invalid block length" << blockLength << "at position" << position;
+        errors++;
+        return false;
+    }
+    const uchar *block = map(position,blockLength);
+    if(!block)
+    {
+        qDebug() << "QDltPcapReader: Block truncated at position" << position;
+        errors++;
+        return false;
+    }
+    const uchar *body = block + 8;
+    const qint64 bodyLength = blockLength - 12;
+    position += blockLength;
+
+    if(blockType == PCAPNG_INTERFACE_DESCRIPTION_BLOCK && bodyLength >= 8)
+    {
+        Interface iface;
+        iface.linkType = read16(body);
+        readInterfaceOptions(iface,body+8,bodyLength-8);
+        interfaces.append(iface);
+    }
+    else if(blockType == PCAPNG_ENHANCED_PACKET_BLOCK || blockType == PCAPNG_OBSOLETE_PACKET_BLOCK)
+    {
+        if(bodyLength < 20)
+        {
+            errors++;
+            return true;
+        }
+        const quint32 interfaceId = blockType == PCAPNG_ENHANCED_PACKET_BLOCK ? read32(body) : read16(body);
+        const quint64 ticks = (quint64(read32(body+4)) << 32) | read32(body+8);
+        const quint32 capturedSize = read32(body+12);
+        if(interfaceId >= quint32(interfaces.size()) || capturedSize > bodyLength - 20)
+        {
+            errors++;
+            return true;
+        }
+        const Interface &iface = interfaces.at(interfaceId);
+        packet.data = reinterpret_cast<const char*>(body + 20);
+        packet.size = capturedSize;
+        packet.originalSize = read32(body+16);
+        packet.linkType = iface.linkType;
+        setTime(packet,iface,ticks);
+        isPacket = true;
+    }
+    else if(blockType == PCAPNG_SIMPLE_PACKET_BLOCK)
+    {
+        // no timestamp, captured on the first interface
+        if(bodyLength < 4 || interfaces.isEmpty())
+        {
+            errors++;
+            return true;
+        }
+        const quint32 originalSize = read32(body);
+        packet.data = reinterpret_cast<const char*>(body + 4);
+        packet.size = int(qMin<qint64>(originalSize, bodyLength - 4));
+        packet.originalSize = originalSize;
+        packet.linkType = interfaces.first().linkType;
+        packet.sec = 0;
+        packet.usec = 0;
+        isPacket = true;
+    }
+
+    return true;
+}
@@ -0,0 +1,137 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltpcapreader.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_PCAP_READER_H
+#define QDLT_PCAP_READER_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include "export_rules.h"
+
+//! Link layer types of captured packets, see https://www.tcpdump.org/linktypes.html
+enum QDltPcapLinkType
+{
+    QDltPcapLinkTypeNull = 0,          //!< BSD loopback, 4 byte address family in host byte order
+    QDltPcapLinkTypeEthernet = 1,      //!< Ethernet II
+    QDltPcapLinkTypeRaw = 101,         //!< IPv4 or IPv6 packet without link layer
+    QDltPcapLinkTypeLinuxSll = 113,    //!< Linux cooked capture
+    QDltPcapLinkTypeLinuxSll2 = 276    //!< Linux cooked capture v2
+};
+
+//! One packet of a capture file.
+/*!
+  The data points into the mapped capture file and is valid until the next packet is read.
+*/
+struct QDltPcapPacket
+{
+    const char *data = nullptr; //!< Captured bytes of the packet.
+    int size = 0;               //!< Number of captured bytes.
+    int originalSize = 0;       //!< Size of the packet on the wire, larger than size if truncated by the snap length.
+    quint32 sec = 0;            //!< Capture time, seconds since 1970-01-01 UTC.
+    quint32 usec = 0;           //!< Capture time, microseconds.
+    int linkType = QDltPcapLinkTypeEthernet; //!< QDltPcapLinkType of the interface.
+};
+
+//! Read the packets of pcap and pcapng capture files.
+/*!
+  The file is mapped into memory in windows of some hundred MB, so files of any size
+  are read without copying the packets. Classic pcap files with microsecond and nanosecond
+  timestamps in both byte orders are supported, as well as pcapng files with several
+  sections and interfaces. Enhanced, simple and obsolete packet blocks are read,
+  all other blocks are skipped.
+*/
+class QDLT_EXPORT QDltPcapReader
+{
+public:
+    //! The constructor.
+    QDltPcapReader();
+
+    //! The destructor, closes the file.
+    ~QDltPcapReader();
+
+    //! Open a capture file and read its file header.
+    /*!
+      \param fileName The pcap or pcapng file.
+      \return false if the file cannot be opened or is no capture file.
+    */
+    bool open(const QString &fileName);
+
+    //! Close the file.
+    void close();
+
+    //! Read the next packet.
+    /*!
+      \param packet The packet, the data is valid until the next call.
+      \return false at the end of the file or if the file is truncated.
+    */
+    bool readPacket(QDltPcapPacket &packet);
+
+    //! Check if the file is in pcapng format.
+    bool isPcapng() const { return pcapng; }
+
+    //! Get the position in the file behind the last packet read.
+    qint64 getPosition() const { return position; }
+
+    //! Get the size of the file.
+    qint64 getFileSize() const { return fileSize; }
+
+    //! Get the number of invalid or truncated blocks found.
+    int getErrors() const { return errors; }
+
+    //! Set the size of the window of the file mapped into memory.
+    /*!
+      Must be called before open(), default is 256 MB.
+      \param size The window size in bytes.
+    */
+    void setWindowSize(qint64 size) { windowSize = size; }
+
+private:
+    struct Interface
+    {
+        int linkType = QDltPcapLinkTypeEthernet;
+        quint64 ticksPerSecond = 1000000;
+        qint64 offsetSeconds = 0;
+    };
+
+    const uchar *map(qint64 pos, qint64 size);
+    quint16 read16(const uchar *data) const;
+    quint32 read32(const uchar *data) const;
+    quint64 read64(const uchar *data) const;
+    bool readPcapRecord(QDltPcapPacket &packet);
+    bool readPcapngBlock(QDltPcapPacket &packet, bool &isPacket);
+    void readInterfaceOptions(Interface &iface, const uchar *options, qint64 size);
+    void setTime(QDltPcapPacket &packet, const Interface &iface, quint64 ticks) const;
+
+    QFile file;
+    qint64 fileSize;
+    qint64 position;
+    qint64 windowSize;
+    uchar *window;
+    qint64 windowStart;
+    qint64 windowLength;
+    bool pcapng;
+    bool bigEndian; // byte order of the file or of the current pcapng section
+    Interface pcapInterface; // link type and time resolution of a classic pcap file
+    QVector<Interface> interfaces; // interfaces of the current pcapng section
+    int errors;
+};
+
+#endif // QDLT_PCAP_READER_H
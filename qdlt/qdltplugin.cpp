@@ -13,6 +13,8 @@ QDltPlugin::QDltPlugin()
     plugindecoderinterface = 0;
     plugincontrolinterface = 0;
     plugincommandinterface = 0;
+    plugindecoderreentrantinterface = 0;
+    decoderReentrant = false;
 
     mode = ModeDisable;
 }
@@ -33,7 +35,10 @@ void QDltPlugin::setFilename(QString _filename)
 {
     filename = _filename;
     if(plugininterface)
+    {
+        QWriteLocker locker(&decoderLock);
         plugininterface->loadConfig(_filename);
+    }
     setMode(ModeEnable);
 
 }
@@ -69,6 +74,8 @@ void QDltPlugin::loadPlugin(QObject *plugin)
         }*/
     }
     plugindecoderinterface = qobject_cast<QDLTPluginDecoderInterface *>(plugin);
+    plugindecoderreentrantinterface = qobject_cast<QDltPluginDecoderReentrantInterface *>(plugin);
+    decoderReentrant = plugindecoderinterface && plugindecoderreentrantinterface && plugindecoderreentrantinterface->isDecoderReentrant();
     plugincontrolinterface = qobject_cast<QDltPluginControlInterface *>(plugin);
     plugincommandinterface = qobject_cast<QDltPluginCommandInterface *>(plugin);
     //item->update();
@@ -80,6 +87,11 @@ bool QDltPlugin::isDecoder()
     return (plugindecoderinterface?true:false);
 }
 
+bool QDltPlugin::isDecoderReentrant()
+{
+    return decoderReentrant;
+}
+
 bool QDltPlugin::isViewer()
 {
     return (pluginviewerinterface?true:false);
@@ -131,7 +143,10 @@ QString QDltPlugin::error()
 bool QDltPlugin::loadConfig(QString filename)
 {
     if(plugininterface)
+    {
+        QWriteLocker locker(&decoderLock);
         return plugininterface->loadConfig(filename);
+    }
     else
         return false;
 }
@@ -265,11 +280,17 @@ if(plugincontrolinterface)
 // decoder plugin interfaces
 bool QDltPlugin::decodeMsg(QDltMsg &msg, int triggeredByUser)
 {
-    if(mode != ModeDisable && plugindecoderinterface && plugindecoderinterface->isMsg(msg,triggeredByUser))
+    if(mode == ModeDisable || !plugindecoderinterface)
+        return false;
+
+    if(decoderReentrant)
     {
-        return plugindecoderinterface->decodeMsg(msg,triggeredByUser);
+        QReadLocker locker(&decoderLock);
+        return plugindecoderinterface->isMsg(msg,triggeredByUser) && plugindecoderinterface->decodeMsg(msg,triggeredByUser);
     }
-    return false;
+
+    QWriteLocker locker(&decoderLock);
+    return plugindecoderinterface->isMsg(msg,triggeredByUser) && plugindecoderinterface->decodeMsg(msg,triggeredByUser);
 }
 
 // command plugin interfaces
@@ -4,6 +4,7 @@
 #include "plugininterface.h"
 
 #include <QDir>
+#include <QReadWriteLock>
 
 #include "export_rules.h"
 
@@ -52,6 +53,12 @@ public:
     */
     bool isDecoder();
 
+    //! Check if the decoder of this plugin can be called from several threads at the same time
+    /*!
+      \return True if the plugin implements QDltPluginDecoderReentrantInterface and declares itself reentrant
+    */
+    bool isDecoderReentrant();
+
     //! Check if this is a viewer plugin
     /*!
       \return True if it is a viewer plugin
@@ -121,10 +128,16 @@ private:
     */
     QDLTPluginInterface *plugininterface;
     QDLTPluginDecoderInterface *plugindecoderinterface;
+    QDltPluginDecoderReentrantInterface *plugindecoderreentrantinterface;
     QDltPluginViewerInterface  *pluginviewerinterface;
     QDltPluginControlInterface *plugincontrolinterface;
     QDltPluginCommandInterface *plugincommandinterface;
 
+    //! Decoding takes the lock shared for reentrant plugins and exclusive otherwise,
+    //! loading a configuration always takes it exclusive.
+    QReadWriteLock decoderLock;
+    bool decoderReentrant;
+
 };
 
 #endif // QDLTPLUGIN_H
@@ -82,6 +82,7 @@ QStringList QDltPluginManager::loadPluginsPath(QDir &dir)
                     item->initMessageDecoder(this);
                     pluginListMutex.lock();
                     plugins.append(item);
+                    updateSnapshot();
                     pluginListMutex.unlock();
 
                     //project.plugin->addTopLevelItem(item);
@@ -128,14 +129,22 @@ void QDltPluginManager::loadConfig(QString pluginName, QString filename) {
 
 void QDltPluginManager::decodeMsg(QDltMsg &msg, int triggeredByUser)
 {
-    QMutexLocker mutexLocker(&pluginListMutex);
-    for(auto* plugin : plugins)
+    std::shared_ptr<const QList<QDltPlugin*>> snapshot = std::atomic_load(&pluginsSnapshot);
+    if(!snapshot)
+        return;
+
+    for(auto* plugin : *snapshot)
     {
         if(plugin->decodeMsg(msg,triggeredByUser))
             break;
     }
 }
 
+void QDltPluginManager::updateSnapshot()
+{
+    std::atomic_store(&pluginsSnapshot, std::make_shared<const QList<QDltPlugin*>>(plugins));
+}
+
 QDltPlugin* QDltPluginManager::findPlugin(const QString& name) const {
 
     QMutexLocker mutexLocker(&pluginListMutex);
@@ -171,6 +180,7 @@ bool QDltPluginManager::decreasePluginPriority(const QString &name)
             {
                 qDebug() << "decrease prio of" << name << "from" << num << "to" << num+1;
                 plugins.move(num, num+1);
+                updateSnapshot();
                 result = true;
                 break;
             }
@@ -192,6 +202,7 @@ bool QDltPluginManager::raisePluginPriority(const QString &name)
             if (plugins[num]->name() == name) {
                 qDebug() << "raise prio of" << name << "from" << num << "to" << num-1;
                 plugins.move(num, num-1);
+                updateSnapshot();
                 result = true;
                 break;
             }
@@ -217,6 +228,7 @@ bool QDltPluginManager::setPluginPriority(const QString& name, int prio)
                 if (prio != num) {
                     qDebug() << "Changing priority of plugin" << name << "from" << num << "to" << prio;
                     plugins.move(num, prio);
+                    updateSnapshot();
                 }
                 result = true;
                 break;
@@ -9,6 +9,8 @@
 
 #include <QDir>
 
+#include <memory>
+
 //! Manage all DLT Plugins
 /*!
   This class loads all DLT Viewer Plugins and provides access to them.
@@ -46,6 +48,9 @@ public:
     //! Implementation of QDltMessageDecoder's pure virtual method.
     //! Decode message by decoding through all loaded an activated decoder plugins.
     /*!
+      Can be called from several threads at the same time. The plugin list is not locked,
+      a snapshot of the list is used instead. Decoder plugins which are not reentrant
+      are called by one thread at a time.
       \param msg The message to be decoded.
       \param triggeredByUser Whether decode operation was triggered by the user or not
     */
@@ -86,6 +91,12 @@ private:
     //! The list of pointers to all loaded plugins
     QList<QDltPlugin*> plugins;
 
+    //! Read-only copy of the plugin list used by decodeMsg(), replaced whenever the list changes
+    std::shared_ptr<const QList<QDltPlugin*>> pluginsSnapshot;
+
+    //! Publish the current plugin list to decodeMsg(), must be called with pluginListMutex locked
+    void updateSnapshot();
+
     //! Loads all plugins from a special directory
     QStringList loadPluginsPath(QDir &dir);
 
@@ -0,0 +1,211 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltrelayserver.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QDebug>
+#include <QHostAddress>
+#include <QMutexLocker>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "qdltrelayserver.h"
+
+namespace {
+
+// data written to a socket before waiting for bytesWritten(), the rest stays in the queue
+const qint64 SOCKET_BUFFER_SIZE = 256*1024;
+
+}
+
+QDltRelayServer::QDltRelayServer(qint64 maxQueueSize)
+    : maxQueueSize(maxQueueSize), server(nullptr), port(0), flushPending(false), dropped(0)
+{
+    moveToThread(&thread);
+}
+
+QDltRelayServer::~QDltRelayServer()
+{
+    stop();
+}
+
+bool QDltRelayServer::start(const QString &address, quint16 port)
+{
+    stop();
+    thread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(this, "listen", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, listening), Q_ARG(QString, address), Q_ARG(quint16, port));
+    if(!listening)
+        stop();
+    return listening;
+}
+
+void QDltRelayServer::stop()
+{
+    if(!thread.isRunning())
+        return;
+    // the sockets are deleted in the thread which created them
+    QMetaObject::invokeMethod(this, "close", Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+}
+
+bool QDltRelayServer::listen(const QString &address, quint16 port)
+{
+    server = new QTcpServer(this);
+    connect(server, &QTcpServer::newConnection, this, &QDltRelayServer::newConnection);
+    if(!server->listen(address.isEmpty() ? QHostAddress(QHostAddress::Any) : QHostAddress(address), port))
+    {
+        error = server->errorString();
+        qDebug() << "QDltRelayServer: cannot listen on port" << port << error;
+        delete server;
+        server = nullptr;
+        return false;
+    }
+    this->port = server->serverPort();
+    return true;
+}
+
+void QDltRelayServer::close()
+{
+    while(!clients.isEmpty())
+        removeClient(clients.last());
+    delete server;
+    server = nullptr;
+    port = 0;
+}
+
+void QDltRelayServer::newConnection()
+{
+    while(QTcpSocket *socket = server->nextPendingConnection())
+    {
+        Client *client = new Client;
+        client->socket = socket;
+
+        // the relay does not forward requests to the ECU
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() { socket->readAll(); });
+        connect(socket, &QTcpSocket::bytesWritten, this, [this, client]() { writeClient(client); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, client]() { removeClient(client); });
+
+        int count;
+        {
+            QMutexLocker locker(&mutex);
+            clients.append(client);
+            count = clients.size();
+        }
+        emit clientsChanged(count);
+    }
+}
+
+void QDltRelayServer::removeClient(Client *client)
+{
+    int count;
+    {
+        QMutexLocker locker(&mutex);
+        if(!clients.removeOne(client))
+            return;
+        count = clients.size();
+    }
+    client->socket->disconnect(this);
+    client->socket->abort();
+    client->socket->deleteLater();
+    delete client;
+    emit clientsChanged(count);
+}
+
+void QDltRelayServer::publish(const QVector<QDltLiveMessage> &messages)
+{
+    if(messages.isEmpty())
+        return;
+
+    QMutexLocker locker(&mutex);
+    if(clients.isEmpty())
+        return;
+
+    // the data is shared by the queues of all clients
+    for(Client *client : std::as_const(clients))
+    {
+        for(const QDltLiveMessage &message : messages)
+        {
+            client->queue.enqueue(message.data);
+            client->queued += message.data.size();
+        }
+        while(client->queued > maxQueueSize)
+        {
+            client->queued -= client->queue.dequeue().size();
+            dropped++;
+        }
+    }
+
+    if(!flushPending)
+    {
+        flushPending = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+void QDltRelayServer::flush()
+{
+    {
+        QMutexLocker locker(&mutex);
+        flushPending = false;
+    }
+    const QVector<Client*> current = clients;
+    for(Client *client : current)
+    {
+        // a client may be removed by the write of another client
+        if(clients.contains(client))
+            writeClient(client);
+    }
+}
+
+void QDltRelayServer::writeClient(Client *client)
+{
+    const qint64 size = SOCKET_BUFFER_SIZE - client->socket->bytesToWrite();
+    if(size <= 0)
+        return;
+
+    // the messages are written at once to keep the number of system calls low
+    QByteArray data;
+    {
+        QMutexLocker locker(&mutex);
+        while(!client->queue.isEmpty() && data.size() < size)
+        {
+            const QByteArray message = client->queue.dequeue();
+            client->queued -= message.size();
+            data.append(message);
+        }
+    }
+    if(!data.isEmpty())
+        client->socket->write(data);
+}
+
+int QDltRelayServer::getClientCount() const
+{
+    QMutexLocker locker(&mutex);
+    return clients.size();
+}
+
+quint64 QDltRelayServer::takeDropped()
+{
+    QMutexLocker locker(&mutex);
+    const quint64 result = dropped;
+    dropped = 0;
+    return result;
+}
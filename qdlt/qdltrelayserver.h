@@ -0,0 +1,128 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltrelayserver.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_RELAY_SERVER_H
+#define QDLT_RELAY_SERVER_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include "export_rules.h"
+#include "qdltlivesink.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+//! Publish the received live messages to local TCP clients.
+/*!
+  The server accepts connections like a dlt-daemon, each client receives the DLT
+  messages without storage header, so the viewer or any other DLT client can connect
+  to it instead of connecting to the ECU. Requests sent by the clients are discarded,
+  only the viewer controls the ECU.
+
+  publish() can be called from any thread and only appends the messages to a queue
+  of each client. The sockets are written by the thread of the server. When a queue
+  exceeds the maximum size, its oldest messages are dropped, so slow clients never
+  block the receiving of the messages.
+*/
+class QDLT_EXPORT QDltRelayServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! The constructor.
+    /*!
+      \param maxQueueSize Maximum number of bytes queued for one client.
+    */
+    explicit QDltRelayServer(qint64 maxQueueSize = 8*1024*1024);
+
+    //! The destructor, stops the server.
+    ~QDltRelayServer();
+
+    //! Start the thread and listen for clients.
+    /*!
+      \param address Local address to listen on, empty for any address.
+      \param port The TCP port, 0 to choose a free port.
+      \return false if the port cannot be opened, see errorString().
+    */
+    bool start(const QString &address, quint16 port);
+
+    //! Disconnect all clients and stop the thread.
+    void stop();
+
+    //! Check if the server is listening.
+    bool isRunning() const { return thread.isRunning(); }
+
+    //! Get the port the server listens on.
+    quint16 serverPort() const { return port; }
+
+    //! Get the description of the last error.
+    QString errorString() const { return error; }
+
+    //! Queue messages for all connected clients.
+    void publish(const QVector<QDltLiveMessage> &messages);
+
+    //! Get the number of connected clients.
+    int getClientCount() const;
+
+    //! Get the number of messages dropped for slow clients since the last call.
+    quint64 takeDropped();
+
+signals:
+    //! A client connected or disconnected.
+    void clientsChanged(int count);
+
+private slots:
+    bool listen(const QString &address, quint16 port);
+    void close();
+    void newConnection();
+    void flush();
+
+private:
+    Q_DISABLE_COPY(QDltRelayServer)
+
+    struct Client
+    {
+        QTcpSocket *socket = nullptr;
+        QQueue<QByteArray> queue;   // protected by mutex
+        qint64 queued = 0;
+    };
+
+    void writeClient(Client *client);
+    void removeClient(Client *client);
+
+    qint64 maxQueueSize;
+    QThread thread;
+    QTcpServer *server;
+    quint16 port;
+    QString error;
+
+    // modified only by the thread of the server, read by publish()
+    QVector<Client*> clients;
+    mutable QMutex mutex;
+    bool flushPending;
+    quint64 dropped;
+};
+
+#endif // QDLT_RELAY_SERVER_H
@@ -163,7 +163,13 @@ void QDltSettingsManager::writeSettings()
     settings->setValue("RefreshRate",RefreshRate);
     settings->setValue("StartUpMinimized",StartupMinimized);
     settings->setValue("ThemeSettings", static_cast<int>(themeSelectionSettings));
-    settings->setValue("msgCacheSize",msgCacheSize);
+    settings->setValue("msgCacheSizeMB",msgCacheSizeMB);
+    settings->setValue("relayServer",relayServer);
+    settings->setValue("relayPort",relayPort);
+    settings->setValue("overload/policy",overloadPolicy);
+    settings->setValue("overload/highWatermarkMB",overloadHighWatermarkMB);
+    settings->setValue("overload/logLevel",overloadLogLevel);
+    settings->setValue("overload/sampleRate",overloadSampleRate);
 
     /* Temporary directory */
     settings->setValue("tempdir/tempUseSystem", tempUseSystem);
@@ -437,7 +443,28 @@ void QDltSettingsManager::readSettings()
     RefreshRate = settings->value("RefreshRate",DEFAULT_REFRESH_RATE).toInt();
     StartupMinimized = settings->value("StartupMinimized",0).toInt();
     themeSelectionSettings = static_cast<UI_Colour>(settings->value("ThemeSettings", 0).toInt());
-    msgCacheSize = settings->value("msgCacheSize",1000).toInt();
+    if(!settings->contains("msgCacheSizeMB") && settings->contains("msgCacheSize"))
+    {
+        /* msgCacheSize was the number of cached messages, about 1 KB each when decoded.
+           The old default of 1000 messages is replaced by the new default. */
+        const qint64 msgCacheSize = settings->value("msgCacheSize").toLongLong();
+        if(msgCacheSize == 1000)
+            msgCacheSizeMB = 256;
+        else if(msgCacheSize <= 0)
+            msgCacheSizeMB = 0;
+        else
+            msgCacheSizeMB = qMax<qint64>(1, (msgCacheSize + 1023) / 1024);
+    }
+    else
+    {
+        msgCacheSizeMB = settings->value("msgCacheSizeMB",256).toInt();
+    }
+    relayServer = settings->value("relayServer",0).toInt();
+    relayPort = settings->value("relayPort",3491).toInt();
+    overloadPolicy = settings->value("overload/policy",0).toInt();
+    overloadHighWatermarkMB = settings->value("overload/highWatermarkMB",256).toInt();
+    overloadLogLevel = settings->value("overload/logLevel",3).toInt();
+    overloadSampleRate = settings->value("overload/sampleRate",10).toInt();
 
     /* startup */
     defaultProjectFile = settings->value("startup/defaultProjectFile",0).toInt();
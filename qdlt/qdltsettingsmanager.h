@@ -86,7 +86,13 @@ public:
     int StartupMinimized; // local settings
     UI_Colour themeSelectionSettings; // local settings
     UI_Colour uiColour; // local settings
-    quint64 msgCacheSize; // local settings
+    quint64 msgCacheSizeMB; // local settings
+    int relayServer; // local setting
+    int relayPort; // local setting
+    int overloadPolicy; // local setting
+    int overloadHighWatermarkMB; // local setting
+    int overloadLogLevel; // local setting
+    int overloadSampleRate; // local setting
 
     int markercolorRed,markercolorGreen,markercolorBlue; // local and project setting
     int autoConnect; // project and local setting
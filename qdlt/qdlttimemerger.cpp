@@ -0,0 +1,286 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdlttimemerger.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QAtomicInt>
+#include <QThread>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "qdlttimemerger.h"
+
+namespace {
+
+/* digits of the radix sort */
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+/* smaller parts are not worth starting a thread */
+const int RADIX_MIN_ENTRIES_PER_THREAD = 64 * 1024;
+
+inline bool lessThan(const QDltTimeIndexEntry &entry1, const QDltTimeIndexEntry &entry2)
+{
+    if(entry1.time != entry2.time)
+        return entry1.time < entry2.time;
+    return entry1.index < entry2.index;
+}
+
+/* call function(worker) for each worker, in separate threads if there is more than one worker */
+void runParallel(int workers, const std::function<void(int)> &function)
+{
+    if(workers <= 1)
+    {
+        function(0);
+        return;
+    }
+
+    QVector<QThread*> threads;
+    for(int worker=0;worker<workers;worker++)
+    {
+        threads.append(QThread::create(function,worker));
+        threads.last()->start();
+    }
+    for(QThread *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+}
+
+}
+
+QDltTimeMerger::QDltTimeMerger(int threads)
+    : threads(threads > 0 ? threads : qMax(1, QThread::idealThreadCount()))
+{
+
+}
+
+void QDltTimeMerger::addInput(QVector<QDltTimeIndexEntry> entries)
+{
+    inputs.append(std::move(entries));
+}
+
+void QDltTimeMerger::clear()
+{
+    inputs.clear();
+}
+
+void QDltTimeMerger::sortRuns(QVector<QDltTimeIndexEntry> &entries)
+{
+    const int count = entries.size();
+    if(count < 2)
+        return;
+
+    /* count the entries older than the newest entry in front of them */
+    int outliers = 0;
+    int newest = 0;
+    for(int num=1;num<count;num++)
+    {
+        if(lessThan(entries[num],entries[newest]))
+            outliers++;
+        else
+            newest = num;
+    }
+    if(outliers == 0)
+        return; // already sorted
+    if(outliers > count / 8)
+    {
+        radixSort(entries,1);
+        return;
+    }
+
+    /* almost sorted input: the outliers are moved to the end,
+       only these are sorted and then merged with the ascending part */
+    QVector<QDltTimeIndexEntry> moved;
+    moved.reserve(outliers);
+    int ascending = 1;
+    for(int num=1;num<count;num++)
+    {
+        if(lessThan(entries[num],entries[ascending-1]))
+            moved.append(entries[num]);
+        else
+            entries[ascending++] = entries[num];
+    }
+    std::copy(moved.constBegin(),moved.constEnd(),entries.begin()+ascending);
+    std::sort(entries.begin()+ascending,entries.end(),lessThan);
+    std::inplace_merge(entries.begin(),entries.begin()+ascending,entries.end(),lessThan);
+}
+
+void QDltTimeMerger::radixSort(QVector<QDltTimeIndexEntry> &entries, int threads)
+{
+    const int count = entries.size();
+    if(count < 2)
+        return;
+
+    if(threads <= 0)
+        threads = QThread::idealThreadCount();
+    const int workers = qBound(1, threads, count / RADIX_MIN_ENTRIES_PER_THREAD);
+    const int chunk = (count + workers - 1) / workers;
+
+    /* the sign bit of the key is flipped, so negative times are sorted in front of positive times */
+    auto key = [](const QDltTimeIndexEntry &entry) { return quint64(entry.time) ^ (quint64(1) << 63); };
+
+    /* digits which are the same in all keys are skipped, e.g. the upper bytes of the time */
+    QVector<quint64> setBits(workers,0);
+    QVector<quint64> clearedBits(workers,0);
+    const QDltTimeIndexEntry *data = entries.constData();
+    runParallel(workers,[&](int worker) {
+        quint64 set = 0;
+        quint64 cleared = 0;
+        for(int num=worker*chunk;num<qMin(count,(worker+1)*chunk);num++)
+        {
+            set |= key(data[num]);
+            cleared |= ~key(data[num]);
+        }
+        setBits[worker] = set;
+        clearedBits[worker] = cleared;
+    });
+    quint64 set = 0;
+    quint64 cleared = 0;
+    for(int worker=0;worker<workers;worker++)
+    {
+        set |= setBits[worker];
+        cleared |= clearedBits[worker];
+    }
+    const quint64 varying = set & cleared;
+
+    /* stable LSD radix sort, each thread counts and moves the entries of its part */
+    QVector<QDltTimeIndexEntry> buffer(count);
+    QDltTimeIndexEntry *source = entries.data();
+    QDltTimeIndexEntry *destination = buffer.data();
+    QVector<int> offsets(workers * RADIX_BUCKETS);
+    for(int shift=0;shift<64;shift+=RADIX_BITS)
+    {
+        if(((varying >> shift) & (RADIX_BUCKETS - 1)) == 0)
+            continue;
+
+        offsets.fill(0);
+        runParallel(workers,[&](int worker) {
+            int *histogram = offsets.data() + worker * RADIX_BUCKETS;
+            for(int num=worker*chunk;num<qMin(count,(worker+1)*chunk);num++)
+                histogram[(key(source[num]) >> shift) & (RADIX_BUCKETS - 1)]++;
+        });
+
+        /* the parts of all threads for one digit follow each other in the order of the threads */
+        int offset = 0;
+        for(int digit=0;digit<RADIX_BUCKETS;digit++)
+        {
+            for(int worker=0;worker<workers;worker++)
+            {
+                const int size = offsets[worker * RADIX_BUCKETS + digit];
+                offsets[worker * RADIX_BUCKETS + digit] = offset;
+                offset += size;
+            }
+        }
+
+        runParallel(workers,[&](int worker) {
+            int *position = offsets.data() + worker * RADIX_BUCKETS;
+            for(int num=worker*chunk;num<qMin(count,(worker+1)*chunk);num++)
+                destination[position[(key(source[num]) >> shift) & (RADIX_BUCKETS - 1)]++] = source[num];
+        });
+        std::swap(source,destination);
+    }
+
+    if(source != entries.data())
+        std::copy(source,source+count,entries.data());
+}
+
+QVector<qint64> QDltTimeMerger::getIndexes(const QVector<QDltTimeIndexEntry> &entries)
+{
+    QVector<qint64> indexes;
+    indexes.reserve(entries.size());
+    for(const auto &entry : entries)
+        indexes.append(entry.index);
+    return indexes;
+}
+
+void QDltTimeMerger::sortInputs()
+{
+    /* each thread takes the next unsorted input */
+    for(auto &input : inputs)
+        input.detach();
+    QAtomicInt next(0);
+    runParallel(qMin(threads,inputs.size()),[this,&next](int) {
+        int input;
+        while((input = next.fetchAndAddRelaxed(1)) < inputs.size())
+            sortRuns(inputs[input]);
+    });
+}
+
+QVector<qint64> QDltTimeMerger::merge()
+{
+    sortInputs();
+
+    QVector<qint64> result;
+    qint64 total = 0;
+    for(const auto &input : std::as_const(inputs))
+        total += input.size();
+    result.reserve(total);
+
+    const int count = inputs.size();
+    if(count == 1)
+    {
+        result = getIndexes(inputs[0]);
+    }
+    else if(count > 1)
+    {
+        /* current entry of each input, finished inputs get an entry behind all messages */
+        const QDltTimeIndexEntry finished = { std::numeric_limits<qint64>::max(), std::numeric_limits<qint64>::max() };
+        QVector<int> position(count,0);
+        QVector<QDltTimeIndexEntry> head(count);
+        for(int num=0;num<count;num++)
+            head[num] = inputs[num].isEmpty() ? finished : inputs[num].first();
+
+        /* tournament tree: the inputs are the leaves count..2*count-1, each inner node
+           keeps the loser of its match, node 0 keeps the overall winner */
+        QVector<int> winner(2*count);
+        QVector<int> loser(count);
+        for(int num=0;num<count;num++)
+            winner[count+num] = num;
+        for(int node=count-1;node>0;node--)
+        {
+            const int input1 = winner[2*node];
+            const int input2 = winner[2*node+1];
+            winner[node] = lessThan(head[input2],head[input1]) ? input2 : input1;
+            loser[node] = winner[node] == input1 ? input2 : input1;
+        }
+        loser[0] = winner[1];
+
+        for(qint64 num=0;num<total;num++)
+        {
+            int input = loser[0];
+            result.append(head[input].index);
+            const int next = ++position[input];
+            head[input] = next < inputs[input].size() ? inputs[input].at(next) : finished;
+
+            /* replay the matches on the path from the leaf of the input to the root */
+            for(int node=(count+input)/2;node>0;node/=2)
+            {
+                if(lessThan(head[loser[node]],head[input]))
+                    std::swap(loser[node],input);
+            }
+            loser[0] = input;
+        }
+    }
+
+    inputs.clear();
+
+    return result;
+}
@@ -0,0 +1,103 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdlttimemerger.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_TIME_MERGER_H
+#define QDLT_TIME_MERGER_H
+
+#include <QVector>
+
+#include "export_rules.h"
+
+//! Entry of a message index sorted by time.
+struct QDltTimeIndexEntry
+{
+    qint64 time;  //!< Sort key, the storage header time in microseconds.
+    qint64 index; //!< Position of the message in the log file.
+};
+
+//! Merge the message indexes of several DLT files by time.
+/*!
+  Each input contains the messages of one file in file order. First the inputs are
+  sorted in parallel. Files written by one logger are almost sorted, only the few messages
+  arriving late are sorted and merged back, other inputs are sorted with a radix sort.
+  Then the sorted inputs are merged with a tournament tree of losers, which needs
+  about log2(k) comparisons per message for k inputs.
+
+  Messages with the same time are ordered by their index, so the result does not
+  depend on the number of threads.
+*/
+class QDLT_EXPORT QDltTimeMerger
+{
+public:
+    //! The constructor.
+    /*!
+      \param threads Maximum number of threads sorting the inputs, 0 for the number of CPU cores.
+    */
+    explicit QDltTimeMerger(int threads = 0);
+
+    //! Add the index of the next input.
+    /*!
+      \param entries The messages of one file in file order.
+    */
+    void addInput(QVector<QDltTimeIndexEntry> entries);
+
+    //! Get the number of inputs.
+    int size() const { return inputs.size(); }
+
+    //! Remove all inputs.
+    void clear();
+
+    //! Sort all inputs and merge them.
+    /*!
+      The inputs are cleared.
+      \return The positions of all messages ordered by time.
+    */
+    QVector<qint64> merge();
+
+    //! Sort the entries by time and index, fast for almost sorted entries.
+    /*!
+      \param entries The entries to be sorted, in ascending order of the index.
+    */
+    static void sortRuns(QVector<QDltTimeIndexEntry> &entries);
+
+    //! Sort the entries by time with a parallel LSD radix sort.
+    /*!
+      The sort is stable, entries with the same time keep their order.
+      Only the bytes of the time which differ between the entries are sorted,
+      needs a buffer of the size of the entries.
+      \param entries The entries to be sorted, in ascending order of the index.
+      \param threads Maximum number of threads, 0 for the number of CPU cores.
+    */
+    static void radixSort(QVector<QDltTimeIndexEntry> &entries, int threads = 0);
+
+    //! Get the positions of the messages of the entries.
+    /*!
+      \param entries The sorted entries.
+      \return The index of each entry.
+    */
+    static QVector<qint64> getIndexes(const QVector<QDltTimeIndexEntry> &entries);
+
+private:
+    void sortInputs();
+
+    int threads;
+    QVector<QVector<QDltTimeIndexEntry>> inputs;
+};
+
+#endif // QDLT_TIME_MERGER_H
@@ -0,0 +1,315 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltudpreceiver.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+#endif
+
+#include "qdltudpreceiver.h"
+
+#ifdef Q_OS_LINUX
+
+namespace {
+
+// larger than the maximum UDP payload, so datagrams are never truncated
+const int DATAGRAM_SIZE = 65536;
+const size_t CONTROL_SIZE = CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(quint32));
+
+}
+
+struct QDltUdpReceiver::Batch
+{
+    std::vector<char> data;
+    std::vector<char> control;
+    std::vector<struct iovec> iov;
+    std::vector<struct mmsghdr> headers;
+};
+
+bool QDltUdpReceiver::isSupported()
+{
+    return true;
+}
+
+QDltUdpReceiver::QDltUdpReceiver(int batchSize)
+    : fd(-1), batchSize(qMax(1, batchSize)), batch(new Batch), datagrams(this->batchSize),
+      kernelDropped(0), dropped(0)
+{
+    batch->data.resize(size_t(this->batchSize) * DATAGRAM_SIZE);
+    batch->control.resize(size_t(this->batchSize) * CONTROL_SIZE);
+    batch->iov.resize(this->batchSize);
+    batch->headers.resize(this->batchSize);
+    for(int i = 0; i < this->batchSize; i++)
+    {
+        batch->iov[i].iov_base = batch->data.data() + size_t(i) * DATAGRAM_SIZE;
+        batch->iov[i].iov_len = DATAGRAM_SIZE;
+        memset(&batch->headers[i], 0, sizeof(struct mmsghdr));
+        batch->headers[i].msg_hdr.msg_iov = &batch->iov[i];
+        batch->headers[i].msg_hdr.msg_iovlen = 1;
+        batch->headers[i].msg_hdr.msg_control = batch->control.data() + size_t(i) * CONTROL_SIZE;
+    }
+}
+
+QDltUdpReceiver::~QDltUdpReceiver()
+{
+    close();
+    delete batch;
+}
+
+void QDltUdpReceiver::setError(const char *function)
+{
+    error = QString("%1: %2").arg(function, strerror(errno));
+}
+
+bool QDltUdpReceiver::open(const QString &bindAddress, quint16 port, int receiveBufferSize)
+{
+    close();
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if(bindAddress.isEmpty())
+    {
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+    else if(inet_pton(AF_INET, bindAddress.toLatin1().constData(), &address.sin_addr) != 1)
+    {
+        error = QString("No IPv4 address: %1").arg(bindAddress);
+        return false;
+    }
+
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+    {
+        setError("socket");
+        return false;
+    }
+
+    const int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+
+    // SO_RCVBUFFORCE exceeds net.core.rmem_max, but needs CAP_NET_ADMIN
+    if(setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &receiveBufferSize, sizeof(receiveBufferSize)) != 0)
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+
+    if(bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        setError("bind");
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    kernelDropped = 0;
+    dropped = 0;
+    return true;
+}
+
+bool QDltUdpReceiver::joinMulticastGroup(const QString &group, int interfaceIndex)
+{
+    struct ip_mreqn request;
+    memset(&request, 0, sizeof(request));
+    if(inet_pton(AF_INET, group.toLatin1().constData(), &request.imr_multiaddr) != 1)
+    {
+        error = QString("No IPv4 address: %1").arg(group);
+        return false;
+    }
+    request.imr_address.s_addr = htonl(INADDR_ANY);
+    request.imr_ifindex = interfaceIndex;
+    if(setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof(request)) != 0)
+    {
+        setError("IP_ADD_MEMBERSHIP");
+        return false;
+    }
+    return true;
+}
+
+void QDltUdpReceiver::close()
+{
+    if(fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+quint16 QDltUdpReceiver::localPort() const
+{
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+    if(fd < 0 || getsockname(fd, reinterpret_cast<struct sockaddr*>(&address), &length) != 0)
+        return 0;
+    return ntohs(address.sin_port);
+}
+
+int QDltUdpReceiver::getReceiveBufferSize() const
+{
+    int size = 0;
+    socklen_t length = sizeof(size);
+    if(fd < 0 || getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, &length) != 0)
+        return 0;
+    return size;
+}
+
+int QDltUdpReceiver::receive()
+{
+    if(fd < 0)
+        return -1;
+
+    // the kernel overwrites the lengths of the control buffers
+    for(struct mmsghdr &header : batch->headers)
+        header.msg_hdr.msg_controllen = CONTROL_SIZE;
+
+    int count;
+    do
+    {
+        count = recvmmsg(fd, batch->headers.data(), batchSize, MSG_DONTWAIT, nullptr);
+    }
+    while(count < 0 && errno == EINTR);
+    if(count < 0)
+    {
+        if(errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+        setError("recvmmsg");
+        return -1;
+    }
+
+    bool now = false;
+    struct timespec current;
+    for(int i = 0; i < count; i++)
+    {
+        struct msghdr &header = batch->headers[i].msg_hdr;
+        QDltUdpDatagram &datagram = datagrams[i];
+        datagram.data = static_cast<const char*>(header.msg_iov->iov_base);
+        datagram.size = int(batch->headers[i].msg_len);
+
+        bool timestamp = false;
+        for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+        {
+            if(cmsg->cmsg_level != SOL_SOCKET)
+                continue;
+            if(cmsg->cmsg_type == SCM_TIMESTAMPNS)
+            {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                datagram.sec = quint32(ts.tv_sec);
+                datagram.usec = quint32(ts.tv_nsec / 1000);
+                timestamp = true;
+            }
+            else if(cmsg->cmsg_type == SO_RXQ_OVFL)
+            {
+                // counter of the socket, wraps around
+                quint32 counter;
+                memcpy(&counter, CMSG_DATA(cmsg), sizeof(counter));
+                dropped += quint32(counter - kernelDropped);
+                kernelDropped = counter;
+            }
+        }
+        if(!timestamp)
+        {
+            if(!now)
+                now = timespec_get(&current, TIME_UTC) != 0;
+            datagram.sec = now ? quint32(current.tv_sec) : 0;
+            datagram.usec = now ? quint32(current.tv_nsec / 1000) : 0;
+        }
+    }
+    return count;
+}
+
+quint64 QDltUdpReceiver::takeDropped()
+{
+    const quint64 result = dropped;
+    dropped = 0;
+    return result;
+}
+
+#else
+
+struct QDltUdpReceiver::Batch
+{
+};
+
+bool QDltUdpReceiver::isSupported()
+{
+    return false;
+}
+
+QDltUdpReceiver::QDltUdpReceiver(int batchSize)
+    : fd(-1), batchSize(batchSize), batch(nullptr), kernelDropped(0), dropped(0)
+{
+}
+
+QDltUdpReceiver::~QDltUdpReceiver()
+{
+}
+
+void QDltUdpReceiver::setError(const char *function)
+{
+    error = QString("%1: not supported").arg(function);
+}
+
+bool QDltUdpReceiver::open(const QString &, quint16, int)
+{
+    setError("open");
+    return false;
+}
+
+bool QDltUdpReceiver::joinMulticastGroup(const QString &, int)
+{
+    setError("joinMulticastGroup");
+    return false;
+}
+
+void QDltUdpReceiver::close()
+{
+}
+
+quint16 QDltUdpReceiver::localPort() const
+{
+    return 0;
+}
+
+int QDltUdpReceiver::getReceiveBufferSize() const
+{
+    return 0;
+}
+
+int QDltUdpReceiver::receive()
+{
+    return -1;
+}
+
+quint64 QDltUdpReceiver::takeDropped()
+{
+    return 0;
+}
+
+#endif
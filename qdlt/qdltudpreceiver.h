@@ -0,0 +1,129 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltudpreceiver.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_UDP_RECEIVER_H
+#define QDLT_UDP_RECEIVER_H
+
+#include <QString>
+#include <QVector>
+
+#include "export_rules.h"
+
+//! One datagram received by QDltUdpReceiver.
+/*!
+  The data points into the buffers of the receiver and is valid until the next receive().
+*/
+struct QDltUdpDatagram
+{
+    const char *data = nullptr; //!< Payload of the datagram.
+    int size = 0;               //!< Size of the payload.
+    quint32 sec = 0;            //!< Kernel receive time, seconds since 1970-01-01 UTC.
+    quint32 usec = 0;           //!< Kernel receive time, microseconds.
+};
+
+//! Receive UDP datagrams in batches with one system call.
+/*!
+  The receiver uses its own IPv4 socket and reads up to batchSize datagrams with
+  one recvmmsg() call into buffers allocated once when the receiver is created.
+  Each datagram gets the receive time of the kernel, the number of datagrams
+  dropped by the kernel because the receive buffer was full is counted.
+
+  Only supported on Linux, see isSupported(). Otherwise open() fails and the
+  caller reads with QUdpSocket.
+*/
+class QDLT_EXPORT QDltUdpReceiver
+{
+public:
+    //! Check if the receiver is supported on this platform.
+    static bool isSupported();
+
+    //! The constructor.
+    /*!
+      \param batchSize Maximum number of datagrams read at once.
+    */
+    explicit QDltUdpReceiver(int batchSize = 64);
+
+    //! The destructor, closes the socket.
+    ~QDltUdpReceiver();
+
+    //! Open the socket and bind it, other sockets may bind to the same port.
+    /*!
+      \param bindAddress IPv4 address to bind to, empty for any address.
+      \param port The UDP port.
+      \param receiveBufferSize Requested size of the kernel receive buffer.
+      \return false if the socket cannot be opened or bound, see errorString().
+    */
+    bool open(const QString &bindAddress, quint16 port, int receiveBufferSize);
+
+    //! Join an IPv4 multicast group.
+    /*!
+      \param group Address of the group.
+      \param interfaceIndex Index of the interface, see QNetworkInterface::index().
+      \return false if the group cannot be joined, see errorString().
+    */
+    bool joinMulticastGroup(const QString &group, int interfaceIndex);
+
+    //! Close the socket.
+    void close();
+
+    //! Get the socket, -1 if not open.
+    int socketDescriptor() const { return fd; }
+
+    //! Get the bound port, useful if the socket was bound to port 0.
+    quint16 localPort() const;
+
+    //! Get the size of the kernel receive buffer as reported by the kernel.
+    int getReceiveBufferSize() const;
+
+    //! Read the pending datagrams without blocking.
+    /*!
+      \return number of datagrams read, at most batchSize, 0 if none is pending, -1 on error.
+    */
+    int receive();
+
+    //! Get a datagram of the last receive().
+    const QDltUdpDatagram &datagram(int n) const { return datagrams[n]; }
+
+    //! Get the number of datagrams dropped by the kernel since the last call.
+    /*!
+      The kernel reports the drops with the next datagram received after them.
+    */
+    quint64 takeDropped();
+
+    //! Get the description of the last error.
+    QString errorString() const { return error; }
+
+private:
+    Q_DISABLE_COPY(QDltUdpReceiver)
+
+    void setError(const char *function);
+
+    // buffers and message headers of the system call, allocated once
+    struct Batch;
+
+    int fd;
+    int batchSize;
+    Batch *batch;
+    QVector<QDltUdpDatagram> datagrams;
+    quint32 kernelDropped;
+    quint64 dropped;
+    QString error;
+};
+
+#endif // QDLT_UDP_RECEIVER_H
@@ -0,0 +1,100 @@
+// Microbenchmark of QDltLruCache against the former std::list based implementation.
+// Access pattern mimics TableModel::data(): every row of a page is looked up once per column and role
+// while the page scrolls forward.
+
+#include <qdltlrucache.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+template<typename Key, typename Value>
+class ListLruCache {
+    struct CacheEntry {
+        Key key;
+        Value value;
+    };
+    using CacheListIterator = typename std::list<CacheEntry>::iterator;
+
+public:
+    ListLruCache(size_t capacity) : m_capacity(capacity) {}
+
+    void put(const Key& key, const Value& value) {
+        auto it = m_keyIteratorsMap.find(key);
+        m_cacheItems.push_front(CacheEntry{key, value});
+        if (it != m_keyIteratorsMap.end()) {
+            m_cacheItems.erase(it->second);
+            m_keyIteratorsMap.erase(it);
+        }
+        m_keyIteratorsMap[key] = m_cacheItems.begin();
+
+        if (m_keyIteratorsMap.size() > m_capacity) {
+            auto last = std::prev(m_cacheItems.end());
+            m_keyIteratorsMap.erase(last->key);
+            m_cacheItems.pop_back();
+        }
+    }
+
+    const Value& get(const Key& key) {
+        auto it = m_keyIteratorsMap.find(key);
+        m_cacheItems.splice(m_cacheItems.begin(), m_cacheItems, it->second);
+        return it->second->value;
+    }
+
+    bool exists(const Key& key) const {
+        return m_keyIteratorsMap.find(key) != m_keyIteratorsMap.end();
+    }
+
+private:
+    std::list<CacheEntry> m_cacheItems;
+    std::unordered_map<Key, CacheListIterator> m_keyIteratorsMap;
+    const size_t m_capacity;
+};
+
+const int rows = 2000000;
+const int pageSize = 50;
+const int lookupsPerRow = 3 * 15; // roles * columns
+
+template<typename Lookup>
+double run(const char* name, Lookup lookup)
+{
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int first = 0; first < rows; first += pageSize / 2) {
+        for (int row = first; row < first + pageSize; ++row) {
+            for (int n = 0; n < lookupsPerRow; ++n) {
+                checksum += lookup(row).size();
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-24s %8.3f s (checksum %zu)\n", name, seconds, checksum);
+    return seconds;
+}
+
+}
+
+int main()
+{
+    const std::string payload(64, 'x');
+
+    ListLruCache<int, std::string> listCache(256);
+    double listTime = run("std::list LRU", [&](int row) -> const std::string& {
+        if (!listCache.exists(row)) {
+            listCache.put(row, payload);
+        }
+        return listCache.get(row);
+    });
+
+    QDltLruCache<int, std::string> flatCache(256);
+    double flatTime = run("flat LRU getOrCompute", [&](int row) -> const std::string& {
+        return flatCache.getOrCompute(row, [&]() { return payload; });
+    });
+
+    std::printf("speedup %.2fx\n", listTime / flatTime);
+    return 0;
+}
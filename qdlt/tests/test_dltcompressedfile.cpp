@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <qdltcompressedfile.h>
+#include <qdltcompressedwriter.h>
+#include <qdltfile.h>
+
+#include "testmessages.h"
+
+namespace {
+
+void appendUInt32(QByteArray &data, quint32 value)
+{
+    for (int i = 0; i < 4; i++)
+        data.append(char((value >> (8 * i)) & 0xff));
+}
+
+quint32 crc32(const QByteArray &data)
+{
+    quint32 crc = 0xffffffff;
+    for (char c : data) {
+        crc ^= quint8(c);
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+// gzip member with uncompressed deflate blocks
+QByteArray gzipMember(const QByteArray &data)
+{
+    QByteArray result("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    for (int pos = 0; pos < data.size() || pos == 0; pos += 65535) {
+        quint16 length = qMin(65535, int(data.size() - pos));
+        result.append(char(pos + length >= data.size() ? 1 : 0));
+        result.append(char(length & 0xff));
+        result.append(char(length >> 8));
+        result.append(char(~length & 0xff));
+        result.append(char((~length >> 8) & 0xff));
+        result.append(data.mid(pos, length));
+    }
+    appendUInt32(result, crc32(data));
+    appendUInt32(result, data.size());
+    return result;
+}
+
+// zstd frame with raw blocks and the content size in the header
+QByteArray zstdFrame(const QByteArray &data)
+{
+    QByteArray result;
+    appendUInt32(result, 0xFD2FB528);
+    result.append(char(0xa0)); // single segment, 4 bytes content size
+    appendUInt32(result, data.size());
+    for (int pos = 0; pos < data.size(); pos += 128 * 1024) {
+        int length = qMin(128 * 1024, int(data.size() - pos));
+        quint32 header = (length << 3) | (pos + length >= data.size() ? 1 : 0);
+        result.append(char(header & 0xff));
+        result.append(char((header >> 8) & 0xff));
+        result.append(char((header >> 16) & 0xff));
+        result.append(data.mid(pos, length));
+    }
+    return result;
+}
+
+bool writeFile(const QString &filename, const QByteArray &data)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(data) == data.size();
+}
+
+void expectSameMessages(const QString &filename, const QByteArray &input, int count)
+{
+    QDltFile file;
+    ASSERT_TRUE(file.open(filename));
+    ASSERT_TRUE(file.createIndex());
+    ASSERT_EQ(file.size(), count);
+    EXPECT_EQ(file.fileSize(), input.size());
+
+    for (int i = 0; i < count; i++)
+        EXPECT_EQ(file.getMsg(i), createStoredMessage(i));
+    // random access from the end to the beginning
+    for (int i = count - 1; i >= 0; i -= 97)
+        EXPECT_EQ(file.getMsg(i), createStoredMessage(i));
+}
+
+class DltCompressedFile : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(dir.isValid());
+        for (int i = 0; i < count; i++)
+            input.append(createStoredMessage(i));
+    }
+
+    QTemporaryDir dir;
+    QByteArray input;
+    const int count = 50000;
+};
+
+}
+
+TEST_F(DltCompressedFile, uncompressed) {
+    const QString filename = dir.filePath("input.dlt");
+    ASSERT_TRUE(writeFile(filename, input));
+
+    QDltCompressedFile file;
+    file.setFileName(filename);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(file.getCompression(), QDltCompressedFile::CompressionNone);
+    EXPECT_EQ(file.readAll(), input);
+    file.close();
+
+    expectSameMessages(filename, input, count);
+}
+
+TEST_F(DltCompressedFile, gzipMultipleMembers) {
+    if (!QDltCompressedFile::isSupported(QDltCompressedFile::CompressionGzip))
+        GTEST_SKIP() << "gzip support not built";
+
+    // members do not end at message boundaries
+    QByteArray compressed;
+    for (int pos = 0; pos < input.size(); pos += 300000)
+        compressed.append(gzipMember(input.mid(pos, 300000)));
+    const QString filename = dir.filePath("input.dlt.gz");
+    ASSERT_TRUE(writeFile(filename, compressed));
+    EXPECT_TRUE(QDltCompressedFile::isCompressedFileName(filename));
+
+    QDltCompressedFile file;
+    file.setFileName(filename);
+    file.setCacheBlocks(1);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(file.getCompression(), QDltCompressedFile::CompressionGzip);
+    EXPECT_EQ(file.size(), input.size());
+    EXPECT_EQ(file.readAll(), input);
+    ASSERT_TRUE(file.seek(input.size() - 1000));
+    EXPECT_EQ(file.read(2000), input.right(1000));
+    file.close();
+
+    expectSameMessages(filename, input, count);
+}
+
+TEST_F(DltCompressedFile, zstdFrames) {
+    if (!QDltCompressedFile::isSupported(QDltCompressedFile::CompressionZstd))
+        GTEST_SKIP() << "zstd support not built";
+
+    QByteArray compressed;
+    QByteArray seekTable;
+    int frames = 0;
+    for (int pos = 0; pos < input.size(); pos += 200000) {
+        QByteArray frame = zstdFrame(input.mid(pos, 200000));
+        compressed.append(frame);
+        appendUInt32(seekTable, frame.size());
+        appendUInt32(seekTable, input.mid(pos, 200000).size());
+        frames++;
+    }
+
+    // frames found by walking through the file
+    const QString filename = dir.filePath("input.dlt.zst");
+    ASSERT_TRUE(writeFile(filename, compressed));
+    {
+        QDltCompressedFile file;
+        file.setFileName(filename);
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        EXPECT_EQ(file.getCompression(), QDltCompressedFile::CompressionZstd);
+        EXPECT_EQ(file.getNumberOfBlocks(), frames);
+        EXPECT_EQ(file.readAll(), input);
+    }
+    expectSameMessages(filename, input, count);
+
+    // frames found in the seek table of the seekable format
+    appendUInt32(compressed, 0x184D2A5E);
+    appendUInt32(compressed, seekTable.size() + 9);
+    compressed.append(seekTable);
+    appendUInt32(compressed, frames);
+    compressed.append(char(0));
+    appendUInt32(compressed, 0x8F92EAB1);
+    const QString seekableName = dir.filePath("seekable.dlt.zst");
+    ASSERT_TRUE(writeFile(seekableName, compressed));
+    {
+        QDltCompressedFile file;
+        file.setFileName(seekableName);
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        EXPECT_EQ(file.getNumberOfBlocks(), frames);
+        EXPECT_EQ(file.readAll(), input);
+    }
+    expectSameMessages(seekableName, input, count);
+}
+
+TEST_F(DltCompressedFile, writeFrames) {
+    if (!QDltCompressedWriter::isSupported())
+        GTEST_SKIP() << "zstd support not built";
+
+    const QString filename = dir.filePath("output.dlt.zst");
+    ASSERT_TRUE(writeFile(filename, QByteArray()));
+
+    // reader follows the file while it is written
+    QDltCompressedFile file;
+    file.setFileName(filename);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(file.getCompression(), QDltCompressedFile::CompressionZstd);
+    EXPECT_EQ(file.size(), 0);
+
+    QDltCompressedWriter writer;
+    writer.setFileName(filename);
+    writer.setFrameSize(64 * 1024);
+    ASSERT_TRUE(writer.open(QIODevice::WriteOnly));
+    for (int i = 0; i < count; i++)
+        ASSERT_EQ(writer.write(createStoredMessage(i)), createStoredMessage(i).size());
+    writer.close();
+    EXPECT_EQ(writer.getUncompressedSize(), input.size());
+
+    EXPECT_TRUE(file.updateBlocks());
+    EXPECT_EQ(file.size(), input.size());
+    EXPECT_EQ(file.getNumberOfBlocks(), (input.size() + 64 * 1024 - 1) / (64 * 1024));
+    EXPECT_EQ(file.readAll(), input);
+    file.close();
+
+    // reopened with the seek table
+    expectSameMessages(filename, input, count);
+}
+
+TEST_F(DltCompressedFile, invalidData) {
+    if (!QDltCompressedFile::isSupported(QDltCompressedFile::CompressionGzip))
+        GTEST_SKIP() << "gzip support not built";
+
+    QByteArray compressed = gzipMember(input);
+    compressed[11] = char(~compressed[11]); // length of the first stored block does not match its complement
+    compressed[12] = char(~compressed[12]);
+    const QString filename = dir.filePath("invalid.dlt.gz");
+    ASSERT_TRUE(writeFile(filename, compressed));
+
+    QDltCompressedFile file;
+    file.setFileName(filename);
+    EXPECT_FALSE(file.open(QIODevice::ReadOnly));
+}
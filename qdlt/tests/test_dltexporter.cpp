@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+#include <qdltexporter.h>
+#include <qdltfile.h>
+
+#include "testmessages.h"
+
+namespace {
+
+QByteArray readAll(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+}
+
+TEST(DltExporter, parallelExportKeepsOrder) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // more messages than fit into the batches of all workers at once
+    QByteArray input;
+    for (int i = 0; i < 20000; i++)
+        input.append(createStoredMessage(i));
+    const QString inputName = dir.filePath("input.dlt");
+    QFile inputFile(inputName);
+    ASSERT_TRUE(inputFile.open(QIODevice::WriteOnly));
+    inputFile.write(input);
+    inputFile.close();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(inputName));
+    ASSERT_TRUE(file.createIndex());
+    ASSERT_EQ(file.size(), 20000);
+
+    const QString outputName = dir.filePath("output.dlt");
+    QDltExporter exporter(&file, outputName, nullptr, QDltExporter::FormatDlt, QDltExporter::SelectionAll, nullptr, 1, 0, 0);
+    exporter.setWorkerThreadCount(4);
+    exporter.exportMessages();
+    EXPECT_EQ(readAll(outputName), input);
+
+    // stream input gives the same result as the index
+    const QString streamName = dir.filePath("stream.dlt");
+    QDltFile emptyFile;
+    QDltExporter streamExporter(&emptyFile, streamName, nullptr, QDltExporter::FormatDlt, QDltExporter::SelectionAll, nullptr, 1, 0, 0);
+    streamExporter.setStreamInputFiles({inputName, inputName});
+    streamExporter.setWorkerThreadCount(3);
+    streamExporter.exportMessages();
+    EXPECT_EQ(readAll(streamName), input + input);
+}
+
+TEST(DltExporter, parallelCsvExportKeepsOrder) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const QString inputName = dir.filePath("input.dlt");
+    QFile inputFile(inputName);
+    ASSERT_TRUE(inputFile.open(QIODevice::WriteOnly));
+    for (int i = 0; i < 5000; i++)
+        inputFile.write(createStoredMessage(i));
+    inputFile.close();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(inputName));
+    ASSERT_TRUE(file.createIndex());
+
+    const QString outputName = dir.filePath("output.csv");
+    QDltExporter exporter(&file, outputName, nullptr, QDltExporter::FormatCsv, QDltExporter::SelectionAll, nullptr, 1, 0, 0, ',', "IO");
+    exporter.setWorkerThreadCount(4);
+    exporter.exportMessages();
+
+    QList<QByteArray> lines = readAll(outputName).split('\n');
+    ASSERT_EQ(lines.size(), 5000 + 2); // header and empty string behind last newline
+    for (int i = 0; i < 5000; i++)
+        EXPECT_EQ(lines[i + 1], QString("\"%1\",\"%2\"").arg(i).arg(i & 0xff).toLatin1());
+}
+
+TEST(DltExporter, parquetExport) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const QString inputName = dir.filePath("input.dlt");
+    QFile inputFile(inputName);
+    ASSERT_TRUE(inputFile.open(QIODevice::WriteOnly));
+    for (int i = 0; i < 5000; i++)
+        inputFile.write(createStoredMessage(i));
+    inputFile.close();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(inputName));
+    ASSERT_TRUE(file.createIndex());
+
+    const QString outputName = dir.filePath("output.parquet");
+    QDltExporter exporter(&file, outputName, nullptr, QDltExporter::FormatParquet, QDltExporter::SelectionAll, nullptr, 1, 0, 0);
+    exporter.setWorkerThreadCount(4);
+    exporter.exportMessages();
+
+    QByteArray output = readAll(outputName);
+    ASSERT_GT(output.size(), 12);
+    EXPECT_TRUE(output.startsWith("PAR1"));
+    EXPECT_TRUE(output.endsWith("PAR1"));
+
+    // footer length in front of the trailing magic
+    quint32 footerLength = 0;
+    for (int i = 0; i < 4; i++)
+        footerLength |= quint32(quint8(output.at(output.size() - 8 + i))) << (8 * i);
+    ASSERT_LT(footerLength, quint32(output.size() - 12));
+    QByteArray footer = output.mid(output.size() - 8 - footerLength, footerLength);
+    EXPECT_TRUE(footer.contains("payload"));
+    EXPECT_TRUE(footer.contains("ecuid"));
+
+    // ecu id is dictionary encoded, stored only once in the single row group
+    EXPECT_EQ(output.count("ECU1"), 1);
+}
+
+TEST(DltExporter, timeRangeOverlappingFiles) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // the second file starts while the first one is still running, one message of the first file is out of order
+    const quint32 start = 1700000000;
+    QByteArray input1, input2;
+    QByteArrayList expected;
+    for (int i = 0; i < 3000; i++) {
+        const QByteArray msg = createStoredMessage(i, i == 2000 ? start : start + i / 10);
+        input1.append(msg);
+        if (i >= 1500 && i <= 2509 && i != 2000)
+            expected.append(msg);
+    }
+    for (int i = 0; i < 3000; i++) {
+        const QByteArray msg = createStoredMessage(i, start + 100 + i / 10);
+        input2.append(msg);
+        if (i >= 500 && i <= 1509)
+            expected.append(msg);
+    }
+    const QString inputName1 = dir.filePath("input1.dlt");
+    const QString inputName2 = dir.filePath("input2.dlt");
+    QFile inputFile1(inputName1), inputFile2(inputName2);
+    ASSERT_TRUE(inputFile1.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(inputFile2.open(QIODevice::WriteOnly));
+    inputFile1.write(input1);
+    inputFile2.write(input2);
+    inputFile1.close();
+    inputFile2.close();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(inputName1));
+    ASSERT_TRUE(file.open(inputName2, true));
+    ASSERT_TRUE(file.createIndex());
+
+    const qint64 startTime = qint64(start + 150) * 1000000;
+    const qint64 stopTime = qint64(start + 250) * 1000000 + 999999;
+    const QString outputName = dir.filePath("output.dlt");
+    QDltExporter exporter(&file, outputName, nullptr, QDltExporter::FormatDlt, QDltExporter::SelectionAll, nullptr, 1, 0, 0);
+    exporter.exportTimeRange(startTime, stopTime);
+    exporter.exportMessages();
+    EXPECT_EQ(readAll(outputName), expected.join());
+
+    // a filter index in reverse order cannot be narrowed, each message is checked
+    QVector<qint64> reversed;
+    for (int i = file.size() - 1; i >= 0; i--)
+        reversed.append(i);
+    file.setIndexFilter(reversed);
+    file.enableFilter(true);
+    const QString filteredName = dir.filePath("filtered.dlt");
+    QDltExporter filteredExporter(&file, filteredName, nullptr, QDltExporter::FormatDlt, QDltExporter::SelectionFiltered, nullptr, 1, 0, 0);
+    filteredExporter.exportTimeRange(startTime, stopTime);
+    filteredExporter.exportMessages();
+    std::reverse(expected.begin(), expected.end());
+    EXPECT_EQ(readAll(filteredName), expected.join());
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <QTemporaryFile>
+
+#include <algorithm>
+
+#include <qdltfile.h>
+#include <qdltfilereader.h>
+
+#include "testmessages.h"
+
+TEST(DltFile, getMsgBatchMatchesGetMsg) {
+    QTemporaryFile tmp;
+    ASSERT_TRUE(tmp.open());
+    for (int i = 0; i < 200; i++)
+        tmp.write(createStoredMessage(i));
+    tmp.flush();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(tmp.fileName()));
+    ASSERT_TRUE(file.createIndex());
+    ASSERT_EQ(file.size(), 200);
+
+    QVector<int> indexes = { 199, 5, 6, 7, -1, 100, 0, 42, 500, 5 };
+    QVector<QByteArray> buffers = file.getMsgBatch(indexes);
+    ASSERT_EQ(buffers.size(), indexes.size());
+
+    for (int i = 0; i < indexes.size(); i++) {
+        if (indexes[i] < 0 || indexes[i] >= file.size())
+            EXPECT_TRUE(buffers[i].isEmpty());
+        else
+            EXPECT_EQ(buffers[i], file.getMsg(indexes[i]));
+    }
+    EXPECT_EQ(buffers[1], createStoredMessage(5));
+}
+
+TEST(DltFile, findMsgByTime) {
+    // several messages with the same time, spread over two files
+    QVector<qint64> times;
+    QTemporaryFile tmp1, tmp2;
+    ASSERT_TRUE(tmp1.open());
+    ASSERT_TRUE(tmp2.open());
+    for (int i = 0; i < 10000; i++) {
+        quint32 seconds = 1700000000 + i / 7;
+        quint32 microseconds = (i % 7) / 2 * 1000;
+        (i < 6000 ? tmp1 : tmp2).write(createStoredMessage(i, seconds, microseconds));
+        times.append(qint64(seconds) * 1000000 + microseconds);
+    }
+    tmp1.flush();
+    tmp2.flush();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(tmp1.fileName()));
+    ASSERT_TRUE(file.open(tmp2.fileName(), true));
+    ASSERT_TRUE(file.createIndex());
+    ASSERT_EQ(file.size(), times.size());
+
+    for (qint64 time = times.first() - 1; time <= times.last() + 1; time += 997) {
+        int expected = std::lower_bound(times.begin(), times.end(), time) - times.begin();
+        EXPECT_EQ(file.findMsgByTime(time), expected) << time;
+    }
+    EXPECT_EQ(file.findMsgByTime(times[6001]), 6001); // first message of its time in the second file
+    EXPECT_EQ(file.findMsgByTime(times.last() + 1), file.size());
+
+    // positions in the filtered index
+    EXPECT_EQ(file.findMsgFilterPos(6000), 6000);
+    EXPECT_EQ(file.findMsgFilterPos(file.size() + 10), file.size());
+}
+
+TEST(DltFile, findMsgRangesByTimeOverlappingFiles) {
+    // the second file starts while the first one is still running
+    QTemporaryFile tmp1, tmp2;
+    ASSERT_TRUE(tmp1.open());
+    ASSERT_TRUE(tmp2.open());
+    for (int i = 0; i < 3000; i++) {
+        tmp1.write(createStoredMessage(i, 1700000000 + i / 10));
+        tmp2.write(createStoredMessage(i, 1700000100 + i / 10));
+    }
+    tmp1.flush();
+    tmp2.flush();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(tmp1.fileName()));
+    ASSERT_TRUE(file.open(tmp2.fileName(), true));
+    ASSERT_TRUE(file.createIndex());
+
+    const QVector<QPair<int, int>> ranges = file.findMsgRangesByTime(qint64(1700000150) * 1000000, qint64(1700000250) * 1000000);
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0], qMakePair(1500, 2510));
+    EXPECT_EQ(ranges[1], qMakePair(3000 + 500, 3000 + 1510));
+
+    // only the first file is in the range
+    const QVector<QPair<int, int>> first = file.findMsgRangesByTime(0, qint64(1700000050) * 1000000);
+    ASSERT_EQ(first.size(), 1);
+    EXPECT_EQ(first[0], qMakePair(0, 510));
+}
+
+TEST(DltFile, findMsgFilterPosUnsorted) {
+    QTemporaryFile tmp;
+    ASSERT_TRUE(tmp.open());
+    for (int i = 0; i < 10; i++)
+        tmp.write(createStoredMessage(i));
+    tmp.flush();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(tmp.fileName()));
+    ASSERT_TRUE(file.createIndex());
+    file.enableFilter(true);
+
+    file.setIndexFilter({1, 3, 5, 7});
+    EXPECT_TRUE(file.isIndexFilterSorted());
+    EXPECT_EQ(file.findMsgFilterPos(4), 2);
+
+    // sorted by time, the filtered index is scanned
+    file.setIndexFilter({7, 1, 5, 3});
+    EXPECT_FALSE(file.isIndexFilterSorted());
+    EXPECT_EQ(file.findMsgFilterPos(4), 0);
+    EXPECT_EQ(file.findMsgFilterPos(8), 4);
+
+    file.clearFilterIndex();
+    file.addFilterIndex(2);
+    file.addFilterIndex(6);
+    EXPECT_TRUE(file.isIndexFilterSorted());
+    file.addFilterIndex(4);
+    EXPECT_FALSE(file.isIndexFilterSorted());
+}
+
+TEST(DltFile, createIndexSortedByTime) {
+    // two ECU traces with interleaved times, the second one starts earlier
+    QTemporaryFile tmp1, tmp2;
+    ASSERT_TRUE(tmp1.open());
+    ASSERT_TRUE(tmp2.open());
+    for (int i = 0; i < 3000; i++) {
+        tmp1.write(createStoredMessage(i, 1700000000 + i / 10, (i % 10) * 100000 + 1));
+        tmp2.write(createStoredMessage(i, 1700000000 + i / 20, (i % 20) * 50000));
+    }
+    tmp1.flush();
+    tmp2.flush();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(tmp1.fileName()));
+    ASSERT_TRUE(file.open(tmp2.fileName(), true));
+    ASSERT_TRUE(file.createIndex());
+    ASSERT_EQ(file.size(), 6000);
+
+    QVector<qint64> sorted = file.createIndexSortedByTime();
+    ASSERT_EQ(sorted.size(), file.size());
+    qint64 lastTime = 0;
+    for (qint64 index : sorted) {
+        QDltMsg msg;
+        ASSERT_TRUE(file.getMsg(index, msg));
+        qint64 time = qint64(msg.getTime()) * 1000000 + msg.getMicroseconds();
+        EXPECT_LE(lastTime, time);
+        lastTime = time;
+    }
+    EXPECT_EQ(sorted[0], 3000);
+    EXPECT_EQ(sorted[1], 0);
+
+    // time range
+    const qint64 start = 1700000100LL * 1000000;
+    const qint64 stop = 1700000109LL * 1000000;
+    QVector<qint64> range = file.createIndexSortedByTime(start, stop);
+    EXPECT_EQ(range.size(), 9 * 10 + 9 * 20 + 1); // the first file has no message at the stop time
+}
+
+TEST(DltFileReader, readsSameMessagesAsIndex) {
+    QTemporaryFile tmp;
+    ASSERT_TRUE(tmp.open());
+    tmp.write("garbage");
+    for (int i = 0; i < 1000; i++) {
+        tmp.write(createStoredMessage(i));
+        // corrupted data behind a message invalidates it, like in createIndex()
+        if (i % 100 == 50)
+            tmp.write("xxDLT");
+    }
+    tmp.flush();
+
+    QDltFile file;
+    ASSERT_TRUE(file.open(tmp.fileName()));
+    ASSERT_TRUE(file.createIndex());
+
+    // small block size forces messages to span block boundaries
+    QDltFileReader reader(100);
+    ASSERT_TRUE(reader.open(tmp.fileName()));
+
+    QByteArray buf;
+    int count = 0;
+    while (reader.readMsg(buf)) {
+        ASSERT_LT(count, file.size());
+        EXPECT_EQ(buf, file.getMsg(count));
+        count++;
+    }
+    EXPECT_EQ(count, file.size());
+    EXPECT_EQ(count, 990);
+    EXPECT_GT(reader.getErrors(), 0);
+    EXPECT_EQ(reader.getPosition(), reader.getFileSize());
+}
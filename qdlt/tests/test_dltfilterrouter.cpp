@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <qdltfilterlist.h>
+#include <qdltfilterrouter.h>
+
+namespace {
+
+QDltFilter *createFilter(QDltFilter::FilterType type, const QString &apid, const QString &ctid = QString())
+{
+    QDltFilter *filter = new QDltFilter();
+    filter->type = type;
+    filter->enableFilter = true;
+    filter->apid = apid;
+    filter->enableApid = !apid.isEmpty();
+    filter->ctid = ctid;
+    filter->enableCtid = !ctid.isEmpty();
+    filter->compileRegexps();
+    return filter;
+}
+
+QDltMsg createMsg(const QString &apid, const QString &ctid)
+{
+    QDltMsg msg;
+    msg.setApid(apid);
+    msg.setCtid(ctid);
+    return msg;
+}
+
+}
+
+TEST(DltFilterRouter, matchesCheckFilterOfEachList) {
+    QDltFilterList lists[4];
+    lists[0].addFilter(createFilter(QDltFilter::positive, "APP1"));
+    lists[1].addFilter(createFilter(QDltFilter::positive, "APP1"));
+    lists[1].addFilter(createFilter(QDltFilter::positive, "APP2"));
+    lists[2].addFilter(createFilter(QDltFilter::negative, "APP1"));
+    lists[3].addFilter(createFilter(QDltFilter::positive, "APP2"));
+    lists[3].addFilter(createFilter(QDltFilter::negative, "APP2", "CTX2"));
+
+    QDltFilterRouter router;
+    for (auto &list : lists) {
+        list.updateSortedFilter();
+        router.addOutput(list);
+    }
+    EXPECT_EQ(router.size(), 4);
+    // filters with the same criteria are evaluated once, also if positive in one list and negative in another
+    EXPECT_EQ(router.sizeFilters(), 3);
+
+    QDltMsg msgs[] = { createMsg("APP1", "CTX1"), createMsg("APP2", "CTX1"), createMsg("APP2", "CTX2"), createMsg("APP3", "CTX1") };
+    QVector<int> matches;
+    for (auto &msg : msgs) {
+        router.route(msg, matches);
+        QVector<int> expected;
+        for (int num = 0; num < 4; num++) {
+            if (lists[num].checkFilter(msg))
+                expected.append(num);
+        }
+        EXPECT_EQ(matches, expected);
+    }
+
+    router.route(msgs[2], matches);
+    EXPECT_EQ(matches, QVector<int>({1, 2}));
+}
@@ -0,0 +1,563 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <qdltconnection.h>
+#include <qdltlivereader.h>
+#include <qdltlivesink.h>
+#include <qdltrelayserver.h>
+#include <qdltudpreceiver.h>
+
+#include "testmessages.h"
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+QByteArray createStream(int count)
+{
+    QByteArray data;
+    for (int i = 0; i < count; i++)
+        data.append(createMessage(i));
+    return data;
+}
+
+// DLT log message with extended header
+QDltLiveMessage createLogMessage(int ecu, int level, const char *apid)
+{
+    QByteArray data;
+    data.append(char(0x25));
+    data.append(char(0));
+    data.append(char(0));
+    data.append(char(18));
+    data.append("ECU1", 4);
+    data.append(char((level << 4) | 0x01));
+    data.append(char(0));
+    data.append(apid, 4);
+    data.append("CON1", 4);
+
+    QDltLiveMessage message;
+    message.ecu = ecu;
+    message.data = data;
+    return message;
+}
+
+// DLT v2 verbose log message with ECU, application and context id
+QDltLiveMessage createLogMessageV2(int ecu, int level, const char *apid)
+{
+    QByteArray data;
+    data.append(char(0x4c));
+    data.append(QByteArray(3, '\0'));
+    data.append(char(0));
+    data.append(char(0));
+    data.append(char(33));
+    data.append(char(level << 4));
+    data.append(char(0));
+    data.append(QByteArray(9, '\0'));
+    data.append(char(4));
+    data.append("ECU1", 4);
+    data.append(char(4));
+    data.append(apid, 4);
+    data.append(char(4));
+    data.append("CON1", 4);
+
+    QDltLiveMessage message;
+    message.ecu = ecu;
+    message.data = data;
+    return message;
+}
+
+#ifdef Q_OS_LINUX
+int connectClient(quint16 port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd >= 0 && connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    struct timeval timeout = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+QByteArray receiveAll(int fd, int size)
+{
+    QByteArray data;
+    char buffer[4096];
+    while (data.size() < size) {
+        const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            break;
+        data.append(buffer, int(received));
+    }
+    return data;
+}
+
+bool waitForClients(const QDltRelayServer &server, int count)
+{
+    for (int i = 0; i < 500 && server.getClientCount() != count; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return server.getClientCount() == count;
+}
+#endif
+
+}
+
+TEST(DltConnection, smallChunks) {
+    const int count = 200;
+    QByteArray stream = createStream(count);
+
+    // every byte is added on its own, the buffer is compacted while messages are parsed
+    QDltConnection connection;
+    QDltMsg msg;
+    int parsed = 0;
+    for (int pos = 0; pos < stream.size(); pos++) {
+        connection.add(stream.mid(pos, 1));
+        while (connection.parseDlt(msg)) {
+            ASSERT_LT(parsed, count);
+            EXPECT_EQ(msg.getHeader() + msg.getPayload(), createMessage(parsed));
+            parsed++;
+        }
+    }
+    EXPECT_EQ(parsed, count);
+    EXPECT_EQ(connection.bytesReceived, (unsigned long)stream.size());
+    EXPECT_EQ(connection.bytesError, 0u);
+}
+
+TEST(DltConnection, syncSerialHeader) {
+    const QByteArray serialHeader("DLS\x01", 4);
+    QByteArray stream;
+    stream.append("garbage");
+    stream.append(serialHeader + createMessage(0));
+    stream.append("DL");
+    stream.append(serialHeader + createMessage(1));
+
+    QDltConnection connection;
+    connection.setSyncSerialHeader(true);
+    QDltMsg msg;
+    QVector<QByteArray> messages;
+    for (int pos = 0; pos < stream.size(); pos += 5) {
+        connection.add(stream.mid(pos, 5));
+        while (connection.parseDlt(msg))
+            messages.append(msg.getHeader() + msg.getPayload());
+    }
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages[0], createMessage(0));
+    EXPECT_EQ(messages[1], createMessage(1));
+    EXPECT_EQ(connection.syncFound, 2u);
+    EXPECT_EQ(connection.bytesError, 9u);
+}
+
+TEST(DltConnection, syncSerialHeaderCorruptedLength) {
+    const QByteArray serialHeader("DLS\x01", 4);
+    QByteArray corrupted = createMessage(0);
+    corrupted[2] = char(0xff);
+    corrupted[3] = char(0xff);
+    QByteArray stream;
+    stream.append(serialHeader + corrupted);
+    for (int num = 1; num <= 3; num++)
+        stream.append(serialHeader + createMessage(num));
+
+    // the parser does not wait for the corrupted length, the following messages are kept
+    QDltConnection connection;
+    connection.setSyncSerialHeader(true);
+    connection.add(stream);
+    QDltMsg msg;
+    QVector<QByteArray> messages;
+    while (connection.parseDlt(msg))
+        messages.append(msg.getHeader() + msg.getPayload());
+    ASSERT_EQ(messages.size(), 3);
+    for (int num = 1; num <= 3; num++)
+        EXPECT_EQ(messages[num - 1], createMessage(num));
+    EXPECT_EQ(connection.bytesError, (unsigned long)(serialHeader.size() + corrupted.size()));
+}
+
+TEST(DltConnection, invalidHeader) {
+    // DLTv2 with the reserved content information is skipped byte by byte
+    QByteArray stream;
+    stream.append(char(0x43));
+    stream.append(createMessage(0));
+
+    QDltConnection connection;
+    QDltMsg msg;
+    connection.add(stream);
+    ASSERT_TRUE(connection.parseDlt(msg, true));
+    EXPECT_EQ(msg.getHeader() + msg.getPayload(), createMessage(0));
+    EXPECT_FALSE(connection.parseDlt(msg, true));
+    EXPECT_EQ(connection.bytesError, 1u);
+}
+
+TEST(DltConnection, asciiLines) {
+    QDltConnection connection;
+    QDltMsg msg;
+    QDltArgument argument;
+    connection.add("first\r\n\nsec");
+    ASSERT_TRUE(connection.parseAscii(msg));
+    ASSERT_TRUE(msg.getArgument(0, argument));
+    EXPECT_EQ(argument.getData(), QByteArray("first", 6));
+    EXPECT_FALSE(connection.parseAscii(msg));
+    connection.add("ond\n");
+    ASSERT_TRUE(connection.parseAscii(msg));
+    ASSERT_TRUE(msg.getArgument(0, argument));
+    EXPECT_EQ(argument.getData(), QByteArray("second", 7));
+    EXPECT_FALSE(connection.parseAscii(msg));
+}
+
+TEST(DltLiveSink, concurrentConnections) {
+    const int ecus = 4;
+    const int count = 5000;
+    QDltLiveSink sink;
+
+    // each thread adds the messages of one connection in batches of varying size
+    std::vector<std::thread> threads;
+    for (int ecu = 0; ecu < ecus; ecu++) {
+        threads.emplace_back([&sink, ecu]() {
+            QVector<QDltLiveMessage> batch;
+            for (int i = 0; i < count; i++) {
+                QDltLiveMessage message;
+                message.ecu = ecu;
+                message.data = QByteArray::number(i);
+                batch.append(message);
+                if (batch.size() > i % 7) {
+                    sink.add(batch);
+                    batch.clear();
+                }
+            }
+            sink.add(batch);
+        });
+    }
+
+    QVector<QDltLiveMessage> received;
+    QVector<QDltLiveMessage> messages;
+    while (received.size() < ecus * count) {
+        sink.take(messages);
+        received += messages;
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    EXPECT_EQ(sink.size(), 0);
+
+    QVector<quint64> next(ecus, 0);
+    for (const QDltLiveMessage &message : received) {
+        ASSERT_GE(message.ecu, 0);
+        ASSERT_LT(message.ecu, ecus);
+        EXPECT_EQ(message.sequence, next[message.ecu]);
+        EXPECT_EQ(message.data, QByteArray::number(qulonglong(next[message.ecu])));
+        next[message.ecu]++;
+    }
+}
+
+TEST(DltLiveSink, dropByLevel) {
+    QDltLiveSink sink;
+    QDltLiveSink::Overload overload;
+    overload.policy = QDltLiveSink::OverloadDropByLevel;
+    overload.highWatermark = 10 * 18;
+    overload.logLevel = QDltMsg::DltLogWarn;
+    sink.setOverload(overload);
+
+    // the first ten messages reach the high watermark, then only errors are kept
+    for (int i = 0; i < 30; i++) {
+        QDltLiveMessage message = createLogMessage(1, i % 2 ? QDltMsg::DltLogError : QDltMsg::DltLogInfo, i % 3 ? "APP1" : "APP2");
+        sink.add(message);
+    }
+    EXPECT_TRUE(sink.isOverloaded());
+    EXPECT_EQ(sink.size(), 20);
+    EXPECT_EQ(sink.getShedTotal(), 10u);
+
+    quint64 shed = 0;
+    for (const QDltLiveShedCounter &counter : sink.getShed()) {
+        EXPECT_EQ(counter.ecu, 1);
+        EXPECT_TRUE(counter.apid == "APP1" || counter.apid == "APP2");
+        shed += counter.count;
+    }
+    EXPECT_EQ(shed, 10u);
+
+    // the shed messages leave gaps in the sequence numbers
+    QVector<QDltLiveMessage> messages;
+    sink.take(messages);
+    EXPECT_FALSE(sink.isOverloaded());
+    ASSERT_EQ(messages.size(), 20);
+    EXPECT_EQ(messages[9].sequence, 9u);
+    EXPECT_EQ(messages[10].sequence, 11u);
+    EXPECT_EQ(messages[19].sequence, 29u);
+
+    sink.clearShed();
+    EXPECT_EQ(sink.getShedTotal(), 0u);
+    EXPECT_TRUE(sink.getShed().isEmpty());
+}
+
+TEST(DltLiveSink, dropByLevelV2) {
+    QDltLiveSink sink;
+    QDltLiveSink::Overload overload;
+    overload.policy = QDltLiveSink::OverloadDropByLevel;
+    overload.highWatermark = 1;
+    overload.logLevel = QDltMsg::DltLogWarn;
+    sink.setOverload(overload);
+
+    QDltLiveMessage first = createLogMessage(1, QDltMsg::DltLogInfo, "APP1");
+    sink.add(first);
+    EXPECT_TRUE(sink.isOverloaded());
+
+    // the level of DLT v2 messages is known, messages without extended header are kept
+    QDltLiveMessage fatal = createLogMessageV2(1, QDltMsg::DltLogFatal, "APP2");
+    QDltLiveMessage info = createLogMessageV2(1, QDltMsg::DltLogInfo, "APP3");
+    QDltLiveMessage noExtendedHeader;
+    noExtendedHeader.ecu = 1;
+    noExtendedHeader.data = createMessage(0);
+    sink.add(fatal);
+    sink.add(info);
+    sink.add(noExtendedHeader);
+
+    EXPECT_EQ(sink.size(), 3);
+    ASSERT_EQ(sink.getShed().size(), 1);
+    EXPECT_EQ(sink.getShed()[0].apid, "APP3");
+    EXPECT_EQ(sink.getShed()[0].count, 1u);
+}
+
+TEST(DltLiveSink, sample) {
+    QDltLiveSink sink;
+    QDltLiveSink::Overload overload;
+    overload.policy = QDltLiveSink::OverloadSample;
+    overload.highWatermark = 1;
+    overload.sampleRate = 4;
+    sink.setOverload(overload);
+
+    QVector<QDltLiveMessage> messages;
+    for (int i = 0; i < 41; i++)
+        messages.append(createLogMessage(2, QDltMsg::DltLogFatal, "APP1"));
+    sink.add(messages);
+
+    // the first message reaches the watermark, then one of four is kept
+    EXPECT_EQ(sink.size(), 11);
+    EXPECT_EQ(sink.getShedTotal(), 30u);
+}
+
+TEST(DltLiveSink, hardLimit) {
+    QDltLiveSink sink;
+    QDltLiveSink::Overload overload;
+    overload.policy = QDltLiveSink::OverloadDropByLevel;
+    overload.highWatermark = 1;
+    overload.hardLimit = 10 * 18;
+    overload.logLevel = QDltMsg::DltLogWarn;
+    sink.setOverload(overload);
+
+    // errors are kept by the policy, the oldest are dropped when the limit is exceeded
+    QDltLiveMessage response = createLogMessage(1, QDltMsg::DltLogError, "APP1");
+    response.controlResponse = true;
+    sink.add(response);
+    for (int i = 0; i < 10; i++) {
+        QDltLiveMessage message = createLogMessage(1, QDltMsg::DltLogError, "APP1");
+        sink.add(message);
+    }
+    EXPECT_EQ(sink.size(), 5);
+    EXPECT_EQ(sink.getShedTotal(), 6u);
+
+    // the control response is kept, the sequence numbers show the dropped messages
+    QVector<QDltLiveMessage> messages;
+    sink.take(messages);
+    ASSERT_EQ(messages.size(), 5);
+    EXPECT_TRUE(messages[0].controlResponse);
+    EXPECT_EQ(messages[0].sequence, 0u);
+    EXPECT_EQ(messages[1].sequence, 7u);
+    EXPECT_EQ(messages[4].sequence, 10u);
+}
+
+TEST(DltLiveSink, block) {
+    QDltLiveSink sink;
+    QDltLiveSink::Overload overload;
+    overload.highWatermark = 18;
+    sink.setOverload(overload);
+
+    // nothing is shed, but the readers have to wait for the consumer
+    QVector<QDltLiveMessage> messages;
+    for (int i = 0; i < 5; i++)
+        messages.append(createLogMessage(3, QDltMsg::DltLogVerbose, "APP1"));
+    sink.add(messages);
+    EXPECT_EQ(sink.size(), 5);
+    EXPECT_EQ(sink.getShedTotal(), 0u);
+    EXPECT_TRUE(sink.isOverloaded());
+    EXPECT_FALSE(sink.waitForSpace(10));
+
+    std::thread consumer([&sink]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        QVector<QDltLiveMessage> taken;
+        sink.take(taken);
+    });
+    bool space = false;
+    for (int i = 0; i < 100 && !space; i++)
+        space = sink.waitForSpace(100);
+    consumer.join();
+    EXPECT_TRUE(space);
+    EXPECT_EQ(sink.size(), 0);
+}
+
+TEST(DltLiveReader, tcpStreamSplit) {
+    const int count = 300;
+    QByteArray stream = createStream(count);
+
+    QDltLiveSink sink;
+    QDltLiveReader::Settings settings;
+    settings.type = QDltLiveReader::TypeTcp;
+    QDltLiveReader reader(7, settings, &sink);
+
+    // messages span the received chunks
+    for (int pos = 0; pos < stream.size(); pos += 311)
+        reader.addData(stream.mid(pos, 311), 1700000000, pos);
+
+    QVector<QDltLiveMessage> messages;
+    sink.take(messages);
+    ASSERT_EQ(messages.size(), count);
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(messages[i].ecu, 7);
+        EXPECT_EQ(messages[i].sequence, quint64(i));
+        EXPECT_EQ(messages[i].data, createMessage(i)) << i;
+        EXPECT_FALSE(messages[i].controlResponse);
+    }
+    EXPECT_EQ(messages[0].sec, 1700000000u);
+
+    QDltLiveReader::Statistics statistics = reader.takeStatistics();
+    EXPECT_EQ(statistics.bytesReceived, quint64(stream.size()));
+    EXPECT_EQ(statistics.bytesError, 0u);
+}
+
+TEST(DltLiveReader, udpDatagrams) {
+    QDltLiveSink sink;
+    QDltLiveReader::Settings settings;
+    settings.type = QDltLiveReader::TypeUdp;
+    QDltLiveReader reader(1, settings, &sink);
+
+    // a datagram with three messages and a truncated one
+    QByteArray datagram = createStream(3);
+    QByteArray truncated = createMessage(3).left(10);
+    reader.addData(datagram + truncated, 0, 0);
+
+    QVector<QDltLiveMessage> messages;
+    sink.take(messages);
+    ASSERT_EQ(messages.size(), 3);
+    for (int i = 0; i < 3; i++)
+        EXPECT_EQ(messages[i].data, createMessage(i));
+
+    QDltLiveReader::Statistics statistics = reader.takeStatistics();
+    EXPECT_EQ(statistics.bytesReceived, quint64(datagram.size() + truncated.size()));
+    EXPECT_EQ(statistics.bytesError, quint64(truncated.size()));
+}
+
+TEST(DltUdpReceiver, batches) {
+#ifdef Q_OS_LINUX
+    QDltUdpReceiver receiver(8);
+    ASSERT_TRUE(receiver.open("127.0.0.1", 0, 1 << 20)) << receiver.errorString().toStdString();
+    ASSERT_NE(receiver.localPort(), 0);
+    EXPECT_EQ(receiver.receive(), 0);
+
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sender, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(receiver.localPort());
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const int count = 50;
+    for (int i = 0; i < count; i++) {
+        QByteArray datagram = createMessage(i);
+        ASSERT_EQ(sendto(sender, datagram.constData(), datagram.size(), 0,
+                         reinterpret_cast<struct sockaddr *>(&address), sizeof(address)),
+                  datagram.size());
+    }
+    close(sender);
+
+    // loopback datagrams are queued when sendto() returns, batches hold at most 8
+    int received = 0;
+    int size;
+    while ((size = receiver.receive()) > 0) {
+        EXPECT_LE(size, 8);
+        for (int i = 0; i < size; i++) {
+            const QDltUdpDatagram &datagram = receiver.datagram(i);
+            EXPECT_EQ(QByteArray(datagram.data, datagram.size), createMessage(received + i));
+            EXPECT_GT(datagram.sec, 0u);
+        }
+        received += size;
+    }
+    EXPECT_EQ(size, 0);
+    EXPECT_EQ(received, count);
+    EXPECT_EQ(receiver.takeDropped(), 0u);
+#else
+    EXPECT_FALSE(QDltUdpReceiver::isSupported());
+#endif
+}
+
+TEST(DltRelayServer, fanOut) {
+#ifdef Q_OS_LINUX
+    QDltRelayServer server;
+    ASSERT_TRUE(server.start("127.0.0.1", 0)) << server.errorString().toStdString();
+    ASSERT_NE(server.serverPort(), 0);
+
+    int first = connectClient(server.serverPort());
+    int second = connectClient(server.serverPort());
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+    ASSERT_TRUE(waitForClients(server, 2));
+
+    // the sink publishes the messages when the readers add them
+    QDltLiveSink sink;
+    sink.setRelay(&server);
+    QVector<QDltLiveMessage> messages;
+    for (int i = 0; i < 100; i++) {
+        QDltLiveMessage message;
+        message.data = createMessage(i);
+        messages.append(message);
+    }
+    sink.add(messages);
+
+    const QByteArray stream = createStream(100);
+    EXPECT_EQ(receiveAll(first, stream.size()), stream);
+    EXPECT_EQ(receiveAll(second, stream.size()), stream);
+    EXPECT_EQ(server.takeDropped(), 0u);
+
+    close(first);
+    EXPECT_TRUE(waitForClients(server, 1));
+    close(second);
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+#endif
+}
+
+TEST(DltRelayServer, dropOldest) {
+#ifdef Q_OS_LINUX
+    // the queue of the client holds about three messages
+    QDltRelayServer server(1000);
+    ASSERT_TRUE(server.start("127.0.0.1", 0)) << server.errorString().toStdString();
+    int client = connectClient(server.serverPort());
+    ASSERT_GE(client, 0);
+    ASSERT_TRUE(waitForClients(server, 1));
+
+    QVector<QDltLiveMessage> messages;
+    QByteArray expected;
+    for (int i = 0; i < 100; i++) {
+        QDltLiveMessage message;
+        message.data = createMessage(i);
+        messages.append(message);
+    }
+    // the newest messages fitting into the queue are kept
+    int kept = 100;
+    for (int size = 0; kept > 0 && size + messages[kept - 1].data.size() <= 1000; kept--)
+        size += messages[kept - 1].data.size();
+    for (int i = kept; i < 100; i++)
+        expected.append(messages[i].data);
+
+    server.publish(messages);
+    EXPECT_EQ(server.takeDropped(), quint64(kept));
+    EXPECT_EQ(receiveAll(client, expected.size()), expected);
+    close(client);
+#endif
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <qdltlrucache.hpp>
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <string>
+
+namespace {
+// all keys get the same hash, so they share one probe sequence starting at the home bucket of the seed
+size_t collidingSeed = 0;
+
+struct CollidingHash {
+    size_t operator()(int) const { return collidingSeed; }
+};
+}
+
+TEST(DltLruCache, evictsLeastRecentlyUsed) {
+    QDltLruCache<int, std::string> cache(3);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+    EXPECT_EQ(cache.size(), 3u);
+
+    // 1 becomes the most recently used entry, so 2 is evicted
+    EXPECT_EQ(cache.get(1), "one");
+    cache.put(4, "four");
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_FALSE(cache.exists(2));
+    EXPECT_TRUE(cache.exists(1));
+    EXPECT_TRUE(cache.exists(3));
+    EXPECT_TRUE(cache.exists(4));
+
+    cache.put(5, "five");
+    EXPECT_FALSE(cache.exists(3));
+    EXPECT_EQ(cache.get(1), "one");
+    EXPECT_EQ(cache.get(4), "four");
+    EXPECT_EQ(cache.get(5), "five");
+    EXPECT_THROW(cache.get(3), std::range_error);
+}
+
+TEST(DltLruCache, putOverwrites) {
+    QDltLruCache<int, std::string> cache(2);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(1, "uno");
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.get(1), "uno");
+
+    // overwriting made 1 the most recently used entry
+    cache.put(2, "dos");
+    cache.put(3, "tres");
+    EXPECT_FALSE(cache.exists(1));
+    EXPECT_EQ(cache.get(2), "dos");
+    EXPECT_EQ(cache.get(3), "tres");
+}
+
+TEST(DltLruCache, evictAcrossWrapAround) {
+    // 4 entries use 8 buckets, with every home bucket some probe sequences wrap around the table end
+    for (collidingSeed = 0; collidingSeed < 64; collidingSeed++) {
+        QDltLruCache<int, int, CollidingHash> cache(4);
+        for (int key = 0; key < 20; key++) {
+            cache.put(key, key * 10);
+            // the oldest entry was deleted from the middle of the probe sequence
+            for (int cached = std::max(0, key - 3); cached <= key; cached++) {
+                const int *value = cache.find(cached);
+                ASSERT_NE(value, nullptr) << "seed " << collidingSeed << " key " << cached;
+                EXPECT_EQ(*value, cached * 10);
+            }
+            if (key >= 4) {
+                EXPECT_FALSE(cache.exists(key - 4));
+            }
+        }
+    }
+}
+
+TEST(DltLruCache, matchesReference) {
+    QDltLruCache<int, int> cache(8);
+    std::list<std::pair<int, int>> reference;
+    std::mt19937 random(1);
+
+    for (int i = 0; i < 10000; i++) {
+        const int key = random() % 24;
+        auto it = reference.begin();
+        while (it != reference.end() && it->first != key) {
+            ++it;
+        }
+        if (random() % 2) {
+            cache.put(key, i);
+            if (it != reference.end()) {
+                reference.erase(it);
+            } else if (reference.size() == 8) {
+                reference.pop_back();
+            }
+            reference.emplace_front(key, i);
+        } else {
+            const int *value = cache.find(key);
+            if (it == reference.end()) {
+                EXPECT_EQ(value, nullptr);
+            } else {
+                ASSERT_NE(value, nullptr);
+                EXPECT_EQ(*value, it->second);
+                reference.splice(reference.begin(), reference, it);
+            }
+        }
+        ASSERT_EQ(cache.size(), reference.size());
+    }
+}
+
+TEST(DltLruCache, clear) {
+    QDltLruCache<int, std::string> cache(4);
+    for (int key = 0; key < 4; key++) {
+        cache.put(key, std::to_string(key));
+    }
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    for (int key = 0; key < 4; key++) {
+        EXPECT_FALSE(cache.exists(key));
+    }
+
+    // the cache is usable again up to its capacity
+    for (int key = 10; key < 15; key++) {
+        cache.put(key, std::to_string(key));
+    }
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_FALSE(cache.exists(10));
+    EXPECT_EQ(cache.get(14), "14");
+}
+
+TEST(DltLruCache, getOrCompute) {
+    QDltLruCache<int, std::string> cache(2);
+    int computed = 0;
+    auto compute = [&computed]() {
+        computed++;
+        return std::string("value");
+    };
+
+    EXPECT_EQ(cache.getOrCompute(1, compute), "value");
+    EXPECT_EQ(computed, 1);
+    EXPECT_TRUE(cache.exists(1));
+
+    // a hit does not compute again
+    EXPECT_EQ(cache.getOrCompute(1, compute), "value");
+    EXPECT_EQ(computed, 1);
+
+    cache.put(2, "two");
+    EXPECT_EQ(cache.getOrCompute(2, compute), "two");
+    EXPECT_EQ(computed, 1);
+}
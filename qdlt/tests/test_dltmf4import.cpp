@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <qdltfile.h>
+#include <qdltimporter.h>
+#include <qdltmf4reader.h>
+#include <qdltmsg.h>
+
+#include "testmessages.h"
+
+namespace {
+
+const int storageHeaderSize = 16;
+const quint64 startTime = 1700000000ULL * 1000000000ULL;
+
+void appendLittleEndian(QByteArray &data, quint64 value, int size)
+{
+    for (int i = 0; i < size; i++)
+        data.append(char((value >> (8 * i)) & 0xff));
+}
+
+void setLittleEndian(QByteArray &data, int pos, quint64 value)
+{
+    for (int i = 0; i < 8; i++)
+        data[pos + i] = char((value >> (8 * i)) & 0xff);
+}
+
+quint32 adler32(const QByteArray &data)
+{
+    quint32 a = 1, b = 0;
+    for (char c : data) {
+        a = (a + quint8(c)) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+// zlib stream with uncompressed deflate blocks
+QByteArray zlibStream(const QByteArray &data)
+{
+    QByteArray result("\x78\x01", 2);
+    for (int pos = 0; pos < data.size() || pos == 0; pos += 65535) {
+        quint16 length = qMin(65535, int(data.size() - pos));
+        result.append(char(pos + length >= data.size() ? 1 : 0));
+        appendLittleEndian(result, length, 2);
+        appendLittleEndian(result, quint16(~length), 2);
+        result.append(data.mid(pos, length));
+    }
+    quint32 checksum = adler32(data);
+    for (int i = 3; i >= 0; i--)
+        result.append(char((checksum >> (8 * i)) & 0xff));
+    return result;
+}
+
+// the rows of the data with the given number of columns are stored column by column
+QByteArray transpose(const QByteArray &data, int columns)
+{
+    int rows = data.size() / columns;
+    QByteArray result;
+    for (int column = 0; column < columns; column++)
+        for (int row = 0; row < rows; row++)
+            result.append(data[row * columns + column]);
+    result.append(data.mid(rows * columns));
+    return result;
+}
+
+// MF4 file built block by block, links are patched when the linked block is added
+class Mf4Builder
+{
+public:
+    Mf4Builder()
+    {
+        data.append("MDF     4.10    dltview ", 24);
+        data.append(QByteArray(40, '\0'));
+    }
+
+    quint64 addBlock(const char *id, const QVector<quint64> &links, const QByteArray &body)
+    {
+        while (data.size() % 8)
+            data.append(char(0));
+        quint64 position = data.size();
+        data.append("##", 2);
+        data.append(id, 2);
+        data.append(QByteArray(4, '\0'));
+        appendLittleEndian(data, 24 + links.size() * 8 + body.size(), 8);
+        appendLittleEndian(data, links.size(), 8);
+        for (quint64 link : links)
+            appendLittleEndian(data, link, 8);
+        data.append(body);
+        return position;
+    }
+
+    void setLink(quint64 block, int link, quint64 value) { setLittleEndian(data, block + 24 + link * 8, value); }
+
+    quint64 addChannelGroup(quint16 recordId, bool vlsd, quint32 dataBytes, const char *name)
+    {
+        QByteArray text(name);
+        text.append(char(0));
+        quint64 tx = addBlock("TX", {}, text);
+        quint64 cn = addBlock("CN", { 0, 0, tx, 0, 0, 0, 0, 0 }, QByteArray(8, '\0'));
+        QByteArray body;
+        appendLittleEndian(body, recordId, 8);
+        appendLittleEndian(body, 0, 8);
+        appendLittleEndian(body, vlsd ? 1 : 0, 2);
+        appendLittleEndian(body, 0, 6);
+        appendLittleEndian(body, dataBytes, 4);
+        appendLittleEndian(body, 0, 4);
+        return addBlock("CG", { 0, cn, 0, 0, 0, 0 }, body);
+    }
+
+    QByteArray data;
+};
+
+// records of DLT frames, each DLT message in a VLSD record followed by the DLT_Frame record
+QByteArray createRecords(int count)
+{
+    QByteArray records;
+    for (int i = 0; i < count; i++) {
+        QByteArray message = createMessage(i);
+        appendLittleEndian(records, 1, 2);
+        appendLittleEndian(records, message.size(), 4);
+        records.append(message);
+        appendLittleEndian(records, 2, 2);
+        appendLittleEndian(records, quint64(i) * 1000000, 8);
+        records.append(char(0));
+        appendLittleEndian(records, 0, 2);
+        appendLittleEndian(records, 0, 2);
+        records.append("ECU1", 4);
+        appendLittleEndian(records, message.size(), 4);
+        appendLittleEndian(records, 0, 4);
+        appendLittleEndian(records, 0, 4);
+    }
+    return records;
+}
+
+QByteArray dzBody(const QByteArray &data, int columns)
+{
+    QByteArray compressed = zlibStream(columns ? transpose(data, columns) : data);
+    QByteArray body("DT", 2);
+    body.append(char(columns ? 1 : 0));
+    body.append(char(0));
+    appendLittleEndian(body, columns, 4);
+    appendLittleEndian(body, data.size(), 8);
+    appendLittleEndian(body, compressed.size(), 8);
+    body.append(compressed);
+    return body;
+}
+
+// file with one data group, the records are split into data blocks at the given positions
+QByteArray createFile(const QByteArray &records, const QVector<int> &splits, bool compressed)
+{
+    Mf4Builder file;
+    QByteArray hd;
+    appendLittleEndian(hd, startTime, 8);
+    appendLittleEndian(hd, 0, 7);
+    quint64 hdBlock = file.addBlock("HD", { 0, 0, 0, 0, 0, 0 }, hd);
+    Q_ASSERT(hdBlock == 64);
+
+    quint64 vlsd = file.addChannelGroup(1, true, 0, "DLT_Frame.DataBytes");
+    quint64 frame = file.addChannelGroup(2, false, 29, "DLT_Frame");
+    file.setLink(vlsd, 0, frame);
+    quint64 dg = file.addBlock("DG", { 0, vlsd, 0, 0 }, QByteArray(8, '\0'));
+    file.setLink(hdBlock, 0, dg);
+
+    QVector<quint64> blocks;
+    for (int i = 0; i + 1 < splits.size(); i++) {
+        QByteArray part = records.mid(splits[i], splits[i + 1] - splits[i]);
+        if (compressed && i % 2 == 0)
+            blocks.append(file.addBlock("DZ", {}, dzBody(part, i % 4 == 0 ? 31 : 0)));
+        else
+            blocks.append(file.addBlock("DT", {}, part));
+    }
+
+    // the blocks are spread over two chained data lists
+    int half = blocks.size() / 2;
+    QByteArray list;
+    appendLittleEndian(list, 0, 8);
+    quint64 second = file.addBlock("DL", QVector<quint64>({ 0 }) + blocks.mid(half), list);
+    quint64 first = file.addBlock("DL", QVector<quint64>({ second }) + blocks.mid(0, half), list);
+    file.setLink(dg, 2, first);
+    return file.data;
+}
+
+void import(const QTemporaryDir &dir, const QByteArray &mf4, QDltFile &result)
+{
+    QString input = dir.filePath("input.mf4");
+    QFile file(input);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(file.write(mf4), mf4.size());
+    file.close();
+
+    QFile output(dir.filePath("output.dlt"));
+    QDltImporter importer(&output);
+    importer.dltIpcFromMF4(input);
+
+    ASSERT_TRUE(result.open(output.fileName()));
+    ASSERT_TRUE(result.createIndex());
+}
+
+}
+
+TEST(DltMf4Import, decodeTransposedBlock) {
+    if (!QDltMf4Reader::isCompressionSupported())
+        GTEST_SKIP() << "built without zlib";
+
+    QByteArray data;
+    for (int i = 0; i < 1000; i++)
+        data.append(char(i * 7 % 251));
+
+    for (int columns : { 0, 1, 29, 999, 1000, 2000 }) {
+        Mf4Builder file;
+        quint64 position = file.addBlock("DZ", {}, dzBody(data, columns));
+        QByteArray decoded;
+        ASSERT_TRUE(QDltMf4Reader::decodeBlock(file.data.mid(position), decoded)) << columns;
+        EXPECT_EQ(decoded, data) << columns;
+    }
+}
+
+TEST(DltMf4Import, blocksInOrder) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // records span the block boundaries
+    const int count = 500;
+    QByteArray records = createRecords(count);
+    QVector<int> splits;
+    for (int pos = 0; pos < records.size(); pos += 997)
+        splits.append(pos);
+    splits.append(records.size());
+
+    QDltFile file;
+    import(dir, createFile(records, splits, QDltMf4Reader::isCompressionSupported()), file);
+    ASSERT_EQ(file.size(), count);
+    for (int i = 0; i < count; i++)
+        EXPECT_EQ(file.getMsg(i).mid(storageHeaderSize), createMessage(i)) << i;
+
+    QDltMsg msg;
+    ASSERT_TRUE(file.getMsg(7, msg));
+    EXPECT_EQ(msg.getTime(), 1700000000);
+    EXPECT_EQ(msg.getMicroseconds(), 7000u);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <qdltmsgcache.h>
+
+TEST(DltMsgCache, missThenHit) {
+    QDltMsgCache cache;
+
+    QDltMsg msg;
+    msg.setApid("APP");
+    msg.setIndex(42);
+
+    QDltMsg result;
+    EXPECT_FALSE(cache.get(42, result));
+    cache.put(42, msg);
+    EXPECT_TRUE(cache.get(42, result));
+    EXPECT_EQ(result.getApid(), "APP");
+    EXPECT_EQ(result.getIndex(), 42);
+
+    EXPECT_EQ(cache.getHits(), 1u);
+    EXPECT_EQ(cache.getMisses(), 1u);
+    EXPECT_EQ(cache.count(), 1);
+    EXPECT_GT(cache.sizeBytes(), 0);
+}
+
+TEST(DltMsgCache, clear) {
+    QDltMsgCache cache;
+    QDltMsg msg;
+
+    for (int i = 0; i < 100; i++)
+        cache.put(i, msg);
+    EXPECT_EQ(cache.count(), 100);
+
+    cache.clear();
+    EXPECT_EQ(cache.count(), 0);
+    EXPECT_FALSE(cache.get(0, msg));
+}
+
+TEST(DltMsgCache, disabled) {
+    QDltMsgCache cache;
+    cache.setMaxSizeMB(0);
+    EXPECT_FALSE(cache.isEnabled());
+
+    QDltMsg msg;
+    cache.put(1, msg);
+    EXPECT_FALSE(cache.get(1, msg));
+    EXPECT_EQ(cache.count(), 0);
+}
+
+TEST(DltMsgCache, budgetIsRespected) {
+    QDltMsgCache cache;
+    cache.setMaxSizeMB(1);
+
+    QDltMsg msg;
+    for (int i = 0; i < 100000; i++)
+        cache.put(i, msg);
+
+    EXPECT_LE(cache.sizeBytes(), 1024 * 1024);
+    EXPECT_LT(cache.count(), 100000);
+}
+
+TEST(DltMsgCache, decoderHashInvalidates) {
+    QDltMsgCache cache;
+    QDltMsg msg;
+
+    EXPECT_FALSE(cache.setDecoderHash(QByteArray()));
+    cache.put(1, msg);
+
+    EXPECT_TRUE(cache.setDecoderHash("plugins1"));
+    EXPECT_EQ(cache.count(), 0);
+    cache.put(1, msg);
+
+    EXPECT_FALSE(cache.setDecoderHash("plugins1"));
+    EXPECT_EQ(cache.count(), 1);
+    EXPECT_EQ(cache.getDecoderHash(), QByteArray("plugins1"));
+}
+
+TEST(DltMsgCache, getOrCompute) {
+    QDltMsgCache cache;
+    QDltMsg msg;
+    int computed = 0;
+    auto compute = [&computed](QDltMsg &) {
+        computed++;
+        return true;
+    };
+
+    EXPECT_TRUE(cache.getOrCompute(1, msg, compute));
+    EXPECT_EQ(computed, 1);
+    EXPECT_TRUE(cache.contains(1));
+
+    // a hit does not compute again
+    EXPECT_TRUE(cache.getOrCompute(1, msg, compute));
+    EXPECT_EQ(computed, 1);
+
+    // a failed computation is not cached
+    EXPECT_FALSE(cache.getOrCompute(2, msg, [](QDltMsg &) { return false; }));
+    EXPECT_FALSE(cache.contains(2));
+}
@@ -0,0 +1,368 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <qdltfile.h>
+#include <qdltimporter.h>
+#include <qdltmsg.h>
+#include <qdltpacketreassembler.h>
+
+#include "testmessages.h"
+
+namespace {
+
+const int storageHeaderSize = 16;
+
+QByteArray createStream(int first, int count)
+{
+    QByteArray data;
+    for (int i = first; i < first + count; i++)
+        data.append(createMessage(i));
+    return data;
+}
+
+void appendBigEndian(QByteArray &data, quint32 value, int size)
+{
+    for (int i = size - 1; i >= 0; i--)
+        data.append(char((value >> (8 * i)) & 0xff));
+}
+
+void appendLittleEndian(QByteArray &data, quint64 value, int size)
+{
+    for (int i = 0; i < size; i++)
+        data.append(char((value >> (8 * i)) & 0xff));
+}
+
+QByteArray ipv4Packet(quint8 source, quint8 protocol, quint16 id, int offset, bool moreFragments, const QByteArray &payload)
+{
+    QByteArray data;
+    data.append(char(0x45));
+    data.append(char(0));
+    appendBigEndian(data, 20 + payload.size(), 2);
+    appendBigEndian(data, id, 2);
+    appendBigEndian(data, (moreFragments ? 0x2000 : 0) | (offset / 8), 2);
+    data.append(char(64));
+    data.append(char(protocol));
+    appendBigEndian(data, 0, 2);
+    appendBigEndian(data, 0xc0a80000 | source, 4);
+    appendBigEndian(data, 0xc0a800ff, 4);
+    data.append(payload);
+    return data;
+}
+
+QByteArray udpDatagram(quint16 destPort, const QByteArray &payload)
+{
+    QByteArray data;
+    appendBigEndian(data, 50000, 2);
+    appendBigEndian(data, destPort, 2);
+    appendBigEndian(data, 8 + payload.size(), 2);
+    appendBigEndian(data, 0, 2);
+    data.append(payload);
+    return data;
+}
+
+QByteArray tcpSegment(quint32 sequence, quint8 flags, const QByteArray &payload)
+{
+    QByteArray data;
+    appendBigEndian(data, 3490, 2);
+    appendBigEndian(data, 50000, 2);
+    appendBigEndian(data, sequence, 4);
+    appendBigEndian(data, 0, 4);
+    data.append(char(5 << 4));
+    data.append(char(flags | 0x10));
+    appendBigEndian(data, 0xffff, 2);
+    appendBigEndian(data, 0, 4);
+    data.append(payload);
+    return data;
+}
+
+QByteArray ethernetFrame(const QByteArray &ipPacket)
+{
+    QByteArray data(12, '\x02');
+    appendBigEndian(data, 0x0800, 2);
+    data.append(ipPacket);
+    return data;
+}
+
+QByteArray pcapFile(const QVector<QByteArray> &frames)
+{
+    QByteArray data;
+    appendLittleEndian(data, 0xa1b2c3d4, 4);
+    appendLittleEndian(data, 2, 2);
+    appendLittleEndian(data, 4, 2);
+    appendLittleEndian(data, 0, 8);
+    appendLittleEndian(data, 65535, 4);
+    appendLittleEndian(data, 1, 4);
+    for (int i = 0; i < frames.size(); i++) {
+        appendLittleEndian(data, 1000 + i, 4);
+        appendLittleEndian(data, 500, 4);
+        appendLittleEndian(data, frames[i].size(), 4);
+        appendLittleEndian(data, frames[i].size(), 4);
+        data.append(frames[i]);
+    }
+    return data;
+}
+
+void appendPcapngBlock(QByteArray &data, quint32 type, const QByteArray &body)
+{
+    QByteArray padded = body;
+    while (padded.size() % 4)
+        padded.append(char(0));
+    appendLittleEndian(data, type, 4);
+    appendLittleEndian(data, 12 + padded.size(), 4);
+    data.append(padded);
+    appendLittleEndian(data, 12 + padded.size(), 4);
+}
+
+// pcapng with nanosecond timestamps
+QByteArray pcapngFile(const QVector<QByteArray> &frames)
+{
+    QByteArray data;
+    QByteArray section;
+    appendLittleEndian(section, 0x1a2b3c4d, 4);
+    appendLittleEndian(section, 1, 2);
+    appendLittleEndian(section, 0, 2);
+    appendLittleEndian(section, quint64(-1), 8);
+    appendPcapngBlock(data, 0x0a0d0d0a, section);
+
+    QByteArray iface;
+    appendLittleEndian(iface, 1, 2);
+    appendLittleEndian(iface, 0, 2);
+    appendLittleEndian(iface, 0, 4);
+    appendLittleEndian(iface, 9, 2);
+    appendLittleEndian(iface, 1, 2);
+    iface.append(char(9));
+    iface.append(QByteArray(3, '\0'));
+    appendLittleEndian(iface, 0, 4);
+    appendPcapngBlock(data, 1, iface);
+
+    for (int i = 0; i < frames.size(); i++) {
+        quint64 ticks = (2000ULL + i) * 1000000000ULL + 250000000ULL;
+        QByteArray packet;
+        appendLittleEndian(packet, 0, 4);
+        appendLittleEndian(packet, ticks >> 32, 4);
+        appendLittleEndian(packet, ticks & 0xffffffff, 4);
+        appendLittleEndian(packet, frames[i].size(), 4);
+        appendLittleEndian(packet, frames[i].size(), 4);
+        packet.append(frames[i]);
+        appendPcapngBlock(data, 6, packet);
+    }
+    return data;
+}
+
+// import the capture and index the output file
+void import(const QTemporaryDir &dir, const QByteArray &capture, QDltFile &result)
+{
+    QString input = dir.filePath("input.pcap");
+    QFile file(input);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(file.write(capture), capture.size());
+    file.close();
+
+    QFile output(dir.filePath("output.dlt"));
+    QDltImporter importer(&output);
+    importer.dltIpcFromPCAP(input);
+
+    ASSERT_TRUE(result.open(output.fileName()));
+    ASSERT_TRUE(result.createIndex());
+}
+
+}
+
+TEST(DltPcapImport, classicPcapUdp) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    QVector<QByteArray> frames;
+    frames.append(ethernetFrame(ipv4Packet(1, 17, 1, 0, false, udpDatagram(3490, createStream(0, 3)))));
+    frames.append(ethernetFrame(ipv4Packet(1, 17, 2, 0, false, udpDatagram(1234, createStream(100, 1)))));
+    frames.append(ethernetFrame(ipv4Packet(1, 17, 3, 0, false, udpDatagram(3489, createStream(3, 1)))));
+
+    QDltFile file;
+    import(dir, pcapFile(frames), file);
+    ASSERT_EQ(file.size(), 4);
+    for (int i = 0; i < 4; i++)
+        EXPECT_EQ(file.getMsg(i).mid(storageHeaderSize), createMessage(i));
+
+    QDltMsg msg;
+    ASSERT_TRUE(file.getMsg(3, msg));
+    EXPECT_EQ(msg.getTime(), 1002);
+    EXPECT_EQ(msg.getMicroseconds(), 500u);
+}
+
+TEST(DltPcapImport, pcapngTcpOutOfOrder) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // the stream is split within messages, one segment arrives late and one is retransmitted
+    QByteArray stream = createStream(0, 20);
+    const quint32 isn = 0xfffffc00; // sequence numbers wrap within the stream
+    QVector<int> splits = { 0, 5, 300, 301, 900, 1700, 2500, int(stream.size()) };
+    QVector<QByteArray> segments;
+    for (int i = 0; i + 1 < splits.size(); i++)
+        segments.append(tcpSegment(isn + 1 + splits[i], 0, stream.mid(splits[i], splits[i + 1] - splits[i])));
+
+    QVector<QByteArray> frames;
+    frames.append(ethernetFrame(ipv4Packet(1, 6, 1, 0, false, tcpSegment(isn, 0x02, QByteArray()))));
+    frames.append(ethernetFrame(ipv4Packet(1, 6, 2, 0, false, segments[0])));
+    frames.append(ethernetFrame(ipv4Packet(1, 6, 3, 0, false, segments[2])));
+    frames.append(ethernetFrame(ipv4Packet(1, 6, 4, 0, false, segments[1])));
+    frames.append(ethernetFrame(ipv4Packet(1, 6, 5, 0, false, segments[1])));
+    for (int i = 3; i < segments.size(); i++)
+        frames.append(ethernetFrame(ipv4Packet(1, 6, 3 + i, 0, false, segments[i])));
+
+    QDltFile file;
+    import(dir, pcapngFile(frames), file);
+    ASSERT_EQ(file.size(), 20);
+    for (int i = 0; i < 20; i++)
+        EXPECT_EQ(file.getMsg(i).mid(storageHeaderSize), createMessage(i)) << i;
+
+    QDltMsg msg;
+    ASSERT_TRUE(file.getMsg(0, msg));
+    // the first message is complete with the late segment
+    EXPECT_EQ(msg.getTime(), 2003);
+    EXPECT_EQ(msg.getMicroseconds(), 250000u);
+}
+
+TEST(DltPcapImport, interleavedFragments) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // two datagrams from different sources with the same id, fragments interleaved and out of order
+    QByteArray first = udpDatagram(3490, createStream(0, 10));
+    QByteArray second = udpDatagram(3490, createStream(10, 10));
+    QVector<QByteArray> frames;
+    frames.append(ethernetFrame(ipv4Packet(1, 17, 7, 0, true, first.left(800))));
+    frames.append(ethernetFrame(ipv4Packet(2, 17, 7, 800, false, second.mid(800))));
+    frames.append(ethernetFrame(ipv4Packet(2, 17, 7, 0, true, second.left(800))));
+    frames.append(ethernetFrame(ipv4Packet(1, 17, 7, 800, false, first.mid(800))));
+
+    QDltFile file;
+    import(dir, pcapFile(frames), file);
+    ASSERT_EQ(file.size(), 20);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(file.getMsg(i).mid(storageHeaderSize), createMessage(i + 10)) << i;
+        EXPECT_EQ(file.getMsg(i + 10).mid(storageHeaderSize), createMessage(i)) << i;
+    }
+}
+
+TEST(DltPcapImport, indexWhileWriting) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // two captures imported into the same output file
+    QString input = dir.filePath("input.pcap");
+    QFile output(dir.filePath("output.dlt"));
+    QDltImporter importer(&output);
+    for (int n = 0; n < 2; n++) {
+        QVector<QByteArray> frames;
+        for (int i = 0; i < 50; i++)
+            frames.append(ethernetFrame(ipv4Packet(1, 17, i, 0, false, udpDatagram(3490, createStream(n * 150 + i * 3, 3)))));
+        QByteArray capture = pcapFile(frames);
+        QFile file(input);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        ASSERT_EQ(file.write(capture), capture.size());
+        file.close();
+        importer.dltIpcFromPCAP(input);
+    }
+
+    QVector<qint64> index;
+    ASSERT_TRUE(importer.getDltIndex(index));
+    ASSERT_EQ(index.size(), 300);
+
+    QDltFile scanned;
+    ASSERT_TRUE(scanned.open(output.fileName()));
+    ASSERT_TRUE(scanned.createIndex());
+    QDltFile written;
+    ASSERT_TRUE(written.open(output.fileName()));
+    written.setDltIndex(index);
+    ASSERT_TRUE(written.updateIndex());
+    ASSERT_EQ(written.size(), scanned.size());
+    for (int i = 0; i < scanned.size(); i++)
+        EXPECT_EQ(written.getMsg(i), scanned.getMsg(i)) << i;
+
+    // the file was changed by someone else, the index is not valid anymore
+    ASSERT_TRUE(output.open(QIODevice::WriteOnly | QIODevice::Append));
+    output.write(createMessage(0));
+    output.close();
+    importer.dltIpcFromPCAP(input);
+    EXPECT_FALSE(importer.getDltIndex(index));
+}
+
+TEST(DltTcpReassembler, gapAndResync) {
+    QVector<QByteArray> messages;
+    QDltTcpReassembler reassembler([&messages](const char *data, int size) { messages.append(QByteArray(data, size)); });
+    reassembler.setMaxPendingBytes(1000);
+
+    QDltFlowKey key;
+    key.protocol = 6;
+    QByteArray stream = createStream(0, 30);
+    int lost = createMessage(0).size() + createMessage(1).size();
+
+    // the capture starts within a connection, the second message is missing
+    reassembler.addSegment(key, 100, 0, stream.constData(), createMessage(0).size() + 10, 0);
+    reassembler.addSegment(key, 100 + lost, 0, stream.constData() + lost, stream.size() - lost, 0);
+    reassembler.flush();
+
+    ASSERT_EQ(messages.size(), 29);
+    EXPECT_EQ(messages[0], createMessage(0));
+    for (int i = 1; i < messages.size(); i++)
+        EXPECT_EQ(messages[i], createMessage(i + 1));
+    EXPECT_EQ(reassembler.getBytesLost(), quint64(createMessage(1).size()));
+    EXPECT_EQ(reassembler.size(), 0);
+}
+
+TEST(DltTcpReassembler, finBeforeMissingSegment) {
+    QVector<QByteArray> messages;
+    QDltTcpReassembler reassembler([&messages](const char *data, int size) { messages.append(QByteArray(data, size)); });
+
+    QDltFlowKey key;
+    key.protocol = 6;
+    QByteArray stream = createStream(0, 10);
+    int half = createMessage(0).size() + createMessage(1).size() + 5;
+
+    // the second half with the FIN is captured before the first half
+    reassembler.addSegment(key, 99, QDltTcpReassembler::FlagSyn, nullptr, 0, 0);
+    reassembler.addSegment(key, 100 + half, QDltTcpReassembler::FlagFin, stream.constData() + half, stream.size() - half, 0);
+    EXPECT_EQ(reassembler.size(), 1);
+    EXPECT_TRUE(messages.isEmpty());
+
+    reassembler.addSegment(key, 100, 0, stream.constData(), half, 0);
+    ASSERT_EQ(messages.size(), 10);
+    for (int i = 0; i < messages.size(); i++)
+        EXPECT_EQ(messages[i], createMessage(i));
+    EXPECT_EQ(reassembler.getBytesLost(), 0u);
+    EXPECT_EQ(reassembler.size(), 0);
+}
+
+TEST(DltMsg, getMsgSize) {
+    // several messages in one datagram, the first with storage header
+    QByteArray storageHeader("DLT\x01", 4);
+    storageHeader.append(QByteArray(8, '\0'));
+    storageHeader.append("ECU1", 4);
+    QByteArray data = storageHeader + createStream(0, 3);
+
+    quint32 size = createMessage(0).size() + storageHeaderSize;
+    EXPECT_EQ(QDltMsg::getMsgSize(data.constData(), data.size()), size);
+    EXPECT_EQ(QDltMsg::getMsgSize(data.constData() + size, data.size() - size), quint32(createMessage(1).size()));
+    EXPECT_EQ(QDltMsg::getMsgSize(data.constData(), size - 1), 0u);
+    EXPECT_EQ(QDltMsg::getMsgSize(data.constData(), 3), 0u);
+
+    // length smaller than the header
+    QByteArray invalid = createMessage(0);
+    invalid[2] = 0;
+    invalid[3] = 4;
+    EXPECT_EQ(QDltMsg::getMsgSize(invalid.constData(), invalid.size()), 0u);
+
+    // DLT version 2 header with message length, reserved content information is invalid
+    QByteArray v2("\x40\x00\x00\x00\x07\x00\x0c", 7);
+    v2.append(QByteArray(5, 'x'));
+    EXPECT_EQ(QDltMsg::getMsgSize(v2.constData(), v2.size(), true), 12u);
+    EXPECT_EQ(QDltMsg::getMsgSize(v2.constData(), v2.size() - 1, true), 0u);
+    v2[0] = char(0x43);
+    EXPECT_EQ(QDltMsg::getMsgSize(v2.constData(), v2.size(), true), 0u);
+
+    QDltMsg msg;
+    EXPECT_EQ(msg.checkMsgSize(data.constData(), data.size()), size);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include <qdlttimemerger.h>
+
+namespace {
+
+// almost sorted input like a trace of one logger, some messages arrive late
+QVector<QDltTimeIndexEntry> createInput(std::mt19937 &random, int count, qint64 firstIndex, int latePercent)
+{
+    QVector<QDltTimeIndexEntry> entries;
+    qint64 time = random() % 100000;
+    for (int i = 0; i < count; i++) {
+        time += random() % 100;
+        qint64 late = (int(random() % 100) < latePercent) ? random() % 1000 : 0;
+        entries.append({ time - late, firstIndex + i });
+    }
+    return entries;
+}
+
+QVector<qint64> sortedIndexes(QVector<QDltTimeIndexEntry> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const QDltTimeIndexEntry &a, const QDltTimeIndexEntry &b) {
+        return a.time < b.time || (a.time == b.time && a.index < b.index);
+    });
+    QVector<qint64> result;
+    for (const auto &entry : entries)
+        result.append(entry.index);
+    return result;
+}
+
+}
+
+TEST(DltTimeMerger, sortRuns) {
+    std::mt19937 random(1);
+    // already sorted, few late messages and many late messages sorted by the radix sort
+    for (int latePercent : { 0, 2, 50 }) {
+        QVector<QDltTimeIndexEntry> entries = createInput(random, 10000, 0, latePercent);
+        QVector<qint64> expected = sortedIndexes(entries);
+        QDltTimeMerger::sortRuns(entries);
+        ASSERT_EQ(entries.size(), expected.size());
+        for (int i = 0; i < entries.size(); i++)
+            EXPECT_EQ(entries[i].index, expected[i]) << latePercent << " " << i;
+    }
+}
+
+TEST(DltTimeMerger, mergeInputs) {
+    std::mt19937 random(2);
+    for (int inputs : { 0, 1, 2, 5, 16, 17 }) {
+        for (int threads : { 1, 4 }) {
+            QDltTimeMerger merger(threads);
+            QVector<QDltTimeIndexEntry> all;
+            qint64 index = 0;
+            for (int input = 0; input < inputs; input++) {
+                // inputs of different size, also empty ones
+                QVector<QDltTimeIndexEntry> entries = createInput(random, random() % 3000, index, 5);
+                index += entries.size();
+                all += entries;
+                merger.addInput(entries);
+            }
+            EXPECT_EQ(merger.size(), inputs);
+            EXPECT_EQ(merger.merge(), sortedIndexes(all)) << inputs << " inputs, " << threads << " threads";
+            EXPECT_EQ(merger.size(), 0);
+        }
+    }
+}
+
+TEST(DltTimeMerger, sameTimeKeepsIndexOrder) {
+    QDltTimeMerger merger;
+    merger.addInput({ { 10, 0 }, { 20, 1 }, { 20, 2 } });
+    merger.addInput({ { 20, 3 }, { 10, 4 } });
+    EXPECT_EQ(merger.merge(), QVector<qint64>({ 0, 4, 1, 2, 3 }));
+}
+
+TEST(DltTimeMerger, radixSort) {
+    std::mt19937 random(3);
+    for (int threads : { 1, 4 }) {
+        // unordered keys like ECU timestamps of several ECUs, negative keys and many equal keys
+        QVector<QDltTimeIndexEntry> entries;
+        for (int i = 0; i < 300000; i++)
+            entries.append({ qint64(random() % 100000) - 50000 + (qint64(random() % 3) << 40), i });
+        QVector<qint64> expected = sortedIndexes(entries);
+        QDltTimeMerger::radixSort(entries, threads);
+        EXPECT_EQ(QDltTimeMerger::getIndexes(entries), expected) << threads << " threads";
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef TESTMESSAGES_H
+#define TESTMESSAGES_H
+
+#include <QByteArray>
+
+// DLT messages for the tests, the payload size and content vary with n
+
+// message with storage header and standard header only
+inline QByteArray createStoredMessage(int n, quint32 seconds = 0, quint32 microseconds = 0)
+{
+    QByteArray payload(n % 50 + 1, char('a' + n % 26));
+    quint16 length = 4 + payload.size();
+
+    QByteArray data;
+    data.append("DLT\x01", 4);
+    for (int i = 0; i < 4; i++)
+        data.append(char((seconds >> (8 * i)) & 0xff));
+    for (int i = 0; i < 4; i++)
+        data.append(char((microseconds >> (8 * i)) & 0xff));
+    data.append("ECU1", 4);
+    data.append(char(0x20));
+    data.append(char(n & 0xff));
+    data.append(char(length >> 8));
+    data.append(char(length & 0xff));
+    data.append(payload);
+    return data;
+}
+
+// DLT message without storage header, standard header with ECU id
+inline QByteArray createMessage(int n)
+{
+    QByteArray payload(n * 37 % 300 + 1, char('a' + n % 26));
+    quint16 length = 8 + payload.size();
+
+    QByteArray data;
+    data.append(char(0x24));
+    data.append(char(n & 0xff));
+    data.append(char(length >> 8));
+    data.append(char(length & 0xff));
+    data.append("ECU1", 4);
+    data.append(payload);
+    return data;
+}
+
+#endif // TESTMESSAGES_H
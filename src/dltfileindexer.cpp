@@ -12,27 +12,12 @@
 #include <QFileInfo>
 
 #include "qdltoptmanager.h"
+#include "qdltcompressedfile.h"
 
 extern "C" {
     #include "dlt_common.h"
 }
 
-DltFileIndexerKey::DltFileIndexerKey(time_t time, unsigned int microseconds, int index)
-    : timestamp(0)
-{
-    this->time = time;
-    this->microseconds = microseconds;
-    this->index = index;
-}
-
-DltFileIndexerKey::DltFileIndexerKey(unsigned int timestamp, int index)
-    : time(0)
-    , microseconds(0)
-{
-    this->timestamp = timestamp;
-    this->index = index;
-}
-
 DltFileIndexer::DltFileIndexer(QObject *parent) :
     QThread(parent)
 {
@@ -96,6 +81,16 @@ bool DltFileIndexer::index(int num)
     //QTime time(0,0,0,0);
     // time.start();
 
+    // the importer already knows the positions of the messages it has written
+    if(!writtenIndexFilename.isEmpty() && QFileInfo(writtenIndexFilename) == QFileInfo(dltFile->getFileName(num)))
+    {
+        indexAllList = writtenIndex;
+        writtenIndexFilename.clear();
+        writtenIndex.clear();
+        qDebug() << "Using index of written file" << dltFile->getFileName(num);
+        return true;
+    }
+
     // load filter index if enabled
     if(filterCacheEnabled && loadIndexCache(dltFile->getFileName(num)))
     {
@@ -104,8 +99,10 @@ bool DltFileIndexer::index(int num)
         return true;
     }
 
-    // prepare indexing
-    QFile f(dltFile->getFileName(num));
+    // prepare indexing, compressed files are indexed by their uncompressed positions
+    QDltCompressedFile f;
+    f.setFileName(dltFile->getFileName(num));
+    f.setCacheBlocks(1);
 
     // open file
     if(!f.open(QIODevice::ReadOnly))
@@ -469,7 +466,10 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
     {
         msg = QSharedPointer<QDltMsg>::create(); // create new instance to be filled by getMsg(), otherwise shared pointer would be empty or pointing to last message
 
-        if(!dltFile->getMsg(ix, *msg))
+        // when only the filter changed, reuse messages already decoded by the decoder plugins
+        bool decoded = (mode != modeIndexAndFilter) && dltFile->getMsgCache()->get(ix, *msg);
+
+        if(!decoded && !dltFile->getMsg(ix, *msg))
             continue; // Skip broken messages
 
         /*if(true == useIndexerThread)
@@ -478,7 +478,7 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
         }
         else
         {*/
-            indexerThread.processMessage(msg, ix);
+            indexerThread.processMessage(msg, ix, decoded);
         //}
 
         if((end-start)!=0)
@@ -516,8 +516,33 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
     //msecsFilterCounter = time.elapsed();
 
     // use sorted values if sort by time enabled
-    if(sortByTimeEnabled || sortByTimestampEnabled)
-        indexFilterList = QVector<qint64>::fromList(indexFilterListSorted.values());
+    if(sortByTimeEnabled)
+    {
+        // the messages of each file are sorted in parallel, then all files are merged
+        QDltTimeMerger merger;
+        int first = 0;
+        qint64 fileEnd = 0;
+        for(int num=0;num<dltFile->getNumberOfFiles();num++)
+        {
+            fileEnd += dltFile->getFileMsgNumber(num);
+            int last = first;
+            while(last < indexFilterListSorted.size() && indexFilterListSorted[last].index < fileEnd)
+                last++;
+            merger.addInput(indexFilterListSorted.mid(first, last - first));
+            first = last;
+        }
+        if(first < indexFilterListSorted.size())
+            merger.addInput(indexFilterListSorted.mid(first));
+        indexFilterListSorted.clear();
+        indexFilterList = merger.merge();
+    }
+    else if(sortByTimestampEnabled)
+    {
+        // timestamps of several ECUs are not ordered, ties keep the file order
+        QDltTimeMerger::radixSort(indexFilterListSorted);
+        indexFilterList = QDltTimeMerger::getIndexes(indexFilterListSorted);
+        indexFilterListSorted.clear();
+    }
 
     // write filter index if enabled
     if(filterCacheEnabled)
@@ -671,6 +696,10 @@ void DltFileIndexer::run()
     activeViewerPlugins = pluginManager->getViewerPlugins();
     activeDecoderPlugins = pluginManager->getDecoderPlugins();
 
+    // decoded messages in the message cache are only valid for the current decoder plugins
+    if(dltFile->getMsgCache()->setDecoderHash(pluginsEnabled ? md5ActiveDecoderPlugins() : QByteArray()))
+        qDebug() << "Decoder plugins changed, message cache cleared";
+
     // calculate runs
     if(mode == modeIndexAndFilter)
         maxRun = dltFile->getNumberOfFiles()+1;
@@ -927,6 +956,9 @@ QByteArray DltFileIndexer::md5ActiveDecoderPlugins()
         hashString += plugin->name();
         hashString += plugin->pluginVersion();
         hashString += plugin->getFilename();
+        // configuration file may be changed and reloaded under the same name
+        if(!plugin->getFilename().isEmpty())
+            hashString += QFileInfo(plugin->getFilename()).lastModified().toString(Qt::ISODateWithMs);
     }
     hashByteArray = hashString.toLatin1();
 
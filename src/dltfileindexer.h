@@ -12,48 +12,11 @@
 #include "qdltfile.h"
 #include "qdltplugin.h"
 #include "qdltpluginmanager.h"
+#include "qdlttimemerger.h"
 
 #define DLT_FILE_INDEXER_SEG_SIZE (1024*1024)
 #define DLT_FILE_INDEXER_FILE_VERSION 2
 
-class DltFileIndexerKey
-{
-public:
-    DltFileIndexerKey(time_t time, unsigned int microseconds, int index);
-    DltFileIndexerKey(unsigned int timestamp, int index);
-
-    friend bool operator< (const DltFileIndexerKey &key1, const DltFileIndexerKey &key2);
-
-private:
-    time_t time;
-    unsigned int microseconds;
-    unsigned int timestamp;
-    int index;
-};
-
-inline bool operator< (const DltFileIndexerKey &key1, const DltFileIndexerKey &key2)
-{
-    if (key1.timestamp == 0 && key2.timestamp == 0)
-    {
-        if (key1.time < key2.time)
-            return true;
-        if (key1.time > key2.time)
-            return false;
-        if (key1.microseconds < key2.microseconds)
-            return true;
-        if (key1.microseconds > key2.microseconds)
-            return false;
-    }
-    else
-    {
-        if (key1.timestamp < key2.timestamp)
-            return true;
-        if (key1.timestamp > key2.timestamp)
-            return false;
-    }
-    return (key1.index < key2.index);
-}
-
 class DltFileIndexer : public QThread
 {
     Q_OBJECT
@@ -105,6 +68,12 @@ public:
     void setPluginsEnabled(bool enable) { pluginsEnabled = enable; }
     bool getPluginsEnabled() { return pluginsEnabled; }
 
+    // number of decoder plugins active in the current run
+    int getDecoderPluginsCount() { return activeDecoderPlugins.size(); }
+
+    // shared cache of decoded messages of the indexed file
+    QDltMsgCache* getMsgCache() { return dltFile->getMsgCache(); }
+
     // enable/disable filters
     void setFiltersEnabled(bool enable) { filtersEnabled = enable; }
     bool getFiltersEnabled() { return filtersEnabled; }
@@ -136,6 +105,9 @@ public:
     // reset / clear file indexes
     void clearindex() { indexAllList.clear(); }
 
+    // index of a file created while it was written, used once instead of scanning the file
+    void setWrittenIndex(const QString &filename, const QVector<qint64> &index) { writtenIndexFilename = filename; writtenIndex = index; }
+
     // main thread routine
     void run();
 
@@ -178,9 +150,13 @@ private:
     // full index
     QVector<qint64> indexAllList;
 
+    // index of a written file, see setWrittenIndex()
+    QString writtenIndexFilename;
+    QVector<qint64> writtenIndex;
+
     // filtered index
     QVector<qint64> indexFilterList;
-    QMap<DltFileIndexerKey,qint64> indexFilterListSorted;
+    QVector<QDltTimeIndexEntry> indexFilterListSorted; // sort by time or timestamp, in file order
 
     // getLogInfoList
     QList<int> getLogInfoList;
@@ -10,7 +10,7 @@ DltFileIndexerThread::DltFileIndexerThread
         bool sortByTimeEnabled,
         bool sortByTimestampEnabled,
         QVector<qint64> *indexFilterList,
-        QMap<DltFileIndexerKey,qint64> *indexFilterListSorted,
+        QVector<QDltTimeIndexEntry> *indexFilterListSorted,
         QDltPluginManager *pluginManager,
         QList<QDltPlugin*> *activeViewerPlugins,
         bool silentMode
@@ -50,7 +50,7 @@ void DltFileIndexerThread::run()
         processMessage(msgPair.first, msgPair.second);
 }
 
-void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int index)
+void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int index, bool decoded)
 {
     DltFileIndexer::IndexingMode mode = indexer->getMode();
     bool pluginsEnabled = indexer->getPluginsEnabled();
@@ -116,10 +116,12 @@ void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int inde
         }
     }
 
-    /* Process all decoderplugins */
-    if ( pluginsEnabled == true )
+    /* Process all decoderplugins, keep the result for the views and the next filter run */
+    if ( pluginsEnabled == true && decoded == false )
      {
      (void) pluginManager->decodeMsg(*msg, silentMode);
+     if ( indexer->getDecoderPluginsCount() > 0 )
+        indexer->getMsgCache()->put(index, *msg);
      }
 
 
@@ -128,11 +130,11 @@ void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int inde
     {
         if(sortByTimeEnabled)
          {
-            indexFilterListSorted->insert(DltFileIndexerKey(msg->getTime(), msg->getMicroseconds(), index), index);
+            indexFilterListSorted->append({ qint64(msg->getTime()) * 1000000 + msg->getMicroseconds(), index });
          }
         else if(sortByTimestampEnabled)
          {
-            indexFilterListSorted->insert(DltFileIndexerKey(msg->getTimestamp(), index), index);
+            indexFilterListSorted->append({ msg->getTimestamp(), index });
          }
         else
          {
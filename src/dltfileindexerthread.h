@@ -9,10 +9,10 @@ class DltFileIndexerThread :public QThread
 {
     Q_OBJECT
 public:
-    DltFileIndexerThread(DltFileIndexer *indexer, QDltFilterList *filterList, bool sortByTimeEnabled, bool sortByTimestampEnabled, QVector<qint64> *indexFilterList, QMap<DltFileIndexerKey,qint64> *indexFilterListSorted, QDltPluginManager *pluginManager, QList<QDltPlugin*> *activeViewerPlugins, bool silentMode);
+    DltFileIndexerThread(DltFileIndexer *indexer, QDltFilterList *filterList, bool sortByTimeEnabled, bool sortByTimestampEnabled, QVector<qint64> *indexFilterList, QVector<QDltTimeIndexEntry> *indexFilterListSorted, QDltPluginManager *pluginManager, QList<QDltPlugin*> *activeViewerPlugins, bool silentMode);
     ~DltFileIndexerThread();
     void enqueueMessage(const QSharedPointer<QDltMsg> &msg, int index);
-    void processMessage(QSharedPointer<QDltMsg> &msg, int index);
+    void processMessage(QSharedPointer<QDltMsg> &msg, int index, bool decoded = false);
     void requestStop();
 
 protected:
@@ -25,7 +25,7 @@ private:
     bool sortByTimestampEnabled;
 
     QVector<qint64> *indexFilterList;
-    QMap<DltFileIndexerKey,qint64> *indexFilterListSorted;
+    QVector<QDltTimeIndexEntry> *indexFilterListSorted;
 
     QDltPluginManager *pluginManager;
     QList<QDltPlugin*> *activeViewerPlugins;
@@ -0,0 +1,177 @@
+#include "dltmsgprefetcher.h"
+
+#include <QMutexLocker>
+
+/* number of pages read ahead in scroll direction */
+#define PREFETCH_PAGES_AHEAD 2
+/* number of pages read behind the scroll direction */
+#define PREFETCH_PAGES_BEHIND 1
+/* number of messages read and decoded in one batch */
+#define PREFETCH_BATCH_SIZE 128
+
+DltMsgPrefetcher::DltMsgPrefetcher(QDltFile *qfile, QDltPluginManager *pluginManager, QObject *parent)
+    : QThread(parent),
+      qfile(qfile),
+      pluginManager(pluginManager),
+      requestPluginsEnabled(false),
+      requestPending(false),
+      busy(false),
+      stopRequested(false),
+      generation(0),
+      lastFirstRow(0)
+{
+
+}
+
+DltMsgPrefetcher::~DltMsgPrefetcher()
+{
+    stop();
+}
+
+void DltMsgPrefetcher::prefetch(int firstRow, int lastRow, bool pluginsEnabled)
+{
+    if(!qfile->getMsgCache()->isEnabled())
+        return;
+
+    int rows = qfile->sizeFilter();
+    if(rows <= 0 || firstRow < 0)
+        return;
+    if(lastRow < firstRow)
+        lastRow = firstRow;
+
+    int pageSize = lastRow - firstRow + 1;
+    bool forward = firstRow >= lastFirstRow;
+    lastFirstRow = firstRow;
+
+    /* visible rows first, then the pages in scroll direction, then the pages behind */
+    int aheadFirst, aheadLast, behindFirst, behindLast;
+    if(forward)
+    {
+        aheadFirst = lastRow + 1;
+        aheadLast = lastRow + PREFETCH_PAGES_AHEAD * pageSize;
+        behindFirst = firstRow - PREFETCH_PAGES_BEHIND * pageSize;
+        behindLast = firstRow - 1;
+    }
+    else
+    {
+        aheadFirst = firstRow - PREFETCH_PAGES_AHEAD * pageSize;
+        aheadLast = firstRow - 1;
+        behindFirst = lastRow + 1;
+        behindLast = lastRow + PREFETCH_PAGES_BEHIND * pageSize;
+    }
+
+    /* filter positions are resolved here, the caller holds the indexer lock, so the filter index is not changed meanwhile */
+    QVector<int> indexes;
+    indexes.reserve((1 + PREFETCH_PAGES_AHEAD + PREFETCH_PAGES_BEHIND) * pageSize);
+    auto appendRows = [&](int first, int last) {
+        first = qMax(first, 0);
+        last = qMin(last, rows - 1);
+        for(int row = first; row <= last; row++)
+            indexes.append(qfile->getMsgFilterPos(row));
+    };
+    appendRows(firstRow, lastRow);
+    appendRows(aheadFirst, aheadLast);
+    appendRows(behindFirst, behindLast);
+
+    QMutexLocker locker(&mutex);
+    requestIndexes = indexes;
+    requestPluginsEnabled = pluginsEnabled;
+    requestPending = true;
+    generation++;
+    requestCondition.wakeOne();
+}
+
+void DltMsgPrefetcher::cancel()
+{
+    QMutexLocker locker(&mutex);
+    requestPending = false;
+    requestIndexes.clear();
+    generation++;
+    while(busy)
+        idleCondition.wait(&mutex);
+    lastFirstRow = 0;
+}
+
+void DltMsgPrefetcher::stop()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+        requestPending = false;
+        generation++;
+        requestCondition.wakeOne();
+    }
+    wait();
+}
+
+void DltMsgPrefetcher::run()
+{
+    QMutexLocker locker(&mutex);
+    while(!stopRequested)
+    {
+        if(!requestPending)
+        {
+            requestCondition.wait(&mutex);
+            continue;
+        }
+
+        QVector<int> indexes = requestIndexes;
+        bool pluginsEnabled = requestPluginsEnabled;
+        unsigned int requestGeneration = generation;
+        requestIndexes.clear();
+        requestPending = false;
+        busy = true;
+
+        locker.unlock();
+        processRequest(indexes, pluginsEnabled, requestGeneration);
+        locker.relock();
+
+        busy = false;
+        idleCondition.wakeAll();
+    }
+}
+
+void DltMsgPrefetcher::processRequest(const QVector<int> &indexes, bool pluginsEnabled, unsigned int requestGeneration)
+{
+    QDltMsgCache *cache = qfile->getMsgCache();
+    bool dltv2Support = qfile->getDLTv2Support();
+
+    QVector<int> batch;
+    batch.reserve(PREFETCH_BATCH_SIZE);
+
+    for(int pos = 0; pos < indexes.size();)
+    {
+        /* stop as soon as a newer request or a cancel arrived */
+        if(generation != requestGeneration)
+            return;
+
+        batch.clear();
+        for(; pos < indexes.size() && batch.size() < PREFETCH_BATCH_SIZE; pos++)
+        {
+            if(!cache->contains(indexes[pos]))
+                batch.append(indexes[pos]);
+        }
+        if(batch.isEmpty())
+            continue;
+
+        QVector<QByteArray> buffers = qfile->getMsgBatch(batch);
+        for(int num = 0; num < batch.size(); num++)
+        {
+            if(generation != requestGeneration)
+                return;
+            if(buffers[num].isEmpty())
+                continue;
+
+            QDltMsg msg;
+            if(!msg.setMsg(buffers[num], true, dltv2Support))
+                continue;
+            msg.setIndex(batch[num]);
+
+            /* background decoding is never triggered by the user */
+            if(pluginsEnabled)
+                pluginManager->decodeMsg(msg, 0);
+
+            cache->put(batch[num], msg);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef DLTMSGPREFETCHER_H
+#define DLTMSGPREFETCHER_H
+
+#include "qdltfile.h"
+#include "qdltpluginmanager.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+
+#include <atomic>
+
+// Reads and decodes the messages around the visible rows of the table view in the background,
+// so that scrolling is served from the message cache of the QDltFile.
+// Messages are read in batches with merged file reads, pages in scroll direction are read first.
+class DltMsgPrefetcher : public QThread
+{
+    Q_OBJECT
+public:
+    DltMsgPrefetcher(QDltFile *qfile, QDltPluginManager *pluginManager, QObject *parent = nullptr);
+    ~DltMsgPrefetcher();
+
+    // Request read-ahead for the visible rows of the filtered file, called from the GUI thread.
+    // The caller must hold the lock of the DltFileIndexer, which changes the filter index.
+    // A new request replaces a pending one.
+    void prefetch(int firstRow, int lastRow, bool pluginsEnabled);
+
+    // Drop the pending request and wait until the running batch is finished,
+    // must be called before the file or the cache is changed.
+    void cancel();
+
+    // Stop the thread.
+    void stop();
+
+protected:
+    void run();
+
+private:
+    void processRequest(const QVector<int> &indexes, bool pluginsEnabled, unsigned int generation);
+
+    QDltFile *qfile;
+    QDltPluginManager *pluginManager;
+
+    QMutex mutex;
+    QWaitCondition requestCondition;
+    QWaitCondition idleCondition;
+    QVector<int> requestIndexes;
+    bool requestPluginsEnabled;
+    bool requestPending;
+    bool busy;
+    bool stopRequested;
+    std::atomic<unsigned int> generation;
+
+    int lastFirstRow;
+};
+
+#endif // DLTMSGPREFETCHER_H
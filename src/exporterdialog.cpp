@@ -26,6 +26,8 @@ void ExporterDialog::setFormat(QDltExporter::DltExportFormat exportFormat)
         ui->radioButtonCsv->setChecked(true);
     else if(exportFormat == QDltExporter::FormatDltDecoded)
         ui->radioButtonDltDecoded->setChecked(true);
+    else if(exportFormat == QDltExporter::FormatParquet)
+        ui->radioButtonParquet->setChecked(true);
 }
 
 QDltExporter::DltExportFormat ExporterDialog::getFormat()
@@ -40,6 +42,8 @@ QDltExporter::DltExportFormat ExporterDialog::getFormat()
         return QDltExporter::FormatCsv;
     if(ui->radioButtonDltDecoded->isChecked())
         return QDltExporter::FormatDltDecoded;
+    if(ui->radioButtonParquet->isChecked())
+        return QDltExporter::FormatParquet;
     return QDltExporter::FormatDlt;
 }
 
@@ -75,3 +79,17 @@ void ExporterDialog::setRange(unsigned long start, unsigned long stop)
     ui->startindex->setText(QString::number(start));
     ui->stopindex->setText(QString::number(stop));
 }
+
+bool ExporterDialog::getTimeRange(qint64 *start, qint64 *stop)
+{
+    /* microseconds, the stop time includes the whole millisecond */
+    *start=ui->starttime->dateTime().toMSecsSinceEpoch()*1000;
+    *stop=ui->stoptime->dateTime().toMSecsSinceEpoch()*1000+999;
+    return ui->groupBoxTimeRange->isChecked();
+}
+
+void ExporterDialog::setTimeRange(const QDateTime &start, const QDateTime &stop)
+{
+    ui->starttime->setDateTime(start);
+    ui->stoptime->setDateTime(stop);
+}
@@ -1,6 +1,7 @@
 #ifndef EXPORTERDIALOG_H
 #define EXPORTERDIALOG_H
 
+#include <QDateTime>
 #include <QDialog>
 
 #include "qdltexporter.h"
@@ -25,6 +26,9 @@ public:
 
     void getRange(unsigned long *start, unsigned long *stop);
     void setRange(unsigned long start, unsigned long stop);
+
+    bool getTimeRange(qint64 *start, qint64 *stop);
+    void setTimeRange(const QDateTime &start, const QDateTime &stop);
     
 private:
     Ui::ExporterDialog *ui;
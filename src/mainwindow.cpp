@@ -50,6 +50,7 @@
 #include <QtEndian>
 #include <QDir>
 #include <QDirIterator>
+#include <QScrollBar>
 
 /**
  * From QDlt.
@@ -210,7 +211,15 @@ MainWindow::MainWindow(QWidget *parent) :
 MainWindow::~MainWindow()
 {
     timer.stop(); // stop the receive timeout timer in case it is running
+    for(int num = 0; num < project.ecu->topLevelItemCount(); num++)
+    {
+        // the reader threads use the live sink
+        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
+        delete ecuitem->reader;
+        ecuitem->reader = nullptr;
+    }
     dltIndexer->stop(); // in case a thread is running we want to stop it
+    msgPrefetcher->stop(); // prefetcher uses qfile and pluginManager
     /**
      * All plugin dockwidgets must be removed from the layout manually and
      * then deleted. This has to be done here, because they contain
@@ -231,6 +240,9 @@ MainWindow::~MainWindow()
     }
 
 
+    // write the remaining frames and the seek table of a compressed log file
+    compressedOutputfile.close();
+
     if(( settings->appendDateTime == 1) && (outputfile.size() != 0))
     {
         // get new filename
@@ -238,10 +250,11 @@ MainWindow::~MainWindow()
         QString newFilename = info.baseName()+
                 (startLoggingDateTime.toString("__yyyyMMdd_hhmmss"))+
                 (QDateTime::currentDateTime().toString("__yyyyMMdd_hhmmss"))+
-                QString(".dlt");
+                QString(QDltCompressedWriter::isCompressedFileName(info.fileName()) ? ".dlt.zst" : ".dlt");
         QFileInfo infoNew(info.absolutePath(),newFilename);
 
         // rename old file
+        msgPrefetcher->cancel();
         qfile.close();
         outputfile.flush();
         outputfile.close();
@@ -270,6 +283,7 @@ MainWindow::~MainWindow()
     delete tableModel;
     delete searchDlg;
     delete dltIndexer;
+    delete msgPrefetcher;
     delete m_shortcut_searchnext;
     delete m_shortcut_searchprev;
     delete sortProxyModel;
@@ -473,10 +487,21 @@ void MainWindow::initView()
     connect(ui->filterWidget, SIGNAL(filterItemDropped()), this, SLOT(filterOrderChanged()));
     connect(ui->filterWidget, SIGNAL(filterCountChanged()), this, SLOT(filterCountChanged()));
 
+    /* messages received by the reader threads are written by the main thread */
+    nextLiveId = 0;
+    connect(&liveSink, &QDltLiveSink::messagesAvailable, this, &MainWindow::readLive, Qt::QueuedConnection);
+
+    /* the reader threads publish the messages to the relay clients */
+    liveSink.setRelay(&relayServer);
+    connect(&relayServer, &QDltRelayServer::clientsChanged, this, &MainWindow::updateRelayStatus);
+
     /* initialise statusbar */
     totalBytesRcvd = 0;
     totalByteErrorsRcvd = 0;
     totalSyncFoundRcvd = 0;
+    totalDatagramsDropped = 0;
+    totalRelayDropped = 0;
+    totalShed = 0;
 
     /* filename string */
     statusFilename = new QLabel("No log file loaded");
@@ -504,6 +529,10 @@ void MainWindow::initView()
     statusBytesReceived = new QLabel("Recv: 0");
     statusByteErrorsReceived = new QLabel("Recv Errors: 0");
     statusSyncFoundReceived = new QLabel("Sync found: 0");
+    statusRelay = new QLabel("Relay: 0");
+    statusRelay->setVisible(false);
+    statusShed = new QLabel("Shed: 0");
+    statusShed->setVisible(false);
     statusProgressBar = new QProgressBar();
 
     statusBar()->addWidget(statusFilename,1);
@@ -512,6 +541,8 @@ void MainWindow::initView()
     statusBar()->addWidget(statusBytesReceived, 0);
     statusBar()->addWidget(statusByteErrorsReceived);
     statusBar()->addWidget(statusSyncFoundReceived);
+    statusBar()->addWidget(statusRelay);
+    statusBar()->addWidget(statusShed);
     statusBar()->addWidget(statusProgressBar);
 
     /* Create search text box */
@@ -680,6 +711,11 @@ void MainWindow::initFileHandling()
     connect(dltIndexer, SIGNAL(finished()), this, SLOT(indexDone()));
     connect(dltIndexer, SIGNAL(started()), this, SLOT(indexStart()));
 
+    /* Initialize read-ahead of messages while scrolling */
+    msgPrefetcher = new DltMsgPrefetcher(&qfile, &pluginManager, this);
+    msgPrefetcher->start(QThread::LowPriority);
+    connect(ui->tableView->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::onTableViewScrolled);
+
     /* Plugins/Filters enabled checkboxes */
     pluginsEnabled = QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool();
     dltIndexer->setPluginsEnabled(pluginsEnabled);
@@ -847,11 +883,14 @@ void MainWindow::initFileHandling()
     if(!QDltOptManager::getInstance()->getPcapFiles().isEmpty())
     {
         qDebug() << "### Import PCAP files";
+        QDltImporter importer(&outputfile);
         for ( const auto& filename : QDltOptManager::getInstance()->getPcapFiles() )
         {
-            QDltImporter importer(&outputfile);
             importer.dltIpcFromPCAP(filename);
         }
+        QVector<qint64> index;
+        if(importer.getDltIndex(index))
+            dltIndexer->setWrittenIndex(outputfile.fileName(),index);
         if(QDltOptManager::getInstance()->isCommandlineMode())
             // if dlt viewer started as converter or with plugin option load file non multithreaded
             reloadLogFile(false,false);
@@ -864,11 +903,14 @@ void MainWindow::initFileHandling()
     if(!QDltOptManager::getInstance()->getMf4Files().isEmpty())
     {
         qDebug() << "### Import MF4 files";
+        QDltImporter importer(&outputfile);
         for ( const auto& filename : QDltOptManager::getInstance()->getMf4Files() )
         {
-            QDltImporter importer(&outputfile);
             importer.dltIpcFromMF4(filename);
         }
+        QVector<qint64> index;
+        if(importer.getDltIndex(index))
+            dltIndexer->setWrittenIndex(outputfile.fileName(),index);
         if(QDltOptManager::getInstance()->isCommandlineMode())
             // if dlt viewer started as converter or with plugin option load file non multithreaded
             reloadLogFile(false,false);
@@ -991,6 +1033,7 @@ void MainWindow::deleteactualFile()
     if(outputfileIsTemporary && !outputfileIsFromCLI)
     {
         // Delete created temp file
+        msgPrefetcher->cancel();
         qfile.close();
         outputfile.close();
         if(outputfile.exists() && !outputfile.remove())
@@ -1053,7 +1096,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
 void MainWindow::on_action_menuFile_New_triggered()
 {
     QString fileName = QFileDialog::getSaveFileName(this,
-        tr("New DLT Log file"), workingDirectory.getDltDirectory(), tr("DLT Files (*.dlt);;All files (*.*)"));
+        tr("New DLT Log file"), workingDirectory.getDltDirectory(), tr("DLT Files (*.dlt);;Compressed DLT Files (*.dlt.zst);;All files (*.*)"));
 
     if(fileName.isEmpty())
     {
@@ -1117,7 +1160,7 @@ void MainWindow::onNewTriggered(QString fileName)
 void MainWindow::on_action_menuFile_Open_triggered()
 {
     QStringList fileNames = QFileDialog::getOpenFileNames(this,
-        tr("Open DLT/PCAP/MF4 files"), workingDirectory.getDltDirectory(), tr("DLT/PCAP/MF4 files (*.dlt *.DLT *.pcap *.PCAP *.mf4 *.MF4);;DLT files (*.dlt *.DLT);;PCAP files (*.pcap *.PCAP);;MF4 files (*.mf4 *.MF4)"));
+        tr("Open DLT/PCAP/MF4 files"), workingDirectory.getDltDirectory(), tr("DLT/PCAP/MF4 files (*.dlt *.DLT *.dlt.zst *.dlt.gz *.pcap *.PCAP *.mf4 *.MF4);;DLT files (*.dlt *.DLT);;Compressed DLT files (*.dlt.zst *.dlt.gz);;PCAP files (*.pcap *.PCAP);;MF4 files (*.mf4 *.MF4)"));
 
     if(fileNames.isEmpty())
         return;
@@ -1129,7 +1172,7 @@ void MainWindow::on_action_menuFile_Open_triggered()
 
     for ( const auto& i : fileNames )
     {
-        if(i.endsWith(".dlt",Qt::CaseInsensitive))
+        if(i.endsWith(".dlt",Qt::CaseInsensitive) || QDltCompressedFile::isCompressedFileName(i))
             dltFileNames+=i;
         else if(i.endsWith(".pcap",Qt::CaseInsensitive))
             pcapFileNames+=i;
@@ -1277,10 +1320,11 @@ bool MainWindow::openDltFile(QStringList fileNames)
         fileNames.append(tempfile.fileName());
     }
 
-    /* open existing file and append new data */
+    /* open existing file and append new data, compressed files are opened read only */
     outputfile.setFileName(fileNames.last());
     setCurrentFile(fileNames.last());
-    if( true == outputfile.open(QIODevice::WriteOnly|QIODevice::Append) )
+    if( QDltCompressedFile::detectCompression(fileNames.last()) == QDltCompressedFile::CompressionNone &&
+        true == outputfile.open(QIODevice::WriteOnly|QIODevice::Append) )
     {
         openFileNames = fileNames;
         isDltFileReadOnly = false;
@@ -1619,6 +1663,12 @@ void MainWindow::on_actionExport_triggered()
 {
     /* export dialog */
     exporterDialog.setRange(0,qfile.size());
+    QDltMsg firstMsg, lastMsg;
+    if(qfile.size()>0 && qfile.getMsg(0,firstMsg) && qfile.getMsg(qfile.size()-1,lastMsg))
+    {
+        exporterDialog.setTimeRange(QDateTime::fromMSecsSinceEpoch(qint64(firstMsg.getTime())*1000+firstMsg.getMicroseconds()/1000),
+                                    QDateTime::fromMSecsSinceEpoch(qint64(lastMsg.getTime())*1000+lastMsg.getMicroseconds()/1000));
+    }
     exporterDialog.exec();
 
     if(exporterDialog.result() != QDialog::Accepted)
@@ -1666,7 +1716,7 @@ void MainWindow::on_actionExport_triggered()
 
     if((exportFormat == QDltExporter::FormatDlt)||(exportFormat == QDltExporter::FormatDltDecoded))
     {
-        filters << "DLT Files (*.dlt)" <<"All files (*.*)";
+        filters << "DLT Files (*.dlt)" << "Compressed DLT Files (*.dlt.zst)" <<"All files (*.*)";
         dialog.setDefaultSuffix("dlt");
         dialog.setWindowTitle("Export to DLT file");
         qDebug() << "DLT Export to Dlt";
@@ -1692,6 +1742,13 @@ void MainWindow::on_actionExport_triggered()
         dialog.setWindowTitle("Export to CSV file");
         qDebug() << "DLT Export to CSV";
     }
+    else if(exportFormat == QDltExporter::FormatParquet)
+    {
+        filters << "Parquet Files (*.parquet)" <<"All files (*.*)";
+        dialog.setDefaultSuffix("parquet");
+        dialog.setWindowTitle("Export to Parquet file");
+        qDebug() << "DLT Export to Parquet";
+    }
 
     dialog.setAcceptMode(QFileDialog::AcceptSave);
     dialog.setDirectory(workingDirectory.getExportDirectory());
@@ -1713,6 +1770,8 @@ void MainWindow::on_actionExport_triggered()
 
     unsigned long int startix, stopix;
     exporterDialog.getRange(&startix,&stopix);
+    qint64 starttime, stoptime;
+    bool timeRange = exporterDialog.getTimeRange(&starttime,&stoptime);
 
     filterUpdate(); // update filters of qfile before starting Exporting for RegEx operation
 
@@ -1724,6 +1783,8 @@ void MainWindow::on_actionExport_triggered()
     {
         exporterThread = new QDltExporter(&qfile, fileName, &pluginManager,exportFormat,exportSelection,0,project.settings->automaticTimeSettings,project.settings->utcOffset,project.settings->dst,QDltOptManager::getInstance()->getDelimiter(),QDltOptManager::getInstance()->getSignature(),this);
         exporterThread->exportMessageRange(startix,stopix);
+        if(timeRange)
+            exporterThread->exportTimeRange(starttime,stoptime);
     }
     connect(exporterThread, &QDltExporter::progress,    this, &MainWindow::progress);
     connect(exporterThread, &QDltExporter::resultReady, this, &MainWindow::handleExportResults);
@@ -1783,6 +1844,7 @@ void MainWindow::onSaveAsTriggered(QString fileName)
     /* change DLT file working directory */
     workingDirectory.setDltDirectory(QFileInfo(fileName).absolutePath());
 
+    msgPrefetcher->cancel();
     qfile.close();
     outputfile.close();
 
@@ -1870,6 +1932,13 @@ void MainWindow::on_action_menuFile_Clear_triggered()
     totalBytesRcvd = 0; // reset receive counter too
     totalSyncFoundRcvd = 0; // reset sync counter too
     totalByteErrorsRcvd = 0; // reset receive byte error too
+    totalDatagramsDropped = 0; // reset datagrams dropped by the kernel too
+    for(int num = 0; num < project.ecu->topLevelItemCount(); num++)
+    {
+        ((EcuItem*)project.ecu->topLevelItem(num))->totalDatagramsDropped = 0;
+    }
+    liveSink.clearShed(); // reset messages shed by the overload policy too
+    updateShedStatus(QHash<int,EcuItem*>());
     target_version_string.clear();
     autoloadPluginsVersionEcus.clear();
     autoloadPluginsVersionStrings.clear();
@@ -2103,8 +2172,8 @@ void MainWindow::reloadLogFileFinishFilter()
     // reconnect ecus again
     //connectPreviouslyConnectedECUs();
 
-    // We might have had readyRead events, which we missed
-    readyRead();
+    // Messages received while indexing are still in the live sink
+    readLive();
 
     // hide progress bar when finished
     statusProgressBar->reset();
@@ -2200,6 +2269,13 @@ void MainWindow::reloadLogFile(bool update, bool multithreaded)
 
     // stop last indexing process, if any
     dltIndexer->stop();
+    msgPrefetcher->cancel();
+
+    // decoded messages are kept while only the filters change,
+    // the indexer invalidates them when the decoder plugin configuration changed
+    qDebug() << "Message cache:" << qfile.getMsgCache()->count() << "messages" << qfile.getMsgCache()->sizeBytes()/1024 << "kB"
+             << "hits" << qfile.getMsgCache()->getHits() << "misses" << qfile.getMsgCache()->getMisses();
+    qfile.getMsgCache()->resetStatistics();
 
     // open qfile
     if( false == update)
@@ -2346,11 +2422,65 @@ void MainWindow::applySettings()
     if(dltIndexer)
         dltIndexer->setFilterCacheEnabled(settings->filterCache);
 
-    // set DLT message chache size
-    qfile.setCacheSize(settings->msgCacheSize);
+    // set DLT message cache size in MB
+    qfile.setCacheSize(settings->msgCacheSizeMB);
 
     // set DLTv2 Support
     qfile.setDLTv2Support(settings->supportDLTv2Decoding);
+
+    // limit the live messages waiting to be written
+    QDltLiveSink::Overload overload;
+    overload.policy = static_cast<QDltLiveSink::OverloadPolicy>(settings->overloadPolicy);
+    overload.highWatermark = qint64(settings->overloadHighWatermarkMB) * 1024 * 1024;
+    overload.logLevel = settings->overloadLogLevel;
+    overload.sampleRate = settings->overloadSampleRate;
+    // the messages kept by the policy must not grow without bound either
+    overload.hardLimit = 2 * overload.highWatermark;
+    liveSink.setOverload(overload);
+
+    // publish the live messages to other DLT clients
+    if(settings->relayServer && (!relayServer.isRunning() || relayServer.serverPort() != settings->relayPort))
+    {
+        if(!relayServer.start(QString(), settings->relayPort))
+        {
+            qDebug() << "Relay server not started:" << relayServer.errorString();
+        }
+    }
+    else if(!settings->relayServer)
+    {
+        relayServer.stop();
+    }
+    updateRelayStatus();
+}
+
+void MainWindow::updateShedStatus(const QHash<int,EcuItem*> &ecuitems)
+{
+    QMap<QString,quint64> shed;
+    QStringList lines;
+    for(const QDltLiveShedCounter &counter : liveSink.getShed())
+    {
+        /* connections of removed ECUs are shown with their id */
+        EcuItem *ecuitem = ecuitems.value(counter.ecu);
+        const QString key = QString("%1:%2").arg(ecuitem ? ecuitem->id : QString::number(counter.ecu), counter.apid);
+        shed[key] += counter.count;
+    }
+    for(auto it = shed.constBegin(); it != shed.constEnd(); ++it)
+    {
+        lines.append(QString("%1 %L2").arg(it.key()).arg(it.value()));
+    }
+    qcontrol.setShedMessages(shed);
+
+    totalShed = liveSink.getShedTotal();
+    statusShed->setVisible(totalShed > 0);
+    statusShed->setText(QString("Shed: %L1").arg(totalShed));
+    statusShed->setToolTip(lines.join("\n"));
+}
+
+void MainWindow::updateRelayStatus()
+{
+    statusRelay->setVisible(relayServer.isRunning());
+    statusRelay->setText(QString("Relay: %L1 clients").arg(relayServer.getClientCount()));
+    statusRelay->setToolTip(QString("Port %1, %L2 messages dropped for slow clients").arg(relayServer.serverPort()).arg(totalRelayDropped));
 }
 
 
@@ -3488,21 +3618,14 @@ void MainWindow::disconnectECU(EcuItem *ecuitem)
         ecuitem->update();
         on_configWidget_itemSelectionChanged();
 
-        /* update conenction state */
-        if(ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP || ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP)
-        {
-            /* TCP or UDP */
-            if (ecuitem->socket->state()!=QAbstractSocket::UnconnectedState)
-                ecuitem->socket->disconnectFromHost();
-        }
-        else
-        {
-            /* Serial */
-            qDebug() << "Close serial port" << ecuitem->getPort();
-            ecuitem->m_serialport->close();
-        }
+        /* close the connection and stop the reader thread */
+        delete ecuitem->reader;
+        ecuitem->reader = nullptr;
 
         ecuitem->InvalidAll();
+
+        /* the state change of the closed reader is ignored by liveStateChanged(), so the plugins are informed here */
+        pluginManager.stateChanged(project.ecu->indexOfTopLevelItem(ecuitem), QDltConnection::QDltConnectionOffline, ecuitem->getHostname());
     }
     checkConnectionState();
 }
@@ -3551,178 +3674,78 @@ void MainWindow::connectECU(EcuItem* ecuitem,bool force)
         /* reset receive buffer */
         ecuitem->totalBytesRcvd = 0;
         ecuitem->totalBytesRcvdLastTimeout = 0;
-        ecuitem->ipcon.clear();
-        ecuitem->serialcon.clear();
 
-        /* start socket connection to host */
+        /* a connection attempt is still running */
+        if(ecuitem->reader && ecuitem->reader->getState() == QDltConnection::QDltConnectionConnecting)
+        {
+            checkConnectionState();
+            return;
+        }
+
+        /* the connection is read and parsed by its own thread, the messages are written by readLive() */
+        QDltLiveReader::Settings readerSettings;
+        readerSettings.supportDLTv2 = settings->supportDLTv2Decoding;
         if(ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP)
         {
             /* TCP */
             qDebug()<< "Try to connect to ECU" << GetConnectionType(ecuitem->interfacetype) << ecuitem->getHostname() << QDateTime::currentDateTime().toString("hh:mm:ss");
-            /* connect socket signals with window slots */
-            if (ecuitem->socket->state()==QAbstractSocket::UnconnectedState)
-            {
-                disconnect(ecuitem->socket,0,0,0);
-                connect(ecuitem->socket,SIGNAL(connected()),this,SLOT(connected()));
-                connect(ecuitem->socket,SIGNAL(disconnected()),this,SLOT(disconnected()));
-#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-                connect(ecuitem->socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(error(QAbstractSocket::SocketError)));
-#else
-                connect(ecuitem->socket, &QAbstractSocket::errorOccurred, this, &MainWindow::error);
-#endif
-                connect(ecuitem->socket,SIGNAL(readyRead()),this,SLOT(readyRead()));
-                connect(ecuitem->socket,SIGNAL(stateChanged(QAbstractSocket::SocketState)),this,SLOT(stateChangedIP(QAbstractSocket::SocketState)));
-                ecuitem->socket->connectToHost(ecuitem->getHostname(),ecuitem->getIpport());
-            }
+            readerSettings.type = QDltLiveReader::TypeTcp;
+            readerSettings.hostname = ecuitem->getHostname();
+            readerSettings.port = ecuitem->getIpport();
+            readerSettings.syncSerialHeader = ecuitem->getSyncSerialHeaderIp();
         }
-        /* start socket connection to host */
-       else if(ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP)
+        else if(ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP)
         {
             /* UDP */
-            bool bindstate = false;
-            QString connectIPaddress = ecuitem->getEthIF();
-
+            readerSettings.type = QDltLiveReader::TypeUdp;
+            readerSettings.bindAddress = ecuitem->getEthIF();
             if ( ecuitem->getEthIF() == "AnyIP")
             {
-                connectIPaddress = "0.0.0.0"; // we need to translate AnyIP to 0.0.0.0 on Linux ...
+                readerSettings.bindAddress = "0.0.0.0"; // we need to translate AnyIP to 0.0.0.0 on Linux ...
             }
+            readerSettings.port = ecuitem->getUdpport();
 
-           /* connect socket signals with window slots */
-            if (ecuitem->socket->state() == QAbstractSocket::UnconnectedState)
+            if (  ecuitem->is_multicast == true )
+            {
+                qDebug()<< "Try to connect (UDP/MC) on" << ecuitem->getEthIF() << GetConnectionType(ecuitem->interfacetype)  << "on port" << ecuitem->getUdpport() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss");
+                readerSettings.multicastGroups = ecuitem->getmcastIP().split(QRegularExpression("\\s+"));
+                readerSettings.multicastGroups.removeAll(QString());
+                readerSettings.multicastInterface = ecuitem->getEthIF();
+            }
+            else
             {
-               disconnect(ecuitem->socket,0,0,0);
-
-               if (  ecuitem->is_multicast == true )
-               {
-                 qDebug()<< "Try to connect (UDP/MC) on" << ecuitem->getEthIF() << GetConnectionType(ecuitem->interfacetype)  << "on port" << ecuitem->getUdpport() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss");
-                 //bindstate = ecuitem->socket->bind(QHostAddress(ecuitem->getmcastIP()), ecuitem->getUdpport(),QUdpSocket::ShareAddress );
-                 bindstate = ecuitem->socket->bind(QHostAddress(connectIPaddress), ecuitem->getUdpport(),QUdpSocket::ShareAddress ) ;
-               }
-               else
-               {
                 qDebug()<< "Try to connect (UDP) to" << ecuitem->getEthIF() << GetConnectionType(ecuitem->interfacetype)  << "on port" << ecuitem->getUdpport() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss");
-                bindstate = ecuitem->socket->bind(QHostAddress(connectIPaddress), ecuitem->getUdpport(),QUdpSocket::ShareAddress ) ;
-               }
-
-               if ( true == bindstate )//ecuitem->socket->bind(QHostAddress(ecuitem->getmcastIP()), ecuitem->getUdpport(),QUdpSocket::ShareAddress ))
-                { // green - success
-                 qDebug() << "Bound to " << ecuitem->getEthIF() << "on port" << ecuitem->getUdpport();
-                 ecuitem->udpsocket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,26214400);
-                 ecuitem->tryToConnect = true;
-                 if (  ecuitem->is_multicast == true )
-                 {
-                     QList<QNetworkInterface> 	interfaces  = QNetworkInterface::allInterfaces();
-                     int num;
-                     for(num=0;num<interfaces.length();num++)
-                     {
-                         if(interfaces[num].humanReadableName()==ecuitem->getEthIF())
-                         {
-                             QString multicastAddressArray = ecuitem->getmcastIP();
-                             QStringList multicastAddress = multicastAddressArray.split(QRegularExpression("\\s+"));
-                             for(int i = 0;i<multicastAddress.size();i++)
-                             {
-                                 if(!multicastAddress[i].isEmpty())
-                                 {
-                                     if ( true == ecuitem->udpsocket.joinMulticastGroup(QHostAddress(multicastAddress[i]), interfaces[num]) )
-                                     {
-                                        qDebug() << "Successfully joined multicast group" << multicastAddress[i] << "on interface" << ecuitem->getEthIF();
-                                     }
-                                     else // setting up multicast failed
-                                     {
-                                        ecuitem->connected = false; // unicast socket setup was ok
-                                        ecuitem->connectError.append("Error joining multicast group");
-                                        qDebug() << "Error joining multicast group" << multicastAddress[i] << "on interface" << ecuitem->getEthIF() << ecuitem->socket->errorString();
-                                     }
-                                 }
-                             }
-                             break;
-                         }
-                     }
-                     if(num==interfaces.length())
-                     {
-                         ecuitem->connected = false; // unicast socket setup was ok
-                         ecuitem->connectError.append("Interface not found");
-                         qDebug() << "Error joining multicast group" << ecuitem->getmcastIP() << "on interface" << ecuitem->getEthIF() << ecuitem->socket->errorString();
-                     }
-                 } // multicast
-                 else // unicast case
-                 {
-                     qDebug() <<  "UDP unicast configured to" << ecuitem->getEthIF();
-                 }
-
-                 connect(ecuitem->socket,SIGNAL(connected()),this,SLOT(connected()));
-                 connect(ecuitem->socket,SIGNAL(disconnected()),this,SLOT(disconnected()));
-#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-                connect(ecuitem->socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(error(QAbstractSocket::SocketError)));
-#else
-                connect(ecuitem->socket, &QAbstractSocket::errorOccurred, this, &MainWindow::error);
-#endif
-                 connect(ecuitem->socket,SIGNAL(readyRead()),this,SLOT(readyRead()));
-                 connect(ecuitem->socket,SIGNAL(stateChanged(QAbstractSocket::SocketState)),this,SLOT(stateChangedIP(QAbstractSocket::SocketState)));
-                 ecuitem->update();
-                }
-                else
-                {
-                  qDebug() << "Error - binding failed with" << ecuitem->socket->errorString();
-                  ecuitem->connectError.append("Binding failed");
-                  ecuitem->connected = false;
-                  ecuitem->update();
-                }
             }
         }
         else
         {
             /* Serial */
-            if ( NULL == ecuitem->m_serialport )
-            {
-                qDebug()<< "Try to connect to ECU on serial port" << ecuitem->getPort() << QDateTime::currentDateTime().toString("hh:mm:ss");
-                ecuitem->m_serialport = new QSerialPort();
-                if ( NULL != ecuitem->m_serialport )
-                {
-                ecuitem->m_serialport->setBaudRate(ecuitem->getBaudrate(), QSerialPort::AllDirections);
-		ecuitem->m_serialport->setPortName(ecuitem->getPort());
-                ecuitem->m_serialport->setDataBits(QSerialPort::Data8);
-                ecuitem->m_serialport->setParity(QSerialPort::NoParity);
-                ecuitem->m_serialport->setStopBits(QSerialPort::OneStop);
-                ecuitem->m_serialport->setFlowControl(QSerialPort::NoFlowControl);
-                //ecuitem->m_serialport->waitForReadyRead(0); // this lead to immediate crash on Windows and Ubuntu
-                QThread::msleep(10);
-                connect(ecuitem->m_serialport,SIGNAL(readyRead()), this, SLOT(readyRead()));
-                connect(ecuitem->m_serialport,SIGNAL(dataTerminalReadyChanged(bool)),this,SLOT(stateChangedSerial(bool)));
-                //ecuitem->m_serialport->waitForReadyRead(10);
-                }
-             }
-            else // serial port object already exists
-            {
-                //to keep things consistent: delete old member, create new one
-                //alternatively we could just close the port, and set the new settings.
-                ecuitem->m_serialport->close();
-                ecuitem->m_serialport->setBaudRate(ecuitem->getBaudrate());
-                ecuitem->m_serialport->setPortName(ecuitem->getPort());
-            }
-
-            if(ecuitem->m_serialport->isOpen())
-            {
-                ecuitem->m_serialport->close();
-                ecuitem->m_serialport->setBaudRate(ecuitem->getBaudrate());
-            }
-
-            ecuitem->m_serialport->open(QIODevice::ReadWrite);
-
-            if( true == ecuitem->m_serialport->isOpen())
-            {
-                ecuitem->connected = true;
-                ecuitem->update();
-                on_configWidget_itemSelectionChanged();
-                qDebug() << "Open serial port" << ecuitem->getPort();
-                /* send new default log level to ECU, if selected in dlg */
-                if (ecuitem->updateDataIfOnline)
-                {
-                    sendUpdates(ecuitem);
-                }
+            qDebug()<< "Try to connect to ECU on serial port" << ecuitem->getPort() << QDateTime::currentDateTime().toString("hh:mm:ss");
+            readerSettings.type = ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_ASCII ? QDltLiveReader::TypeSerialAscii : QDltLiveReader::TypeSerialDlt;
+            readerSettings.serialPort = ecuitem->getPort();
+            readerSettings.baudrate = ecuitem->getBaudrate();
+            readerSettings.syncSerialHeader = ecuitem->getSyncSerialHeaderSerial();
+        }
 
-            }
+        /* the state of the connection is reported by liveStateChanged() */
+        if(ecuitem->reader)
+        {
+            /* the Offline state of the closed reader must not be taken for the new reader with the same id */
+            disconnect(ecuitem->reader, nullptr, this, nullptr);
         }
+        delete ecuitem->reader;
+        /* the id is kept on reconnect, messages of the previous reader still waiting in the sink are written too */
+        if(ecuitem->liveId < 0)
+        {
+            ecuitem->liveId = nextLiveId++;
+        }
+        else
+        {
+            liveSink.reset(ecuitem->liveId);
+        }
+        ecuitem->reader = new QDltLiveReader(ecuitem->liveId, readerSettings, &liveSink);
+        connect(ecuitem->reader, &QDltLiveReader::stateChanged, this, &MainWindow::liveStateChanged);
+        ecuitem->reader->start();
 
         if(  (settings->showCtId && settings->showCtIdDesc) || (settings->showApId && settings->showApIdDesc) )
         {
@@ -3732,31 +3755,61 @@ void MainWindow::connectECU(EcuItem* ecuitem,bool force)
     checkConnectionState();
 }
 
-void MainWindow::connected()
+void MainWindow::liveStateChanged(int ecu, int state, const QString &error)
 {
-    /* signal emited when connected to host */
-    /* find socket which emited signal */
-    //qDebug() << "Connected" << __LINE__ << __FILE__;
+    /* signal emited by the reader thread when the connection state changed */
+    /* find the ECU of the reader, a reader which was already closed is ignored */
     for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
     {
         EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
-        if( ecuitem->socket == sender())
+        if( !ecuitem->reader || ecuitem->liveId != ecu )
         {
-            /* update connection state */
-            ecuitem->connected = true;
-            ecuitem->connectError.clear();
-            ecuitem->update();
-            on_configWidget_itemSelectionChanged();
+            continue;
+        }
 
-            /* reset receive buffer */
+        switch(state)
+        {
+        case QDltConnection::QDltConnectionOnline:
+            qDebug()<<"Connected to" << ecuitem->getHostname() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss") << GetConnectionType(ecuitem->interfacetype);
+            /* UDP is connected when the first data is received */
+            if(ecuitem->interfacetype != EcuItem::INTERFACETYPE_UDP)
+            {
+                ecuitem->connected = true;
+            }
+            ecuitem->connectError.clear();
             ecuitem->totalBytesRcvd = 0;
             ecuitem->totalBytesRcvdLastTimeout = 0;
-            ecuitem->ipcon.clear();
-            ecuitem->serialcon.clear();
-            qDebug()<<"Connected to" << ecuitem->getHostname() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss") << GetConnectionType(ecuitem->interfacetype);
+            break;
+        case QDltConnection::QDltConnectionError:
+            qDebug() << "Connection error" << error << "for" << ecuitem->getHostname() << GetConnectionType(ecuitem->interfacetype);
+            ecuitem->connectError = error;
+            ecuitem->connected = false;
+            break;
+        case QDltConnection::QDltConnectionOffline:
+            qDebug() << "Disconnected" << ecuitem->getHostname() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss") << GetConnectionType(ecuitem->interfacetype);
+            ecuitem->connected = false;
+            ecuitem->InvalidAll();
+            break;
+        default:
+            break;
         }
+
+        /* update ECU item */
+        ecuitem->update();
+        on_configWidget_itemSelectionChanged();
+
+        if (state == QDltConnection::QDltConnectionOnline && ecuitem->updateDataIfOnline)
+        {
+            /* send new default log level to ECU, if selected in dlg */
+            sendUpdates(ecuitem);
+        }
+
+        /* plugins know errors as offline connection */
+        pluginManager.stateChanged(num,
+                                   state == QDltConnection::QDltConnectionError ? QDltConnection::QDltConnectionOffline : QDltConnection::QDltConnectionState(state),
+                                   ecuitem->getHostname());
     }
-checkConnectionState();
+    checkConnectionState();
 }
 
 void MainWindow::checkConnectionState()
@@ -3815,46 +3868,11 @@ void MainWindow::checkConnectionState()
     }
 }
 
-void MainWindow::disconnected()
-{
-    /* signal emited when disconnected to host */
-    /* find socket which emited signal */
-    for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
-    {
-        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
-        if( ecuitem &&
-            (ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP || ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP) &&
-            ecuitem->socket == sender())
-        {
-            switch (ecuitem->interfacetype)
-            {
-               case EcuItem::INTERFACETYPE_TCP:
-                    qDebug() << "Disconnected" << ecuitem->getHostname() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss") << GetConnectionType(ecuitem->interfacetype);
-                    break;
-               case EcuItem::INTERFACETYPE_UDP:
-                    qDebug() << "UDP socket closed on" << ecuitem->getEthIF() << "at" << QDateTime::currentDateTime().toString("hh:mm:ss") << GetConnectionType(ecuitem->interfacetype);
-                    break;
-               default:
-                    break;
-            }
-
-            /* update connection state */
-            ecuitem->connected = false;
-            ecuitem->connectError.clear();
-            ecuitem->InvalidAll();
-            ecuitem->update();
-            on_configWidget_itemSelectionChanged();
-
-            /* disconnect socket signals from window slots */
-            disconnect(ecuitem->socket,0,0,0);
-        }
-    }
-    checkConnectionState();
-}
-
-
 void MainWindow::timeout()
 {
+        /* write the messages which were delayed by the indexer */
+        readLive();
+
         for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
         {
             EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
@@ -3902,74 +3920,12 @@ void MainWindow::timeout()
         checkConnectionState();
 }
 
-void MainWindow::error(QAbstractSocket::SocketError /* socketError */)
-{
-    /* signal emited when connection to host is not possible */
-    //qDebug() << "Socket error" << __LINE__ << __FILE__;
-    /* find socket which emited signal */
-    for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
-    {
-        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
-        if( ecuitem &&
-            (ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP || ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP) &&
-            ecuitem->socket == sender())
-        {
-            /* save error */
-            ecuitem->connectError = ecuitem->socket->errorString();
-            qDebug() << "Socket connection error" << ecuitem->socket->errorString() << "for" << ecuitem->getHostname() << "on" << ecuitem->getIpport();// << __LINE__ << __FILE__;
-            /* disconnect socket */
-            ecuitem->socket->disconnectFromHost();
-
-            /* update connection state */
-            ecuitem->connected = false;
-            ecuitem->update();
-
-            on_configWidget_itemSelectionChanged();
-        }
-
-    }
-}
-
-void MainWindow::readyRead()
-{
-    /* signal emited when socket received data */
-    //qDebug() << "readyRead" << __LINE__ << __FILE__;
-    /* Delay reading, if indexer is working on the dlt file */
-    if(true == dltIndexer->tryLock())
-    {
-        /* find socket which emited signal */
-        for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
-        {
-            EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
-            if( ecuitem && (ecuitem->socket == sender() || ecuitem->m_serialport == sender() || dltIndexer == sender() ) && ( true == ecuitem->connected || (ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP ) ) )
-            {
-                read(ecuitem);
-            }
-        }
-        dltIndexer->unlock();
-    }
-    /*
-    else
-    {
-      qDebug() << "Fail locking indexer in readyRead" << __LINE__ << __FILE__;
-      //tbd: have a look why this one is called in commandline / mode File open
-    }
-    */
-
-}
-
 void MainWindow::writeDLTMessageToFile(const QByteArray& bufferHeader, std::string_view payload,
-                                       const EcuItem* ecuitem) {
-    DltStorageHeader str = QDltImporter::makeDltStorageHeader();
+                                       const EcuItem* ecuitem, quint32 sec, quint32 usec) {
+    DltStorageHeader str = QDltImporter::makeDltStorageHeader(QDltImporter::DltStorageHeaderTimestamp{sec, usec});
     if (ecuitem)
         dlt_set_id(str.ecu, ecuitem->id.toLatin1());
 
-    /* check if message is matching the filter */
-    // open the outputfile, if it is not open yet
-    if(!outputfile.isOpen() && !outputfile.open(QIODevice::WriteOnly|QIODevice::Append))
-    {
-        qDebug() << "Failed opening WriteOnly" << outputfile.fileName();
-    }
     // set start time when writing first data
     if(startLoggingDateTime.isNull())
     {
@@ -3979,221 +3935,209 @@ void MainWindow::writeDLTMessageToFile(const QByteArray& bufferHeader, std::stri
     if( settings->splitlogfile != 0) // only in case the file size limit checking is active ...
      {
      // check if files size limit reached ( see Settings->Project Other->Maximum File Size )
-     if( ( ((outputfile.size()+sizeof(DltStorageHeader)+bufferHeader.size()+ payload.size())) > settings->fmaxFileSizeMB *1000*1000) )
+     if( ( ((outputfileSize()+sizeof(DltStorageHeader)+bufferHeader.size()+ payload.size())) > settings->fmaxFileSizeMB *1000*1000) )
       {
         createsplitfile();
       }
     }
 
+    // the output is opened after splitting, the split file is complete
+    QIODevice *device = openOutputDevice();
+    if(!device)
+    {
+        return;
+    }
+    QIODevice &output = *device;
+
     // write data into file
     if(!ecuitem || !ecuitem->getWriteDLTv2StorageHeader())
     {
         // write version 1 storage header
-        outputfile.write((char*)&str,sizeof(DltStorageHeader));
+        output.write((char*)&str,sizeof(DltStorageHeader));
     }
     else
     {
         // write version 2 storage header
-        outputfile.write((char*)"DLT",3);
+        output.write((char*)"DLT",3);
         quint8 version = 2;
-        outputfile.write((char*)&version,1);
+        output.write((char*)&version,1);
         quint32 nanoseconds = str.microseconds * 1000ul; // not in big endian format
-        outputfile.write((char*)&nanoseconds,4);
+        output.write((char*)&nanoseconds,4);
         quint64 seconds = (quint64) str.seconds; // not in big endian format
-        outputfile.write(((char*)&seconds),5);
+        output.write(((char*)&seconds),5);
         quint8 length;
         length = ecuitem->id.length();
-        outputfile.write((char*)&length,1);
-        outputfile.write(ecuitem->id.toLatin1(),ecuitem->id.length());
+        output.write((char*)&length,1);
+        output.write(ecuitem->id.toLatin1(),ecuitem->id.length());
     }
-    outputfile.write(bufferHeader);
-    outputfile.write(payload.data(), payload.size());
-    outputfile.flush();
+    output.write(bufferHeader);
+    output.write(payload.data(), payload.size());
+    // flushed by readLive() after all received messages are written
     //outputfile.close();  // This slows down online tracing, keep open while online tracing
 }
 
-void MainWindow::read(EcuItem* ecuitem)
+QIODevice *MainWindow::openOutputDevice()
 {
-    int udpMessageCounter = 0;
-    long int bytesRcvd = 0;
+    // logging into a .dlt.zst file is compressed in zstd frames by a background thread
+    if(QDltCompressedWriter::isCompressedFileName(outputfile.fileName()))
+    {
+        return openCompressedOutputfile() ? &compressedOutputfile : nullptr;
+    }
 
-    if (nullptr == ecuitem)
+    // open the outputfile, if it is not open yet
+    if(!outputfile.isOpen() && !outputfile.open(QIODevice::WriteOnly|QIODevice::Append))
     {
-       qDebug() << "Invalid ECU given in" << __FILE__ << "Line:" << __LINE__;
-       return;
+        qDebug() << "Failed opening WriteOnly" << outputfile.fileName();
+        return nullptr;
     }
+    return &outputfile;
+}
 
-    qmsg.clear();
-    data.clear();
+qint64 MainWindow::outputfileSize() const
+{
+    // the compressed file is written by the writer thread, the size on disk is not the size of the log
+    if(QDltCompressedWriter::isCompressedFileName(outputfile.fileName()))
+    {
+        if(compressedOutputfile.isOpen() && compressedOutputfile.fileName() == outputfile.fileName())
+        {
+            return compressedOutputfile.getUncompressedSize();
+        }
+        return 0;
+    }
+    return outputfile.size();
+}
 
-    switch (ecuitem->interfacetype)
-     {
-      case EcuItem::INTERFACETYPE_TCP:
-          /* TCP */
-          data = ecuitem->socket->readAll();
-          bytesRcvd = data.size();
-          //qDebug() << "bytes received" << bytesRcvd;
-          ecuitem->ipcon.add(data);
-          break;
-      case EcuItem::INTERFACETYPE_UDP:
-          while(ecuitem->udpsocket.hasPendingDatagrams() && udpMessageCounter<100)
-          {
-            data.resize(ecuitem->udpsocket.pendingDatagramSize());
-            bytesRcvd = ecuitem->udpsocket.readDatagram( data.data(), data.size() );
-            //qDebug() << "bytes received" << bytesRcvd;
-            unsigned int dataSize = data.size();
-            const char* dataPtr = data.data();
-            // Find one or more DLT messages in the UDP message
-            while(dataSize>0)
-            {
-                quint32 sizeMsg = qmsg.checkMsgSize(dataPtr,dataSize,settings->supportDLTv2Decoding);
-                if(sizeMsg>0)
-                {
-                    // DLT message found, write it with storage header
-                    QByteArray empty;
-                    if(settings->loggingOnlyFilteredMessages)
-                    {
-                        // write only messages which match filter
-                        bool silentMode = !QDltOptManager::getInstance()->issilentMode();
-                        QDltMsg qmsg;
-                        qmsg.setMsg(QByteArray(dataPtr,sizeMsg),false,settings->supportDLTv2Decoding);
-                        if ( true == pluginsEnabled ) // we check the general plugin enabled/disabled switch
-                        {
-                           pluginManager.decodeMsg(qmsg,silentMode);
-                        }
-                        if(qfile.checkFilter(qmsg))
-                        {
-                            writeDLTMessageToFile(empty,{dataPtr,sizeMsg}, ecuitem);
-                        }
-                    }
-                    else
-                    {
-                        // write all messages
-                        writeDLTMessageToFile(empty, {dataPtr,sizeMsg}, ecuitem);
-                    }
-                    totalBytesRcvd+=sizeMsg;
-                    if(sizeMsg<=dataSize)
-                    {
-                        dataSize -= sizeMsg;
-                        dataPtr += sizeMsg;
-                    }
-                    else
-                    {
-                        dataSize = 0;
-                    }
-                }
-                else
-                {
-                    dataSize = 0;
-                }
-            }
-            //ecuitem->ipcon.add(data);
-            ecuitem->connected= true;
-            ecuitem->tryToConnect = true;
-            ecuitem->update();
-            udpMessageCounter++;
+bool MainWindow::openCompressedOutputfile()
+{
+    if(compressedOutputfile.isOpen() && compressedOutputfile.fileName() == outputfile.fileName())
+    {
+        return true;
+    }
 
-            /* analyse received message, check if DLT control message response */
-            /*if(qmsg.setMsg(data,false))
-            {
-                if ( (qmsg.getType()==QDltMsg::DltTypeControl) && (qmsg.getSubtype()==QDltMsg::DltControlResponse))
-                {
-                    controlMessage_ReceiveControlMessage(ecuitem,qmsg);
-                }
-            }*/
-          }
-          break;
-      case EcuItem::INTERFACETYPE_SERIAL_DLT:
-      case EcuItem::INTERFACETYPE_SERIAL_ASCII:
-          data = ecuitem->m_serialport->readAll();
-          bytesRcvd = data.size();
-          ecuitem->serialcon.add(data);
-          break;
-      default:
-         break;
-     }
+    // log file was changed, complete the previous compressed file
+    compressedOutputfile.close();
+
+    // frames can only be written to a new file
+    if(isDltFileReadOnly || outputfile.size() != 0)
+    {
+        qDebug() << "Appending to compressed log file is not supported" << outputfile.fileName();
+        return false;
+    }
 
+    compressedOutputfile.setFileName(outputfile.fileName());
+    // the view is updated when a frame is complete, so frames are completed at least every second
+    compressedOutputfile.setMaxFrameDelay(1000);
+    if(!compressedOutputfile.open(QIODevice::WriteOnly))
+    {
+        qDebug() << "Failed opening WriteOnly" << outputfile.fileName() << compressedOutputfile.errorString();
+        return false;
+    }
+    return true;
+}
 
-    if (bytesRcvd <= 0 && ecuitem->connected == false)
+void MainWindow::readLive()
+{
+    /* signal emited when the readers added messages to the live sink */
+    /* Delay writing, if indexer is working on the dlt file, the messages stay in the sink */
+    if(false == dltIndexer->tryLock())
     {
-      qDebug() << "ERROR: bytesRcvd <= 0 in " << __LINE__ << __FILE__;
-      return;
+        return;
     }
 
-    /* reading data; new data is added to the current buffer */
-     ecuitem->totalBytesRcvd += bytesRcvd;
+    liveSink.take(liveMessages);
 
-     while(((ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP) && ecuitem->ipcon.parseDlt(qmsg,settings->supportDLTv2Decoding)) ||
-            (ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_DLT && ecuitem->serialcon.parseDlt(qmsg,settings->supportDLTv2Decoding)) ||
-            (ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_ASCII && ecuitem->serialcon.parseAscii(qmsg)) )
+    /* find the ECUs of the messages and collect the statistics of the readers */
+    QHash<int,EcuItem*> ecuitems;
+    for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
+    {
+        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
+        if(ecuitem->liveId >= 0)
+        {
+            ecuitems.insert(ecuitem->liveId, ecuitem);
+        }
+        if(ecuitem->reader)
         {
-            /* analyse received message, check if DLT control message response */
-            if ( (qmsg.getType()==QDltMsg::DltTypeControl) && (qmsg.getSubtype()==QDltMsg::DltControlResponse))
+            const QDltLiveReader::Statistics statistics = ecuitem->reader->takeStatistics();
+            ecuitem->totalBytesRcvd += statistics.bytesReceived;
+            totalBytesRcvd += statistics.bytesReceived;
+            totalByteErrorsRcvd += statistics.bytesError;
+            totalSyncFoundRcvd += statistics.syncFound;
+            if(statistics.datagramsDropped)
             {
-                controlMessage_ReceiveControlMessage(ecuitem,qmsg);
+                ecuitem->totalDatagramsDropped += statistics.datagramsDropped;
+                totalDatagramsDropped += statistics.datagramsDropped;
+                qDebug() << "UDP receive buffer full," << statistics.datagramsDropped << "datagrams dropped on" << ecuitem->getEthIF() << "port" << ecuitem->getUdpport();
             }
+        }
+    }
+    totalRelayDropped += relayServer.takeDropped();
+    if(liveSink.getShedTotal() != totalShed)
+    {
+        updateShedStatus(ecuitems);
+    }
+
+    for(const QDltLiveMessage &message : std::as_const(liveMessages))
+    {
+        /* messages of ECUs which were removed meanwhile are dropped */
+        EcuItem *ecuitem = ecuitems.value(message.ecu);
+        if(!ecuitem)
+        {
+            continue;
+        }
+
+        if(ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP && true == ecuitem->tryToConnect && false == ecuitem->connected)
+        {
+            /* UDP is connected when data is received */
+            ecuitem->connected = true;
+            ecuitem->update();
+        }
+
+        if(message.controlResponse || settings->loggingOnlyFilteredMessages)
+        {
+            qmsg.setMsg(message.data,false,settings->supportDLTv2Decoding);
+        }
+
+        /* analyse received message, check if DLT control message response */
+        if(message.controlResponse)
+        {
+            controlMessage_ReceiveControlMessage(ecuitem,qmsg);
+        }
 
-            /* write message to file */
-            const QByteArray bufferHeader = qmsg.getHeader();
-            const QByteArray bufferPayload = qmsg.getPayload();
-            if(settings->loggingOnlyFilteredMessages)
+        /* write message to file */
+        if(settings->loggingOnlyFilteredMessages)
+        {
+            // write only messages which match filter
+            bool silentMode = !QDltOptManager::getInstance()->issilentMode();
+            if ( true == pluginsEnabled ) // we check the general plugin enabled/disabled switch
             {
-                // write only messages which match filter
-                bool silentMode = !QDltOptManager::getInstance()->issilentMode();
-                if ( true == pluginsEnabled ) // we check the general plugin enabled/disabled switch
-                {
-                   pluginManager.decodeMsg(qmsg,silentMode);
-                }
-                if(qfile.checkFilter(qmsg))
-                {
-                    writeDLTMessageToFile(
-                                bufferHeader,
-                                {bufferPayload.data(),
-                                 static_cast<std::string_view::size_type>(bufferPayload.size())},
-                                ecuitem);
-                }
+               pluginManager.decodeMsg(qmsg,silentMode);
             }
-            else
+            if(!qfile.checkFilter(qmsg))
             {
-                // write all messages
-                writeDLTMessageToFile(
-                            bufferHeader,
-                            {bufferPayload.data(),
-                             static_cast<std::string_view::size_type>(bufferPayload.size())},
-                            ecuitem);
+                continue;
             }
+        }
+        writeDLTMessageToFile(QByteArray(),
+                              {message.data.constData(),
+                               static_cast<std::string_view::size_type>(message.data.size())},
+                              ecuitem, message.sec, message.usec);
+    }
 
-        } //end while
-
-     if(ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP)
+    if(!liveMessages.isEmpty())
+    {
+        /* the messages of all connections are flushed at once */
+        if(outputfile.isOpen())
         {
-            /* TCP or UDP */
-            totalByteErrorsRcvd+=ecuitem->ipcon.bytesError;
-            ecuitem->ipcon.bytesError = 0;
-            totalBytesRcvd+=ecuitem->ipcon.bytesReceived;
-            //qDebug() << "totalBytesRcvd" << totalBytesRcvd;
-            ecuitem->ipcon.bytesReceived = 0;
-            totalSyncFoundRcvd+=ecuitem->ipcon.syncFound;
-            ecuitem->ipcon.syncFound = 0;
-         }
-       else if(ecuitem->m_serialport)
-         {
-            /* serial */
-            totalByteErrorsRcvd+=ecuitem->serialcon.bytesError;
-            ecuitem->serialcon.bytesError = 0;
-            totalBytesRcvd+=ecuitem->serialcon.bytesReceived;
-            ecuitem->serialcon.bytesReceived = 0;
-            totalSyncFoundRcvd+=ecuitem->serialcon.syncFound;
-            ecuitem->serialcon.syncFound = 0;
-         }
+            outputfile.flush();
+        }
+        liveMessages.clear();
 
-     //if(outputfile.isOpen()) //&& ( settings->loggingOnlyMode == 0 )  )
-     //   {
-            if(false == dltIndexer->isRunning())
-            {
-                updateIndex();
-            }
-     //   }
+        if(false == dltIndexer->isRunning())
+        {
+            updateIndex();
+        }
+    }
+    dltIndexer->unlock();
 }
 
 
@@ -4203,10 +4147,13 @@ void MainWindow::createsplitfile()
     dltIndexer->stop();
     QFileInfo info(outputfile.fileName());
 
+    // compressed file is complete after writing the seek table
+    compressedOutputfile.close();
+
     QString newFilename = info.baseName()+
             (startLoggingDateTime.toString("__yyyyMMdd_hhmmss"))+
             (QDateTime::currentDateTime().toString("__yyyyMMdd_hhmmss"))+
-            QString(".dlt");
+            QString(QDltCompressedWriter::isCompressedFileName(info.fileName()) ? ".dlt.zst" : ".dlt");
     QFileInfo infoNew(info.absolutePath(),newFilename);
     qDebug() << "Split to" <<  outputfile.fileName() << "to" << infoNew.absoluteFilePath();
 
@@ -4301,7 +4248,7 @@ void MainWindow::updateIndex()
 
     for(int num=oldsize;num<qfile.size();num++)
     {
-     qmsg.setMsg(qfile.getMsg(num),true,settings->supportDLTv2Decoding);
+     bool validMsg = qmsg.setMsg(qfile.getMsg(num),true,settings->supportDLTv2Decoding);
      qmsg.setIndex(num);
 
      if ( true == pluginsEnabled ) // we check the general plugin enabled/disabled switch
@@ -4318,6 +4265,10 @@ void MainWindow::updateIndex()
         pluginManager.decodeMsg(qmsg,silentMode);
       }
 
+     // new messages are shown next in the table view, keep the decoded message in the shared cache
+     if(validMsg)
+        qfile.getMsgCache()->put(num,qmsg);
+
      if(qfile.checkFilter(qmsg))
       {
             qfile.addFilterIndex(num);
@@ -4357,9 +4308,32 @@ void MainWindow::draw_timeout()
 void MainWindow::drawUpdatedView()
 {
 
-    statusByteErrorsReceived->setText(QString("Recv Errors: %L1").arg(totalByteErrorsRcvd));
+    if(totalDatagramsDropped > 0)
+    {
+        statusByteErrorsReceived->setText(QString("Recv Errors: %L1, UDP dropped: %L2").arg(totalByteErrorsRcvd).arg(totalDatagramsDropped));
+    }
+    else
+    {
+        statusByteErrorsReceived->setText(QString("Recv Errors: %L1").arg(totalByteErrorsRcvd));
+    }
+    QStringList receiveErrors;
+    receiveErrors.append(QString("Invalid bytes received: %L1").arg(totalByteErrorsRcvd));
+    receiveErrors.append(QString("UDP datagrams dropped, receive buffer full: %L1").arg(totalDatagramsDropped));
+    for(int num = 0; num < project.ecu->topLevelItemCount(); num++)
+    {
+        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
+        if(ecuitem->totalDatagramsDropped > 0)
+        {
+            receiveErrors.append(QString("  %1: %L2").arg(ecuitem->id).arg(ecuitem->totalDatagramsDropped));
+        }
+    }
+    statusByteErrorsReceived->setToolTip(receiveErrors.join("\n"));
     statusBytesReceived->setText(QString("Recv: %L1").arg(totalBytesRcvd));
     statusSyncFoundReceived->setText(QString("Sync found: %L1").arg(totalSyncFoundRcvd));
+    if(relayServer.isRunning())
+    {
+        updateRelayStatus();
+    }
 
     tableModel->modelChanged();
 
@@ -4371,6 +4345,25 @@ void MainWindow::drawUpdatedView()
 
 }
 
+void MainWindow::onTableViewScrolled(int value)
+{
+    Q_UNUSED(value);
+
+    int firstRow = ui->tableView->rowAt(0);
+    int lastRow = ui->tableView->rowAt(ui->tableView->viewport()->height() - 1);
+    if(firstRow < 0)
+        return;
+    if(lastRow < 0)
+        lastRow = tableModel->rowCount() - 1;
+
+    // the indexer changes the filter index, no prefetching while it is running
+    if(dltIndexer->tryLock())
+    {
+        msgPrefetcher->prefetch(firstRow, lastRow, pluginsEnabled);
+        dltIndexer->unlock();
+    }
+}
+
 void MainWindow::onTableViewSelectionChanged(const QItemSelection & selected, const QItemSelection & deselected)
 {
     Q_UNUSED(deselected);
@@ -4427,14 +4420,16 @@ void MainWindow::onTableViewSelectionChanged(const QItemSelection & selected, co
 
         }
 
-        if ( pluginsEnabled == true )
+        // the table view has already decoded the selected message, take it from the shared message cache
+        QDltMsg decodedMsg;
+        if(!qfile.getMsgDecoded(msgIndex,decodedMsg,pluginsEnabled ? &pluginManager : nullptr,!QDltOptManager::getInstance()->issilentMode()))
         {
-        pluginManager.decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
+            decodedMsg = msg;
         }
 
         for(int i = 0; i < activeViewerPlugins.size(); i++){
             item = (QDltPlugin*)activeViewerPlugins.at(i);
-            item->selectedIdxMsgDecoded(msgIndex,msg);
+            item->selectedIdxMsgDecoded(msgIndex,decodedMsg);
         }
     }
 }
@@ -4572,11 +4567,11 @@ void MainWindow::controlMessage_SendControlMessage(EcuItem* ecuitem,DltMessage &
     msg.headersize = sizeof(DltStorageHeader) + sizeof(DltStandardHeader) + sizeof(DltExtendedHeader) + DLT_STANDARD_HEADER_EXTRA_SIZE(msg.standardheader->htyp);
     msg.standardheader->len = DLT_HTOBE_16(msg.headersize - sizeof(DltStorageHeader) + msg.datasize);
 
-    /* send message to daemon */
-    if ((ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP || ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP) && ecuitem->socket->isOpen())
+    /* send message to daemon, the data is written by the thread of the reader */
+    const bool online = ecuitem->reader && ecuitem->reader->getState() == QDltConnection::QDltConnectionOnline;
+    QByteArray tmpBuf;
+    if ((ecuitem->interfacetype == EcuItem::INTERFACETYPE_TCP || ecuitem->interfacetype == EcuItem::INTERFACETYPE_UDP) && online)
     {
-        QByteArray tmpBuf;
-
         /* Optional: Send serial header, if requested */
         if (ecuitem->getSendSerialHeaderIp())
             tmpBuf.append((const char*)dltSerialHeader, sizeof(dltSerialHeader));
@@ -4584,25 +4579,23 @@ void MainWindow::controlMessage_SendControlMessage(EcuItem* ecuitem,DltMessage &
         /* Send data */
         tmpBuf.append((const char*)msg.headerbuffer+sizeof(DltStorageHeader),msg.headersize-sizeof(DltStorageHeader));
         tmpBuf.append((const char*)msg.databuffer,msg.datasize);
-
-        ecuitem->socket->write(tmpBuf);
     }
-    else if (ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_DLT && ecuitem->m_serialport && ecuitem->m_serialport->isOpen())
+    else if (ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_DLT && online)
     {
         /* Optional: Send serial header, if requested */
         if (ecuitem->getSendSerialHeaderSerial())
-            ecuitem->m_serialport->write((const char*)dltSerialHeader,sizeof(dltSerialHeader));
+            tmpBuf.append((const char*)dltSerialHeader,sizeof(dltSerialHeader));
 
         /* Send data */
-        ecuitem->m_serialport->write((const char*)msg.headerbuffer+sizeof(DltStorageHeader),msg.headersize-sizeof(DltStorageHeader));
-        ecuitem->m_serialport->write((const char*)msg.databuffer,msg.datasize);
+        tmpBuf.append((const char*)msg.headerbuffer+sizeof(DltStorageHeader),msg.headersize-sizeof(DltStorageHeader));
+        tmpBuf.append((const char*)msg.databuffer,msg.datasize);
     }
-    else if (ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_ASCII && ecuitem->m_serialport && ecuitem->m_serialport->isOpen())
+    else if (ecuitem->interfacetype == EcuItem::INTERFACETYPE_SERIAL_ASCII && online)
     {
         /* In SERIAL_ASCII mode we send only user input */
         if (appid == "SER" && contid == "CON") {
-            ecuitem->m_serialport->write((const char*)(msg.databuffer+8),(msg.datasize-8));
-            ecuitem->m_serialport->write("\r\n");
+            tmpBuf.append((const char*)(msg.databuffer+8),(msg.datasize-8));
+            tmpBuf.append("\r\n");
         }
         else
         {
@@ -4615,19 +4608,23 @@ void MainWindow::controlMessage_SendControlMessage(EcuItem* ecuitem,DltMessage &
         qDebug() << "ECU is not connected !!";
         return;
     }
+    ecuitem->reader->write(tmpBuf);
 
     /* Skip the file handling, if indexer is working on the file */
-    if(!outputfile.isOpen() && !outputfile.open(QIODevice::WriteOnly|QIODevice::Append))
+    QIODevice *output = openOutputDevice();
+    if(!output)
     {
-        qDebug() << "Failed opening WriteOnly" << outputfile.fileName();
         return;
     }
     if(dltIndexer->tryLock())
     {
         /* store ctrl message in log file */
-        outputfile.write((const char*)msg.headerbuffer,msg.headersize);
-        outputfile.write((const char*)msg.databuffer,msg.datasize);
-        outputfile.flush();
+        output->write((const char*)msg.headerbuffer,msg.headersize);
+        output->write((const char*)msg.databuffer,msg.datasize);
+        if(output == &outputfile)
+        {
+            outputfile.flush();
+        }
 
         /* read received messages in DLT file parser and update DLT message list view */
         /* update indexes  and table view */
@@ -4692,19 +4689,25 @@ void MainWindow::controlMessage_WriteControlMessage(DltMessage &msg, QString app
     msg.standardheader->len = DLT_HTOBE_16(msg.headersize - sizeof(DltStorageHeader) + msg.datasize);
 
     /* Skip the file handling, if indexer is working on the file */
-    if(!outputfile.isOpen() && !outputfile.open(QIODevice::WriteOnly|QIODevice::Append))
+    QIODevice *output = openOutputDevice();
+    if(!output)
     {
-        qDebug() << "Failed opening WriteOnly" << outputfile.fileName();
         return;
     }
     if(dltIndexer->tryLock())
     {
         /* store ctrl message in log file */
-        // https://bugreports.qt-project.org/browse/QTBUG-26069
-        outputfile.seek(outputfile.size());
-        outputfile.write((const char*)msg.headerbuffer,msg.headersize);
-        outputfile.write((const char*)msg.databuffer,msg.datasize);
-        outputfile.flush();
+        if(output == &outputfile)
+        {
+            // https://bugreports.qt-project.org/browse/QTBUG-26069
+            outputfile.seek(outputfile.size());
+        }
+        output->write((const char*)msg.headerbuffer,msg.headersize);
+        output->write((const char*)msg.databuffer,msg.datasize);
+        if(output == &outputfile)
+        {
+            outputfile.flush();
+        }
 
         /* read received messages in DLT file parser and update DLT message list view */
         /* update indexes  and table view */
@@ -5896,82 +5899,6 @@ void MainWindow::sendUpdates(EcuItem* ecuitem)
 
 }
 
-void MainWindow::stateChangedSerial(bool dsrChanged){
-    /* signal emited when connection state changed */
-
-    /* find socket which emited signal */
-    for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
-    {
-        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
-        if( ecuitem->m_serialport == sender())
-        {
-            /* update ECU item */
-            ecuitem->update();
-
-            if(dsrChanged)
-            {
-                /* send new default log level to ECU, if selected in dlg */
-                if (ecuitem->updateDataIfOnline)
-                {
-                    sendUpdates(ecuitem);
-                }
-            }
-
-            if(dsrChanged)
-            {
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionOnline,ecuitem->getHostname());
-            }
-            else
-            {
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionOffline,ecuitem->getHostname());
-            }
-
-        }
-    }
-}
-
-void MainWindow::stateChangedIP(QAbstractSocket::SocketState socketState)
-{
-    /* signal emited when connection state changed */
-    //qDebug() << "stateChangedIP" << socketState << __LINE__ << __FILE__;
-    /* find socket which emited signal */
-    for(int num = 0; num < project.ecu->topLevelItemCount (); num++)
-    {
-        EcuItem *ecuitem = (EcuItem*)project.ecu->topLevelItem(num);
-        if( ecuitem && ecuitem->socket == sender())
-        {
-            /* update ECU item */
-            ecuitem->update();
-
-            if (socketState==QAbstractSocket::ConnectedState)
-            {
-                /* send new default log level to ECU, if selected in dlg */
-                if (ecuitem->updateDataIfOnline)
-                {
-                    sendUpdates(ecuitem);
-                }
-            }
-
-            switch(socketState){
-            case QAbstractSocket::UnconnectedState:
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionOffline,ecuitem->getHostname());
-                break;
-            case QAbstractSocket::ConnectingState:
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionConnecting,ecuitem->getHostname());
-                break;
-            case QAbstractSocket::ConnectedState:
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionOnline,ecuitem->getHostname());
-                break;
-            case QAbstractSocket::ClosingState:
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionOffline,ecuitem->getHostname());
-                break;
-            default:
-                pluginManager.stateChanged(num,QDltConnection::QDltConnectionOffline,ecuitem->getHostname());
-                break;
-            }
-        }
-    }
-}
 /*
 void MainWindow::stateChangedUDP(QAbstractSocket::SocketState socketState)
 {
@@ -7423,7 +7350,7 @@ void MainWindow::dropEvent(QDropEvent *event)
             QUrl url = event->mimeData()->urls()[num];
             filename = url.toLocalFile();
 
-            if(filename.endsWith(".dlt", Qt::CaseInsensitive))
+            if(filename.endsWith(".dlt", Qt::CaseInsensitive) || QDltCompressedFile::isCompressedFileName(filename))
             {
                 filenames.append(filename);
                 workingDirectory.setDltDirectory(QFileInfo(filename).absolutePath());
@@ -8352,6 +8279,13 @@ void MainWindow::on_lineEditFilterEnd_textChanged(const QString &arg1)
 void MainWindow::handleImportResults(const QString &)
 {
     statusProgressBar->hide();
+
+    // the importer indexed the messages while writing them, no need to scan the file again
+    QVector<qint64> index;
+    QDltImporter *importer = qobject_cast<QDltImporter*>(sender());
+    if(importer && importer->getDltIndex(index))
+        dltIndexer->setWrittenIndex(outputfile.fileName(),index);
+
     reloadLogFile();
 }
 
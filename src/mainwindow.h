@@ -35,12 +35,16 @@
 #include "searchdialog.h"
 #include "filterdialog.h"
 #include "dltfileindexer.h"
+#include "dltmsgprefetcher.h"
 #include "workingdirectory.h"
 #include "exporterdialog.h"
 #include "searchtablemodel.h"
 #include "sortfilterproxymodel.h"
 #include "ui_mainwindow.h"
 #include "searchform.h"
+#include "qdltcompressedwriter.h"
+#include "qdltlivesink.h"
+#include "qdltrelayserver.h"
 
 /**
  * @brief Namespace to contain the toolbar positions.
@@ -118,6 +122,7 @@ private:
 
     QDltControl qcontrol;
     QFile outputfile;
+    QDltCompressedWriter compressedOutputfile; // live logging into a .dlt.zst outputfile
     bool outputfileIsTemporary;
     bool outputfileIsFromCLI;
     TableModel *tableModel;
@@ -131,11 +136,16 @@ private:
     QLabel *statusBytesReceived;
     QLabel *statusByteErrorsReceived;
     QLabel *statusSyncFoundReceived;
+    QLabel *statusRelay;
+    QLabel *statusShed;
     QProgressBar *statusProgressBar;
 
     unsigned long totalBytesRcvd;
     unsigned long totalByteErrorsRcvd;
     unsigned long totalSyncFoundRcvd;
+    quint64 totalDatagramsDropped;
+    unsigned long totalRelayDropped;
+    quint64 totalShed;
 
     /* Search */
     SearchDialog *searchDlg;
@@ -206,13 +216,21 @@ private:
     QHostAddress UDPsender; // in readdatagramm
     quint16 senderPort; // in readdatagramm
 
-    /* used in ::read() */
-    QByteArray data;
+    /* publishes the live messages to other DLT clients */
+    QDltRelayServer relayServer;
+
+    /* messages of all live connections, written by readLive() */
+    QDltLiveSink liveSink;
+    QVector<QDltLiveMessage> liveMessages;
+    int nextLiveId;
     QDltMsg qmsg;
 
     /* dlt-file Indexer with cancel cabability */
     DltFileIndexer *dltIndexer;
 
+    /* background read-ahead of the messages around the visible rows */
+    DltMsgPrefetcher *msgPrefetcher;
+
     /* Color for blinking 'Apply changes'-button */
     QColor pulseButtonColor;
 
@@ -283,7 +301,6 @@ private:
     void connectECU(EcuItem *ecuitem,bool force = false);
     void disconnectECU(EcuItem *ecuitem);
     void checkConnectionState();
-    void read(EcuItem *ecuitem);
     void updateIndex();
     void drawUpdatedView();
 
@@ -293,6 +310,9 @@ private:
     void setCurrentFile(const QString &fileName);
     void removeCurrentFile(const QString &fileName);
     void createsplitfile();
+    QIODevice *openOutputDevice();
+    qint64 outputfileSize() const;
+    bool openCompressedOutputfile();
 
     void updateRecentProjectActions();
     void setCurrentProject(const QString &projectName);
@@ -368,7 +388,7 @@ private:
     QString getPathFromExplorerViewIndexModel(const QModelIndex &proxyIndex);
 
     void writeDLTMessageToFile(const QByteArray& bufferHeader, std::string_view payload,
-                               const EcuItem* ecuitem);
+                               const EcuItem* ecuitem, quint32 sec, quint32 usec);
 
 protected:
     void keyPressEvent ( QKeyEvent * event ) override;
@@ -389,6 +409,7 @@ private slots:
     void triggerPluginsAutoload();
 
     void onTableViewSelectionChanged(const QItemSelection & selected, const QItemSelection & deselected);
+    void onTableViewScrolled(int value);
     void onSearchresultsTableSelectionChanged(const QItemSelection & selected, const QItemSelection & deselected);
 
     void on_tableView_customContextMenuRequested(QPoint pos);
@@ -519,10 +540,10 @@ private slots:
     void indexStart();
     void filterAdd();
     void filterAddTable();
-    void connected();
-    void disconnected();
-    void error(QAbstractSocket::SocketError);
-    void readyRead();
+    void liveStateChanged(int ecu, int state, const QString &error);
+    void readLive();
+    void updateRelayStatus();
+    void updateShedStatus(const QHash<int,EcuItem*> &ecuitems);
     void timeout();
     void draw_timeout();
     void connectAll();
@@ -533,8 +554,6 @@ private slots:
     void openRecentProject();
     void openRecentFilters();
     void applyConfigEnabled(bool enabled);
-    void stateChangedIP(QAbstractSocket::SocketState socketState);
-    void stateChangedSerial(bool dsrChanged);
     void sectionInTableDoubleClicked(int logicalIndex);
     void on_actionJump_To_triggered();
     void on_actionAutoScroll_triggered(bool checked);
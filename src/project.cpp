@@ -34,7 +34,8 @@ const char *traceinfo[] = {"default","off","on"};
 
 EcuItem::EcuItem(QTreeWidgetItem *parent)
 : QTreeWidgetItem(parent,ecu_type)
-, socket(0)
+, reader(nullptr)
+, liveId(-1)
 {
     /* initialise receive buffer and message*/
     id = default_id;
@@ -61,6 +62,7 @@ EcuItem::EcuItem(QTreeWidgetItem *parent)
     autoReconnectTimeout = RECONNECT_TIMEOUT;
     totalBytesRcvd = 0;
     totalBytesRcvdLastTimeout = 0;
+    totalDatagramsDropped = 0;
     is_multicast = false;
 
     tryToConnect = false;
@@ -68,8 +70,6 @@ EcuItem::EcuItem(QTreeWidgetItem *parent)
 
     status = EcuItem::unknown;
 
-    m_serialport = 0;
-
     /* Limit size of socket receiption buffer to limit application buffer size */
     /* qt sets buffer normally to unlimited */
     //socket.setReadBufferSize(64000);
@@ -81,7 +81,7 @@ EcuItem::EcuItem(QTreeWidgetItem *parent)
 
 EcuItem::~EcuItem()
 {
-
+    delete reader;
 }
 
 void EcuItem::update()
@@ -133,7 +133,6 @@ void EcuItem::update()
         case EcuItem::INTERFACETYPE_TCP:
 
             setData(1,Qt::DisplayRole,QString("%1 [TCP %2:%3]").arg(description).arg(hostname).arg(ipport));
-            socket = & tcpsocket;
             break;
         case EcuItem::INTERFACETYPE_UDP:
             if ( true == is_multicast)
@@ -144,12 +143,10 @@ void EcuItem::update()
             {
             setData(1,Qt::DisplayRole,QString("%1 [UDP %2:%3]").arg(description).arg(ethIF).arg(udpport));
             }
-            socket = & udpsocket;
             break;
         case EcuItem::INTERFACETYPE_SERIAL_DLT:
         case EcuItem::INTERFACETYPE_SERIAL_ASCII:
             setData(1,Qt::DisplayRole,QString("%1 [%2]").arg(description).arg(port));
-            socket = 0;
             break;
     }
 
@@ -23,6 +23,7 @@
 
 #include "plugintreewidget.h"
 #include "qdltipconnection.h"
+#include "qdltlivereader.h"
 #include "qdltserialconnection.h"
 #include "qdltplugin.h"
 #include "qdltsettingsmanager.h"
@@ -77,12 +78,9 @@ public:
     bool updateDataIfOnline;
     void update();
 
-    /* connection */
-    QTcpSocket tcpsocket;
-    QUdpSocket udpsocket;
-    QAbstractSocket * socket;
-
-    QSerialPort *m_serialport;
+    /* connection, read by the thread of the reader */
+    QDltLiveReader *reader;
+    int liveId; /* id of the messages of the reader in the live sink */
 
     /* connection status */
     bool tryToConnect;
@@ -95,6 +93,7 @@ public:
 
     /* current received message and buffer for receivig from the socket */
     unsigned long totalBytesRcvd;
+    quint64 totalDatagramsDropped; /* UDP datagrams dropped by the kernel, receive buffer full */
 
     /* AutoReconnecct */
     int32_t totalBytesRcvdLastTimeout;
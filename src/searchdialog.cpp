@@ -365,7 +365,6 @@ void SearchDialog::findMessages(long int searchLine, long int searchBorder, QReg
 {
 
     QDltMsg msg;
-    QByteArray buf;
     int ctr = 0;
     Qt::CaseSensitivity is_Case_Sensitive = Qt::CaseInsensitive;
 
@@ -425,16 +424,17 @@ void SearchDialog::findMessages(long int searchLine, long int searchBorder, QReg
             emit searchProgressValueChanged(static_cast<int>(ctr * 100.0 / file->sizeFilter()));
         }
 
-        /* get the message with the selected item id */
-        buf = file->getMsgFilter(searchLine);
-        msg.setMsg(buf);
-        msg.setIndex(file->getMsgFilterPos(searchLine));
-
-        /* decode the message if desired - could this call be avoided as the message is already decoded elsewhere ? */
+        /* get the message with the selected item id, decoded messages are reused from the message cache;
+           a search runs over the whole file, so the results are not added to the cache */
+        QDltMessageDecoder *decoder = nullptr;
         if(QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool())
         {
-            //qDebug() << "Decode" << __LINE__;
-            pluginManager->decodeMsg(msg, fSilentMode);
+            decoder = pluginManager;
+        }
+        if(!file->getMsgDecoded(file->getMsgFilterPos(searchLine), msg, decoder, fSilentMode, false))
+        {
+            match = false;
+            continue;
         }
 
         const bool matchFound = getRegExp() ? matcher.match(msg, searchTextRegExp) : matcher.match(msg, getText());
@@ -38,6 +38,16 @@ SearchTableModel::~SearchTableModel()
 
 }
 
+bool SearchTableModel::getDecodedMsg(int row, QDltMsg &msg) const
+{
+    QDltMessageDecoder *decoder = nullptr;
+    if(QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool())
+        decoder = pluginManager;
+
+    /* decoded messages are shared with the main table view through the message cache of qfile */
+    return qfile->getMsgDecoded(m_searchResultList.at(row), msg, decoder, !QDltOptManager::getInstance()->issilentMode());
+}
+
 QVariant SearchTableModel::data(const QModelIndex &index, int role) const
 {
     QDltMsg msg;
@@ -52,7 +62,7 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
     if (role == Qt::DisplayRole)
     {
         /* get the message with the selected item id */
-        if(!qfile->getMsg(m_searchResultList.at(index.row()), msg))
+        if(!getDecodedMsg(index.row(), msg))
         {
             if(index.column() == FieldNames::Index)
             {
@@ -65,9 +75,6 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
             return QVariant();
         }
 
-        if(QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool())
-            pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
-
         QString visu_data;
         switch(index.column())
         {
@@ -195,7 +202,7 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
 
     if ( role == Qt::ForegroundRole )
     {
-        if(qfile->getMsg(m_searchResultList.at(index.row()), msg))
+        if(getDecodedMsg(index.row(), msg))
         {
             /* Valid message found, calculate background color and find optimal forground color */
             return QVariant(QBrush(DltUiUtils::optimalTextColor(getMsgBackgroundColor(msg))));
@@ -213,7 +220,7 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
 
     if ( role == Qt::BackgroundRole )
     {
-        if(qfile->getMsg(m_searchResultList.at(index.row()), msg))
+        if(getDecodedMsg(index.row(), msg))
         {
             /* Valid message found, calculate background color */
             return QVariant(QBrush(getMsgBackgroundColor(msg)));
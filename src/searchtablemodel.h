@@ -57,7 +57,10 @@ public:
     QDltFile *qfile;
     Project *project;
     QDltPluginManager *pluginManager;
-    
+
+private:
+    bool getDecodedMsg(int row, QDltMsg &msg) const;
+
 signals:
     
 public slots:
@@ -379,7 +379,13 @@ void SettingsDialog::writeDlg()
     ui->spinBoxFrequency->setValue(settings->RefreshRate);
     ui->checkBoxStartUpMinimized->setChecked(settings->StartupMinimized);
     ui->comboBox_MessageIdFormat->setCurrentText(settings->msgIdFormat);
-    ui->lineEditMsgCacheSize->setText(QString("%1").arg(settings->msgCacheSize));
+    ui->lineEditMsgCacheSize->setText(QString("%1").arg(settings->msgCacheSizeMB));
+    ui->checkBoxRelayServer->setChecked(settings->relayServer);
+    ui->spinBoxRelayPort->setValue(settings->relayPort);
+    ui->comboBoxOverloadPolicy->setCurrentIndex(settings->overloadPolicy);
+    ui->spinBoxOverloadHighWatermark->setValue(settings->overloadHighWatermarkMB);
+    ui->comboBoxOverloadLogLevel->setCurrentIndex(settings->overloadLogLevel-1);
+    ui->spinBoxOverloadSampleRate->setValue(settings->overloadSampleRate);
 
     ui->comboBoxTheme->setCurrentIndex(static_cast<int>(settings->themeSelectionSettings));
 }
@@ -469,7 +475,13 @@ void SettingsDialog::readDlg()
     settings->RefreshRate = ui->spinBoxFrequency->value();
     settings->StartupMinimized = ui->checkBoxStartUpMinimized->isChecked();
     settings->msgIdFormat=ui->comboBox_MessageIdFormat->currentText();
-    settings->msgCacheSize = ui->lineEditMsgCacheSize->text().toULong();
+    settings->msgCacheSizeMB = ui->lineEditMsgCacheSize->text().toULong();
+    settings->relayServer = ui->checkBoxRelayServer->isChecked();
+    settings->relayPort = ui->spinBoxRelayPort->value();
+    settings->overloadPolicy = ui->comboBoxOverloadPolicy->currentIndex();
+    settings->overloadHighWatermarkMB = ui->spinBoxOverloadHighWatermark->value();
+    settings->overloadLogLevel = ui->comboBoxOverloadLogLevel->currentIndex()+1;
+    settings->overloadSampleRate = ui->spinBoxOverloadSampleRate->value();
 
     auto prevUISettings = settings->themeSelectionSettings;
     settings->themeSelectionSettings = static_cast<QDltSettingsManager::UI_Colour>(ui->comboBoxTheme->currentIndex());
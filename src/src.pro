@@ -148,6 +148,7 @@ SOURCES += main.cpp \
     exporterdialog.cpp \
     dltmsgqueue.cpp \
     dltfileindexerthread.cpp \
+    dltmsgprefetcher.cpp \
     dltfileindexerdefaultfilterthread.cpp \
     ecutree.cpp \
 
@@ -180,6 +181,7 @@ HEADERS += mainwindow.h \
     exporterdialog.h \
     dltmsgqueue.h \
     dltfileindexerthread.h \
+    dltmsgprefetcher.h \
     dltfileindexerdefaultfilterthread.h \
     mcudpsocket.h \
     ecutree.h \
@@ -76,19 +76,14 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
 
      long int filterposindex = qfile->getMsgFilterPos(index.row());
 
+     // decoded messages are shared with the search view, plugins and exporter through the message cache of qfile
      std::optional<QDltMsg> msg;
-     if (m_cache.exists(index.row())) {
-         msg = m_cache.get(index.row());
-     } else {
-         QDltMsg omsg;
-         if (bool success = qfile->getMsg(filterposindex, omsg); success) {
-            msg = std::make_optional(omsg);
-            if (QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool()) {
-                pluginManager->decodeMsg(*msg, !QDltOptManager::getInstance()->issilentMode());
-            }
-         }
-
-         m_cache.put(index.row(), msg);
+     QDltMessageDecoder *decoder = nullptr;
+     if (QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool()) {
+         decoder = pluginManager;
+     }
+     if (QDltMsg omsg; qfile->getMsgDecoded(filterposindex, omsg, decoder, !QDltOptManager::getInstance()->issilentMode())) {
+         msg = std::move(omsg);
      }
 
      if (role == Qt::DisplayRole)
@@ -32,7 +32,6 @@
 #include "project.h"
 #include "qdltpluginmanager.h"
 #include "fieldnames.h"
-#include <qdltlrucache.hpp>
 
 #include <optional>
 
@@ -69,10 +68,6 @@ private:
     bool emptyForceFlag;
     bool loggingOnlyMode;
 
-    // cache is used in data()-method to avoid decoding of the same message multiple times
-    // key is a message index in the qdltfile; message can fail to decode, in that case value is empty optional
-    mutable QDltLruCache<int, std::optional<QDltMsg>> m_cache{1};
-
     long int searchhit;
     QColor searchBackgroundColor() const;
     QColor searchhit_higlightColor;